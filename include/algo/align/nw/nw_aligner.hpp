@@ -239,6 +239,11 @@ public:
 
     void    EnableMultipleThreads(bool enable = true);
 
+    // Run the dynamic programming through the vectorized kernel where the
+    // platform has one (the default); the results are the same either way
+    void    EnableSimd(bool enable = true) { m_Simd = enable; }
+    bool    IsSimdEnabled(void) const;
+
     // A naive pattern generator-use cautiously.
     // Do not use on sequences with repeats or error.
     size_t MakePattern(const size_t hit_size = 100, 
@@ -320,6 +325,9 @@ protected:
     bool                      m_mt;
     size_t                    m_maxthreads;
 
+    // vectorized kernel flag
+    bool                      m_Simd;
+
     // approximate max space to use
     size_t                   m_MaxMem;
 
@@ -376,6 +384,15 @@ protected:
             return 0x0F & ((m_Buf[i >> 1]) >> ((i & 1) << 2));
         }
 
+        // direct access for the vectorized kernel which sets values
+        // in arbitrary order and so needs the matrix zero-filled first
+        void Clear(size_t dim) {
+            memset(m_Buf, 0, dim / 2 + 1);
+        }
+        Uint1* SetBuf(void) {
+            return m_Buf;
+        }
+
     private:
         
         Uint1 * m_Buf;
@@ -641,6 +641,25 @@ class NCBI_XCONNECT_EXPORT CNetScheduleExecutor
                 unsigned         wait_time,
                 const string&    affinity_list = kEmptyStr);
 
+    /// Get up to max_jobs pending jobs in one request.
+    ///
+    /// Works like GetJob() without waiting, except that a server can
+    /// return several jobs in one reply. The jobs are appended to 'jobs'.
+    /// Servers that do not support this return at most one job.
+    /// At most 1000 jobs are requested at once, and a server can be
+    /// configured to give out fewer ([server]/max_get_jobs).
+    /// Like GetJob(), it requests jobs with the affinity preference of
+    /// the executor and 'affinity_list' only; the configured
+    /// 'affinity_ladder' that worker nodes walk with prioritized_aff
+    /// is not used.
+    ///
+    /// @return
+    ///     Number of jobs appended to 'jobs'.
+    ///
+    size_t GetJobs(vector<CNetScheduleJob>& jobs,
+                   unsigned                 max_jobs,
+                   const string&            affinity_list = kEmptyStr);
+
     /// Put job result (job should be received by GetJob() or WaitJob())
     ///
     /// @param job
@@ -649,6 +668,16 @@ class NCBI_XCONNECT_EXPORT CNetScheduleExecutor
     ///
     void PutResult(const CNetScheduleJob& job);
 
+    /// Put results of several jobs.
+    ///
+    /// The commands for the jobs of the same server are sent in one
+    /// batch and their replies are read afterwards, so there is
+    /// one round trip per server instead of one per job.
+    /// If some of the jobs fail, all the rest are still processed and
+    /// the first error is rethrown.
+    ///
+    void PutResults(const vector<CNetScheduleJob>& jobs);
+
     /// Put job interim (progress) message.
     ///
     /// @note The progress message must be first saved to a NetCache blob,
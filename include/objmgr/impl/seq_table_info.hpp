@@ -244,6 +244,15 @@ public:
     bool IsPartial(size_t row) const {
         return m_Partial.GetBool(row);
     }
+    bool IsSetPartial(size_t row) const {
+        return m_Partial && m_Partial.IsSet(row);
+    }
+
+    // true if location Seq-id, range, and strand are stored in
+    // separate columns, so they can be read without creating Seq-loc
+    bool HasColumnLocation(void) const {
+        return m_Location.IsSet() && !m_Location.IsRealLoc();
+    }
     
     CConstRef<CSeq_id> GetLocationId(size_t row) const {
         return GetLocation().GetId(row);
@@ -261,6 +270,11 @@ public:
     bool HasLabel(size_t row) const;
     string GetLabel(size_t row) const;
 
+    // return values straight from the table columns,
+    // null if the row has no such value
+    const string* GetComment(size_t row) const;
+    const string* GetNamedQual(size_t row, const CTempString& qual_name) const;
+
     bool MatchBitFilter(const SAnnotSelector& sel, size_t row) const;
 
     // returns null if column not found
@@ -407,22 +407,6 @@ bool CSeq_feat_Handle::GetExcept(void) const
 }
 
 
-inline
-bool CSeq_feat_Handle::IsSetComment(void) const
-{
-    // table SNP features may have comment
-    return IsTableSNP()? IsSetSNPComment(): GetSeq_feat()->IsSetComment();
-}
-
-
-inline
-const string& CSeq_feat_Handle::GetComment(void) const
-{
-    // table SNP features may have comment
-    return IsTableSNP()? GetSNPComment(): GetSeq_feat()->GetComment();
-}
-
-
 inline
 bool CSeq_feat_Handle::IsSetProduct(void) const
 {
@@ -134,6 +134,11 @@ public:
     void GetSeqData(const const_iterator& start,
                     const const_iterator& stop,
                     string& buffer) const;
+    /// Fill buffers[i] with the sequence data for ranges[i].
+    /// Much faster than separate GetSeqData() calls for many short
+    /// ranges, especially if the ranges are sorted by start.
+    void GetSeqData(const vector<TSeqRange>& ranges,
+                    vector<string>& buffers) const;
     void GetPackedSeqData(string& buffer,
                           TSeqPos start = 0,
                           TSeqPos stop = kInvalidSeqPos);
@@ -131,6 +131,11 @@ public:
     /// Fill the buffer string with the count bytes of sequence data
     /// starting with current iterator position
     void GetSeqData(string& buffer, TSeqPos count);
+    /// Fill buffers[i] with the sequence data of ranges[i] in one pass
+    /// over the sequence segments, ranges should be sorted by start.
+    /// The data is decoded straight into the buffers, so the iterator
+    /// position and its cache are left intact.
+    void GetSeqData(const vector<TSeqRange>& ranges, vector<string>& buffers);
 
     /// Get number of chars from current position to the current buffer end
     TSeqPos GetBufferSize(void) const;
@@ -242,6 +247,8 @@ private:
     void x_UpdateCacheUp(TSeqPos pos);
     void x_UpdateCacheDown(TSeqPos pos);
     void x_FillCache(TSeqPos start, TSeqPos count);
+    void x_FillData(const CSeqMap_CI& seg, char* dst,
+                    TSeqPos start, TSeqPos count);
     void x_UpdateSeg(TSeqPos pos);
     void x_InitSeg(TSeqPos pos);
     void x_IncSeg(void);
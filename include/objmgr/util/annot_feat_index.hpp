@@ -0,0 +1,203 @@
+#ifndef OBJMGR_UTIL___ANNOT_FEAT_INDEX__HPP
+#define OBJMGR_UTIL___ANNOT_FEAT_INDEX__HPP
+
+/*  $Id$
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+* File Description:
+*   Read-only feature index over Seq-annots, without CScope
+*/
+
+#include <corelib/ncbistd.hpp>
+#include <corelib/ncbiobj.hpp>
+#include <util/range.hpp>
+#include <objects/seq/seq_id_handle.hpp>
+#include <objects/seqfeat/SeqFeatData.hpp>
+#include <objmgr/util/seq_loc_util.hpp>
+
+BEGIN_NCBI_SCOPE
+BEGIN_SCOPE(objects)
+
+class CSeq_annot;
+class CSeq_feat;
+class CSeq_loc;
+class CObject_id;
+
+BEGIN_SCOPE(feature)
+
+
+/** @addtogroup ObjUtilFeature
+ *
+ * @{
+ */
+
+
+/////////////////////////////////////////////////////////////////////////////
+/// CAnnotFeatIndex
+///
+/// Compact read-only index of features from one or more feature table
+/// Seq-annots, for bulk processing of whole-genome annotation (writers,
+/// validators) where loading the data into a CScope and iterating it with
+/// CFeat_CI/CFeatTree is too expensive.
+///
+/// For each Seq-id and feature subtype the index keeps arrays of feature
+/// extremes sorted by start, one per length class (as CAnnotObject_Index
+/// does), so an overlap query is a binary search plus a short scan in each
+/// class, even with chromosome-sized features around.  Gene, mRNA and CDS
+/// parent links are computed once in the constructor, following the
+/// CFeatTree rules:
+///   - CDS -> mRNA by matching intervals, or by feature id xref;
+///   - other features -> gene by location subset, by gene xref
+///     (locus-tag or locus), or by feature id xref;
+///   - a suppressed gene xref (empty Gene-ref) means no gene.
+///
+/// Seq-ids are compared literally: without a scope there is no way to
+/// know that e.g. a GI and an accession denote the same sequence.
+/// The index keeps references to the indexed Seq-annots, which must not be
+/// modified while the index is in use.
+
+class NCBI_XOBJUTIL_EXPORT CAnnotFeatIndex : public CObject
+{
+public:
+    /// Position of a feature in the index, in the order features appear
+    /// in the source annots.
+    typedef Uint4 TFeatIndex;
+    static const TFeatIndex kNoFeat = TFeatIndex(-1);
+    typedef vector<TFeatIndex> TFeatList;
+    typedef vector< CConstRef<CSeq_annot> > TAnnots;
+
+    explicit CAnnotFeatIndex(const CSeq_annot& annot);
+    explicit CAnnotFeatIndex(const TAnnots& annots);
+    ~CAnnotFeatIndex(void);
+
+    /// Number of indexed features
+    size_t GetSize(void) const
+        {
+            return m_Feats.size();
+        }
+    const CSeq_feat& GetFeat(TFeatIndex feat) const
+        {
+            return *m_Feats[feat].m_Feat;
+        }
+    CSeqFeatData::ESubtype GetSubtype(TFeatIndex feat) const
+        {
+            return m_Feats[feat].m_Subtype;
+        }
+
+    /// Precomputed parent: mRNA for CDS, gene for other features,
+    /// kNoFeat if there is none.
+    TFeatIndex GetParent(TFeatIndex feat) const
+        {
+            return m_Feats[feat].m_Parent;
+        }
+    /// Children in index order
+    void GetChildren(TFeatIndex feat, TFeatList& children) const;
+
+    /// Best gene for an indexed feature, following parent links
+    /// (so a CDS gets the gene of its mRNA). kNoFeat for genes.
+    TFeatIndex GetBestGene(TFeatIndex feat) const;
+    /// Best gene for an arbitrary location: the smallest gene containing
+    /// the location extremes (eOverlap_Contained).
+    TFeatIndex GetBestGene(const CSeq_loc& loc) const;
+
+    /// Collect features whose extremes on the Seq-id overlap the range.
+    /// eSubtype_any selects all subtypes. Results are sorted by index.
+    void GetOverlappingFeats(const CSeq_id_Handle& id,
+                             const CRange<TSeqPos>& range,
+                             CSeqFeatData::ESubtype subtype,
+                             TFeatList& feats) const;
+    void GetOverlappingFeats(const CSeq_loc& loc,
+                             CSeqFeatData::ESubtype subtype,
+                             TFeatList& feats) const;
+
+private:
+    struct SFeatInfo {
+        CConstRef<CSeq_feat>   m_Feat;
+        CSeqFeatData::ESubtype m_Subtype;
+        TFeatIndex             m_Parent;
+    };
+    // Feature extremes on one Seq-id
+    struct SInterval {
+        TSeqPos    m_From;
+        TSeqPos    m_To;
+        TFeatIndex m_Feat;
+
+        bool operator<(const SInterval& b) const
+            {
+                return m_From != b.m_From? m_From < b.m_From:
+                    m_To != b.m_To? m_To < b.m_To: m_Feat < b.m_Feat;
+            }
+    };
+    // Intervals of similar length sorted by start; an interval overlapping
+    // [from, to] starts within [from - m_MaxLength, to].
+    struct SLevel {
+        TSeqPos           m_MaxLength;
+        vector<SInterval> m_Intervals;
+    };
+    typedef vector<SLevel> TIntervals;
+    typedef pair<CSeq_id_Handle, CSeqFeatData::ESubtype> TIntervalsKey;
+    typedef map<TIntervalsKey, TIntervals> TIntervalsMap;
+    typedef multimap<string, TFeatIndex> TGeneNameMap;
+    typedef multimap<const CObject_id*, TFeatIndex,
+                     PPtrLess<const CObject_id*> > TFeatIdMap;
+
+    void x_AddAnnot(const CSeq_annot& annot);
+    void x_AddFeat(const CSeq_feat& feat);
+    void x_Index(void);
+    void x_LinkParents(void);
+    TFeatIndex x_FindParentByXref(TFeatIndex feat,
+                                  CSeqFeatData::ESubtype parent_type) const;
+    TFeatIndex x_FindGeneByGeneXref(TFeatIndex feat, bool& suppressed) const;
+    TFeatIndex x_FindBestParent(const CSeq_loc& loc,
+                                CSeqFeatData::ESubtype parent_type,
+                                sequence::EOverlapType overlap_type) const;
+    void x_CollectOverlapping(const TIntervals& intervals,
+                              const CRange<TSeqPos>& range,
+                              TFeatList& feats) const;
+
+    TAnnots            m_Annots;
+    vector<SFeatInfo>  m_Feats;
+    // children of feature i are m_Children[m_ChildStart[i]..m_ChildStart[i+1])
+    vector<TFeatIndex> m_ChildStart;
+    vector<TFeatIndex> m_Children;
+    TIntervalsMap      m_Intervals;
+    TGeneNameMap       m_GenesByLocusTag;
+    TGeneNameMap       m_GenesByLocus;
+    TFeatIdMap         m_FeatsById;
+
+private:
+    CAnnotFeatIndex(const CAnnotFeatIndex&);
+    CAnnotFeatIndex& operator=(const CAnnotFeatIndex&);
+};
+
+
+/* @} */
+
+
+END_SCOPE(feature)
+END_SCOPE(objects)
+END_NCBI_SCOPE
+
+#endif  // OBJMGR_UTIL___ANNOT_FEAT_INDEX__HPP
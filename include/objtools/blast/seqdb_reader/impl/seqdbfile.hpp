@@ -522,7 +522,30 @@ public:
     inline void
     GetSeqStart(int     oid,
                 TIndx & start) const;
-    
+
+    /// Get the offset tables of the index file
+    ///
+    /// This method maps the index file (if needed) and returns
+    /// pointers to the header, sequence and ambiguity offset tables.
+    /// The pointers stay valid until the lease on the file is
+    /// released, and entries are stored in network byte order.  The
+    /// ambiguity table is only available for nucleotide volumes.
+    ///
+    /// @param hdr
+    ///   The returned header offset table.
+    /// @param seq
+    ///   The returned sequence offset table.
+    /// @param amb
+    ///   The returned ambiguity offset table, or NULL.
+    void GetOffsetTables(const Uint4 *& hdr,
+                         const Uint4 *& seq,
+                         const Uint4 *& amb) const
+    {
+        hdr = x_GetHdr();
+        seq = x_GetSeq();
+        amb = (x_GetSeqType() == 'n') ? x_GetAmb() : NULL;
+    }
+
     /// Get the sequence data type.
     char GetSeqType() const
     {
@@ -210,6 +210,20 @@ public:
     ///     The lock holder object for this thread. [in]
     void OpenSeqFile(CSeqDBLockHold &locked) const;
 
+    /// Map the volume files for a scan by several threads
+    ///
+    /// This method opens the sequence and header files and fills in
+    /// the region with pointers into the memory maps of the index,
+    /// sequence and header files.  The pointers stay valid until the
+    /// volume is closed or its leases are released (UnLease()).
+    ///
+    /// @param region
+    ///     The mapped tables of this volume. [out]
+    /// @param locked
+    ///     The lock holder object for this thread. [in]
+    void GetScanRegion(SSeqDBVolRegion & region,
+                       CSeqDBLockHold  & locked) const;
+
     /// Sequence length for protein databases.
     ///
     /// This method returns the length of the sequence in bases, and
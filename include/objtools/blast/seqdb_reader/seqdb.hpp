@@ -66,6 +66,9 @@ USING_SCOPE(objects);
 /// Forward declaration of CSeqDB class
 class CSeqDB;
 
+/// Forward declaration of CSeqDBScanPart class
+class CSeqDBScanPart;
+
 
 /// CSeqDBIter
 ///
@@ -1006,6 +1009,24 @@ public:
     /// iterations to be performed over the same CSeqDB object
     void ResetInternalChunkBookmark();
 
+    /// Split the iteration range for a scan by several threads.
+    ///
+    /// The OIDs of the iteration range are split into at most
+    /// num_parts contiguous parts holding roughly the same amount of
+    /// sequence data, and the files of all volumes are mapped before
+    /// this method returns.  Each part is meant to be iterated by a
+    /// single thread; see CSeqDBScanPart.  The parts read from these
+    /// mappings, so they must not be used after the sequence memory of
+    /// the database is flushed (CSeqDBImpl::FlushSeqMemory() releases
+    /// the mappings).
+    ///
+    /// @param num_parts
+    ///   Number of parts, usually the number of threads.
+    /// @param parts
+    ///   The returned parts, in OID order.
+    void GetScanParts(int                              num_parts,
+                      vector< CRef<CSeqDBScanPart> > & parts) const;
+
     /// Get list of database names.
     ///
     /// This returns the database name list used at construction.
@@ -1528,6 +1549,9 @@ protected:
     /// Implementation details are hidden.  (See seqdbimpl.hpp).
     class CSeqDBImpl * m_Impl;
 
+    /// Scan parts check that the database memory is not flushed.
+    friend class CSeqDBScanPart;
+
     /// No-argument Constructor
     ///
     /// This version of the constructor is used as an extension by the
@@ -1580,6 +1604,99 @@ FindBlastDBs(const string& path, const string& dbtype, bool recurse,
              bool include_alias_files = false,
              bool remove_redundant_dbs = false);
 
+/// CSeqDBScanPart --
+///
+/// One part of a database scan by several threads.
+///
+/// Parts are created by CSeqDB::GetScanParts(), which maps the files
+/// of all volumes beforehand.  Each part is meant to be iterated by a
+/// single thread: sequence and header data are read directly from the
+/// pre-mapped volume regions, so neither the atlas lock nor the
+/// per-thread sequence caches of CSeqDB::SetNumberOfThreads() are
+/// involved.  The returned data stays valid as long as the CSeqDB
+/// object exists and its sequence memory is not flushed, and does
+/// not need to be returned.  Parts must not be used once the memory
+/// is flushed; debug builds assert this.
+
+class NCBI_XOBJREAD_EXPORT CSeqDBScanPart : public CObject {
+public:
+    /// Get the first OID of this part.
+    int GetBegin() const
+    {
+        return m_Begin;
+    }
+
+    /// Get the OID after the last OID of this part.
+    int GetEnd() const
+    {
+        return m_End;
+    }
+
+    /// Move to the next included OID of this part.
+    /// @return
+    ///   False if the end of the part was reached.
+    bool Next();
+
+    /// Get the current OID.
+    int GetOID() const
+    {
+        return m_OID;
+    }
+
+    /// Get the sequence data of the current OID.
+    ///
+    /// The data is in the same format as returned by
+    /// CSeqDB::GetSequence().
+    ///
+    /// @param buffer
+    ///   The returned sequence data.
+    /// @return
+    ///   The length of the sequence in bases.
+    int GetSequence(const char ** buffer) const;
+
+    /// Get the header of the current OID as binary ASN.1.
+    ///
+    /// @return
+    ///   The Blast-def-line-set of the sequence, unfiltered.
+    CTempString GetRawHeader() const;
+
+private:
+    /// CSeqDB is a friend so it alone can create objects of this type.
+    friend class CSeqDB;
+
+    /// Build a part (called only from CSeqDB).
+    CSeqDBScanPart(const CSeqDB * db, int begin, int end, int flush_count)
+        : m_DB        (db),
+          m_Begin     (begin),
+          m_End       (end),
+          m_OID       (begin - 1),
+          m_RegionIdx (0),
+          m_FlushCount(flush_count)
+    {
+    }
+
+    /// The database this part belongs to.
+    CConstRef<CSeqDB>       m_DB;
+
+    /// Mapped tables of the volumes overlapping this part.
+    vector<SSeqDBVolRegion> m_Regions;
+
+    /// First OID of this part.
+    int                     m_Begin;
+
+    /// OID after the last OID of this part.
+    int                     m_End;
+
+    /// The current OID.
+    int                     m_OID;
+
+    /// Index of the region holding the current OID.
+    size_t                  m_RegionIdx;
+
+    /// Flushes of the database memory before the regions were mapped.
+    int                     m_FlushCount;
+};
+
 /// CSeqDBSequence --
 ///
 /// Small class to implement RIAA for sequences.
@@ -2059,6 +2059,54 @@ NCBI_XOBJREAD_EXPORT
 const string SeqDB_GetOidMaskFileExt(bool db_is_protein, EOidMaskType t);
 
 
+/// SSeqDBVolRegion
+///
+/// Memory mapped tables of one database volume.  These are filled in
+/// when a scan by several threads is prepared (see CSeqDBScanPart),
+/// so that sequence and header data can be located by pointer
+/// arithmetic alone, without the atlas lock or the lease mutexes.
+/// The offset tables are stored in network byte order.
+
+struct SSeqDBVolRegion {
+    /// Default constructor
+    SSeqDBVolRegion()
+        : oid_start  (0),
+          oid_end    (0),
+          seq_type   ('p'),
+          hdr_offsets(NULL),
+          seq_offsets(NULL),
+          amb_offsets(NULL),
+          hdr_data   (NULL),
+          seq_data   (NULL)
+    {
+    }
+
+    /// First OID of the volume.
+    int           oid_start;
+
+    /// OID after the last OID of the volume.
+    int           oid_end;
+
+    /// Sequence type ('p' or 'n').
+    char          seq_type;
+
+    /// Header offsets, one per OID plus one.
+    const Uint4 * hdr_offsets;
+
+    /// Sequence offsets, one per OID plus one.
+    const Uint4 * seq_offsets;
+
+    /// Ambiguity offsets, one per OID (nucleotide volumes only).
+    const Uint4 * amb_offsets;
+
+    /// Start of the header file data.
+    const char  * hdr_data;
+
+    /// Start of the sequence file data.
+    const char  * seq_data;
+};
+
+
 
 
 
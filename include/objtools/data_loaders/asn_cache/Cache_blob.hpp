@@ -50,6 +50,10 @@ BEGIN_NCBI_SCOPE
 BEGIN_objects_SCOPE // namespace ncbi::objects::
 
 class CSeq_entry;
+class CCache_blob_Dictionary;
+END_objects_SCOPE
+class CZstdCompression;
+BEGIN_objects_SCOPE
 
 /////////////////////////////////////////////////////////////////////////////
 class CCache_blob : public CCache_blob_Base
@@ -60,25 +64,107 @@ public:
     enum {
         kVersion = 1,
         kMagicNum = 0x05D705DD,
+        kMagicNumZstd = 0x05D705DE,
         kMD5Size = 16
     };
 
+    /// Blob compression, stored in the blob as its magic number
+    enum ECompression {
+        eZlib,  ///< zlib stream (kMagicNum), readable by all versions
+        eZstd   ///< zstd frame with optional dictionary (kMagicNumZstd)
+    };
+
     // constructor
     CCache_blob(void);
     // destructor
     ~CCache_blob(void);
 
-    void Pack(const CSeq_entry& entry);
+    /// Serialize and compress the entry.  eZstd blobs record the id of
+    /// 'dict', the same dictionary must be registered to unpack them.
+    void Pack(const CSeq_entry& entry,
+              ECompression compression = eZlib,
+              const CCache_blob_Dictionary* dict = NULL);
+
+    /// Unpack the blob, the compression is detected from the magic number
     void UnPack(CSeq_entry& entry) const;
     void UnPack(vector<unsigned char>& raw_bytes) const;
 
+    ECompression GetCompression(void) const;
+
 private:
+    void x_UnPackZstd(vector<unsigned char>& raw_bytes) const;
+
     // Prohibit copy constructor and assignment operator
     CCache_blob(const CCache_blob& value);
     CCache_blob& operator=(const CCache_blob& value);
 
 };
 
+
+/////////////////////////////////////////////////////////////////////////////
+///
+/// CCache_blob_Dictionary --
+///
+/// zstd dictionary trained on the Seq-entries of one ASN cache.  Seq-entries
+/// are small and very repetitive, so a shared dictionary makes the blobs
+/// both smaller and faster to decode.  Each eZstd blob records the id of
+/// its dictionary, and CCache_blob::UnPack() looks it up among the
+/// registered ones; CAsnCacheStore registers the dictionary of the cache
+/// when it opens it.
+///
+class CCache_blob_Dictionary : public CObject
+{
+public:
+    explicit CCache_blob_Dictionary(const vector<char>& data);
+    ~CCache_blob_Dictionary(void);
+
+    /// Load dictionary from a file and register it
+    static CRef<CCache_blob_Dictionary> Load(const string& file_name);
+
+    /// Train a dictionary on serialized (ASN.1 binary) Seq-entries.
+    /// Return NULL if there is not enough data to train on.
+    static CRef<CCache_blob_Dictionary>
+    Train(const vector< vector<unsigned char> >& samples, size_t max_size);
+
+    /// Make the dictionary available to CCache_blob::UnPack()
+    static void Register(CCache_blob_Dictionary& dict);
+
+    /// Find a registered dictionary, return NULL if there is none
+    static CConstRef<CCache_blob_Dictionary> Find(Uint4 id);
+
+    void Save(const string& file_name) const;
+
+    /// Checksum of the dictionary data, never 0
+    Uint4 GetId(void) const { return m_Id; }
+    const vector<char>& GetData(void) const { return m_Data; }
+
+private:
+    friend class CCache_blob;
+
+    CCache_blob_Dictionary(void);
+
+    /// Stand-in used for eZstd blobs packed without a dictionary, id 0
+    static const CCache_blob_Dictionary& x_GetEmpty(void);
+
+    void x_Compress(const void* src, size_t src_size, vector<char>& dst) const;
+    void x_Decompress(const char* src, size_t src_size,
+                      void* dst, size_t dst_size) const;
+
+    CZstdCompression* x_AcquireCodec(void) const;
+    void x_ReleaseCodec(CZstdCompression* codec) const;
+
+    struct SCodecPool;
+
+    vector<char>            m_Data;
+    Uint4                   m_Id;
+    unique_ptr<SCodecPool>  m_Pool;
+
+private:
+    // Prohibit copy constructor and assignment operator
+    CCache_blob_Dictionary(const CCache_blob_Dictionary&);
+    CCache_blob_Dictionary& operator=(const CCache_blob_Dictionary&);
+};
+
 /////////////////// CCache_blob inline methods
 
 /////////////////// end of CCache_blob inline methods
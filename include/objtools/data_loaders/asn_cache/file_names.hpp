@@ -57,6 +57,13 @@ namespace NASNCacheFileName
         return CDirEntry::ConcatPath( root_dir, GetSeqIdChunk() );
     }
      
+    /// zstd dictionary shared by the cache blobs, see CCache_blob_Dictionary
+    inline string GetZstdDictionary() { return string( "zstd_dict" ); }
+    inline string GetZstdDictionary( const string & root_dir )
+    {
+        return CDirEntry::ConcatPath( root_dir, GetZstdDictionary() );
+    }
+
     inline string GetIntermediateFilePrefix() { return string( "intermediate." ); }
 
     inline string GetHeader() { return string( "header" ); }
@@ -152,6 +152,19 @@ public:
     using TSeqIdTypes = ct::const_bitset<CSeq_id::e_MaxChoice, CSeq_id::E_Choice>;
     const TSeqIdTypes& GetSeqIdTypes() const { return m_seq_id_types; }
 
+    // Index building options, must be set before the first GetNextBlob().
+    //
+    // With more than one thread the entries of huge sets in memory mapped
+    // binary ASN.1 files are skipped over by the main pass and indexed by
+    // the worker threads. It's not used when ExtendReadHooks() was called,
+    // derived readers which override x_Set*Hooks() must add the records
+    // to the context lists and keep their hooks thread-safe to use it.
+    void SetIndexThreads(unsigned num_threads) { m_index_threads = num_threads; }
+    // The index of each blob is saved to the sidecar file and loaded
+    // from there by later runs if the input file did not change since.
+    // Extra hooks and hooks of derived readers are not called in this case.
+    void SetIndexFile(const string& filename) { m_index_file = filename; }
+
 protected:
     // temporary structure for indexing
     struct TBioseqInfoRec
@@ -167,6 +180,12 @@ protected:
     {
         std::deque<TBioseqInfoRec> bioseq_stack;
         std::deque<TBioseqSetList::iterator> bioseq_set_stack;
+        // where the records go, the reader's lists for the main pass
+        TBioseqList*    bioseq_list     = nullptr;
+        TBioseqSetList* bioseq_set_list = nullptr;
+        TFileSize       base_pos        = 0; // file position of the stream start
+        int             max_local_id    = 0;
+        bool            has_huge_set_annot = false;
     };
 
     virtual void x_SetHooks(CObjectIStream& objStream, TContext& context);
@@ -178,8 +197,22 @@ protected:
     TStreamPos GetCurrentPos() const;
 
 private:
+    struct SIndexChunk;
+    using TIndexChunks = std::deque<SIndexChunk>;
+
     void x_ResetIndex();
     void x_IndexNextAsn1();
+    void x_InitContext(TContext& context, TBioseqList& bioseq_list,
+                       TBioseqSetList& bioseq_set_list, TFileSize base_pos);
+    void x_SetDispatchHook(CObjectIStream& objStream, TContext& context, TIndexChunks& chunks);
+    void x_IndexChunks(TIndexChunks& chunks);
+    void x_IndexChunk(SIndexChunk& chunk);
+    bool x_UseParallelIndex() const;
+    void x_OpenIndexFile();
+    void x_CreateIndexFile(time_t mtime);
+    bool x_ReadIndexRecord();
+    void x_WriteIndexRecord();
+    void x_CommitIndexFile();
     void x_ThrowDuplicateId(
         const TBioseqSetInfo& existingInfo,const TBioseqSetInfo& newInfo, const CSeq_id& duplicateId);
 
@@ -189,6 +222,11 @@ private:
     TStreamPos              m_current_pos      = 0; // points to current blob in concatenated ASN.1 file
     CRef<CHugeFile>         m_file;
     std::list<t_more_hooks> m_more_hooks;
+    unsigned                m_index_threads    = 0;
+    string                  m_index_file;
+    bool                    m_index_file_opened = false;
+    unique_ptr<CNcbiIfstream> m_index_in;
+    unique_ptr<CNcbiOfstream> m_index_out;
 
 // global lists, readonly after indexing
 protected:
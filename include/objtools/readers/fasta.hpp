@@ -147,6 +147,30 @@ public:
     /// Read multiple sequences (by default, as many as are available.)
     CRef<CSeq_entry> ReadSet(int max_seqs = kMax_Int, ILineErrorListener* pMessageListener = nullptr);
 
+    /// Read all sequences from a regular file, with the same result as
+    /// ReadSet() would give.  The file is memory-mapped and split at
+    /// deflines into chunks of about GetParallelChunkSize() bytes, which
+    /// are parsed concurrently on a pool of worker threads.  Sequences,
+    /// lowercase masks and messages posted to pMessageListener are
+    /// delivered in file order, with file-wide line numbers.
+    /// @param path
+    ///   File to read; the reader's own line reader (if any) is not used.
+    /// @param num_threads
+    ///   Number of worker threads; 0 means one per CPU.
+    /// @note
+    ///   The chunks are parsed by CFastaReader objects carrying over the
+    ///   settings of this one, so overrides of the virtual parsing methods
+    ///   in derived classes only take effect in sequential reading.
+    ///   When pMessageListener is NULL, warnings are logged as they are
+    ///   found rather than in file order.
+    CRef<CSeq_entry> ReadSetParallel(const string& path,
+                                     unsigned int num_threads = 0,
+                                     ILineErrorListener* pMessageListener = nullptr);
+
+    /// Approximate size in bytes of the chunks parsed by ReadSetParallel().
+    size_t GetParallelChunkSize(void) const     { return m_ParallelChunkSize; }
+    void   SetParallelChunkSize(size_t size)    { m_ParallelChunkSize = size; }
+
     /// Read as many sequences as are available, and interpret them as
     /// an alignment, with hyphens marking relative deletions.
     /// @param reference_row
@@ -314,6 +338,14 @@ protected:
 
     std::string x_NucOrProt(void) const;
 
+    // ReadSetParallel() support
+    struct SParallelChunk;
+    void x_ReadParallelChunk(SParallelChunk& chunk,
+                             ILineErrorListener* pMessageListener) const;
+    bool x_MergeParallelChunk(SParallelChunk& chunk,
+                              CSeq_entry& entry,
+                              ILineErrorListener* pMessageListener);
+
 private:
     CModHandler m_ModHandler;
 
@@ -333,7 +365,10 @@ private:
 
     void x_SetDeflineParseInfo(SDefLineParseInfo& info);
 
+    void x_CopySettings(CFastaReader& reader) const;
+
     bool m_bModifiedMaxIdLength=false;
+    size_t m_ParallelChunkSize = 16 * 1024 * 1024;
 
 protected:
     struct SGap : public CObject {
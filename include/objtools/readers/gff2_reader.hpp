@@ -59,6 +59,13 @@ public:
         fGenbankMode =  1 << 4,
         fRetainLocusIds = 1 << 5,
         fAssumeCircularSequence = 1 << 6,
+        // Return one annot per sequence region: a new annot is started
+        // whenever the seqid changes (as well as at "###" and
+        // "##sequence-region"). CGff3Reader also releases everything kept
+        // for resolving parents and merging locations when the next annot
+        // starts, so memory grows with the largest region rather than the
+        // file; features must not span regions.
+        fStreaming = 1 << 7,
     } TFlags;
 
     using IdToFeatureMap = map<string, CRef<CSeq_feat>>;
@@ -103,6 +103,9 @@ public:
 
     virtual ~CGff3Reader();
 
+    /// With fStreaming, call this while !lr.AtEOF() && !AtSequenceData()
+    /// (as ReadSeqAnnots does) to get the regions one at a time; a null
+    /// annot is not an end marker.
     CRef<CSeq_annot>
     ReadSeqAnnot(
         ILineReader& lr,
@@ -225,6 +228,8 @@ protected:
     void xProcessSequenceRegionPragma(
         const string& pragma) override;
 
+    void xReleaseRegionData();
+
     // Data:
     map<string, string> mCdsParentMap;
     set<string> mCdsParents;
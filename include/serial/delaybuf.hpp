@@ -48,6 +48,7 @@ BEGIN_NCBI_SCOPE
 
 class CByteSource;
 class CItemInfo;
+class CObjectMemoryPool;
 
 /////////////////////////////////////////////////////////////////////////////
 ///
@@ -110,6 +111,15 @@ public:
     void SetData(const CItemInfo* itemInfo, TObjectPtr object,
                  ESerialDataFormat dataFormat, TFormatFlags flags,
                  CByteSource& data);
+    /// Reset the buffer with a new data
+    ///
+    /// @param memoryPool
+    ///   Memory pool of the stream the data came from; CObject-derived
+    ///   objects created when the data is parsed will be allocated from it
+    void SetData(const CItemInfo* itemInfo, TObjectPtr object,
+                 ESerialDataFormat dataFormat, TFormatFlags flags,
+                 CByteSource& data,
+                 CObjectMemoryPool* memoryPool);
 
 private:
     struct SInfo
@@ -117,7 +127,7 @@ private:
     public:
         SInfo(const CItemInfo* itemInfo, TObjectPtr object,
               ESerialDataFormat dataFormat, TFormatFlags flags,
-              CByteSource& source);
+              CByteSource& source, CObjectMemoryPool* memoryPool);
         ~SInfo(void);
 
         // member info
@@ -130,6 +140,8 @@ private:
         TFormatFlags m_Flags;
         // data source
         mutable CRef<CByteSource> m_Source;
+        // memory pool of the original stream
+        CRef<CObjectMemoryPool> m_MemoryPool;
     };
 
     // private method declarations to prevent implicit generation by compiler
@@ -0,0 +1,113 @@
+#ifndef CLASSDIRECT__HPP
+#define CLASSDIRECT__HPP
+
+/*  $Id$
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+* File Description:
+*   Member I/O helpers used by the statically dispatched read/write
+*   functions datatool generates with -ocd
+*   (see CClassTypeInfo::SetDirectFunctions()).
+*/
+
+#include <corelib/ncbistd.hpp>
+#include <serial/impl/classinfo.hpp>
+#include <serial/objistr.hpp>
+#include <serial/objostr.hpp>
+
+
+/** @addtogroup TypeInfoCPP
+ *
+ * @{
+ */
+
+
+BEGIN_NCBI_SCOPE
+
+class NCBI_XSERIAL_EXPORT CClassDirectIO
+{
+public:
+    /// Read primitive or string member which has 'set' flag,
+    /// same as the member info would do it
+    template<class T>
+    static bool ReadStd(CObjectIStream& in,
+                        const CMemberInfo* memberInfo,
+                        TObjectPtr classPtr,
+                        T& data)
+        {
+            _ASSERT(memberInfo->HaveSetFlag());
+            memberInfo->UpdateSetFlagYes(classPtr);
+            try {
+                in.ReadStd(data);
+                if ( in.GetVerifyData() == eSerialVerifyData_Yes ) {
+                    memberInfo->Validate(classPtr, in);
+                }
+            }
+            catch ( CSerialException& e ) {
+                x_ReadFailed(in, memberInfo, classPtr, e);
+            }
+            return true;
+        }
+
+    /// Write primitive or string member which has 'set' flag;
+    /// members which are not definitely set are left to the member info
+    template<class T>
+    static bool WriteStd(CObjectOStream& out,
+                         const CMemberInfo* memberInfo,
+                         TConstObjectPtr classPtr,
+                         const T& data)
+        {
+            _ASSERT(memberInfo->HaveSetFlag());
+            if ( memberInfo->GetSetFlag(classPtr) != CMemberInfo::eSetYes ||
+                 out.IsWritingDefaultValuesEnforced() ) {
+                return false;
+            }
+            if ( out.GetVerifyData() == eSerialVerifyData_Yes ) {
+                memberInfo->Validate(classPtr, out);
+            }
+            BEGIN_OBJECT_FRAME_OF2(out, eFrameClassMember, memberInfo->GetId());
+            out.BeginClassMember(memberInfo->GetId());
+            out.WriteStd(data);
+            out.EndClassMember();
+            END_OBJECT_FRAME_OF(out);
+            return true;
+        }
+
+private:
+    // exception handling of CMemberInfoFunctions::ReadWithSetFlagMember();
+    // must be called from within the catch block
+    static void x_ReadFailed(CObjectIStream& in,
+                             const CMemberInfo* memberInfo,
+                             TObjectPtr classPtr,
+                             CSerialException& e);
+};
+
+
+END_NCBI_SCOPE
+
+
+/* @} */
+
+#endif  /* CLASSDIRECT__HPP */
@@ -116,6 +116,20 @@ public:
     void SetGlobalHook(const CTempString& member_names,
                        CReadClassMemberHook* hook);
 
+    /// Statically dispatched member I/O, generated by datatool (-ocd).
+    /// The functions either read/write the member and return true, or
+    /// return false to leave it to the member's own (type info) functions.
+    /// They are used for ASN.1 binary and JSON streams only, and never for
+    /// a member (or member type) with read/write hooks installed.
+    typedef bool (*TDirectReadFunction)(CObjectIStream& in,
+                                        const CMemberInfo* memberInfo,
+                                        TObjectPtr classPtr);
+    typedef bool (*TDirectWriteFunction)(CObjectOStream& out,
+                                         const CMemberInfo* memberInfo,
+                                         TConstObjectPtr classPtr);
+    void SetDirectFunctions(TDirectReadFunction readFunc,
+                            TDirectWriteFunction writeFunc);
+
 public:
 
     // iterators interface
@@ -142,6 +156,9 @@ private:
 
     TGetTypeIdFunction m_GetTypeIdFunction;
 
+    TDirectReadFunction m_DirectReadFunction;
+    TDirectWriteFunction m_DirectWriteFunction;
+
     const CMemberInfo* GetImplicitMember(void) const;
 
 private:
@@ -156,6 +173,9 @@ private:
     static void ReadImplicitMember(CObjectIStream& in,
                                    TTypeInfo objectType,
                                    TObjectPtr objectPtr);
+    static void ReadClassDirect(CObjectIStream& in,
+                                TTypeInfo objectType,
+                                TObjectPtr objectPtr);
     static void WriteClassRandom(CObjectOStream& out,
                                  TTypeInfo objectType,
                                  TConstObjectPtr objectPtr);
@@ -165,6 +185,9 @@ private:
     static void WriteImplicitMember(CObjectOStream& out,
                                     TTypeInfo objectType,
                                     TConstObjectPtr objectPtr);
+    static void WriteClassDirect(CObjectOStream& out,
+                                 TTypeInfo objectType,
+                                 TConstObjectPtr objectPtr);
     static void SkipClassSequential(CObjectIStream& in,
                                     TTypeInfo objectType);
     static void SkipClassRandom(CObjectIStream& in,
@@ -177,6 +177,11 @@ public:
     void SetPathCopyHook(CObjectStreamCopier* copier, const string& path,
                          CCopyClassMemberHook* hook);
 
+    /// Check if any (global, local or path) read hook is installed
+    bool HaveReadHooks(void) const;
+    /// Check if any (global, local or path) write hook is installed
+    bool HaveWriteHooks(void) const;
+
     // default I/O (without hooks)
     void DefaultReadMember(CObjectIStream& in,
                            TObjectPtr classPtr) const;
@@ -142,6 +142,18 @@ void CMemberInfo::CopyMissingMember(CObjectStreamCopier& stream) const
     m_CopyHookData.GetCurrentFunction2nd()(stream, this);
 }
 
+inline
+bool CMemberInfo::HaveReadHooks(void) const
+{
+    return m_ReadHookData.HaveHooks();
+}
+
+inline
+bool CMemberInfo::HaveWriteHooks(void) const
+{
+    return m_WriteHookData.HaveHooks();
+}
+
 inline
 void CMemberInfo::DefaultReadMember(CObjectIStream& stream,
                                     TObjectPtr classPtr) const
@@ -40,6 +40,13 @@ ESerialDataFormat CObjectIStream::GetDataFormat(void) const
 }
 
 
+inline
+bool CObjectIStream::IsMemoryMapped(void) const
+{
+    return m_MemoryFile.get() != 0;
+}
+
+
 inline
 CObjectIStream* CObjectIStream::Open(const string& fileName,
                                      ESerialDataFormat format)
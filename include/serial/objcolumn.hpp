@@ -0,0 +1,333 @@
+#ifndef OBJCOLUMN__HPP
+#define OBJCOLUMN__HPP
+
+/*  $Id$
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+* File Description:
+*   Columnar storage of many objects of the same class: every member is
+*   stored in its own column, and readers decode only the columns they need
+*/
+
+#include <serial/objectinfo.hpp>
+
+
+/** @addtogroup ObjStreamSupport
+ *
+ * @{
+ */
+
+
+BEGIN_NCBI_SCOPE
+
+class CObjectIStream;
+class CObjectOStream;
+class CMemberInfo;
+
+/////////////////////////////////////////////////////////////////////////////
+///
+///  CObjectColumns
+///
+///  Columns of a class (SEQUENCE or SET), made from its type information.
+///
+///  Every member of the class is a column named by the member name.
+///  Members which are classes themselves (also through CRef<>) are split
+///  further into columns of their members, named "member.submember" and
+///  following their parent column.  Primitive members are stored as
+///  numbers or strings; choices, containers and other members are stored
+///  as ASN.1 binary data of the member, and so are members of a class
+///  which is already split on the way to them (recursive types).
+
+class NCBI_XSERIAL_EXPORT CObjectColumns
+{
+public:
+    enum EColumnType {
+        eColumn_Struct,  ///< class member; presence only, data in children
+        eColumn_Null,    ///< NULL member; presence only
+        eColumn_Bool,
+        eColumn_Int,     ///< signed integer or ENUMERATED
+        eColumn_Uint,    ///< unsigned integer
+        eColumn_Double,
+        eColumn_String,  ///< string, dictionary encoded
+        eColumn_Binary   ///< ASN.1 binary data of the member
+    };
+
+    struct SColumn
+    {
+        string             m_Name;
+        EColumnType        m_Type;
+        size_t             m_Parent;  ///< kInvalidColumn for class members
+        size_t             m_End;     ///< index after the last child column
+        const CMemberInfo* m_Member;
+        TTypeInfo          m_ValueType; ///< pointed type for CRef<> classes
+    };
+
+    static const size_t kInvalidColumn = size_t(-1);
+
+    explicit CObjectColumns(TTypeInfo type);
+
+    TTypeInfo GetTypeInfo(void) const;
+
+    size_t GetColumnCount(void) const;
+    const SColumn& GetColumn(size_t index) const;
+
+    /// Find column by its name;
+    /// @return
+    ///   kInvalidColumn if there is no such column
+    size_t FindColumn(const string& name) const;
+
+private:
+    typedef vector<TTypeInfo> TPath;
+
+    void x_AddMembers(const CClassTypeInfo* classType,
+                      const string& prefix, size_t parent, TPath& path);
+
+    TTypeInfo       m_TypeInfo;
+    vector<SColumn> m_Columns;
+};
+
+
+/////////////////////////////////////////////////////////////////////////////
+///
+///  CObjectColumnWriter
+///
+///  Write objects of one class in columnar format.
+///
+///  Objects are collected in memory into groups of GetRowGroupSize() rows;
+///  a full group is written column after column.  Strings are dictionary
+///  encoded within the group when it makes them shorter.
+///
+///  Usage:
+///  @code
+///
+///  CObjectColumnWriter writer(out, CSeq_feat::GetTypeInfo());
+///  for (CTypeConstIterator<CSeq_feat> it(entry); it; ++it) {
+///      writer.Write(ConstObjectInfo(*it));
+///  }
+///  writer.Close();
+///
+///  @endcode
+
+class NCBI_XSERIAL_EXPORT CObjectColumnWriter
+{
+public:
+    /// @param row_group_size
+    ///   Number of objects written at once; zero means default size
+    CObjectColumnWriter(CNcbiOstream& out, TTypeInfo type,
+                        size_t row_group_size = 0);
+    /// Closes the writer if it is not closed yet
+    ~CObjectColumnWriter(void);
+
+    const CObjectColumns& GetColumns(void) const;
+    size_t GetRowGroupSize(void) const;
+
+    /// Add object of the writer type.
+    /// If the object cannot be written (e.g. its mandatory member is not
+    /// set), the exception is passed on and the object is not added.
+    void Write(const CConstObjectInfo& object);
+
+    /// Write objects collected so far as a row group
+    void Flush(void);
+
+    /// Flush and write end of data
+    void Close(void);
+
+private:
+    struct SColumnData;
+
+    void x_WriteRow(size_t begin, size_t end, TConstObjectPtr classPtr);
+    void x_DropRow(void);
+    void x_SetNull(size_t begin, size_t end);
+    void x_SetValue(size_t index, TConstObjectPtr valuePtr);
+    void x_AddString(size_t index, const string& value);
+
+    CNcbiOstream&          m_Output;
+    CObjectColumns         m_Columns;
+    size_t                 m_RowGroupSize;
+    size_t                 m_Rows;
+    bool                   m_Closed;
+    vector<SColumnData>    m_Data;
+    unique_ptr<CNcbiOstrstream> m_ValueStream;
+    unique_ptr<CObjectOStream>  m_ValueOut;
+
+private:
+    CObjectColumnWriter(const CObjectColumnWriter&);
+    CObjectColumnWriter& operator=(const CObjectColumnWriter&);
+};
+
+
+/////////////////////////////////////////////////////////////////////////////
+///
+///  CObjectColumnReader
+///
+///  Read objects written by CObjectColumnWriter, one row group at a time.
+///
+///  Only the selected columns are decoded; others are skipped without
+///  parsing.  Values can be taken from the columns directly, or objects
+///  can be filled with the selected members.
+///
+///  Usage:
+///  @code
+///
+///  CObjectColumnReader reader(in, CSeq_feat::GetTypeInfo());
+///  size_t comment = reader.GetColumns().FindColumn("comment");
+///  reader.SelectColumns({"comment"});
+///  while ( reader.NextRowGroup() ) {
+///      for (size_t row = 0; row < reader.GetRowCount(); ++row) {
+///          if ( reader.IsSet(comment, row) ) {
+///              ... reader.GetString(comment, row) ...
+///          }
+///      }
+///  }
+///
+///  @endcode
+
+class NCBI_XSERIAL_EXPORT CObjectColumnReader
+{
+public:
+    /// Read header of the data; its columns must be the ones of the type
+    CObjectColumnReader(CNcbiIstream& in, TTypeInfo type);
+    ~CObjectColumnReader(void);
+
+    const CObjectColumns& GetColumns(void) const;
+
+    /// Decode only the named columns, starting with the next row group.
+    /// Columns of parent members, and all child columns of class members
+    /// are decoded as well.
+    void SelectColumns(const vector<string>& names);
+    /// Decode all columns (the default)
+    void SelectAllColumns(void);
+    bool IsSelected(size_t column) const;
+
+    /// Read next row group
+    /// @return
+    ///   FALSE at the end of data
+    bool NextRowGroup(void);
+
+    /// Number of rows in the current group
+    size_t GetRowCount(void) const;
+
+    /// Check if the member is present in the row
+    bool IsSet(size_t column, size_t row) const;
+
+    bool          GetBool(size_t column, size_t row) const;
+    Int8          GetInt8(size_t column, size_t row) const;
+    Uint8         GetUint8(size_t column, size_t row) const;
+    double        GetDouble(size_t column, size_t row) const;
+    /// Value of string column, or ASN.1 binary data of binary column
+    const string& GetString(size_t column, size_t row) const;
+
+    /// Reset the object and set its members of the selected columns
+    void ReadObject(const CObjectInfo& object, size_t row);
+
+private:
+    struct SColumnData;
+
+    void x_ReadRow(size_t begin, size_t end, TObjectPtr classPtr,
+                   size_t row);
+    void x_ReadValue(size_t index, TObjectPtr valuePtr, size_t row);
+    const SColumnData& x_GetValue(size_t column, size_t row,
+                                  CObjectColumns::EColumnType type) const;
+
+    CNcbiIstream&       m_Input;
+    CObjectColumns      m_Columns;
+    vector<bool>        m_Selected;
+    size_t              m_Rows;
+    bool                m_End;
+    vector<SColumnData> m_Data;
+    string              m_Chunk;
+    unique_ptr<CObjectIStream> m_ValueIn;
+
+private:
+    CObjectColumnReader(const CObjectColumnReader&);
+    CObjectColumnReader& operator=(const CObjectColumnReader&);
+};
+
+
+/////////////////////////////////////////////////////////////////////////////
+// inline functions
+
+inline
+TTypeInfo CObjectColumns::GetTypeInfo(void) const
+{
+    return m_TypeInfo;
+}
+
+
+inline
+size_t CObjectColumns::GetColumnCount(void) const
+{
+    return m_Columns.size();
+}
+
+
+inline
+const CObjectColumns::SColumn& CObjectColumns::GetColumn(size_t index) const
+{
+    return m_Columns[index];
+}
+
+
+inline
+const CObjectColumns& CObjectColumnWriter::GetColumns(void) const
+{
+    return m_Columns;
+}
+
+
+inline
+size_t CObjectColumnWriter::GetRowGroupSize(void) const
+{
+    return m_RowGroupSize;
+}
+
+
+inline
+const CObjectColumns& CObjectColumnReader::GetColumns(void) const
+{
+    return m_Columns;
+}
+
+
+inline
+bool CObjectColumnReader::IsSelected(size_t column) const
+{
+    return m_Selected[column];
+}
+
+
+inline
+size_t CObjectColumnReader::GetRowCount(void) const
+{
+    return m_Rows;
+}
+
+
+END_NCBI_SCOPE
+
+
+/* @} */
+
+#endif  /* OBJCOLUMN__HPP */
@@ -62,6 +62,7 @@ class CVariantInfo;
 class CDelayBuffer;
 class CByteSource;
 class CByteSourceReader;
+class CMemoryFile;
 
 class CObjectInfo;
 class CObjectInfoMI;
@@ -253,6 +254,19 @@ public:
     /// @param size
     ///   Memory buffer size
     void OpenFromBuffer(const char* buffer, size_t size);
+
+    /// Attach reader to a memory mapped file
+    ///
+    /// The whole file is mapped into memory and the input buffer points
+    /// directly into the mapped pages, so no data is copied on the way in.
+    /// The mapping is released by Close().
+    /// @param fileName
+    ///   Input file name
+    void OpenFromMemoryFile(const string& fileName);
+
+    /// Check if the reader is attached to a memory mapped file
+    /// @sa OpenFromMemoryFile
+    bool IsMemoryMapped(void) const;
     
     /// Detach reader from a data source
     void Close(void);
@@ -802,7 +816,9 @@ public:
 //---------------------------------------------------------------------------
 // Internals
 
-    // memory pool to use to create new objects when reading data
+    // memory pool to use to create new objects when reading data;
+    // it is used for CObject-derived objects only, including the ones
+    // parsed later from delay buffers
     void SetMemoryPool(CObjectMemoryPool* memory_pool)
         {
             m_MemoryPool = memory_pool;
@@ -869,6 +885,15 @@ public:
 
         size_t Read(void* dst, size_t length, bool forceLength = false);
 
+        /// Read up to 'length' bytes without copying them.
+        ///
+        /// Returns the bytes as they are in the input buffer, or an empty
+        /// string when the data format or the buffer state does not allow
+        /// it (nothing is consumed in this case, use Read() instead).
+        /// The result is valid until the next read from the stream, or
+        /// until the stream is closed if it is memory mapped.
+        CTempString ReadInPlace(size_t length);
+
         bool KnownLength(void) const;
         size_t GetExpectedLength(void) const;
 
@@ -1004,6 +1029,7 @@ public:
     // byte block
     virtual void BeginBytes(ByteBlock& block) = 0;
     virtual size_t ReadBytes(ByteBlock& block, char* buffer, size_t count) = 0;
+    virtual CTempString ReadBytesInPlace(ByteBlock& block, size_t count);
     virtual void EndBytes(const ByteBlock& block);
 
     // char block
@@ -1073,6 +1099,7 @@ private:
     ESerialSkipUnknown m_SkipUnknown;
     ESerialSkipUnknown m_SkipUnknownVariants;
     AutoPtr<CReadObjectList> m_Objects;
+    AutoPtr<CMemoryFile> m_MemoryFile;
 
     TFailFlags m_Fail;
     TFlags m_Flags;
@@ -208,6 +208,7 @@ protected:
 
     virtual void BeginBytes(ByteBlock& block) override;
     virtual size_t ReadBytes(ByteBlock& block, char* dst, size_t length) override;
+    virtual CTempString ReadBytesInPlace(ByteBlock& block, size_t length) override;
     virtual void EndBytes(const ByteBlock& block) override;
 
     virtual void BeginChars(CharBlock& block) override;
@@ -330,6 +331,7 @@ public:
 private:
     void ReadBytes(char* buffer, size_t count);
     void ReadBytes(string& str, size_t count);
+    const char* GetBytesInBuffer(size_t count);
     bool FixVisibleChars(char* buffer, size_t& count, EFixNonPrint fix_method);
     bool FixVisibleChars(string& str, EFixNonPrint fix_method);
     void SkipBytes(size_t count);
@@ -116,6 +116,14 @@ public:
     ///   Formatting type
     void SetBinaryDataFormat(EBinaryDataFormat fmt);
 
+    /// Scan string values with SSE2/AVX2 when the CPU supports them
+    /// (on by default).  Runs of plain characters are then copied at once,
+    /// and only quotes, escapes, line ends and characters which need
+    /// conversion are decoded one by one; the result is the same.
+    /// Switching it off is meant for benchmarks.
+    void SetSimdEnabled(bool enable);
+    bool IsSimdEnabled(void) const;
+
     virtual string ReadFileHeader(void) override;
 
 protected:
@@ -222,6 +230,7 @@ private:
     int ReadEscapedChar(bool* encoded=0);
     char ReadEncodedChar(EStringType type, bool& encoded);
     TUnicodeSymbol ReadUtf8Char(char c);
+    void x_ReadPlainChars(EStringType type, string* str);
     string x_ReadString(EStringType type);
     void x_ReadData(string& data, EStringType type = eStringTypeUTF8);
     bool x_ReadDataAndCheck(string& data, EStringType type = eStringTypeUTF8);
@@ -247,6 +256,7 @@ private:
     string m_LastTag;
     string m_RejectedTag;
     EBinaryDataFormat m_BinaryFormat;
+    bool m_SimdEnabled;
     CStringUTF8 m_Utf8Buf;
     CStringUTF8::const_iterator m_Utf8Pos;
 };
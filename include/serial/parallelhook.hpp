@@ -0,0 +1,188 @@
+#ifndef PARALLELHOOK__HPP
+#define PARALLELHOOK__HPP
+
+/*  $Id$
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+* File Description:
+*   Read hooks which parse elements of a large SEQUENCE OF / SET OF
+*   in parallel threads
+*/
+
+#include <serial/objhook.hpp>
+
+
+/** @addtogroup ObjStreamSupport
+ *
+ * @{
+ */
+
+
+BEGIN_NCBI_SCOPE
+
+class CByteSource;
+
+/////////////////////////////////////////////////////////////////////////////
+///
+///  CParallelContainerReader
+///
+///  Read container elements in parallel.
+///
+///  The reader skips the elements in the input stream without parsing
+///  them, collecting raw data of consecutive elements into batches of
+///  about GetBatchSize() bytes.  Each batch is parsed by a separate
+///  CObjectIStream in its own thread, and the parsed elements are appended
+///  to the container in their original order.
+///
+///  Only containers of pointers to CObject-derived classes (CRef<>),
+///  read from ASN.1 binary input, are read in parallel; other containers
+///  and formats, and streams which track object references, are read in
+///  the usual way.  A container met again inside of an element being
+///  parsed in parallel is read sequentially.
+///
+///  @attention
+///   Element streams do not share local and path hooks of the source
+///   stream; override InitElementStream() to set hooks on them.
+///   Global hooks are called in parsing threads, and must be thread-safe.
+///
+///  Usage:
+///  @code
+///
+///  in->SetPathReadMemberHook("Bioseq-set.seq-set",
+///                            new CParallelReadClassMemberHook);
+///  in->SetPathReadVariantHook("Seq-annot.data.ftable",
+///                             new CParallelReadChoiceVariantHook);
+///
+///  @endcode
+
+class NCBI_XSERIAL_EXPORT CParallelContainerReader
+{
+public:
+    /// @param max_threads
+    ///   Maximum number of parsing threads;
+    ///   zero means the number of CPUs
+    /// @param batch_size
+    ///   Approximate size in bytes of raw data parsed by one thread at once;
+    ///   zero means default size
+    CParallelContainerReader(unsigned max_threads = 0, size_t batch_size = 0);
+    virtual ~CParallelContainerReader(void);
+
+    unsigned GetMaxThreads(void) const;
+    size_t GetBatchSize(void) const;
+
+    /// Check if elements of the container type can be read from
+    /// this stream in parallel
+    bool CanReadInParallel(CObjectIStream& in,
+                           const CObjectTypeInfo& type) const;
+
+    /// Read container from the stream, replacing its current contents
+    /// @sa CanReadInParallel()
+    void ReadContainer(CObjectIStream& in, const CObjectInfo& container);
+
+protected:
+    /// Set up stream which will parse a batch of elements.
+    /// The stream already has flags, verification and skip settings of
+    /// the source stream, and its own memory pool if the source stream
+    /// has one.
+    /// @note
+    ///   The method is called in parsing threads.
+    virtual void InitElementStream(CObjectIStream& in);
+
+private:
+    struct SSettings;
+    typedef vector< CRef<CObject> > TBatch;
+
+    TBatch x_ParseBatch(CRef<CByteSource> data,
+                        TTypeInfo objectType,
+                        const SSettings& settings);
+
+    unsigned m_MaxThreads;
+    size_t   m_BatchSize;
+
+private:
+    CParallelContainerReader(const CParallelContainerReader&);
+    CParallelContainerReader& operator=(const CParallelContainerReader&);
+};
+
+
+/// Read hook for a container class member (SEQUENCE OF / SET OF)
+/// which parses the elements in parallel.
+/// Members of other types are read by default.
+/// @sa CParallelContainerReader
+class NCBI_XSERIAL_EXPORT CParallelReadClassMemberHook
+    : public CReadClassMemberHook,
+      public CParallelContainerReader
+{
+public:
+    CParallelReadClassMemberHook(unsigned max_threads = 0,
+                                 size_t batch_size = 0);
+    virtual ~CParallelReadClassMemberHook(void);
+
+    virtual void ReadClassMember(CObjectIStream& in,
+                                 const CObjectInfoMI& member) override;
+};
+
+
+/// Read hook for a container choice variant (SEQUENCE OF / SET OF)
+/// which parses the elements in parallel.
+/// Variants of other types are read by default.
+/// @sa CParallelContainerReader
+class NCBI_XSERIAL_EXPORT CParallelReadChoiceVariantHook
+    : public CReadChoiceVariantHook,
+      public CParallelContainerReader
+{
+public:
+    CParallelReadChoiceVariantHook(unsigned max_threads = 0,
+                                   size_t batch_size = 0);
+    virtual ~CParallelReadChoiceVariantHook(void);
+
+    virtual void ReadChoiceVariant(CObjectIStream& in,
+                                   const CObjectInfoCV& variant) override;
+};
+
+
+/////////////////////////////////////////////////////////////////////////////
+// inline functions
+
+inline
+unsigned CParallelContainerReader::GetMaxThreads(void) const
+{
+    return m_MaxThreads;
+}
+
+
+inline
+size_t CParallelContainerReader::GetBatchSize(void) const
+{
+    return m_BatchSize;
+}
+
+
+END_NCBI_SCOPE
+
+
+/* @} */
+
+#endif  /* PARALLELHOOK__HPP */
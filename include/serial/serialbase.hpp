@@ -69,6 +69,7 @@ class CChoiceTypeInfo;
 class CEnumeratedTypeValues;
 class CObjectInfoCV;
 class CObjectInfoMI;
+class CMemberInfo;
 class CReadClassMemberHook;
 class CReadChoiceVariantHook;
 
@@ -130,7 +130,9 @@ enum ESerialOpenFlags {
     eSerial_StdWhenStd   = 1 << 2, ///< use std when filename is "stdin"/"stdout"
     eSerial_StdWhenMask  = 15,
     eSerial_StdWhenAny   = eSerial_StdWhenMask,
-    eSerial_UseFileForReread = 1 << 4
+    eSerial_UseFileForReread = 1 << 4,
+    eSerial_MemoryMap    = 1 << 5  ///< map the whole file into memory and
+                                   ///< read directly from the mapped pages
 };
 typedef int TSerialOpenFlags;
 
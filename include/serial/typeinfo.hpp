@@ -233,6 +233,11 @@ public:
     void SetPathCopyHook(CObjectStreamCopier* copier, const string& path,
                          CCopyObjectHook* hook);
 
+    /// Check if any (global, local or path) read hook is installed
+    bool HaveReadHooks(void) const;
+    /// Check if any (global, local or path) write hook is installed
+    bool HaveWriteHooks(void) const;
+
     // default methods without checking hook
     void DefaultReadData(CObjectIStream& in, TObjectPtr object) const;
     void DefaultWriteData(CObjectOStream& out, TConstObjectPtr object) const;
@@ -104,6 +104,8 @@ public:
         }
 
 private:
+    friend class CBamIndex; // for index cache
+
     string m_Text;
     map<string, size_t> m_RefByName;
     TRefs m_Refs;
@@ -460,11 +462,23 @@ public:
     void Read(const char* buffer_ptr, size_t buffer_size);
     void Read(CNcbiIstream& in);
 
+    // Index cache is a compact pre-processed copy of the index and
+    // BAM header, memory-mapped on read and shared by all processes.
+    // References' index data is loaded from the cache on first access.
+    // Return false if the cache file doesn't exist or is out of date
+    // with the BAM or index files.
+    bool ReadCache(const string& cache_file_name,
+                   const string& bam_file_name,
+                   const string& index_file_name,
+                   CBamHeader& header);
+    // Write current index and the header into cache file.
+    void WriteCache(const string& cache_file_name,
+                    const string& bam_file_name,
+                    const CBamHeader& header) const;
+
     typedef vector<SBamIndexRefIndex> TRefs;
-    const TRefs& GetRefs() const
-        {
-            return m_Refs;
-        }
+    // with index cache it will load all references
+    const TRefs& GetRefs() const;
     size_t GetRefCount() const
         {
             return m_Refs.size();
@@ -754,11 +768,15 @@ public:
        }
 
 private:
+    class CCacheFile;
+
     string m_FileName;
-    TRefs m_Refs;
+    mutable TRefs m_Refs;
     Uint8 m_UnmappedCount;
     Uint8 m_TotalReadBytes;
     double m_TotalReadSeconds;
+    // references are loaded from mapped index cache file on demand
+    CRef<CCacheFile> m_CacheFile;
 };
 
 
@@ -1006,6 +1024,11 @@ public:
     void Open(const string& bam_path);
     void Open(const string& bam_path, const string& index_path);
 
+    // directory of index cache files, empty if the cache is disabled;
+    // the default is taken from [BAM] INDEX_CACHE_DIR
+    static string GetIndexCacheDir();
+    static void SetIndexCacheDir(const string& dir);
+
 
     const CBamHeader& GetHeader() const
         {
@@ -335,6 +335,17 @@ public:
 
     pair<Uint8, double> GetUncompressStatistics() const;
 
+    // Number of background threads that decompress blocks ahead of
+    // CBGZFStream reading position, 0 means no read-ahead.
+    // The default is taken from [BGZF] DECOMPRESS_THREADS parameter.
+    unsigned GetDecompressThreads() const
+        {
+            return m_DecompressThreads;
+        }
+    void SetDecompressThreads(unsigned threads);
+    // number of blocks that CBGZFStream schedules ahead
+    size_t GetReadAheadBlocks() const;
+
 protected:
     friend class CBGZFStream;
 
@@ -352,14 +363,31 @@ protected:
                      TFileBlockPos file_pos,
                      CPagedFile::TPage& page,
                      CSimpleBufferT<char>& buffer);
+    // parse block header and return the compressed block size
+    CBGZFBlock::TFileBlockSize x_ReadBlockHeader(TFileBlockPos file_pos,
+                                                 CPagedFile::TPage& page,
+                                                 CSimpleBufferT<char>& buffer,
+                                                 size_t& header_size);
+
+    // schedule background decompression of the block;
+    // return false if the decompression queue is full
+    bool x_ScheduleBlock(TFileBlockPos file_pos);
+    // forget scheduled blocks whose decompression has not started yet
+    void x_CancelBlocks(const deque<TFileBlockPos>& file_poses);
     
 private:
+    class CDecompressPool;
+
     CRef<CPagedFile> m_File;
     CRef<TBlockCache> m_BlockCache;
 
     mutable CFastMutex m_StatMutex;
     Uint8 m_TotalUncompressBytes;
     double m_TotalUncompressSeconds;
+
+    unsigned m_DecompressThreads;
+    // must be destroyed first as its threads use the file
+    unique_ptr<CDecompressPool> m_DecompressPool;
 };
 
 
@@ -439,6 +467,10 @@ public:
     
 private:
     bool x_NextBlock();
+    // schedule decompression of blocks after current one
+    void x_ReadAhead();
+    // cancel decompression of scheduled blocks that are not read yet
+    void x_CancelReadAhead();
     
     const char* x_Read(CBGZFPos::TFileBlockPos file_pos, size_t size, char* buffer);
     
@@ -452,6 +484,11 @@ private:
     CSimpleBufferT<char> m_InReadBuffer;
     CSimpleBufferT<char> m_OutReadBuffer;
     CBGZFPos m_EndPos;
+    // blocks scheduled for background decompression
+    CPagedFile::TPage m_ReadAheadPage;
+    CSimpleBufferT<char> m_ReadAheadBuffer;
+    deque<CBGZFPos::TFileBlockPos> m_ReadAheadBlocks;
+    CBGZFPos::TFileBlockPos m_ReadAheadPos;
 };
 
 
@@ -342,6 +342,32 @@ public:
         ENcbiOwnership          own = eNoOwnership
     );
 
+    /// Train a dictionary on samples of typical data.
+    ///
+    /// A trained dictionary gives the best gain for many small inputs with
+    /// a similar structure, each too short to build good statistics alone.
+    /// 
+    /// @param samples
+    ///   Samples, stored one after another.
+    /// @param sample_sizes
+    ///   Size of each sample in 'samples'.
+    /// @param dict_capacity
+    ///   Maximum size of the dictionary, ~100KB is usually a good choice.
+    /// @param dict
+    ///   Trained dictionary data, suitable for CCompressionDictionary.
+    /// @return
+    ///   Return TRUE on success, FALSE on error. Training can fail if there
+    ///   are too few samples, or they are too small.
+    /// @sa
+    ///   SetDictionary
+    /// 
+    static bool TrainDictionary(
+        const void*           samples,
+        const vector<size_t>& sample_sizes,
+        size_t                dict_capacity,
+        vector<char>&         dict
+    );
+
     //=======================================================================
     // Advanced compression-specific parameters
     //=======================================================================
@@ -0,0 +1,649 @@
+#ifndef UTIL___MPMC_QUEUE__HPP
+#define UTIL___MPMC_QUEUE__HPP
+
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ */
+
+/// @file mpmc_queue.hpp
+///
+/// Definition of CMPMCQueue template -- lock-free bounded queue for many
+/// producers and many consumers.
+/// See also: @ref CSyncQueueDescription.
+
+#include <corelib/ncbistd.hpp>
+#include <corelib/ncbimtx.hpp>
+#include <corelib/ncbitime.hpp>
+#include <util/sync_queue.hpp>
+
+#include <atomic>
+#include <iterator>
+#include <new>
+
+
+BEGIN_NCBI_SCOPE
+
+
+/// Lock-free bounded queue for many producers and many consumers.
+///
+/// Companion of CSyncQueue for producer/consumer pipelines where the mutex
+/// of CSyncQueue becomes the bottleneck. Elements are kept in a ring buffer
+/// of fixed capacity; every slot has a sequence number telling whether it is
+/// ready to be written or read on the current lap, so producers and
+/// consumers only compete for the two position counters (one CAS per
+/// operation, or per batch with PushN() and PopN()).
+///
+/// Push() and Pop() have the same blocking semantics as in CSyncQueue: they
+/// wait while the queue is full (empty) and throw CSyncQueueException with
+/// eNoRoom (eEmpty) if the timeout expires. The waiting is done on
+/// semaphores, so a thread blocked on a full or empty queue does not burn
+/// the CPU. Unlike CSyncQueue NULL timeout always means infinite wait.
+///
+/// There are no access guardians, iterators or priority containers here --
+/// use CSyncQueue if any of that is needed.
+///
+/// @param Type
+///   Type of elements saved in the queue. Its copy and move constructors
+///   must not throw: a slot claimed by a producer cannot be given back.
+
+template <class Type>
+class CMPMCQueue
+{
+public:
+    /// Short name of this queue type
+    typedef CMPMCQueue<Type>   TThisType;
+    /// Type of values stored in the queue
+    typedef Type               TValue;
+    /// Type of size of the queue
+    typedef size_t             TSize;
+
+    /// Construct queue
+    ///
+    /// @param max_size
+    ///   Maximum size of the queue. Must be greater than zero. The actual
+    ///   capacity is rounded up to a power of 2, see GetMaxSize().
+    CMPMCQueue(TSize max_size);
+
+    /// Destroy the queue together with all elements left in it
+    ~CMPMCQueue(void);
+
+    /// Add new element to the end of queue.
+    /// @note  This call will block if the queue is full
+    ///
+    /// @param elem
+    ///   Element to push
+    /// @param timeout
+    ///   Maximum time period to wait on this call; NULL to wait infinitely.
+    ///   If the timeout is exceeded, then throw CSyncQueueException.
+    void Push(const TValue& elem, const CTimeSpan* timeout = NULL);
+    void Push(TValue&& elem, const CTimeSpan* timeout = NULL);
+
+    /// Retrieve an element from the queue.
+    /// @note  This call will block if the queue is empty
+    ///
+    /// @param timeout
+    ///   Maximum time period to wait on this call; NULL to wait infinitely.
+    ///   If the timeout is exceeded, then throw CSyncQueueException.
+    TValue Pop(const CTimeSpan* timeout = NULL);
+
+    /// Add new element to the end of queue if there is room for it.
+    /// @note  This call always returns immediately, without any blocking
+    ///
+    /// @return
+    ///   TRUE if the element was added, FALSE if the queue is full
+    bool TryPush(const TValue& elem);
+    bool TryPush(TValue&& elem);
+
+    /// Retrieve an element from the queue if there is any.
+    /// @note  This call always returns immediately, without any blocking
+    ///
+    /// @return
+    ///   TRUE if the element was retrieved into elem, FALSE if the queue
+    ///   is empty
+    bool TryPop(TValue& elem);
+
+    /// Add all elements of the range [first, last) to the end of queue.
+    /// Elements are copied into the queue in as few batches as the free room
+    /// allows; elements from other producers can come in between batches.
+    /// @note  This call will block if the queue is full
+    ///
+    /// @param first, last
+    ///   Range of elements to push (forward iterators); pass
+    ///   make_move_iterator() iterators to move the elements instead
+    /// @param timeout
+    ///   Maximum time period to wait on this call; NULL to wait infinitely.
+    /// @return
+    ///   Number of elements pushed. It is less than the size of the range
+    ///   only if the timeout is exceeded (no exception is thrown then).
+    template <class TForwardIter>
+    TSize PushN(TForwardIter first, TForwardIter last,
+                const CTimeSpan* timeout = NULL);
+
+    /// Retrieve up to max_count elements from the queue.
+    /// Waits for at least one element, then takes as many of the elements
+    /// already in the queue as it can at once.
+    /// @note  This call will block if the queue is empty
+    ///
+    /// @param out
+    ///   Output iterator to store elements to
+    /// @param max_count
+    ///   Maximum number of elements to retrieve
+    /// @param timeout
+    ///   Maximum time period to wait on this call; NULL to wait infinitely.
+    /// @return
+    ///   Number of elements retrieved; 0 only if the timeout is exceeded
+    ///   (no exception is thrown then) or if max_count is 0.
+    template <class TOutputIter>
+    TSize PopN(TOutputIter out, TSize max_count,
+               const CTimeSpan* timeout = NULL);
+
+    /// Check if the queue is empty.
+    /// @note  This call always returns immediately, without any blocking.
+    ///        With concurrent operations the result can be outdated.
+    bool IsEmpty(void) const;
+
+    /// Check if the queue is full (has GetMaxSize() elements)
+    /// @note  This call always returns immediately, without any blocking
+    ///        With concurrent operations the result can be outdated.
+    bool IsFull(void) const;
+
+    /// Get count of elements already stored in the queue
+    /// @note  This call always returns immediately, without any blocking
+    ///        With concurrent operations the result can be outdated.
+    TSize GetSize(void) const;
+
+    /// Get the maximum # of elements allowed to be kept in the queue
+    /// @note  This call always returns immediately, without any blocking
+    TSize GetMaxSize(void) const;
+
+private:
+    /// Prohibit copying and assigning
+    CMPMCQueue(const TThisType&);
+    TThisType& operator= (const TThisType&);
+
+    /// Slot of the ring buffer.
+    /// For the position pos the slot is free when m_Seq == pos and holds
+    /// an element when m_Seq == pos + 1.
+    struct SCell {
+        atomic<TSize>  m_Seq;
+        alignas(Type) unsigned char m_Storage[sizeof(Type)];
+
+        Type* GetValue(void)
+        { return reinterpret_cast<Type*>(m_Storage); }
+    };
+
+    /// Type of a waiting predicate: try to do the operation
+    typedef bool (TThisType::*TTryFunc)(void* arg);
+
+    template <class TValueRef>
+    bool x_TryPush(TValueRef&& elem);
+
+    /// Claim up to max_count consecutive free slots
+    /// @return
+    ///   Number of slots claimed, the first one is at *pos
+    TSize x_ClaimForPush(TSize max_count, TSize* pos);
+    /// Claim up to max_count consecutive slots with elements
+    TSize x_ClaimForPop (TSize max_count, TSize* pos);
+
+    /// Wake up threads waiting for elements (room)
+    void x_Notify(atomic<int>& waiters, CSemaphore& trigger, TSize count);
+
+    /// Wait until try_func succeeds
+    /// @return
+    ///   FALSE if the timeout is exceeded
+    bool x_Wait(TTryFunc          try_func,
+                void*             arg,
+                atomic<int>&      waiters,
+                CSemaphore&       trigger,
+                const CTimeSpan*  timeout);
+
+    // Adaptors of operations for x_Wait()
+    bool x_TryPushCopy(void* arg)
+    { return x_TryPush(*static_cast<const TValue*>(arg)); }
+    bool x_TryPushMove(void* arg)
+    { return x_TryPush(std::move(*static_cast<TValue*>(arg))); }
+    bool x_TryPop(void* arg)
+    { return TryPop(*static_cast<TValue*>(arg)); }
+
+    /// Adaptor of a batch operation for x_Wait()
+    template <class TIter>
+    struct SBatch {
+        SBatch(TIter it, TSize n) : iter(it), count(n), done(0) {}
+        TIter  iter;
+        TSize  count;
+        TSize  done;
+    };
+    template <class TForwardIter>
+    bool x_TryPushBatch(void* arg);
+    template <class TOutputIter>
+    bool x_TryPopBatch(void* arg);
+
+    /// Size of the cache line to keep the counters apart
+    static const size_t kCacheLine = 64;
+
+    alignas(kCacheLine)
+    atomic<TSize>  m_PushPos;        ///< Next position to push to
+    alignas(kCacheLine)
+    atomic<TSize>  m_PopPos;         ///< Next position to pop from
+    alignas(kCacheLine)
+    SCell*         m_Cells;          ///< Ring buffer
+    TSize          m_Mask;           ///< Capacity - 1
+    atomic<int>    m_WaitNotEmpty;   ///< Number of threads waiting to pop
+    atomic<int>    m_WaitNotFull;    ///< Number of threads waiting to push
+    CSemaphore     m_TrigNotEmpty;   ///< Signal "the queue is not empty"
+    CSemaphore     m_TrigNotFull;    ///< Signal "the queue is not full"
+};
+
+
+
+// --------------------------------------
+// All template methods implementation
+// --------------------------------------
+
+
+template <class Type>
+inline
+CMPMCQueue<Type>::CMPMCQueue(TSize max_size)
+    : m_PushPos(0),
+      m_PopPos(0),
+      m_Cells(NULL),
+      m_Mask(0),
+      m_WaitNotEmpty(0),
+      m_WaitNotFull(0),
+      m_TrigNotEmpty(0, kMax_Int),
+      m_TrigNotFull(0, kMax_Int)
+{
+    if (max_size == 0) {
+        NCBI_THROW(CSyncQueueException, eWrongMaxSize,
+                   "Zero size for CMPMCQueue is not allowed");
+    }
+    TSize capacity = 1;
+    while (capacity < max_size) {
+        capacity <<= 1;
+    }
+    m_Mask = capacity - 1;
+    m_Cells = new SCell[capacity];
+    for (TSize i = 0;  i < capacity;  ++i) {
+        m_Cells[i].m_Seq.store(i, memory_order_relaxed);
+    }
+}
+
+
+template <class Type>
+inline
+CMPMCQueue<Type>::~CMPMCQueue(void)
+{
+    TSize pos = m_PopPos.load(memory_order_relaxed);
+    TSize end = m_PushPos.load(memory_order_relaxed);
+    for ( ;  pos != end;  ++pos) {
+        m_Cells[pos & m_Mask].GetValue()->~Type();
+    }
+    delete[] m_Cells;
+}
+
+
+template <class Type>
+inline
+typename CMPMCQueue<Type>::TSize
+CMPMCQueue<Type>::x_ClaimForPush(TSize max_count, TSize* ppos)
+{
+    TSize pos = m_PushPos.load(memory_order_relaxed);
+    for (;;) {
+        TSize seq = m_Cells[pos & m_Mask].m_Seq.load(memory_order_acquire);
+        ptrdiff_t diff = ptrdiff_t(seq - pos);
+        if (diff < 0) {
+            // The slot still holds an element from the previous lap
+            return 0;
+        }
+        if (diff > 0) {
+            // Another producer was faster
+            pos = m_PushPos.load(memory_order_relaxed);
+            continue;
+        }
+        TSize count = 1;
+        while (count < max_count
+               &&  m_Cells[(pos + count) & m_Mask].m_Seq
+                                .load(memory_order_acquire) == pos + count) {
+            ++count;
+        }
+        if (m_PushPos.compare_exchange_weak(pos, pos + count,
+                                            memory_order_relaxed)) {
+            *ppos = pos;
+            return count;
+        }
+    }
+}
+
+
+template <class Type>
+inline
+typename CMPMCQueue<Type>::TSize
+CMPMCQueue<Type>::x_ClaimForPop(TSize max_count, TSize* ppos)
+{
+    TSize pos = m_PopPos.load(memory_order_relaxed);
+    for (;;) {
+        TSize seq = m_Cells[pos & m_Mask].m_Seq.load(memory_order_acquire);
+        ptrdiff_t diff = ptrdiff_t(seq - (pos + 1));
+        if (diff < 0) {
+            // Nothing is pushed to the slot yet
+            return 0;
+        }
+        if (diff > 0) {
+            // Another consumer was faster
+            pos = m_PopPos.load(memory_order_relaxed);
+            continue;
+        }
+        TSize count = 1;
+        while (count < max_count
+               &&  m_Cells[(pos + count) & m_Mask].m_Seq
+                            .load(memory_order_acquire) == pos + count + 1) {
+            ++count;
+        }
+        if (m_PopPos.compare_exchange_weak(pos, pos + count,
+                                           memory_order_relaxed)) {
+            *ppos = pos;
+            return count;
+        }
+    }
+}
+
+
+template <class Type>
+inline
+void CMPMCQueue<Type>::x_Notify(atomic<int>&  waiters,
+                                CSemaphore&   trigger,
+                                TSize         count)
+{
+    // Pairs with the fence in x_Wait(): either the waiting thread sees
+    // the change in the queue or we see the waiting thread.
+    atomic_thread_fence(memory_order_seq_cst);
+    int n_waiters = waiters.load(memory_order_relaxed);
+    if (n_waiters > 0) {
+        trigger.Post((unsigned int) min(TSize(n_waiters), count));
+    }
+}
+
+
+template <class Type>
+template <class TValueRef>
+inline
+bool CMPMCQueue<Type>::x_TryPush(TValueRef&& elem)
+{
+    TSize pos;
+    if (x_ClaimForPush(1, &pos) == 0) {
+        return false;
+    }
+    SCell& cell = m_Cells[pos & m_Mask];
+    new (cell.GetValue()) Type(std::forward<TValueRef>(elem));
+    cell.m_Seq.store(pos + 1, memory_order_release);
+    x_Notify(m_WaitNotEmpty, m_TrigNotEmpty, 1);
+    return true;
+}
+
+
+template <class Type>
+inline
+bool CMPMCQueue<Type>::TryPush(const TValue& elem)
+{
+    return x_TryPush(elem);
+}
+
+
+template <class Type>
+inline
+bool CMPMCQueue<Type>::TryPush(TValue&& elem)
+{
+    return x_TryPush(std::move(elem));
+}
+
+
+template <class Type>
+inline
+bool CMPMCQueue<Type>::TryPop(TValue& elem)
+{
+    TSize pos;
+    if (x_ClaimForPop(1, &pos) == 0) {
+        return false;
+    }
+    SCell& cell = m_Cells[pos & m_Mask];
+    elem = std::move(*cell.GetValue());
+    cell.GetValue()->~Type();
+    cell.m_Seq.store(pos + m_Mask + 1, memory_order_release);
+    x_Notify(m_WaitNotFull, m_TrigNotFull, 1);
+    return true;
+}
+
+
+template <class Type>
+template <class TForwardIter>
+inline
+bool CMPMCQueue<Type>::x_TryPushBatch(void* arg)
+{
+    SBatch<TForwardIter>* batch = static_cast<SBatch<TForwardIter>*>(arg);
+    TSize pos;
+    TSize count = x_ClaimForPush(batch->count - batch->done, &pos);
+    for (TSize i = 0;  i < count;  ++i, ++batch->iter) {
+        SCell& cell = m_Cells[(pos + i) & m_Mask];
+        new (cell.GetValue()) Type(*batch->iter);
+        cell.m_Seq.store(pos + i + 1, memory_order_release);
+    }
+    if (count != 0) {
+        batch->done += count;
+        x_Notify(m_WaitNotEmpty, m_TrigNotEmpty, count);
+    }
+    return batch->done == batch->count;
+}
+
+
+template <class Type>
+template <class TOutputIter>
+inline
+bool CMPMCQueue<Type>::x_TryPopBatch(void* arg)
+{
+    SBatch<TOutputIter>* batch = static_cast<SBatch<TOutputIter>*>(arg);
+    TSize pos;
+    TSize count = x_ClaimForPop(batch->count, &pos);
+    for (TSize i = 0;  i < count;  ++i) {
+        SCell& cell = m_Cells[(pos + i) & m_Mask];
+        *batch->iter = std::move(*cell.GetValue());
+        ++batch->iter;
+        cell.GetValue()->~Type();
+        cell.m_Seq.store(pos + i + m_Mask + 1, memory_order_release);
+    }
+    if (count != 0) {
+        batch->done = count;
+        x_Notify(m_WaitNotFull, m_TrigNotFull, count);
+    }
+    return count != 0;
+}
+
+
+template <class Type>
+inline
+bool CMPMCQueue<Type>::x_Wait(TTryFunc          try_func,
+                              void*             arg,
+                              atomic<int>&      waiters,
+                              CSemaphore&       trigger,
+                              const CTimeSpan*  timeout)
+{
+    // Short spinning helps when the other side is about to catch up
+    for (int i = 0;  i < 64;  ++i) {
+        if ( (this->*try_func)(arg) ) {
+            return true;
+        }
+    }
+
+    CStopWatch timer(CStopWatch::eStart);
+    for (;;) {
+        // The counter is checked by the other side after it changes the
+        // queue, so it must be increased before the last check here
+        waiters.fetch_add(1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        if ( (this->*try_func)(arg) ) {
+            waiters.fetch_sub(1, memory_order_relaxed);
+            return true;
+        }
+
+        bool is_success = true;
+        if (timeout) {
+            CTimeSpan tmo(timeout->GetAsDouble() - timer.Elapsed());
+            is_success = tmo.GetSign() == ePositive
+                         &&  trigger.TryWait(CTimeout(tmo));
+        }
+        else {
+            trigger.Wait();
+        }
+        waiters.fetch_sub(1, memory_order_relaxed);
+
+        if ( !is_success ) {
+            // Last chance - the timeout could expire while the queue
+            // was being changed
+            return (this->*try_func)(arg);
+        }
+    }
+}
+
+
+template <class Type>
+inline
+void CMPMCQueue<Type>::Push(const TValue& elem, const CTimeSpan* timeout)
+{
+    if ( !x_TryPush(elem)
+         &&  !x_Wait(&TThisType::x_TryPushCopy,
+                     const_cast<TValue*>(&elem),
+                     m_WaitNotFull, m_TrigNotFull, timeout) ) {
+        ThrowSyncQueueNoRoom();
+    }
+}
+
+
+template <class Type>
+inline
+void CMPMCQueue<Type>::Push(TValue&& elem, const CTimeSpan* timeout)
+{
+    // x_TryPush() moves from elem only when it succeeds
+    if ( !x_TryPush(std::move(elem))
+         &&  !x_Wait(&TThisType::x_TryPushMove, &elem,
+                     m_WaitNotFull, m_TrigNotFull, timeout) ) {
+        ThrowSyncQueueNoRoom();
+    }
+}
+
+
+template <class Type>
+inline
+typename CMPMCQueue<Type>::TValue
+CMPMCQueue<Type>::Pop(const CTimeSpan* timeout)
+{
+    TValue elem;
+    if ( !TryPop(elem)
+         &&  !x_Wait(&TThisType::x_TryPop, &elem,
+                     m_WaitNotEmpty, m_TrigNotEmpty, timeout) ) {
+        ThrowSyncQueueEmpty();
+    }
+    return elem;
+}
+
+
+template <class Type>
+template <class TForwardIter>
+inline
+typename CMPMCQueue<Type>::TSize
+CMPMCQueue<Type>::PushN(TForwardIter      first,
+                        TForwardIter      last,
+                        const CTimeSpan*  timeout)
+{
+    SBatch<TForwardIter> batch(first, TSize(distance(first, last)));
+    if (batch.count != 0
+        &&  !x_TryPushBatch<TForwardIter>(&batch)) {
+        x_Wait(&TThisType::template x_TryPushBatch<TForwardIter>, &batch,
+               m_WaitNotFull, m_TrigNotFull, timeout);
+    }
+    return batch.done;
+}
+
+
+template <class Type>
+template <class TOutputIter>
+inline
+typename CMPMCQueue<Type>::TSize
+CMPMCQueue<Type>::PopN(TOutputIter       out,
+                       TSize             max_count,
+                       const CTimeSpan*  timeout)
+{
+    SBatch<TOutputIter> batch(out, max_count);
+    if (max_count != 0
+        &&  !x_TryPopBatch<TOutputIter>(&batch)) {
+        x_Wait(&TThisType::template x_TryPopBatch<TOutputIter>, &batch,
+               m_WaitNotEmpty, m_TrigNotEmpty, timeout);
+    }
+    return batch.done;
+}
+
+
+template <class Type>
+inline
+typename CMPMCQueue<Type>::TSize
+CMPMCQueue<Type>::GetSize(void) const
+{
+    TSize pop_pos  = m_PopPos.load(memory_order_acquire);
+    TSize push_pos = m_PushPos.load(memory_order_acquire);
+    ptrdiff_t size = ptrdiff_t(push_pos - pop_pos);
+    if (size < 0) {
+        return 0;
+    }
+    return min(TSize(size), GetMaxSize());
+}
+
+
+template <class Type>
+inline
+typename CMPMCQueue<Type>::TSize
+CMPMCQueue<Type>::GetMaxSize(void) const
+{
+    return m_Mask + 1;
+}
+
+
+template <class Type>
+inline
+bool CMPMCQueue<Type>::IsEmpty(void) const
+{
+    return GetSize() == 0;
+}
+
+
+template <class Type>
+inline
+bool CMPMCQueue<Type>::IsFull(void) const
+{
+    return GetSize() == GetMaxSize();
+}
+
+
+END_NCBI_SCOPE
+
+#endif  /* UTIL___MPMC_QUEUE__HPP */
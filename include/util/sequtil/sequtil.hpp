@@ -69,6 +69,13 @@ public:
     typedef ECodingType  TCodingType;
 
     static ECodingType GetCodingType(TCoding coding);
+
+    /// Nucleotide conversions use vectorized kernels (SSSE3/AVX2 on x86,
+    /// NEON on 64-bit ARM) when the CPU supports them; the results are the
+    /// same as with the byte-wise tables.  Switching them off is meant for
+    /// benchmarks and for checking the kernels against the tables.
+    static bool IsSimdEnabled(void);
+    static void SetSimdEnabled(bool enable);
 };
 
 
@@ -101,6 +101,11 @@ public:
     // skip chars which may not be in buffer
     void GetChars(size_t count)
         THROWS1((CIOException));
+    // return pointer to chars if all of them are already in buffer
+    // and skip them, otherwise return null and skip nothing;
+    // the pointer is valid until the buffer is refilled, or until
+    // the buffer is closed if it is external
+    const char* GetCharsInBuffer(size_t count);
 
     // precondition: last char extracted was either '\r' or '\n'
     // action: increment line count and
@@ -123,6 +128,8 @@ public:
         THROWS1((CIOException));
 
     const char* GetCurrentPos(void) const THROWS1_NONE;
+    // return number of chars already in buffer after current position
+    size_t GetAvailableChars(void) const THROWS1_NONE;
     // returns true if succeeded
     bool TrySetCurrentPos(const char* pos);
 
@@ -148,6 +148,17 @@ void CIStreamBuffer::GetChars(size_t count)
     }
 }
 
+inline
+const char* CIStreamBuffer::GetCharsInBuffer(size_t count)
+{
+    const char* pos = m_CurrentPos;
+    if ( size_t(m_DataEndPos - pos) < count ) {
+        return 0;
+    }
+    m_CurrentPos = pos + count;
+    return pos;
+}
+
 inline
 const char* CIStreamBuffer::GetCurrentPos(void) const
     THROWS1_NONE
@@ -155,6 +166,13 @@ const char* CIStreamBuffer::GetCurrentPos(void) const
     return m_CurrentPos;
 }
 
+inline
+size_t CIStreamBuffer::GetAvailableChars(void) const
+    THROWS1_NONE
+{
+    return m_DataEndPos - m_CurrentPos;
+}
+
 inline
 size_t CIStreamBuffer::GetLine(void) const
     THROWS1_NONE
@@ -207,6 +207,22 @@ private:
 class NCBI_XUTIL_EXPORT CThreadPool
 {
 public:
+    /// How the pool distributes tasks among its threads
+    ///
+    /// @sa CThreadPool()
+    enum EScheduling {
+        /// All tasks wait in one priority queue (default)
+        eSharedQueue,
+        /// Every thread has its own deque of tasks. Tasks added from inside
+        /// a pool thread go to that thread's deque; other tasks go to the
+        /// shared queue and are taken from there in batches. Threads which
+        /// run out of tasks steal them from the deques of other threads.
+        /// Much less lock contention with many short tasks, at the cost of
+        /// task priorities being honored only in the shared queue, and
+        /// queue_size limiting only the shared queue.
+        eWorkStealing
+    };
+
     /// Constructor
     /// @param queue_size
     ///   Maximum number of tasks waiting in the queue. If 0 then tasks
@@ -224,12 +240,15 @@ public:
     /// @param threads_mode
     ///   Running mode of all threads in thread pool. Values fRunDetached and
     ///   fRunAllowST are ignored.
+    /// @param scheduling
+    ///   How tasks are distributed among the threads
     ///
-    /// @sa AddTask()
+    /// @sa AddTask(), EScheduling
     CThreadPool(unsigned int      queue_size,
                 unsigned int      max_threads,
                 unsigned int      min_threads = 2,
-                CThread::TRunMode threads_mode = CThread::fRunDefault);
+                CThread::TRunMode threads_mode = CThread::fRunDefault,
+                EScheduling       scheduling = eSharedQueue);
 
     /// Add task to the pool for execution.
     /// @note
@@ -303,9 +322,12 @@ public:
     /// @param threads_mode
     ///   Running mode of all threads in thread pool. Values fRunDetached and
     ///   fRunAllowST are ignored.
+    /// @param scheduling
+    ///   How tasks are distributed among the threads
     CThreadPool(unsigned int            queue_size,
                 CThreadPool_Controller* controller,
-                CThread::TRunMode       threads_mode = CThread::fRunDefault);
+                CThread::TRunMode       threads_mode = CThread::fRunDefault,
+                EScheduling             scheduling = eSharedQueue);
 
     /// Set timeout to wait for all threads to finish before the pool
     /// should be able to destroy.
@@ -394,6 +416,7 @@ public:
     unsigned int GetThreadsCount(void) const;
 
     /// Get the number of tasks currently waiting in queue
+    /// (with eWorkStealing scheduling - also in deques of threads)
     unsigned int GetQueuedTasksCount(void) const;
 
     /// Get the number of currently executing tasks
@@ -402,6 +425,38 @@ public:
     /// Does method Abort() was already called for this ThreadPool
     bool IsAborted(void) const;
 
+    /// Scheduler statistics
+    ///
+    /// The counters are collected only with eWorkStealing scheduling;
+    /// the queue depths are reported with any scheduling.
+    /// @sa GetSchedulerStats()
+    /// Every executed task is counted once in local_tasks, shared_tasks
+    /// or stolen_tasks, by the way its thread got it; tasks moved into the
+    /// thread's deque along with it are counted when taken from there.
+    struct SSchedulerStats {
+        Uint8 local_tasks;     ///< Tasks taken by threads from own deques
+        Uint8 shared_tasks;    ///< Tasks taken from the shared queue
+        Uint8 stolen_tasks;    ///< Tasks stolen from deques of other threads
+        Uint8 steal_attempts;  ///< Attempts to steal tasks
+        Uint8 failed_steals;   ///< Attempts to steal which found nothing
+        Uint8 idle_waits;      ///< Times threads went idle for lack of tasks
+        Uint8 max_local_depth; ///< Largest length of a thread's deque so far
+        Uint8 queued_local;    ///< Tasks waiting in threads' deques now
+        Uint8 queued_shared;   ///< Tasks waiting in the shared queue now
+
+        SSchedulerStats(void)
+            : local_tasks(0), shared_tasks(0), stolen_tasks(0),
+              steal_attempts(0), failed_steals(0), idle_waits(0),
+              max_local_depth(0), queued_local(0), queued_shared(0)
+        {}
+    };
+
+    /// Get the scheduler statistics accumulated since the pool creation
+    SSchedulerStats GetSchedulerStats(void) const;
+
+    /// Get the scheduling the pool was created with
+    EScheduling GetScheduling(void) const;
+
 protected:
     /// Create new thread for the pool
     virtual CThreadPool_Thread* CreateThread(void);
@@ -33,10 +33,13 @@
 
 #include <ncbi_pch.hpp>
 #include "mm_aligner_threads.hpp"
+#include "nw_aligner_kernel.hpp"
 
 #include <corelib/ncbimtx.hpp>
 #include <algo/align/nw/align_exception.hpp>
 
+#include <algorithm>
+
 BEGIN_NCBI_SCOPE
 
 CMMAligner::CMMAligner()
@@ -493,7 +496,51 @@ void CMMAligner::x_RunTop ( const SCoordRect& rect,
     TScore V0 = lt? 0: wg;
     TScore E, G, n0;
 
-    for(i = 1;  i < N1 - 1;  ++i) {
+    i = 1;
+    if(N1 > kNWKernelMinDim + 1 && N2 > kNWKernelMinDim && IsSimdEnabled()) {
+
+        // score-only rows, in blocks ending at progress reporting points
+        vector<TScore> stl_colV (N1 - 1);
+        for(size_t ii = 1; ii < N1 - 1; ++ii) {
+            stl_colV[ii] = V0 += ws;
+        }
+
+        SNWKernelArgs args;
+        args.m_Seq2    = seq2 + 1;
+        args.m_Len2    = dim2;
+        args.m_Matrix  = sm;
+        args.m_Wg1     = args.m_Wg1Last = m_Wg;
+        args.m_Ws1     = args.m_Ws1Last = m_Ws;
+        args.m_Wg2     = m_Wg;
+        args.m_Ws2     = m_Ws;
+        args.m_Wg2Last = bFreeGapRight2? 0: m_Wg;
+        args.m_Ws2Last = bFreeGapRight2? 0: m_Ws;
+        args.m_RowV    = rowV;
+        args.m_RowF    = rowF;
+
+        for(; i < N1 - 1; ++i) {
+
+            const size_t i_end = min(N1 - 2, (i + prg_rep_rate - 1) /
+                                     prg_rep_rate * prg_rep_rate);
+            args.m_Seq1 = seq1 + i;
+            args.m_Len1 = i_end - i + 1;
+            args.m_ColV = &stl_colV[i - 1];
+            NW_RunKernel(args);
+            i = i_end;
+
+            if( m_prg_callback && i % prg_rep_rate == 0 ) {
+#ifdef NCBI_THREADS
+                CFastMutexGuard guard (progress_mutex);
+#endif
+                m_prg_info.m_iter_done += prg_rep_increment;
+                if( (m_terminate = m_prg_callback(&m_prg_info)) ) {
+                    break;
+                }
+            }
+        }
+    }
+
+    for(;  i < N1 - 1 && !m_terminate;  ++i) {
         
         V = V0 += ws;
         E = kInfMinus;
@@ -664,7 +711,63 @@ void CMMAligner::x_RunBtm(const SCoordRect& rect,
     TScore V0 = rb? 0: wg;
     TScore E, G, n0;
 
-    for(i = N1 - 2;  i > 0;  --i) {
+    i = N1 - 2;
+    if(N1 > kNWKernelMinDim + 1 && N2 > kNWKernelMinDim && IsSimdEnabled()) {
+
+        // score-only rows, in blocks ending at progress reporting points;
+        // the kernel runs forward so everything is reversed
+        vector<TScore> stl_colV (N1 - 1);
+        for(size_t r = 1; r < N1 - 1; ++r) {
+            stl_colV[r] = V0 += ws;
+        }
+        string rseq1 (seq1 + 1, seq1 + N1 - 1);
+        string rseq2 (seq2, seq2 + N2 - 1);
+        reverse(rseq1.begin(), rseq1.end());
+        reverse(rseq2.begin(), rseq2.end());
+        reverse(stl_rowV.begin(), stl_rowV.end());
+        reverse(stl_rowF.begin(), stl_rowF.end());
+
+        SNWKernelArgs args;
+        args.m_Seq2    = rseq2.data();
+        args.m_Len2    = dim2;
+        args.m_Matrix  = sm;
+        args.m_Wg1     = args.m_Wg1Last = m_Wg;
+        args.m_Ws1     = args.m_Ws1Last = m_Ws;
+        args.m_Wg2     = m_Wg;
+        args.m_Ws2     = m_Ws;
+        args.m_Wg2Last = bFreeGapLeft2? 0: m_Wg;
+        args.m_Ws2Last = bFreeGapLeft2? 0: m_Ws;
+        args.m_RowV    = rowV;
+        args.m_RowF    = rowF;
+
+        for(size_t r = 1; r < N1 - 1; ++r) {
+
+            const size_t r_end = min(N1 - 2, (r + prg_rep_rate) /
+                                     prg_rep_rate * prg_rep_rate - 1);
+            args.m_Seq1 = rseq1.data() + r - 1;
+            args.m_Len1 = r_end - r + 1;
+            args.m_ColV = &stl_colV[r - 1];
+            NW_RunKernel(args);
+            r = r_end;
+            i = N1 - 1 - r;
+
+            if( m_prg_callback && (N1 - i) % prg_rep_rate == 0 ) {
+#ifdef NCBI_THREADS
+                CFastMutexGuard guard (progress_mutex);
+#endif
+                m_prg_info.m_iter_done += prg_rep_increment;
+                if( (m_terminate = m_prg_callback(&m_prg_info)) ) {
+                    break;
+                }
+            }
+            --i;
+        }
+
+        reverse(stl_rowV.begin(), stl_rowV.end());
+        reverse(stl_rowF.begin(), stl_rowF.end());
+    }
+
+    for(;  i > 0 && !m_terminate;  --i) {
         
         V = V0 += ws;
         E = kInfMinus;
@@ -35,6 +35,7 @@
 #include <ncbi_pch.hpp>
 
 #include "nw_aligner_threads.hpp"
+#include "nw_aligner_kernel.hpp"
 #include "messages.hpp"
 
 #include <corelib/ncbi_system.hpp>
@@ -73,6 +74,7 @@ CNWAligner::CNWAligner()
       m_score(kInfMinus),
       m_mt(false),
       m_maxthreads(1),
+      m_Simd(true),
       m_MaxMem(GetDefaultSpaceLimit())
 {
     SetScoreMatrix(0);
@@ -102,6 +104,7 @@ CNWAligner::CNWAligner( const char* seq1, size_t len1,
       m_score(kInfMinus),
       m_mt(false),
       m_maxthreads(1),
+      m_Simd(true),
       m_MaxMem(GetDefaultSpaceLimit())
 {
     SetScoreMatrix(scoremat);
@@ -130,6 +133,7 @@ CNWAligner::CNWAligner(const string& seq1,
       m_score(kInfMinus),
       m_mt(false),
       m_maxthreads(1),
+      m_Simd(true),
       m_MaxMem(GetDefaultSpaceLimit())
 {
     SetScoreMatrix(scoremat);
@@ -271,8 +275,14 @@ CNWAligner::TScore CNWAligner::x_Align(SAlignInOut* data)
     TScore wsleft1   = bFreeGapLeft1? 0: m_Ws;
     TScore wg1 = m_Wg, ws1 = m_Ws;
 
+    const bool use_kernel = N1 > kNWKernelMinDim && N2 > kNWKernelMinDim
+                            && IsSimdEnabled();
+
     // index calculation: [i,j] = i*n2 + j
     CBacktraceMatrix4 backtrace_matrix (N1 * N2);
+    if(use_kernel) {
+        backtrace_matrix.Clear(N1 * N2);
+    }
     backtrace_matrix.SetAt(0, 0);
 
     // first row
@@ -305,6 +315,64 @@ CNWAligner::TScore CNWAligner::x_Align(SAlignInOut* data)
 
     --k;
 
+    if(use_kernel) {
+
+        // column 0 and the progress reporting stay here; the kernel is run
+        // on blocks of rows between progress reports
+        vector<TScore> stl_colV (N1);
+        for(size_t i = 1; i < N1; ++i) {
+            stl_colV[i] = V0 += wsleft2;
+            backtrace_matrix.SetBuf()[(i*N2) >> 1] |=
+                kMaskFc << (((i*N2) & 1) << 2);
+        }
+
+        SNWKernelArgs args;
+        args.m_Seq2    = m_Seq2 + data->m_offset2;
+        args.m_Len2    = data->m_len2;
+        args.m_Matrix  = sm;
+        args.m_Wg1     = args.m_Wg1Last = m_Wg;
+        args.m_Ws1     = args.m_Ws1Last = m_Ws;
+        args.m_Wg2     = m_Wg;
+        args.m_Ws2     = m_Ws;
+        args.m_Wg2Last = bFreeGapRight2? 0: m_Wg;
+        args.m_Ws2Last = bFreeGapRight2? 0: m_Ws;
+        args.m_RowV    = &stl_rowV[0];
+        args.m_RowF    = &stl_rowF[0];
+        args.m_SmithWaterman = m_SmithWaterman;
+        args.m_GapLater = m_GapPreference == eLater;
+        args.m_Trace   = backtrace_matrix.SetBuf();
+
+        const size_t rows_per_block = m_prg_callback? kNWKernelBlock: N1;
+        for(size_t i = 1; i < N1 && !m_terminate; i += rows_per_block) {
+
+            args.m_Seq1 = seq1 + i - 1;
+            args.m_Len1 = min(rows_per_block, N1 - i);
+            args.m_ColV = &stl_colV[i - 1];
+            args.m_TraceOrigin = (i - 1) * N2;
+            if(i + args.m_Len1 == N1 && bFreeGapRight1) {
+                args.m_Wg1Last = args.m_Ws1Last = 0;
+            }
+            args.m_BestScore = best_V;
+            args.m_BestPos = 0;
+
+            NW_RunKernel(args);
+
+            if(args.m_BestScore > best_V) {
+                best_V = args.m_BestScore;
+                backtrace_matrix.SetBestPos(args.m_TraceOrigin +
+                                            args.m_BestPos);
+            }
+            k = (i - 1 + args.m_Len1) * N2 + N2 - 1;
+
+            if(m_prg_callback) {
+                m_prg_info.m_iter_done = k;
+                m_terminate = m_prg_callback(&m_prg_info);
+            }
+        }
+        V = stl_rowV[N2 - 1];
+        seq1 = seq1_end;
+    }
+
     for(;  seq1 != seq1_end && !m_terminate;  ++seq1) {
 
         backtrace_matrix.SetAt(++k, kMaskFc);
@@ -403,7 +471,9 @@ CNWAligner::TScore CNWAligner::x_Align(SAlignInOut* data)
         }
     }
 
-    backtrace_matrix.Purge(++k);
+    if(!use_kernel) {
+        backtrace_matrix.Purge(++k);
+    }
     backtrace_matrix.SetBestScore(best_V);
 
     /*
@@ -1138,6 +1208,12 @@ void CNWAligner::EnableMultipleThreads(bool enable)
 }
 
 
+bool CNWAligner::IsSimdEnabled(void) const
+{
+    return m_Simd && NW_HaveKernel();
+}
+
+
 CNWAligner::TScore CNWAligner::ScoreFromTranscript(
                        const TTranscript& transcript,
                        size_t start1, size_t start2) const
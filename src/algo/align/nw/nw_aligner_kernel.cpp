@@ -0,0 +1,381 @@
+/* $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:  Vectorized affine-gap dynamic programming kernel
+ *
+ * ===========================================================================
+ *
+ */
+
+#include <ncbi_pch.hpp>
+#include "nw_aligner_kernel.hpp"
+
+#include <corelib/ncbi_system.hpp>
+#include <algo/align/nw/align_exception.hpp>
+
+#include <string.h>
+
+// The kernel relies on the GCC vector extensions (supported by GCC and
+// Clang); the instruction set is picked at run time.  All helpers are
+// forcibly inlined into the per-instruction-set entry points, so the
+// vector ABI warnings about them do not apply.
+#if defined(__GNUC__)  &&  (defined(__x86_64__)  ||  defined(__i386__))
+#  define NCBI_NW_KERNEL_VECTOR   1
+#  define NCBI_NW_KERNEL_TARGETS  1
+#elif defined(__GNUC__)  &&  (defined(__aarch64__)  ||  defined(__ARM_NEON))
+#  define NCBI_NW_KERNEL_VECTOR   1
+#endif
+
+#ifdef NCBI_NW_KERNEL_VECTOR
+#  define NCBI_NW_KERNEL_INLINE  inline __attribute__((always_inline))
+#  if defined(__GNUC__)  &&  !defined(__clang__)
+#    pragma GCC diagnostic ignored "-Wpsabi"
+#  endif
+#endif
+
+
+BEGIN_NCBI_SCOPE
+
+
+#ifdef NCBI_NW_KERNEL_VECTOR
+
+namespace {
+
+typedef CNWAligner::TScore TScore;
+
+// backtrace bits, see CNWAligner::x_Align()
+const TScore kTraceFc = 0x01;
+const TScore kTraceEc = 0x02;
+const TScore kTraceE  = 0x04;
+const TScore kTraceD  = 0x08;
+
+
+template<int W>
+struct SNWVector
+{
+    typedef TScore TVec __attribute__((vector_size(W * sizeof(TScore))));
+};
+
+template<class TVec>
+NCBI_NW_KERNEL_INLINE TVec s_Select(const TVec& mask, const TVec& a, const TVec& b)
+{
+    return (mask & a) | (~mask & b);
+}
+
+template<class TVec>
+NCBI_NW_KERNEL_INLINE TVec s_Max(const TVec& a, const TVec& b)
+{
+    return s_Select(a > b, a, b);
+}
+
+// Shift lanes by one: lane l gets lane l-1 of 'v', lane 0 that of 'first'
+#ifdef __clang__
+#  define NCBI_NW_SHUFFLE(a, b, ...)  __builtin_shufflevector(a, b, __VA_ARGS__)
+#else
+#  define NCBI_NW_SHUFFLE(a, b, ...)  \
+    __builtin_shuffle(a, b, typename SNWVector<W>::TVec{__VA_ARGS__})
+#endif
+
+template<int W> struct SNWShift;
+
+template<> struct SNWShift<4>
+{
+    enum { W = 4 };
+    template<class TVec>
+    static NCBI_NW_KERNEL_INLINE TVec Apply(const TVec& v, const TVec& first)
+    {
+        return NCBI_NW_SHUFFLE(v, first, 4, 0, 1, 2);
+    }
+};
+
+template<> struct SNWShift<8>
+{
+    enum { W = 8 };
+    template<class TVec>
+    static NCBI_NW_KERNEL_INLINE TVec Apply(const TVec& v, const TVec& first)
+    {
+        return NCBI_NW_SHUFFLE(v, first, 8, 0, 1, 2, 3, 4, 5, 6);
+    }
+};
+
+template<class TVec>
+NCBI_NW_KERNEL_INLINE TVec s_Load(const TScore* p)
+{
+    TVec v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+template<class TVec>
+NCBI_NW_KERNEL_INLINE void s_Store(TScore* p, const TVec& v)
+{
+    memcpy(p, &v, sizeof(v));
+}
+
+
+template<int W>
+NCBI_NW_KERNEL_INLINE void s_RunKernel(SNWKernelArgs& args)
+{
+    typedef typename SNWVector<W>::TVec TVec;
+
+    const size_t n1 = args.m_Len1;
+    const size_t n2 = args.m_Len2;
+    const size_t stride = n2 + 1;
+
+    TScore* rowV = args.m_RowV;
+    TScore* rowF = args.m_RowF;
+    const bool sw = args.m_SmithWaterman;
+    Uint1* trace = args.m_Trace;
+
+    const TVec vZero = TVec();
+    const TVec vInf  = vZero + kInfMinus;
+    const TVec vN2   = vZero + TScore(n2);
+    const TVec vLater = vZero - TScore(args.m_GapLater ? 1 : 0);
+    const TVec vWg2 = vZero + args.m_Wg2, vWg2Last = vZero + args.m_Wg2Last;
+    const TVec vWs2 = vZero + args.m_Ws2, vWs2Last = vZero + args.m_Ws2Last;
+
+    TScore buf [W + 1];
+    for (int l = 0; l < W; ++l) {
+        buf[l] = l;
+    }
+    const TVec vLane = s_Load<TVec>(buf);
+
+    // the second sequence padded so that lanes running ahead of or behind
+    // the matrix still read valid residues
+    vector<unsigned char> pad2 (n2 + 2*W, (unsigned char)args.m_Seq2[0]);
+    copy(args.m_Seq2, args.m_Seq2 + n2, pad2.begin() + W);
+    const unsigned char* seq2 = &pad2[W - 1];
+
+    // backtrace of a strip, W values per step
+    vector<TScore> strip (trace? (n2 + W) * W: 0);
+
+    for (size_t r = 1; r <= n1; r += W) {
+
+        const size_t rows = min(size_t(W), n1 - r + 1);
+
+        // per-lane (per-row) parameters
+        const TNCBIScore* row_sc [W];
+        TScore col [W], wg1 [W], ws1 [W];
+        for (size_t l = 0; l < size_t(W); ++l) {
+            if (l < rows) {
+                const size_t i = r + l;
+                row_sc[l] = args.m_Matrix[(unsigned char)args.m_Seq1[i - 1]];
+                col[l] = args.m_ColV[i];
+                wg1[l] = i == n1? args.m_Wg1Last: args.m_Wg1;
+                ws1[l] = i == n1? args.m_Ws1Last: args.m_Ws1;
+            }
+            else {
+                row_sc[l] = row_sc[0];
+                col[l] = kInfMinus;
+                wg1[l] = args.m_Wg1;
+                ws1[l] = args.m_Ws1;
+            }
+        }
+        const TVec vWg1 = s_Load<TVec>(wg1);
+        const TVec vWs1 = s_Load<TVec>(ws1);
+
+        // state of the cell last computed by each lane
+        TVec V = s_Load<TVec>(col);
+        TVec E = vInf;
+        TVec F = vInf;
+
+        // V of the cell above the previous one, i.e. the diagonal
+        buf[0] = rowV[0];
+        for (int l = 1; l < W; ++l) {
+            buf[l] = kInfMinus;
+        }
+        TVec up_prev = s_Load<TVec>(buf);
+
+        // Smith-Waterman: the best cell in each lane
+        TVec best = vZero + args.m_BestScore;
+        TVec best_j = vZero;
+        const TVec lane_valid = vLane < (vZero + TScore(rows));
+
+        const size_t last = rows - 1;
+        const size_t steps = n2 + rows - 1;
+
+        TScore sc [W];
+
+        for (size_t t = 1; t <= steps; ++t) {
+
+            // values from above: lane 0 reads the row above the strip,
+            // the other lanes take the previous output of the lane above
+            const size_t t0 = t <= n2? t: n2;
+            const TVec up  = SNWShift<W>::Apply(V, vZero + rowV[t0]);
+            const TVec upF = SNWShift<W>::Apply(F, vZero + rowF[t0]);
+
+            const TVec diag = up_prev;
+            up_prev = up;
+
+            for (int l = 0; l < W; ++l) {
+                sc[l] = row_sc[l][seq2[Int8(t) - l]];
+            }
+            const TVec G = diag + s_Load<TVec>(sc);
+
+            const TVec j = (vZero + TScore(t)) - vLane;
+            const TVec last_col = j == vN2;
+            const TVec wg2 = s_Select(last_col, vWg2Last, vWg2);
+            const TVec ws2 = s_Select(last_col, vWs2Last, vWs2);
+
+            TVec n0 = V + vWg1;
+            const TVec ec = E >= n0;
+            const TVec En = s_Max(E, n0) + vWs1;
+
+            n0 = up + wg2;
+            const TVec fc = upF >= n0;
+            const TVec Fn = s_Max(upF, n0) + ws2;
+
+            TVec Vn = s_Max(s_Max(En, Fn), G);
+
+            if (trace) {
+                const TVec c1 = (G < Fn) | ((G == Fn) & vLater);
+                const TVec c2 = (En > G) | ((En == G) & vLater);
+                const TVec e  = s_Select(c1, En > Fn, c2);
+                const TVec d  = ~c1 & ~c2;
+                const TVec tracer = (fc & kTraceFc) | (ec & kTraceEc)
+                                  | (e & kTraceE) | (d & kTraceD);
+                s_Store(&strip[t * W], tracer);
+            }
+
+            if (sw) {
+                Vn = s_Max(Vn, vZero);
+                const TVec better = (Vn > best) & (j > vZero) & (j <= vN2)
+                                    & lane_valid;
+                best = s_Select(better, Vn, best);
+                best_j = s_Select(better, j, best_j);
+            }
+
+            const TVec active = j > vZero;
+            V = s_Select(active, Vn, V);
+            E = s_Select(active, En, E);
+            F = s_Select(active, Fn, F);
+
+            // the last lane produces the output row
+            if (t > last) {
+                rowV[t - last] = V[last];
+                rowF[t - last] = F[last];
+            }
+        }
+
+        rowV[0] = col[last];
+
+        // the strip's backtrace is kept by step; write it out by row
+        if (trace) {
+            for (size_t l = 0; l < rows; ++l) {
+                const TScore* src = &strip[(l + 1) * W + l];
+                size_t k = args.m_TraceOrigin + (r + l) * stride + 1;
+                for (size_t j = 1; j <= n2; ++j, ++k, src += W) {
+                    trace[k >> 1] |= Uint1(*src << ((k & 1) << 2));
+                }
+            }
+        }
+
+        if (sw) {
+            TScore lane_best [W], lane_j [W];
+            s_Store(lane_best, best);
+            s_Store(lane_j, best_j);
+            for (size_t l = 0; l < rows; ++l) {
+                if (lane_j[l] > 0  &&  lane_best[l] > args.m_BestScore) {
+                    args.m_BestScore = lane_best[l];
+                    args.m_BestPos = (r + l) * stride + lane_j[l];
+                }
+            }
+        }
+    }
+}
+
+
+#ifdef NCBI_NW_KERNEL_TARGETS
+
+__attribute__((target("avx2")))
+void s_RunKernelAVX2(SNWKernelArgs& args)
+{
+    s_RunKernel<8>(args);
+}
+
+__attribute__((target("sse4.1")))
+void s_RunKernelSSE41(SNWKernelArgs& args)
+{
+    s_RunKernel<4>(args);
+}
+
+#endif
+
+void s_RunKernelDefault(SNWKernelArgs& args)
+{
+    s_RunKernel<4>(args);
+}
+
+
+typedef void (*FRunKernel)(SNWKernelArgs& args);
+
+FRunKernel s_SelectKernel(void)
+{
+#ifdef NCBI_NW_KERNEL_TARGETS
+    if (CCpuFeatures::AVX2()) {
+        return s_RunKernelAVX2;
+    }
+    if (CCpuFeatures::SSE41()) {
+        return s_RunKernelSSE41;
+    }
+#endif
+    return s_RunKernelDefault;
+}
+
+} // namespace
+
+
+bool NW_HaveKernel(void)
+{
+    return true;
+}
+
+
+void NW_RunKernel(SNWKernelArgs& args)
+{
+    static const FRunKernel run = s_SelectKernel();
+    if (args.m_Len1 > 0  &&  args.m_Len2 > 0) {
+        run(args);
+    }
+}
+
+#else  // NCBI_NW_KERNEL_VECTOR
+
+bool NW_HaveKernel(void)
+{
+    return false;
+}
+
+
+void NW_RunKernel(SNWKernelArgs& /*args*/)
+{
+    NCBI_THROW(CAlgoAlignException, eInternal,
+               "Vectorized alignment kernel is not available");
+}
+
+#endif  // NCBI_NW_KERNEL_VECTOR
+
+
+END_NCBI_SCOPE
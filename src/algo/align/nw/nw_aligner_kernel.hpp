@@ -0,0 +1,119 @@
+#ifndef ALGO___NW_ALIGNER_KERNEL__HPP
+#define ALGO___NW_ALIGNER_KERNEL__HPP
+
+/* $Id$
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+* File Description:  Vectorized affine-gap dynamic programming kernel
+*                    shared by CNWAligner and CMMAligner
+*
+*/
+
+#include <algo/align/nw/nw_aligner.hpp>
+
+BEGIN_NCBI_SCOPE
+
+
+// Input and output of NW_RunKernel().
+//
+// The kernel fills rows 1..m_Len1 and columns 1..m_Len2 of an affine-gap
+// dynamic programming matrix, taking row 0 from m_RowV/m_RowF and column 0
+// from m_ColV. Row i corresponds to m_Seq1[i-1], column j to m_Seq2[j-1].
+// Scores, gap choices and traceback bits are identical to those of the
+// scalar loop in CNWAligner::x_Align().
+//
+// The rows are processed in strips as wide as the vector unit; within a
+// strip each lane runs one row, one column behind the lane above it, so
+// all dependencies of a cell are resolved in the previous step.
+
+struct SNWKernelArgs
+{
+    typedef CNWAligner::TScore TScore;
+
+    SNWKernelArgs(void):
+        m_Seq1(0), m_Len1(0), m_Seq2(0), m_Len2(0), m_Matrix(0),
+        m_Wg1(0), m_Ws1(0), m_Wg1Last(0), m_Ws1Last(0),
+        m_Wg2(0), m_Ws2(0), m_Wg2Last(0), m_Ws2Last(0),
+        m_RowV(0), m_RowF(0), m_ColV(0),
+        m_SmithWaterman(false), m_GapLater(true),
+        m_Trace(0), m_TraceOrigin(0),
+        m_BestScore(0), m_BestPos(0)
+    {}
+
+    const char*  m_Seq1;
+    size_t       m_Len1;
+    const char*  m_Seq2;
+    size_t       m_Len2;
+    const TNCBIScore (*m_Matrix) [NCBI_FSM_DIM];
+
+    // gap (open, extension) in the first sequence (horizontal moves);
+    // the last row uses m_Wg1Last and m_Ws1Last
+    TScore m_Wg1, m_Ws1, m_Wg1Last, m_Ws1Last;
+
+    // gap (open, extension) in the second sequence (vertical moves);
+    // the last column uses m_Wg2Last and m_Ws2Last
+    TScore m_Wg2, m_Ws2, m_Wg2Last, m_Ws2Last;
+
+    // [in]  row 0 (m_Len2 + 1 values, m_RowF[0] is not used);
+    // [out] the last row
+    TScore* m_RowV;
+    TScore* m_RowF;
+
+    // [in] column 0, indexed by row; m_ColV[0] is not used (m_RowV[0] is)
+    const TScore* m_ColV;
+
+    bool m_SmithWaterman;
+    bool m_GapLater;      // CNWAligner::eLater
+
+    // four-bit backtrace matrix as used by CNWAligner (row stride
+    // m_Len2 + 1); cell [i,j] goes to index m_TraceOrigin + i*(m_Len2+1) + j.
+    // The buffer must be zero-filled, only the nibbles of the cells
+    // computed are set. Null if no backtrace is needed.
+    Uint1* m_Trace;
+    size_t m_TraceOrigin;
+
+    // [in/out] Smith-Waterman only: the best score and its position
+    // (relative to m_TraceOrigin); updated only by a strictly better score
+    TScore m_BestScore;
+    size_t m_BestPos;
+};
+
+
+// The kernel pays off on all but tiny matrices
+const size_t kNWKernelMinDim = 16;
+
+// Rows per kernel call between progress reports
+const size_t kNWKernelBlock = 256;
+
+
+// Whether NW_RunKernel() is supported by the compiler and the platform
+bool NW_HaveKernel(void);
+
+void NW_RunKernel(SNWKernelArgs& args);
+
+
+END_NCBI_SCOPE
+
+#endif  /* ALGO___NW_ALIGNER_KERNEL__HPP */
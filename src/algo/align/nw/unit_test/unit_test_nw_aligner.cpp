@@ -0,0 +1,238 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   CNWAligner and CMMAligner with the vectorized dynamic programming
+ *   kernel and without it must give the same scores and transcripts.
+ *
+ * ===========================================================================
+ */
+
+#include <ncbi_pch.hpp>
+
+#include <corelib/test_boost.hpp>
+#include <util/random_gen.hpp>
+#include <util/tables/raw_scoremat.h>
+
+#include <algo/align/nw/nw_aligner.hpp>
+#include <algo/align/nw/mm_aligner.hpp>
+#include <algo/align/nw/align_exception.hpp>
+
+USING_NCBI_SCOPE;
+
+
+// Aligner settings varied by the tests
+struct SAlignParams
+{
+    SAlignParams(void)
+        : m_Protein(false), m_MM(false), m_SmithWaterman(false),
+          m_GapPreference(CNWAligner::eLater), m_Esf(0), m_Wms(0)
+    {}
+
+    bool m_Protein;
+    bool m_MM;
+    bool m_SmithWaterman;
+    CNWAligner::EGapPreference m_GapPreference;
+    int  m_Esf;  // end-space free flags: L1, R1, L2, R2 in bits 0..3
+    CNWAligner::TScore m_Wms;  // mismatch, if not zero
+};
+
+
+// Score and transcript of one run, or the error if the run fails
+static string s_Align(const string& seq1, const string& seq2,
+                      const SAlignParams& params, bool simd)
+{
+    unique_ptr<CNWAligner> aligner(params.m_MM ?
+                                   new CMMAligner : new CNWAligner);
+    if ( params.m_Protein ) {
+        aligner->SetScoreMatrix(&NCBISM_Blosum62);
+    }
+    if ( params.m_Wms ) {
+        aligner->SetWms(params.m_Wms);
+        aligner->SetScoreMatrix(0);
+    }
+    aligner->SetEndSpaceFree((params.m_Esf & 1) != 0, (params.m_Esf & 2) != 0,
+                             (params.m_Esf & 4) != 0, (params.m_Esf & 8) != 0);
+    if ( !params.m_MM ) {
+        aligner->SetSmithWaterman(params.m_SmithWaterman);
+        aligner->SetGapPreference(params.m_GapPreference);
+    }
+    aligner->EnableSimd(simd);
+    BOOST_REQUIRE_EQUAL(aligner->IsSimdEnabled() && !simd, false);
+    try {
+        aligner->SetSequences(seq1, seq2);
+        CNWAligner::TScore score = aligner->Run();
+        return NStr::IntToString(score) + " " +
+            aligner->GetTranscriptString();
+    }
+    catch ( CAlgoAlignException& e ) {
+        return string("error ") + e.GetErrCodeString();
+    }
+}
+
+
+static void s_Compare(const string& seq1, const string& seq2,
+                      const SAlignParams& params)
+{
+    string scalar = s_Align(seq1, seq2, params, false);
+    string simd   = s_Align(seq1, seq2, params, true);
+    if ( scalar != simd ) {
+        BOOST_ERROR("SIMD and scalar results differ:"
+                    << " MM=" << params.m_MM
+                    << " protein=" << params.m_Protein
+                    << " SW=" << params.m_SmithWaterman
+                    << " esf=" << params.m_Esf
+                    << " seq1=" << seq1 << " seq2=" << seq2
+                    << "\nscalar: " << scalar << "\nsimd:   " << simd);
+    }
+}
+
+
+static string s_RandomSeq(CRandom& rnd, size_t len, const char* alphabet)
+{
+    const size_t count = strlen(alphabet);
+    string seq(len, ' ');
+    for ( auto& c : seq ) {
+        c = alphabet[rnd.GetRand(0, CRandom::TValue(count - 1))];
+    }
+    return seq;
+}
+
+
+// A copy of the sequence with random substitutions, insertions and
+// deletions, so that the alignment has runs of matches and gaps
+static string s_Mutate(CRandom& rnd, const string& seq, const char* alphabet)
+{
+    const size_t count = strlen(alphabet);
+    string result;
+    for ( size_t i = 0; i < seq.size(); ++i ) {
+        switch ( rnd.GetRand(0, 19) ) {
+        case 0:
+            result += alphabet[rnd.GetRand(0, CRandom::TValue(count - 1))];
+            break;
+        case 1:
+            i += rnd.GetRand(0, 10);
+            break;
+        case 2:
+            result += s_RandomSeq(rnd, rnd.GetRand(1, 10), alphabet);
+            result += seq[i];
+            break;
+        default:
+            result += seq[i];
+            break;
+        }
+    }
+    return result;
+}
+
+
+static const char kNucl[] = "ACGT";
+static const char kProt[] = "ARNDCQEGHILKMFPSTWYV";
+
+
+BOOST_AUTO_TEST_CASE(RandomPairs)
+{
+    CRandom rnd(1);
+    for ( int protein = 0; protein < 2; ++protein ) {
+        const char* alphabet = protein ? kProt : kNucl;
+        for ( int pass = 0; pass < 40; ++pass ) {
+            // lengths around the strip widths and the minimal kernel size
+            string seq1 = s_RandomSeq(rnd, rnd.GetRand(1, pass < 20 ? 40 : 700),
+                                      alphabet);
+            string seq2 = pass % 3 ? s_Mutate(rnd, seq1, alphabet) :
+                s_RandomSeq(rnd, rnd.GetRand(1, 700), alphabet);
+            if ( seq2.empty() ) {
+                seq2 = alphabet[0];
+            }
+            for ( int mm = 0; mm < 2; ++mm ) {
+                SAlignParams params;
+                params.m_Protein = protein != 0;
+                params.m_MM = mm != 0;
+                params.m_Esf = pass % 16;
+                s_Compare(seq1, seq2, params);
+                s_Compare(seq2, seq1, params);
+                if ( !mm ) {
+                    params.m_GapPreference = CNWAligner::eEarlier;
+                    s_Compare(seq1, seq2, params);
+                    params.m_SmithWaterman = true;
+                    params.m_Esf = 0;
+                    s_Compare(seq1, seq2, params);
+                }
+            }
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(EndSpaceFree)
+{
+    // a short sequence inside a long one, so that free end gaps matter;
+    // CMMAligner runs the reversed bottom pass on each split
+    CRandom rnd(2);
+    string genomic = s_RandomSeq(rnd, 1500, kNucl);
+    string cdna = s_Mutate(rnd, genomic.substr(400, 600), kNucl);
+    for ( int esf = 0; esf < 16; ++esf ) {
+        for ( int mm = 0; mm < 2; ++mm ) {
+            SAlignParams params;
+            params.m_MM = mm != 0;
+            params.m_Esf = esf;
+            s_Compare(cdna, genomic, params);
+            s_Compare(genomic, cdna, params);
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(EdgeCases)
+{
+    CRandom rnd(3);
+    string seq = s_RandomSeq(rnd, 300, kNucl);
+    vector< pair<string, string> > pairs = {
+        { "", "" },
+        { "", seq },
+        { seq, "" },
+        { "A", "A" },
+        { "A", "C" },
+        { "A", seq },
+        { seq, "G" },
+        { seq, seq },
+        // nothing matches: with a high mismatch penalty all is gaps
+        { string(200, 'A'), string(300, 'C') },
+        { string(17, 'A'), string(17, 'C') },
+        { string(18, 'T'), string(400, 'G') }
+    };
+    for ( auto& p : pairs ) {
+        for ( int esf = 0; esf < 16; esf += 5 ) {
+            for ( int mm = 0; mm < 2; ++mm ) {
+                SAlignParams params;
+                params.m_MM = mm != 0;
+                params.m_Esf = esf;
+                s_Compare(p.first, p.second, params);
+                params.m_Wms = -100;
+                s_Compare(p.first, p.second, params);
+            }
+        }
+    }
+}
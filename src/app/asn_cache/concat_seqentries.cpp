@@ -123,6 +123,12 @@ int CConcatSeqEntriesApplication::Run(void)
 void    DumpSeqEntries( CDir & cache_dir, CNcbiOstream & output_stream )
 {
     CCache_blob a_blob;
+
+    string  dict_file =
+        NASNCacheFileName::GetZstdDictionary( cache_dir.GetPath() );
+    if ( CFile( dict_file ).Exists() ) {
+        CCache_blob_Dictionary::Load( dict_file );
+    }
     
     CDir::TEntries  chunk_list
         = cache_dir.GetEntries( NASNCacheFileName::GetChunkPrefix() + "*", 
@@ -43,6 +43,7 @@
 
 #include <serial/serial.hpp>
 #include <serial/objistr.hpp>
+#include <serial/objistrasnb.hpp>
 #include <serial/objostr.hpp>
 
 #include <objects/seqset/Seq_entry.hpp>
@@ -151,6 +152,7 @@ public:
         , m_Genome (CBioSource::eGenome_unknown)
         , m_ExtractDelta(false)
         , m_MaxDeltaLevel(UINT_MAX)
+        , m_Compression(CCache_blob::eZlib)
     {
     }
     
@@ -203,6 +205,16 @@ private:
                                  CNcbiOstream& ostr_seqids,
                                  ESerialDataFormat serial_fmt);
 
+    void x_ConvertCache(const string& src_path,
+                        CNcbiOstream& ostr_seqids,
+                        size_t &count);
+
+    CRef<CCache_blob_Dictionary> x_TrainDictionary(const string& src_path,
+                                                   size_t max_samples,
+                                                   size_t max_size);
+
+    void x_Pack(CCache_blob& blob, const CSeq_entry& entry);
+
     void x_ExtractDelta(CBioseq_Handle         bsh,
                      set<CSeq_id_Handle>& delta_ids);
     void x_UpsertDescriptor(list<CRef<CSeqdesc> >& descs, CRef<CSeqdesc> new_desc);
@@ -243,6 +255,8 @@ private: // data
     set<CSeq_inst::EMol> m_StripInstMol;
     bool m_ExtractDelta;
     unsigned m_MaxDeltaLevel;
+    CCache_blob::ECompression m_Compression;
+    CRef<CCache_blob_Dictionary> m_ZstdDict;
     set<CSeq_id_Handle> m_CachedIds;
     set<CSeq_id_Handle> m_PreviousExecutionIds;
     set<string> m_PreviousExecutionRuns;
@@ -435,6 +449,34 @@ void CPrimeCacheApplication::Init(void)
 
     arg_desc->AddFlag("resume", "Resume interrupted previous execution");
 
+    arg_desc->AddOptionalKey("convert", "SourceCache",
+                             "Copy all entries of an existing cache, e.g. to "
+                             "change the compression of its blobs; input "
+                             "arguments are ignored",
+                             CArgDescriptions::eDirectory);
+
+    arg_desc->AddDefaultKey("compression", "Compression",
+                            "Compression of the cache blobs; zstd blobs "
+                            "cannot be read by older versions of the cache",
+                            CArgDescriptions::eString, "zlib");
+    arg_desc->SetConstraint("compression",
+                            &(*new CArgAllow_Strings, "zlib", "zstd"));
+
+    arg_desc->AddOptionalKey("zstd-dict", "Dictionary",
+                             "Path to a zstd dictionary to compress the "
+                             "blobs with",
+                             CArgDescriptions::eString);
+
+    arg_desc->AddDefaultKey("zstd-dict-size", "Size",
+                            "With -convert, maximum size of a zstd "
+                            "dictionary trained on the source cache; "
+                            "0 to compress without a dictionary",
+                            CArgDescriptions::eInteger, "112640");
+
+    arg_desc->AddDefaultKey("zstd-dict-samples", "Count",
+                            "Number of entries to train the dictionary on",
+                            CArgDescriptions::eInteger, "10000");
+
     arg_desc->AddFlag("non-exclusive",
                       "Can run this cache process in parallel with other "
                       "tasks; use this if writing to a dedicated cache rather "
@@ -645,7 +687,7 @@ void CPrimeCacheApplication::x_Process_Fasta(CNcbiIstream& istr,
         }
         CCache_blob blob;
         blob.SetTimestamp(timestamp);
-        blob.Pack(*entry);
+        x_Pack(blob, *entry);
 
         m_MainChunk.OpenForWrite(m_CachePath);
         size_t offset = m_MainChunk.GetOffset();
@@ -722,7 +764,7 @@ void CPrimeCacheApplication::x_Process_SRA(CNcbiIstream& istr,
 
             CCache_blob blob;
             blob.SetTimestamp(timestamp);
-            blob.Pack(*entry);
+            x_Pack(blob, *entry);
 
             m_MainChunk.OpenForWrite(m_CachePath);
             size_t offset = m_MainChunk.GetOffset();
@@ -823,7 +865,7 @@ void CPrimeCacheApplication::x_CacheSeqEntry(CNcbiIstream& istr,
 
         CCache_blob blob;
         blob.SetTimestamp(timestamp);
-        blob.Pack(*entry);
+        x_Pack(blob, *entry);
 
         m_MainChunk.OpenForWrite(m_CachePath);
         size_t offset = m_MainChunk.GetOffset();
@@ -855,6 +897,125 @@ void CPrimeCacheApplication::x_CacheSeqEntry(CNcbiIstream& istr,
     LOG_POST(Error << "Cache Seq-entry: done, cached " << count << " items");
 }
 
+void CPrimeCacheApplication::x_Pack(CCache_blob& blob, const CSeq_entry& entry)
+{
+    blob.Pack(entry, m_Compression, m_ZstdDict.GetPointerOrNull());
+}
+
+CRef<CCache_blob_Dictionary>
+CPrimeCacheApplication::x_TrainDictionary(const string& src_path,
+                                          size_t max_samples,
+                                          size_t max_size)
+{
+    vector< vector<unsigned char> > samples;
+    CDir::TEntries chunk_list =
+        CDir(src_path).GetEntries(NASNCacheFileName::GetChunkPrefix() + "*",
+                                  CDir::eIgnoreRecursive | CDir::fCreateObjects);
+    ITERATE (CDir::TEntries, chunk_it, chunk_list) {
+        if (samples.size() >= max_samples) {
+            break;
+        }
+        CNcbiIfstream chunk_stream((*chunk_it)->GetPath().c_str(),
+                                   IOS_BASE::in | IOS_BASE::binary);
+        CObjectIStreamAsnBinary blob_stream(chunk_stream);
+        while (samples.size() < max_samples  &&  !blob_stream.EndOfData()) {
+            CCache_blob blob;
+            blob_stream >> blob;
+            samples.push_back(vector<unsigned char>());
+            blob.UnPack(samples.back());
+        }
+    }
+
+    CRef<CCache_blob_Dictionary> dict =
+        CCache_blob_Dictionary::Train(samples, max_size);
+    if (dict) {
+        LOG_POST(Error << "Trained zstd dictionary of " << dict->GetData().size()
+                 << " bytes on " << samples.size() << " entries");
+    }
+    else {
+        ERR_POST(Warning << "Cannot train zstd dictionary on "
+                 << samples.size() << " entries, using none");
+    }
+    return dict;
+}
+
+void CPrimeCacheApplication::x_ConvertCache(const string& src_path,
+                                            CNcbiOstream& ostr_seqids,
+                                            size_t &count)
+{
+    if (CDirEntry::NormalizePath(CDirEntry::CreateAbsolutePath(src_path)) ==
+        CDirEntry::NormalizePath(CDirEntry::CreateAbsolutePath(m_CachePath))) {
+        NCBI_THROW(CException, eUnknown,
+                   "cannot convert cache into itself: " + src_path);
+    }
+
+    string src_dict_file = NASNCacheFileName::GetZstdDictionary(src_path);
+    if (CFile(src_dict_file).Exists()) {
+        CCache_blob_Dictionary::Load(src_dict_file);
+    }
+
+    const CArgs& args = GetArgs();
+    size_t dict_size = args["zstd-dict-size"].AsInteger();
+    if (m_Compression == CCache_blob::eZstd  &&  !m_ZstdDict  &&  dict_size) {
+        m_ZstdDict = x_TrainDictionary(src_path,
+                                       args["zstd-dict-samples"].AsInteger(),
+                                       dict_size);
+        if (m_ZstdDict) {
+            m_ZstdDict->Save(NASNCacheFileName::GetZstdDictionary(m_CachePath));
+            CCache_blob_Dictionary::Register(*m_ZstdDict);
+        }
+    }
+
+    CRef<CObjectManager> om(CObjectManager::GetInstance());
+    CDir::TEntries chunk_list =
+        CDir(src_path).GetEntries(NASNCacheFileName::GetChunkPrefix() + "*",
+                                  CDir::eIgnoreRecursive | CDir::fCreateObjects);
+    ITERATE (CDir::TEntries, chunk_it, chunk_list) {
+        CNcbiIfstream chunk_stream((*chunk_it)->GetPath().c_str(),
+                                   IOS_BASE::in | IOS_BASE::binary);
+        CObjectIStreamAsnBinary blob_stream(chunk_stream);
+        while ( !blob_stream.EndOfData() ) {
+            if (CSignal::IsSignaled()) {
+                NCBI_THROW(CException, eUnknown,
+                           "trapped signal, exiting");
+            }
+
+            CCache_blob src_blob;
+            blob_stream >> src_blob;
+            CRef<CSeq_entry> entry(new CSeq_entry);
+            src_blob.UnPack(*entry);
+
+            CCache_blob blob;
+            blob.SetTimestamp(src_blob.GetTimestamp());
+            x_Pack(blob, *entry);
+
+            m_MainChunk.OpenForWrite(m_CachePath);
+            size_t offset = m_MainChunk.GetOffset();
+            m_MainChunk.Write(blob);
+            size_t size = m_MainChunk.GetOffset() - offset;
+            Uint4 chunk_id = m_MainChunk.GetChunkSerialNum();
+
+            entry->Parentize();
+            x_ExtractAndIndex(*entry, blob.GetTimestamp(),
+                              chunk_id, offset, size);
+
+            // note that we do this in a private scope and use no data loaders
+            CScope scope(*om);
+            CSeq_entry_Handle seh = scope.AddTopLevelSeqEntry(*entry);
+            for (CBioseq_CI bioseq_it(seh);  bioseq_it;  ++bioseq_it) {
+                ostr_seqids << sequence::GetId(*bioseq_it, m_id_type) << '\n';
+            }
+
+            ++count;
+            if (count % 100000 == 0) {
+                LOG_POST(Error << "Convert cache: processed " << count << " entries...");
+            }
+        }
+    }
+
+    LOG_POST(Error << "Convert cache: done, converted " << count << " entries");
+}
+
 void CPrimeCacheApplication::x_Read_Ids(CNcbiIstream& istr,
                                         set<CSeq_id_Handle> &ids)
 {
@@ -907,7 +1068,7 @@ void CPrimeCacheApplication::x_Process_Ids(const set<CSeq_id_Handle> &ids,
 
         CCache_blob blob;
         blob.SetTimestamp(timestamp);
-        blob.Pack(*entry);
+        x_Pack(blob, *entry);
 
         m_MainChunk.OpenForWrite(m_CachePath);
         size_t offset = m_MainChunk.GetOffset();
@@ -1011,7 +1172,7 @@ void CPrimeCacheApplication::CCacheBioseq::operator () (CBioseq & bioseq)
 
     CCache_blob blob;
     blob.SetTimestamp(timestamp_);
-    blob.Pack(*entry);
+    parent_->x_Pack(blob, *entry);
 
     parent_->m_MainChunk.OpenForWrite(parent_->m_CachePath);
     size_t offset = parent_->m_MainChunk.GetOffset();
@@ -1215,6 +1376,31 @@ int CPrimeCacheApplication::Run(void)
          m_SeqIdIndex.Open(NASNCacheFileName::GetBDBIndex(m_CachePath, CAsnIndex::e_seq_id), CBDB_RawFile::eReadWriteCreate);
      }}
 
+    if (args["compression"].AsString() == "zstd") {
+        m_Compression = CCache_blob::eZstd;
+    }
+    {{
+        /// Blobs already in the cache were packed with the cache's
+        /// dictionary, there can be only one
+        string dict_file = NASNCacheFileName::GetZstdDictionary(m_CachePath);
+        if (CFile(dict_file).Exists()) {
+            m_ZstdDict = CCache_blob_Dictionary::Load(dict_file);
+        }
+        if (args["zstd-dict"]) {
+            CRef<CCache_blob_Dictionary> dict =
+                CCache_blob_Dictionary::Load(args["zstd-dict"].AsString());
+            if (m_ZstdDict  &&  m_ZstdDict->GetId() != dict->GetId()) {
+                NCBI_THROW(CException, eUnknown,
+                           "cache already has a different zstd dictionary: " +
+                           dict_file);
+            }
+            if ( !m_ZstdDict ) {
+                dict->Save(dict_file);
+            }
+            m_ZstdDict = dict;
+        }
+    }}
+
     bool resuming_from_clean_wrapup = false;
     if (args["resume"]) {
         CFile output_file(args["oseq-ids"].AsString());
@@ -1303,7 +1489,10 @@ int CPrimeCacheApplication::Run(void)
 
     size_t count = 0;
     set<CSeq_id_Handle> ids;
-    if (args["input-manifest"]) {
+    if (args["convert"]) {
+        x_ConvertCache(args["convert"].AsString(), ostr, count);
+    }
+    else if (args["input-manifest"]) {
         CNcbiIstream& istr = args["input-manifest"].AsInputFile();
         string line;
         while (NcbiGetlineEOL(istr, line)) {
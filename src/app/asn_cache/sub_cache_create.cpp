@@ -1418,6 +1418,11 @@ void CAsnSubCacheCreateApplication::x_LocateBlobsInCache(TIndexMapById& index_ma
         CAsnIndex asn_index(CAsnIndex::e_main);
         asn_index.SetCacheSize(1 * 1024 * 1024 * 1024);
         asn_index.Open(cache_index, CBDB_RawFile::eReadOnly);
+        string dict_file =
+            NASNCacheFileName::GetZstdDictionary(dir_it->GetPath());
+        if (CFile(dict_file).Exists()) {
+            CCache_blob_Dictionary::Load(dict_file);
+        }
 
         if(one_by_one) {
             LOG_POST(Error << "  retrieval: one-by-one");
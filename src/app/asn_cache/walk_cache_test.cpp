@@ -132,7 +132,8 @@ int CWalkAsnCacheApplication::Run(void)
             
             output_stream << "Blob " << count << " at offset "
                 << chunk_object_stream.GetStreamPos() << '\n';
-            if ( CCache_blob::kMagicNum != the_blob.GetMagic() ) {
+            if ( CCache_blob::kMagicNum != the_blob.GetMagic()  &&
+                 CCache_blob::kMagicNumZstd != the_blob.GetMagic() ) {
                 LOG_POST( Error << "Blob number " << count << " has a bad magic number of 0x"
                             << std::hex << the_blob.GetMagic() );
             }
@@ -162,6 +162,7 @@ private:
     void xProcessGtf(const CArgs&, CNcbiIstream&, CNcbiOstream&);
     void xProcessNewick(const CArgs&, CNcbiIstream&, CNcbiOstream&);
     void xProcessGff3(const CArgs&, CNcbiIstream&, CNcbiOstream&);
+    void xProcessGff3Annot(const CArgs&, CGff3Reader&, CSeq_annot&, CNcbiOstream&);
     void xProcessGff2(const CArgs&, CNcbiIstream&, CNcbiOstream&);
     void xProcessGvf(const CArgs&, CNcbiIstream&, CNcbiOstream&);
     void xProcessAlignment(const CArgs&, CNcbiIstream&, CNcbiOstream&);
@@ -589,6 +590,10 @@ void CMultiReaderApp::Init()
         "old-code",
         "use old gff3 reader implementation",
         true );
+    arg_desc->AddFlag(
+        "streaming",
+        "gff3: convert and write one sequence region at a time",
+        true );
 
     //
     //  gff reader specific arguments:
@@ -1052,22 +1057,44 @@ void CMultiReaderApp::xProcessGff3(
     }
     //TestCanceler canceler;
     //reader.SetCanceler(&canceler);
-    reader.ReadSeqAnnots(annots, istr, m_pErrors.get());
-    for (CRef<CSeq_annot> it : annots) {
-        const auto& data = it->GetData();
-        if (data.IsFtable()) {
-            const auto& features = it->GetData().GetFtable();
-            if (features.empty()) {
-                continue;
+    if (m_iFlags & CGff3Reader::fStreaming) {
+        // write each region before reading the next one
+        CStreamLineReader lr(istr);
+        while (!lr.AtEOF()  &&  !reader.AtSequenceData()) {
+            CRef<CSeq_annot> pAnnot = reader.ReadSeqAnnot(lr, m_pErrors.get());
+            if (pAnnot) {
+                xProcessGff3Annot(args, reader, *pAnnot, ostr);
             }
-            auto pLocationMerger = reader.GetLocationMerger();
-            xPostProcessAnnot(args, *it, pLocationMerger.get());
         }
-        else {
-            xPostProcessAnnot(args, *it);
+        return;
+    }
+    reader.ReadSeqAnnots(annots, istr, m_pErrors.get());
+    for (CRef<CSeq_annot> it : annots) {
+        xProcessGff3Annot(args, reader, *it, ostr);
+    }
+}
+
+//  ----------------------------------------------------------------------------
+void CMultiReaderApp::xProcessGff3Annot(
+    const CArgs& args,
+    CGff3Reader& reader,
+    CSeq_annot& annot,
+    CNcbiOstream& ostr)
+//  ----------------------------------------------------------------------------
+{
+    const auto& data = annot.GetData();
+    if (data.IsFtable()) {
+        const auto& features = annot.GetData().GetFtable();
+        if (features.empty()) {
+            return;
         }
-        xWriteObject(args, *it, ostr);
+        auto pLocationMerger = reader.GetLocationMerger();
+        xPostProcessAnnot(args, annot, pLocationMerger.get());
     }
+    else {
+        xPostProcessAnnot(args, annot);
+    }
+    xWriteObject(args, annot, ostr);
 }
 
 //  ----------------------------------------------------------------------------
@@ -1448,6 +1475,9 @@ void CMultiReaderApp::xSetFlags(
         if ( args["gene-xrefs"] ) {
             m_iFlags |= CGff3Reader::fGeneXrefs;
         }
+        if ( args["streaming"] ) {
+            m_iFlags |= CGff3Reader::fStreaming;
+        }
         if (args["genbank-no-locus-tags"]) {
             m_iFlags |= CGff3Reader::fGeneXrefs;
             m_iFlags |= CGtfReader::fGenbankMode;
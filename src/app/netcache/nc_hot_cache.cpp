@@ -0,0 +1,418 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description: In-memory tier for small frequently read blobs.
+ *
+ */
+
+#include "nc_pch.hpp"
+
+#include "nc_hot_cache.hpp"
+#include "nc_db_info.hpp"
+#include "nc_stat.hpp"
+
+#include <list>
+#include <unordered_map>
+
+
+BEGIN_NCBI_SCOPE
+
+
+enum EHotSegment {
+    eHotWindow = 0,
+    eHotProbation,
+    eHotProtected,
+    eHotCntSegments
+};
+
+/// Number of independently locked parts of the cache
+static const Uint1 kHotCntShards = 32;
+/// Share of the memory budget given to LRU window, in percents
+static const Uint1 kHotWindowPct = 1;
+/// Share of the main part given to protected segment, in percents
+static const Uint1 kHotProtectedPct = 80;
+/// Memory taken by cached blob besides its key and contents (approximately)
+static const size_t kHotBlobOverhead = sizeof(SNCHotBlob) + 64;
+/// Assumed average size of cached blob, used to size frequency sketch
+static const size_t kHotAvgBlobSize = 1024;
+static const size_t kHotMinSketchWidth = 256;
+static const size_t kHotMaxSketchWidth = 1024 * 1024;
+static const Uint1 kHotSketchDepth = 4;
+static const Uint1 kHotMaxFrequency = 15;
+/// Sketch counters are halved after this many accesses per counter in a row
+static const size_t kHotSampleFactor = 10;
+
+
+typedef list< CSrvRef<SNCHotBlob> >                 THotList;
+typedef unordered_map<string, THotList::iterator>   THotIndex;
+
+struct SHotShard
+{
+    CMiniMutex    lock;
+    THotIndex     index;
+    THotList      lists[eHotCntSegments];
+    size_t        sizes[eHotCntSegments];
+    /// Count-min sketch, kHotSketchDepth rows of sketch_width counters
+    vector<Uint1> sketch;
+    size_t        sketch_width;
+    size_t        cnt_accesses;
+
+    SHotShard(void) : sketch_width(0), cnt_accesses(0)
+    {
+        memset(sizes, 0, sizeof(sizes));
+    }
+};
+
+
+static SHotShard s_HotShards[kHotCntShards];
+static Uint8 s_HotMemBudget = 0;
+static Uint8 s_HotMaxBlobSize = 0;
+static size_t s_HotSketchWidth = kHotMinSketchWidth;
+
+
+static inline Uint8
+s_HashKey(const string& key)
+{
+    return hash<string>()(key);
+}
+
+static inline SHotShard*
+s_GetShard(Uint8 key_hash)
+{
+    return &s_HotShards[(key_hash >> 40) % kHotCntShards];
+}
+
+static inline size_t
+s_SketchIndex(const SHotShard* shard, Uint8 key_hash, Uint1 row)
+{
+    // Double hashing gives independent enough positions in each row
+    Uint8 h2 = (key_hash * NCBI_CONST_UINT8(0x9E3779B97F4A7C15)) >> 32;
+    return row * shard->sketch_width
+           + ((key_hash + row * (h2 | 1)) & (shard->sketch_width - 1));
+}
+
+static Uint1
+s_GetFrequency(const SHotShard* shard, Uint8 key_hash)
+{
+    Uint1 result = kHotMaxFrequency;
+    for (Uint1 row = 0; row < kHotSketchDepth; ++row) {
+        result = min(result, shard->sketch[s_SketchIndex(shard, key_hash, row)]);
+    }
+    return result;
+}
+
+static void
+s_RecordAccess(SHotShard* shard, Uint8 key_hash)
+{
+    // Conservative update: only the smallest counters are incremented
+    Uint1 freq = s_GetFrequency(shard, key_hash);
+    if (freq < kHotMaxFrequency) {
+        for (Uint1 row = 0; row < kHotSketchDepth; ++row) {
+            Uint1& cnt = shard->sketch[s_SketchIndex(shard, key_hash, row)];
+            if (cnt == freq)
+                ++cnt;
+        }
+    }
+    if (++shard->cnt_accesses >= kHotSampleFactor * shard->sketch_width) {
+        NON_CONST_ITERATE(vector<Uint1>, it, shard->sketch) {
+            *it >>= 1;
+        }
+        shard->cnt_accesses /= 2;
+    }
+}
+
+static void
+s_ResizeSketch(SHotShard* shard)
+{
+    if (shard->sketch_width == s_HotSketchWidth)
+        return;
+    shard->sketch_width = s_HotSketchWidth;
+    shard->sketch.assign(kHotSketchDepth * shard->sketch_width, 0);
+    shard->cnt_accesses = 0;
+}
+
+static inline size_t
+s_GetShardBudget(void)
+{
+    return size_t(s_HotMemBudget / kHotCntShards);
+}
+
+static inline size_t
+s_GetWindowLimit(void)
+{
+    return s_GetShardBudget() * kHotWindowPct / 100;
+}
+
+static inline size_t
+s_GetMainLimit(void)
+{
+    return s_GetShardBudget() - s_GetWindowLimit();
+}
+
+static inline size_t
+s_GetMainSize(const SHotShard* shard)
+{
+    return shard->sizes[eHotProbation] + shard->sizes[eHotProtected];
+}
+
+static void
+s_MoveTo(SHotShard* shard, THotList::iterator it, Uint1 segment)
+{
+    SNCHotBlob* blob = *it;
+    shard->sizes[blob->segment] -= blob->mem_size;
+    shard->lists[segment].splice(shard->lists[segment].begin(),
+                                 shard->lists[blob->segment], it);
+    blob->segment = segment;
+    shard->sizes[segment] += blob->mem_size;
+}
+
+static void
+s_Remove(SHotShard* shard, THotList::iterator it)
+{
+    SNCHotBlob* blob = *it;
+    shard->sizes[blob->segment] -= blob->mem_size;
+    shard->index.erase(blob->key);
+    shard->lists[blob->segment].erase(it);
+}
+
+static void
+s_TouchBlob(SHotShard* shard, THotList::iterator it)
+{
+    SNCHotBlob* blob = *it;
+    if (blob->segment != eHotProbation) {
+        s_MoveTo(shard, it, blob->segment);
+        return;
+    }
+    // Second access in the main part makes blob protected
+    s_MoveTo(shard, it, eHotProtected);
+    size_t protected_limit = s_GetMainLimit() * kHotProtectedPct / 100;
+    THotList& prot_list = shard->lists[eHotProtected];
+    while (shard->sizes[eHotProtected] > protected_limit
+           &&  prot_list.size() > 1)
+    {
+        s_MoveTo(shard, --prot_list.end(), eHotProbation);
+    }
+}
+
+static THotList::iterator
+s_GetMainVictim(SHotShard* shard)
+{
+    if (!shard->lists[eHotProbation].empty())
+        return --shard->lists[eHotProbation].end();
+    return --shard->lists[eHotProtected].end();
+}
+
+/// Move blobs that don't fit into the window to the main part if TinyLFU
+/// estimates them as more valuable than the main part's victims.
+static void
+s_EvictFromWindow(SHotShard* shard)
+{
+    size_t window_limit = s_GetWindowLimit();
+    size_t main_limit = s_GetMainLimit();
+    THotList& window = shard->lists[eHotWindow];
+    while (shard->sizes[eHotWindow] > window_limit  &&  !window.empty()) {
+        THotList::iterator cand = --window.end();
+        size_t cand_size = (*cand)->mem_size;
+        bool admit = cand_size <= main_limit;
+        if (admit) {
+            Uint1 cand_freq = s_GetFrequency(shard, s_HashKey((*cand)->key));
+            while (s_GetMainSize(shard) + cand_size > main_limit) {
+                THotList::iterator victim = s_GetMainVictim(shard);
+                if (s_GetFrequency(shard, s_HashKey((*victim)->key)) >= cand_freq) {
+                    admit = false;
+                    break;
+                }
+                s_Remove(shard, victim);
+            }
+        }
+        if (admit)
+            s_MoveTo(shard, cand, eHotProbation);
+        else
+            s_Remove(shard, cand);
+    }
+}
+
+/// Drop least recently used blobs until the shard fits into its budget.
+static void
+s_TrimShard(SHotShard* shard)
+{
+    THotList& window = shard->lists[eHotWindow];
+    while (shard->sizes[eHotWindow] > s_GetWindowLimit()  &&  !window.empty()) {
+        s_Remove(shard, --window.end());
+    }
+    while (s_GetMainSize(shard) > s_GetMainLimit()) {
+        s_Remove(shard, s_GetMainVictim(shard));
+    }
+}
+
+static inline bool
+s_IsSameVersion(const SNCHotBlob* blob, const SNCBlobVerData* ver_data)
+{
+    return blob->create_time == ver_data->create_time
+           &&  blob->create_server == ver_data->create_server
+           &&  blob->create_id == ver_data->create_id
+           &&  blob->data.size() == ver_data->size;
+}
+
+
+void
+CNCHotCache::Configure(Uint8 mem_budget, Uint8 max_blob_size)
+{
+    size_t width = size_t(mem_budget / kHotCntShards / kHotAvgBlobSize);
+    width = max(kHotMinSketchWidth, min(kHotMaxSketchWidth, width));
+    size_t pow2_width = kHotMinSketchWidth;
+    while (pow2_width < width)
+        pow2_width *= 2;
+
+    for (Uint1 i = 0; i < kHotCntShards; ++i) {
+        s_HotShards[i].lock.Lock();
+    }
+    s_HotMemBudget = mem_budget;
+    s_HotMaxBlobSize = max_blob_size;
+    s_HotSketchWidth = pow2_width;
+    for (Uint1 i = 0; i < kHotCntShards; ++i) {
+        SHotShard* shard = &s_HotShards[i];
+        if (mem_budget != 0)
+            s_ResizeSketch(shard);
+        s_TrimShard(shard);
+        shard->lock.Unlock();
+    }
+}
+
+Uint8
+CNCHotCache::GetMemBudget(void)
+{
+    return s_HotMemBudget;
+}
+
+Uint8
+CNCHotCache::GetMaxBlobSize(void)
+{
+    return s_HotMaxBlobSize;
+}
+
+bool
+CNCHotCache::IsEnabled(void)
+{
+    return ACCESS_ONCE(s_HotMemBudget) != 0;
+}
+
+CSrvRef<SNCHotBlob>
+CNCHotCache::Get(const string& key, const SNCBlobVerData* ver_data)
+{
+    CSrvRef<SNCHotBlob> result;
+    Uint8 key_hash = s_HashKey(key);
+    SHotShard* shard = s_GetShard(key_hash);
+
+    shard->lock.Lock();
+    if (s_HotMemBudget != 0) {
+        s_RecordAccess(shard, key_hash);
+        THotIndex::iterator it = shard->index.find(key);
+        if (it != shard->index.end()) {
+            if (s_IsSameVersion(*it->second, ver_data)) {
+                result = *it->second;
+                s_TouchBlob(shard, it->second);
+            }
+            else {
+                s_Remove(shard, it->second);
+            }
+        }
+    }
+    shard->lock.Unlock();
+
+    CNCStat::HotCacheRead(result.NotNull());
+    return result;
+}
+
+void
+CNCHotCache::Put(const string& key,
+                 const SNCBlobVerData* ver_data,
+                 const char* data,
+                 Uint4 data_size)
+{
+    if (!IsEnabled()  ||  data_size > ACCESS_ONCE(s_HotMaxBlobSize)
+        ||  data_size != ver_data->size)
+    {
+        return;
+    }
+
+    CSrvRef<SNCHotBlob> blob(new SNCHotBlob());
+    blob->key = key;
+    blob->create_time = ver_data->create_time;
+    blob->create_server = ver_data->create_server;
+    blob->create_id = ver_data->create_id;
+    blob->data.assign(data, data_size);
+    blob->mem_size = key.size() + data_size + kHotBlobOverhead;
+    blob->segment = eHotWindow;
+
+    Uint8 key_hash = s_HashKey(key);
+    SHotShard* shard = s_GetShard(key_hash);
+    shard->lock.Lock();
+    if (s_HotMemBudget != 0) {
+        THotIndex::iterator it = shard->index.find(key);
+        if (it != shard->index.end()) {
+            s_Remove(shard, it->second);
+        }
+        THotList& window = shard->lists[eHotWindow];
+        window.push_front(blob);
+        shard->index[key] = window.begin();
+        shard->sizes[eHotWindow] += blob->mem_size;
+        s_EvictFromWindow(shard);
+    }
+    shard->lock.Unlock();
+}
+
+void
+CNCHotCache::Invalidate(const string& key)
+{
+    if (!IsEnabled())
+        return;
+
+    SHotShard* shard = s_GetShard(s_HashKey(key));
+    shard->lock.Lock();
+    THotIndex::iterator it = shard->index.find(key);
+    if (it != shard->index.end()) {
+        s_Remove(shard, it->second);
+    }
+    shard->lock.Unlock();
+}
+
+void
+CNCHotCache::GetSizes(Uint8& mem_size, Uint8& cnt_blobs)
+{
+    mem_size = cnt_blobs = 0;
+    for (Uint1 i = 0; i < kHotCntShards; ++i) {
+        SHotShard* shard = &s_HotShards[i];
+        shard->lock.Lock();
+        for (Uint1 seg = 0; seg < eHotCntSegments; ++seg) {
+            mem_size += shard->sizes[seg];
+        }
+        cnt_blobs += shard->index.size();
+        shard->lock.Unlock();
+    }
+}
+
+
+END_NCBI_SCOPE
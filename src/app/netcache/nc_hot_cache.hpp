@@ -0,0 +1,99 @@
+#ifndef NETCACHE__NC_HOT_CACHE__HPP
+#define NETCACHE__NC_HOT_CACHE__HPP
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description: In-memory tier for small frequently read blobs.
+ *
+ */
+
+
+#include "srv_ref.hpp"
+
+
+BEGIN_NCBI_SCOPE
+
+
+struct SNCBlobVerData;
+
+
+/// Whole small blob kept in memory by CNCHotCache.
+struct SNCHotBlob : public CObject
+{
+    string  key;
+    Uint8   create_time;
+    Uint8   create_server;
+    Uint4   create_id;
+    string  data;
+    size_t  mem_size;
+    Uint1   segment;
+};
+
+
+/// Optional in-memory tier of the blob storage holding contents of small
+/// frequently read blobs so that they are not read from database files
+/// again when blob's metadata is re-created.
+///
+/// Admission follows W-TinyLFU: new blobs go to a small LRU window, blob
+/// evicted from the window replaces the LRU victim of the main segmented
+/// LRU only if it's estimated as more frequently accessed than the victim.
+/// Access frequencies are kept in 4-bit count-min sketch which is
+/// periodically halved to age out old popularity.
+///
+/// Cached contents are checked against the blob's version identity
+/// (create_time, create_server and create_id) on each lookup, so a changed
+/// blob is never served from here even if invalidation didn't happen.
+class CNCHotCache
+{
+public:
+    /// Set memory budget and maximum size of blob that can be cached.
+    /// Zero budget disables the cache and drops everything from it.
+    static void Configure(Uint8 mem_budget, Uint8 max_blob_size);
+    static Uint8 GetMemBudget(void);
+    static Uint8 GetMaxBlobSize(void);
+    static bool IsEnabled(void);
+
+    /// Get contents of the given version of the blob. Every call is counted
+    /// as an access to the blob for the admission policy.
+    static CSrvRef<SNCHotBlob> Get(const string& key,
+                                   const SNCBlobVerData* ver_data);
+    /// Offer contents of the blob just read from database.
+    static void Put(const string& key,
+                    const SNCBlobVerData* ver_data,
+                    const char* data,
+                    Uint4 data_size);
+    /// Drop blob contents, e.g. when blob is re-written or deleted.
+    static void Invalidate(const string& key);
+
+    static void GetSizes(Uint8& mem_size, Uint8& cnt_blobs);
+
+private:
+    CNCHotCache(void);
+};
+
+
+END_NCBI_SCOPE
+
+#endif /* NETCACHE__NC_HOT_CACHE__HPP */
@@ -251,6 +251,17 @@ CNCStat::x_ClearStats(void)
     m_PeerSynOps = 0;
     m_CntCleanedFiles = 0;
     m_CntFailedFiles = 0;
+    // Counters are incremented without m_StatLock, so the vectors
+    // must not be reallocated once they are created.
+    size_t cnt_slots = size_t(CNCDistributionConf::GetMaxSlotNumber()) + 1;
+    m_KeyMapLockFree.resize(cnt_slots);
+    m_KeyMapLocks.resize(cnt_slots);
+    m_KeyMapContended.resize(cnt_slots);
+    fill(m_KeyMapLockFree.begin(), m_KeyMapLockFree.end(), 0);
+    fill(m_KeyMapLocks.begin(), m_KeyMapLocks.end(), 0);
+    fill(m_KeyMapContended.begin(), m_KeyMapContended.end(), 0);
+    m_HotCacheHits = 0;
+    m_HotCacheMisses = 0;
     m_CmdLens.Initialize();
     m_CmdsByName.clear();
     m_LensByStatus.clear();
@@ -360,6 +371,14 @@ CNCStat::x_AddStats(CNCStat* src_stat)
     m_PeerSynOps += src_stat->m_PeerSynOps;
     m_CntCleanedFiles += src_stat->m_CntCleanedFiles;
     m_CntFailedFiles += src_stat->m_CntFailedFiles;
+    size_t cnt_slots = min(m_KeyMapLocks.size(), src_stat->m_KeyMapLocks.size());
+    for (size_t i = 0; i < cnt_slots; ++i) {
+        m_KeyMapLockFree[i] += src_stat->m_KeyMapLockFree[i];
+        m_KeyMapLocks[i] += src_stat->m_KeyMapLocks[i];
+        m_KeyMapContended[i] += src_stat->m_KeyMapContended[i];
+    }
+    m_HotCacheHits += src_stat->m_HotCacheHits;
+    m_HotCacheMisses += src_stat->m_HotCacheMisses;
     m_CheckedRecs.AddValues(src_stat->m_CheckedRecs);
     m_MovedRecs.AddValues(src_stat->m_MovedRecs);
     m_MovedSize.AddValues(src_stat->m_MovedSize);
@@ -578,6 +597,34 @@ CNCStat::DiskDataRead(size_t data_size)
     AtomicAdd(s_Stat()->m_DiskDataRead, data_size);
 }
 
+void
+CNCStat::KeyMapLockFreeRead(Uint2 slot)
+{
+    CNCStat* stat = s_Stat();
+    if (slot < stat->m_KeyMapLockFree.size())
+        AtomicAdd(stat->m_KeyMapLockFree[slot], 1);
+}
+
+void
+CNCStat::KeyMapLocked(Uint2 slot, bool contended)
+{
+    CNCStat* stat = s_Stat();
+    if (slot < stat->m_KeyMapLocks.size()) {
+        AtomicAdd(stat->m_KeyMapLocks[slot], 1);
+        if (contended)
+            AtomicAdd(stat->m_KeyMapContended[slot], 1);
+    }
+}
+
+void
+CNCStat::HotCacheRead(bool hit)
+{
+    if (hit)
+        AtomicAdd(s_Stat()->m_HotCacheHits, 1);
+    else
+        AtomicAdd(s_Stat()->m_HotCacheMisses, 1);
+}
+
 void
 CNCStat::DiskBlobWrite(Uint8 blob_size)
 {
@@ -817,6 +864,20 @@ CNCStat::PrintToLogs(CTempString stat_name)
         .PrintParam("avg_moved_recs", m_MovedRecs.GetAverage())
         .PrintParam("moved_size", m_MovedSize.GetSum())
         .PrintParam("avg_moved_size", m_MovedSize.GetAverage());
+    Uint8 key_lockfree = 0, key_locks = 0, key_contended = 0;
+    for (size_t i = 0; i < m_KeyMapLocks.size(); ++i) {
+        key_lockfree += m_KeyMapLockFree[i];
+        key_locks += m_KeyMapLocks[i];
+        key_contended += m_KeyMapContended[i];
+    }
+    diag.PrintParam("keymap_lockfree", key_lockfree)
+        .PrintParam("keymap_locks", key_locks)
+        .PrintParam("keymap_contended", key_contended);
+    Uint8 hot_reads = m_HotCacheHits + m_HotCacheMisses;
+    diag.PrintParam("hot_cache_hits", m_HotCacheHits)
+        .PrintParam("hot_cache_misses", m_HotCacheMisses)
+        .PrintParam("hot_cache_hit_pct",
+                    hot_reads == 0 ? 0 : m_HotCacheHits * 100 / hot_reads);
     diag.Flush();
 
     CSrvPrintProxy proxy(ctx);
@@ -1096,6 +1157,21 @@ CNCStat::PrintToSocket(CSrvSocketTask* sock)
                     << g_ToSizeStr(m_MovedSize.GetSum()) << " (per file "
                     << g_ToSmartStr(m_MovedRecs.GetAverage()) << " recs, "
                     << g_ToSizeStr(m_MovedSize.GetAverage()) << ")" << endl;
+    if (m_HotCacheHits + m_HotCacheMisses != 0) {
+        proxy << "Hot cache reads - "
+                    << g_ToSmartStr(m_HotCacheHits) << " hits, "
+                    << g_ToSmartStr(m_HotCacheMisses) << " misses, "
+                    << m_HotCacheHits * 100 / (m_HotCacheHits + m_HotCacheMisses)
+                    << "% hit rate" << endl;
+    }
+    for (size_t i = 0; i < m_KeyMapLocks.size(); ++i) {
+        if (m_KeyMapLockFree[i] == 0  &&  m_KeyMapLocks[i] == 0)
+            continue;
+        proxy << "Key map slot " << i << " - "
+                    << g_ToSmartStr(m_KeyMapLockFree[i]) << " lock-free reads, "
+                    << g_ToSmartStr(m_KeyMapLocks[i]) << " locks ("
+                    << g_ToSmartStr(m_KeyMapContended[i]) << " contended)" << endl;
+    }
     proxy << endl;
 
     m_SrvStat->PrintToSocket(proxy);
@@ -103,6 +103,13 @@ public:
     static void DiskBlobWrite(Uint8 blob_size);
     static void DBFileCleaned(bool success, Uint4 seen_recs,
                               Uint4 moved_recs, Uint4 moved_size);
+    /// Lookup in the blob key map of the slot was done without locking
+    static void KeyMapLockFreeRead(Uint2 slot);
+    /// Lock of the blob key map of the slot was taken; contended is TRUE
+    /// if it was held by another thread at the moment
+    static void KeyMapLocked(Uint2 slot, bool contended);
+    /// Blob contents was looked up in the hot blob cache
+    static void HotCacheRead(bool hit);
     static void SaveCurStateStat(const SNCStateStat& state);
 
 public:
@@ -157,6 +164,12 @@ private:
     Uint8 m_PeerSynOps;
     Uint8 m_CntCleanedFiles;
     Uint8 m_CntFailedFiles;
+    /// Key map access counters indexed by slot number
+    vector<Uint8> m_KeyMapLockFree;
+    vector<Uint8> m_KeyMapLocks;
+    vector<Uint8> m_KeyMapContended;
+    Uint8 m_HotCacheHits;
+    Uint8 m_HotCacheMisses;
     TSrvTimeTerm m_CmdLens;
     TCmdCountsMap m_CmdsByName;
     TStatusCmdLens m_LensByStatus;
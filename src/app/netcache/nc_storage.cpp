@@ -41,6 +41,7 @@
 #include "nc_storage_blob.hpp"
 #include "sync_log.hpp"
 #include "nc_stat.hpp"
+#include "nc_hot_cache.hpp"
 #include "logging.hpp"
 #include "peer_control.hpp"
 
@@ -91,6 +92,8 @@ static const char* kNCStorage_MinRecNoSaveParam = "min_rec_no_save_period";
 static const char* kNCStorage_FailedWriteSize   = "failed_write_blob_key_count";
 static const char* kNCStorage_MaxBlobSizeStore  = "max_blob_size_store";
 static const char* kNCStorage_WbMemRelease      = "task_priority_wb_memrelease";
+static const char* kNCStorage_HotCacheSize     = "hot_cache_size";
+static const char* kNCStorage_HotCacheMaxBlob  = "hot_cache_max_blob_size";
 
 
 // storage file type signatures
@@ -170,10 +173,37 @@ typedef std::set<SNCCacheData*, SCacheKeyCompare>   TKeyMap;
 
 #endif  // __NC_CACHEDATA_INTR_SET
 
+typedef vector<SNCCacheData*> TCacheDataList;
+
+/// Sorted copy of bucket's key map which is searched without any locking.
+/// Writers change only key_map (under the lock) and mark the bucket as dirty,
+/// index is rebuilt by CExpiredCleaner once per pass over time buckets.
+/// Old index is deleted via RCU, cache datas erased from key_map are deleted
+/// via RCU only after the index that could point to them is replaced.
+struct SKeyIndex : public CSrvRCUUser
+{
+    TCacheDataList datas;
+
+    virtual void ExecuteRCU(void);
+};
+
+struct SKeyIndexCompare
+{
+    bool operator() (const SNCCacheData* x, const string& key) const
+    {
+        return x->key < key;
+    }
+};
+
 struct SBucketCache
 {
     CMiniMutex   lock;
     TKeyMap      key_map;
+    SKeyIndex*   key_index;
+    bool         index_dirty;
+    TCacheDataList  erased;
+
+    SBucketCache(void) : key_index(NULL), index_dirty(true) {}
 };
 typedef map<Uint2, SBucketCache*> TBucketCacheMap;
 
@@ -584,6 +614,12 @@ s_ReadVariableParams(const CNcbiRegistry& reg)
     SetWBHardSizeLimit(NStr::StringToUInt8_DataSize(reg.GetString(
                        kNCStorage_RegSection, "write_back_hard_size_limit", "4 GB")));
 
+    CNCHotCache::Configure(
+        NStr::StringToUInt8_DataSize(reg.GetString(
+                       kNCStorage_RegSection, kNCStorage_HotCacheSize, "0")),
+        NStr::StringToUInt8_DataSize(reg.GetString(
+                       kNCStorage_RegSection, kNCStorage_HotCacheMaxBlob, "16 KB")));
+
     int to2 = reg.GetInt(kNCStorage_RegSection, "write_back_timeout", 1000);
     int to1 = reg.GetInt(kNCStorage_RegSection, "write_back_timeout_startup", to2);
     SetWBWriteTimeout( CNCServer::IsInitiallySynced() ? to2 : to1, to2);
@@ -1383,6 +1419,10 @@ void CNCBlobStorage::WriteSetup(CSrvSocketTask& task)
     task.WriteText(eol).WriteText(kNCStorage_MaxBlobSizeStore).WriteText(str).WriteText(iss)
                                                    .WriteText(NStr::UInt8ToString_DataSize( s_MaxBlobSizeStore)).WriteText(eos);
     task.WriteText(eol).WriteText(kNCStorage_MaxBlobSizeStore).WriteText(is ).WriteNumber( s_MaxBlobSizeStore);
+    task.WriteText(eol).WriteText(kNCStorage_HotCacheSize    ).WriteText(str).WriteText(iss)
+                                                   .WriteText(NStr::UInt8ToString_DataSize( CNCHotCache::GetMemBudget())).WriteText(eos);
+    task.WriteText(eol).WriteText(kNCStorage_HotCacheSize    ).WriteText(is ).WriteNumber( CNCHotCache::GetMemBudget());
+    task.WriteText(eol).WriteText(kNCStorage_HotCacheMaxBlob ).WriteText(is ).WriteNumber( CNCHotCache::GetMaxBlobSize());
     task.WriteText(eol).WriteText("db_limit_percentage_alert" ).WriteText(is ).WriteNumber( s_WarnLimitOnPct);
     task.WriteText(eol).WriteText("db_limit_percentage_alert_delta").WriteText(is).WriteNumber(s_WarnLimitOffPct);
     task.WriteText(eol).WriteText("write_back_soft_size_limit").WriteText(str).WriteText(iss)
@@ -1448,6 +1488,10 @@ void CNCBlobStorage::WriteBlobStat(CSrvSocketTask& task)
     task.WriteText(eol).WriteText("InCache_count").WriteText( is).WriteNumber( cache_count);
     task.WriteText(eol).WriteText("TimeTable_count").WriteText( is).WriteNumber( timetable_count);
     task.WriteText(eol).WriteText("Purge_count").WriteText( is).WriteNumber( CNCBlobAccessor::GetPurgeCount());
+    Uint8 hot_size = 0, hot_count = 0;
+    CNCHotCache::GetSizes(hot_size, hot_count);
+    task.WriteText(eol).WriteText("HotCache_size").WriteText(iss).WriteText(NStr::UInt8ToString_DataSize(hot_size)).WriteText(eos);
+    task.WriteText(eol).WriteText("HotCache_count").WriteText( is).WriteNumber( hot_count);
 
 #if __NC_CACHEDATA_ALL_MONITOR
     size_t ncaches_count = 0;
@@ -1771,12 +1815,93 @@ s_GetBucketCache(Uint2 bucket)
     return it->second;
 }
 
+static inline Uint2
+s_GetSlotByTimeBucket(Uint2 time_bucket)
+{
+    return Uint2((time_bucket - 1) / CNCDistributionConf::GetCntSlotBuckets() + 1);
+}
+
+static void
+s_LockKeyMap(SBucketCache* cache, Uint2 time_bucket)
+{
+    bool contended = !cache->lock.TryLock();
+    if (contended) {
+        cache->lock.Lock();
+    }
+    CNCStat::KeyMapLocked(s_GetSlotByTimeBucket(time_bucket), contended);
+}
+
+static SNCCacheData*
+s_FindKeyLockFree(SBucketCache* cache, const string& key)
+{
+    SKeyIndex* index = ACCESS_ONCE(cache->key_index);
+    if (!index) {
+        return NULL;
+    }
+    TCacheDataList::const_iterator it = lower_bound(index->datas.begin(),
+                                                    index->datas.end(),
+                                                    key, SKeyIndexCompare());
+    if (it == index->datas.end()  ||  (*it)->key != key) {
+        return NULL;
+    }
+    SNCCacheData* data = *it;
+    CNCBlobStorage::ReferenceCacheData(data);
+    // Pairs with the check of ref_cnt in ReleaseCacheData(): either it sees
+    // our reference or we see the flag.
+    if (ACCESS_ONCE(data->key_removed)) {
+        CNCBlobStorage::ReleaseCacheData(data);
+        return NULL;
+    }
+    return data;
+}
+
+static void
+s_RebuildKeyIndex(Uint2 time_bucket)
+{
+    SBucketCache* cache = s_GetBucketCache(time_bucket);
+    if (!ACCESS_ONCE(cache->index_dirty)) {
+        return;
+    }
+
+    SKeyIndex* new_index = new SKeyIndex();
+    TCacheDataList erased;
+    s_LockKeyMap(cache, time_bucket);
+    new_index->datas.reserve(cache->key_map.size());
+    ITERATE(TKeyMap, it, cache->key_map) {
+#if __NC_CACHEDATA_INTR_SET
+        new_index->datas.push_back(const_cast<SNCCacheData*>(&*it));
+#else
+        new_index->datas.push_back(*it);
+#endif
+    }
+    SKeyIndex* old_index = cache->key_index;
+    AtomicCAS(cache->key_index, old_index, new_index);
+    erased.swap(cache->erased);
+    cache->index_dirty = false;
+    cache->lock.Unlock();
+
+    if (old_index) {
+        old_index->CallRCU();
+    }
+    ITERATE(TCacheDataList, it, erased) {
+        (*it)->CallRCU();
+    }
+}
+
 static SNCCacheData*
 s_GetKeyCacheData(Uint2 time_bucket, const string& key, bool need_create)
 {
     SBucketCache* cache = s_GetBucketCache(time_bucket);
     SNCCacheData* data = NULL;
-    cache->lock.Lock();
+    if (!need_create) {
+        data = s_FindKeyLockFree(cache, key);
+        if (data) {
+            CNCStat::KeyMapLockFreeRead(s_GetSlotByTimeBucket(time_bucket));
+            return data;
+        }
+        // Key could be added after the index was built
+    }
+    s_LockKeyMap(cache, time_bucket);
 #if __NC_CACHEDATA_INTR_SET
     if (need_create) {
         TKeyMap::insert_commit_data commit_data;
@@ -1787,6 +1912,7 @@ s_GetKeyCacheData(Uint2 time_bucket, const string& key, bool need_create)
             data->key = key;
             data->time_bucket = time_bucket;
             cache->key_map.insert_unique_commit(*data, commit_data);
+            cache->index_dirty = true;
             AtomicAdd(s_CurKeysCnt, 1);
 
 #if __NC_CACHEDATA_ALL_MONITOR
@@ -1825,6 +1951,7 @@ s_GetKeyCacheData(Uint2 time_bucket, const string& key, bool need_create)
         data->key = key;
         data->time_bucket = time_bucket;
         cache->key_map.insert(data);
+        cache->index_dirty = true;
         AtomicAdd(s_CurKeysCnt, 1);
 
 #if __NC_CACHEDATA_ALL_MONITOR
@@ -1860,6 +1987,11 @@ CNCAlerts::Register(CNCAlerts::eDebugReleaseCacheData1, "ref_cnt is 0");
     if (data->ref_cnt.Add(-1) != 0) {
         return;
     }
+    // Key of a stored blob stays in the map, no need to lock it. Whoever
+    // clears coord holds a reference and will come here again.
+    if (!data->coord.empty()) {
+        return;
+    }
 
     Uint2 time_bucket = data->time_bucket;
     TBucketCacheMap::const_iterator it = s_BucketsCache.find(time_bucket);
@@ -1867,7 +1999,7 @@ CNCAlerts::Register(CNCAlerts::eDebugReleaseCacheData1, "ref_cnt is 0");
         return;
     }
     SBucketCache* cache = it->second;
-    cache->lock.Lock();
+    s_LockKeyMap(cache, time_bucket);
 
 #ifdef _DEBUG
     if (!data->coord.empty() && data->dead_time == 0) {
@@ -1886,11 +2018,25 @@ CNCAlerts::Register(CNCAlerts::eDebugReleaseCacheData1, "ref_cnt is 0");
         cache->lock.Unlock();
         return;
     }
+    // Lock-free lookup could take a reference meanwhile, see
+    // s_FindKeyLockFree().
+    AtomicCAS(data->key_removed, false, true);
+    if (data->ref_cnt.Get() != 0) {
+        ACCESS_ONCE(data->key_removed) = false;
+        cache->lock.Unlock();
+        return;
+    }
 #if __NC_CACHEDATA_INTR_SET
     size_t n = cache->key_map.erase(*data);
 #else
     size_t n = cache->key_map.erase(data);
 #endif
+    if (n != 0) {
+        // Published index can still point to data, it will be deleted
+        // when the index is rebuilt.
+        cache->erased.push_back(data);
+        cache->index_dirty = true;
+    }
     cache->lock.Unlock();
 
 #if __NC_CACHEDATA_ALL_MONITOR
@@ -1902,7 +2048,6 @@ CNCAlerts::Register(CNCAlerts::eDebugReleaseCacheData1, "ref_cnt is 0");
 
     if (n != 0) {
         AtomicSub(s_CurKeysCnt, 1);
-        data->CallRCU();
     }
 #ifdef _DEBUG
     else {
@@ -3904,6 +4049,8 @@ CExpiredCleaner::x_CleanNextBucket(void)
     table->lock.Unlock();
 
     if (m_BatchSize == 0) {
+        // publish key map changes made since the last pass
+        s_RebuildKeyIndex(m_CurBucket);
         // goto next bucket
         ++m_CurBucket;
         SetRunnable();
@@ -4730,4 +4877,10 @@ SNCCacheData::ExecuteRCU(void)
     delete this;
 }
 
+void
+SKeyIndex::ExecuteRCU(void)
+{
+    delete this;
+}
+
 END_NCBI_SCOPE
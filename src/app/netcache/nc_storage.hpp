@@ -68,6 +68,9 @@ public:
     Uint4 chunk_size;
     CAtomicCounter_WithAutoInit ref_cnt;
     CMiniMutex lock;
+    /// Set when the data is going to be erased from the key map. Checked by
+    /// lock-free lookups after they take a reference.
+    bool key_removed;
 
     SNCCacheData(void);
     ~SNCCacheData(void);
@@ -195,6 +198,7 @@ SNCCacheData::SNCCacheData(void)
       time_bucket(0),
       map_size(0),
       chunk_size(0),
+      key_removed(false),
       ver_mgr(NULL)
 {
 #if __NC_CACHEDATA_MONITOR
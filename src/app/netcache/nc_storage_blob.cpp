@@ -603,6 +603,7 @@ CWriteBackControl::ResetStatCounters(void)
 void
 CNCBlobVerManager::x_DeleteCurVersion(void)
 {
+    CNCHotCache::Invalidate(m_Key);
     m_CacheData->coord.clear();
     m_CacheData->dead_time = 0;
     CNCBlobStorage::ChangeCacheDeadTime(m_CacheData);
@@ -928,6 +929,8 @@ CNCBlobVerManager::FinalizeWriting(SNCBlobVerData* ver_data)
         &&  s_IsCurVerOlder(m_CurVersion, ver_data))
     {
         old_ver.Swap(m_CurVersion);
+        // Written by client or received from peer, contents has changed
+        CNCHotCache::Invalidate(m_Key);
         m_CacheData->coord = m_CurVersion->coord;
         m_CacheData->dead_time = m_CurVersion->dead_time;
         if (m_CacheData->saved_dead_time != m_CacheData->dead_time) {
@@ -1547,6 +1550,7 @@ CNCBlobAccessor::Deinitialize(void)
 
     m_NewData.Reset();
     m_CurData.Reset();
+    m_HotBlob.Reset();
     if (m_VerManager) {
         m_VerManager->Release();
         m_VerManager = NULL;
@@ -1618,7 +1622,8 @@ CNCBlobAccessor::GetReadMemSize(void)
     }
     if (m_Buffer) {
         if (m_ChunkPos < m_ChunkSize) {
-            m_Buffer = m_CurData->chunks[m_CurChunk];
+            if (!m_HotBlob)
+                m_Buffer = m_CurData->chunks[m_CurChunk];
             return m_ChunkSize - m_ChunkPos;
         }
         ++m_CurChunk;
@@ -1635,6 +1640,19 @@ CNCBlobAccessor::GetReadMemSize(void)
         return m_ChunkSize - m_ChunkPos;
     }
 
+    // Only whole small blobs are kept in the hot cache
+    bool hot_candidate = m_CurData->cnt_chunks == 1
+                         &&  CNCHotCache::IsEnabled()
+                         &&  m_CurData->size <= CNCHotCache::GetMaxBlobSize();
+    if (hot_candidate) {
+        m_HotBlob = CNCHotCache::Get(m_BlobKey, m_CurData);
+        if (m_HotBlob) {
+            m_Buffer = &m_HotBlob->data[0];
+            m_ChunkSize = Uint4(need_size);
+            return m_ChunkSize - m_ChunkPos;
+        }
+    }
+
     if (!m_ChunkMaps) {
         m_ChunkMaps = new SNCChunkMaps(m_CurData->map_size);
         s_AddCurrentMem(s_CalcChunkMapsSize(m_CurData->map_size));
@@ -1651,6 +1669,9 @@ CNCBlobAccessor::GetReadMemSize(void)
     }
 
     ACCESS_ONCE(m_CurData->chunks[m_CurChunk]) = m_Buffer;
+    if (hot_candidate) {
+        CNCHotCache::Put(m_BlobKey, m_CurData, m_Buffer, m_ChunkSize);
+    }
     return m_ChunkSize - m_ChunkPos;
 }
 
@@ -30,6 +30,7 @@
 
 
 #include "nc_db_info.hpp"
+#include "nc_hot_cache.hpp"
 
 
 BEGIN_NCBI_SCOPE
@@ -248,6 +249,8 @@ private:
     Uint4       m_ChunkSize;
     Uint8       m_SizeRead;
     char*       m_Buffer;
+    /// Blob contents taken from CNCHotCache, m_Buffer points into it
+    CSrvRef<SNCHotBlob> m_HotBlob;
     CSrvTask*   m_Owner;
 };
 
@@ -439,7 +439,8 @@ CNetScheduleHandler::SCommandMap CNetScheduleHandler::sm_CommandMap[] = {
           { "ip",                eNSPT_Str, eNSPA_Optional, ""  },
           { "sid",               eNSPT_Str, eNSPA_Optional, ""  },
           { "ncbi_phid",         eNSPT_Str, eNSPA_Optional, ""  },
-          { "prioritized_aff",   eNSPT_Int, eNSPA_Optional, "0" } } },
+          { "prioritized_aff",   eNSPT_Int, eNSPA_Optional, "0" },
+          { "count",             eNSPT_Int, eNSPA_Optional, "0" } } },
     { "PUT",           { &CNetScheduleHandler::x_ProcessPut,
                          eNS_Queue | eNS_Worker | eNS_Program },
         { { "job_key",           eNSPT_Id,  eNSPA_Required      },
@@ -2146,6 +2147,10 @@ void CNetScheduleHandler::x_ProcessGetJob(CQueue* q)
         x_CheckNonAnonymousClient("use GET2 command");
         x_CheckPortAndTimeout();
         x_CheckGetParameters();
+
+        // Do not let one worker node take too many jobs at once
+        if (m_CommandArguments.count > m_Server->GetMaxGetJobs())
+            m_CommandArguments.count = m_Server->GetMaxGetJobs();
     }
     else {
         // The affinity options are only for the second version of the command
@@ -2217,6 +2222,50 @@ void CNetScheduleHandler::x_ProcessGetJob(CQueue* q)
         x_SetCmdRequestStatus(eStatus_BadRequest);
         x_WriteMessage("ERR:ePrefAffExpired:" + kEndOfResponse);
     } else {
+        // GET2 with count > 1: the first job is picked as usual (it may
+        // register the client as waiting), the rest are added without
+        // waiting and all of them go in one reply.
+        vector<CJob>    jobs;
+        if (cmdv2 && m_CommandArguments.count > 1) {
+            vector<unsigned int>    job_ids;
+
+            if (job.GetId()) {
+                jobs.push_back(job);
+                job_ids.push_back(job.GetId());
+            }
+            while (!jobs.empty() && jobs.size() < m_CommandArguments.count) {
+                CJob        next_job;
+                string      next_added_pref_aff;
+
+                x_ClearRollbackAction();
+                if (q->GetJobOrWait(m_ClientId, 0, 0, &aff_list,
+                                    m_CommandArguments.wnode_affinity,
+                                    m_CommandArguments.any_affinity,
+                                    m_CommandArguments.exclusive_new_aff,
+                                    m_CommandArguments.prioritized_aff,
+                                    cmdv2, &group_list, &next_job,
+                                    m_RollbackAction,
+                                    next_added_pref_aff) == false)
+                    break;
+                if (!next_job.GetId())
+                    break;
+
+                jobs.push_back(next_job);
+                job_ids.push_back(next_job.GetId());
+                if (!next_added_pref_aff.empty()) {
+                    if (!added_pref_aff.empty())
+                        added_pref_aff.append(1, ',');
+                    added_pref_aff.append(next_added_pref_aff);
+                }
+            }
+
+            // One rollback for all the picked jobs
+            x_ClearRollbackAction();
+            if (!job_ids.empty())
+                m_RollbackAction = new CNSBatchGetJobRollback(m_ClientId,
+                                                              job_ids);
+        }
+
         if (job.GetId())
             x_LogCommandWithJob(job);
 
@@ -2232,7 +2281,10 @@ void CNetScheduleHandler::x_ProcessGetJob(CQueue* q)
                         .Print("added_preferred_affinity", added_pref_aff);
             }
         }
-        x_PrintGetJobResponse(q, job, cmdv2);
+        if (cmdv2 && m_CommandArguments.count > 1)
+            x_PrintGetJobsResponse(q, jobs);
+        else
+            x_PrintGetJobResponse(q, job, cmdv2);
         x_ClearRollbackAction();
     }
 
@@ -4329,44 +4381,7 @@ CNetScheduleHandler::x_PrintGetJobResponse(const CQueue *  q,
     }
 
     if (cmdv2) {
-        string      submitter_notif_info;
-        if (job.GetSubmNotifPort() != 0) {
-            string  host = CSocketAPI::ntoa(job.GetSubmAddr());
-            if (host == "127.0.0.1") {
-                unsigned int    my_addr = CSocketAPI::GetLocalHostAddress();
-                host = CSocketAPI::ntoa(my_addr);
-                if (host == "127.0.0.1") {
-                    ERR_POST(Warning <<
-                             "Could not detect the self host address "
-                             "to provide it to a worker node");
-                }
-            }
-            submitter_notif_info.append("&submitter_notif_host=")
-                                .append(NStr::URLEncode(host))
-                                .append("&submitter_notif_port=")
-                                .append(to_string(job.GetSubmNotifPort()));
-        }
-        string      reply;
-        reply.reserve(1024);
-        reply.append("OK:job_key=")
-             .append(job_key)
-             .append("&input=")
-             .append(NStr::URLEncode(job.GetInput()))
-             .append("&affinity=")
-             .append(NStr::URLEncode(q->GetAffinityTokenByID(job.GetAffinityId())))
-             .append("&client_ip=")
-             .append(NStr::URLEncode(job.GetClientIP()))
-             .append("&client_sid=")
-             .append(NStr::URLEncode(job.GetClientSID()))
-             .append("&ncbi_phid=")
-             .append(NStr::URLEncode(job.GetNCBIPHID()))
-             .append("&mask=")
-             .append(to_string(job.GetMask()))
-             .append("&auth_token=")
-             .append(job.GetAuthToken())
-             .append(submitter_notif_info)
-             .append(kEndOfResponse);
-        x_WriteMessage(reply);
+        x_WriteMessage(x_GetJobResponse2(q, job, job_key));
     } else {
         x_WriteMessage(
                        "OK:" + job_key +
@@ -4382,6 +4397,78 @@ CNetScheduleHandler::x_PrintGetJobResponse(const CQueue *  q,
 }
 
 
+// Multiple jobs reply for GET2 with count: the 'OK:jobs=<n>' line followed
+// by n lines in the single job GET2 format
+void
+CNetScheduleHandler::x_PrintGetJobsResponse(const CQueue *         q,
+                                            const vector<CJob> &   jobs)
+{
+    string      reply = "OK:jobs=" + to_string(jobs.size()) + kEndOfResponse;
+    string      job_keys;
+
+    for (const auto &  job : jobs) {
+        string      job_key = q->MakeJobKey(job.GetId());
+
+        reply.append(x_GetJobResponse2(q, job, job_key));
+        if (!job_keys.empty())
+            job_keys.append(1, ',');
+        job_keys.append(job_key);
+    }
+
+    if (x_NeedCmdLogging())
+        GetDiagContext().Extra()
+            .Print("job_key", jobs.empty() ? string("None") : job_keys)
+            .Print("job_count", jobs.size());
+    x_WriteMessage(reply);
+}
+
+
+string
+CNetScheduleHandler::x_GetJobResponse2(const CQueue *  q,
+                                       const CJob &    job,
+                                       const string &  job_key)
+{
+    string      submitter_notif_info;
+    if (job.GetSubmNotifPort() != 0) {
+        string  host = CSocketAPI::ntoa(job.GetSubmAddr());
+        if (host == "127.0.0.1") {
+            unsigned int    my_addr = CSocketAPI::GetLocalHostAddress();
+            host = CSocketAPI::ntoa(my_addr);
+            if (host == "127.0.0.1") {
+                ERR_POST(Warning <<
+                         "Could not detect the self host address "
+                         "to provide it to a worker node");
+            }
+        }
+        submitter_notif_info.append("&submitter_notif_host=")
+                            .append(NStr::URLEncode(host))
+                            .append("&submitter_notif_port=")
+                            .append(to_string(job.GetSubmNotifPort()));
+    }
+    string      reply;
+    reply.reserve(1024);
+    reply.append("OK:job_key=")
+         .append(job_key)
+         .append("&input=")
+         .append(NStr::URLEncode(job.GetInput()))
+         .append("&affinity=")
+         .append(NStr::URLEncode(q->GetAffinityTokenByID(job.GetAffinityId())))
+         .append("&client_ip=")
+         .append(NStr::URLEncode(job.GetClientIP()))
+         .append("&client_sid=")
+         .append(NStr::URLEncode(job.GetClientSID()))
+         .append("&ncbi_phid=")
+         .append(NStr::URLEncode(job.GetNCBIPHID()))
+         .append("&mask=")
+         .append(to_string(job.GetMask()))
+         .append("&auth_token=")
+         .append(job.GetAuthToken())
+         .append(submitter_notif_info)
+         .append(kEndOfResponse);
+    return reply;
+}
+
+
 bool CNetScheduleHandler::x_CanBeWithoutQueue(FProcessor  processor) const
 {
     return // STATUS/STATUS2
@@ -4646,6 +4733,8 @@ string CNetScheduleHandler::x_GetServerSection(void) const
                 "\"\n"
            "max_client_data=\"" +
                 to_string(m_Server->GetMaxClientData()) + "\"\n"
+           "max_get_jobs=\"" +
+                to_string(m_Server->GetMaxGetJobs()) + "\"\n"
            "admin_host=\"" +
                 m_Server->GetAdminHosts().GetAsFromConfig() + "\"\n"
            "admin_client_name=\"" +
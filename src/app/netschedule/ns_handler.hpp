@@ -248,6 +248,11 @@ private:
     void x_PrintGetJobResponse(const CQueue * q,
                                const CJob &   job,
                                bool           add_security_token);
+    void x_PrintGetJobsResponse(const CQueue *        q,
+                                const vector<CJob> &  jobs);
+    string x_GetJobResponse2(const CQueue *  q,
+                             const CJob &    job,
+                             const string &  job_key);
     bool x_CanBeWithoutQueue(FProcessor  processor) const;
     bool x_NeedToGeneratePHIDAndSID(FProcessor  processor) const;
     bool x_WorkerNodeCommand(void) const;
@@ -72,6 +72,7 @@ CQueue::CQueue(const string &        queue_name,
     m_RunTimeLine(NULL),
     m_QueueName(queue_name),
     m_Kind(queue_kind),
+    m_OperationLock(CRWLock::fFavorWriters),
 
     m_LastId(0),
     m_SavedId(s_ReserveDelta),
@@ -439,7 +440,7 @@ unsigned int  CQueue::Submit(const CNSClientId &        client,
     // Take the queue lock and start the operation
     {{
         string              scope = client.GetScope();
-        CFastMutexGuard     guard(m_OperationLock);
+        CWriteLockGuard     guard(m_OperationLock);
 
 
         if (!scope.empty()) {
@@ -542,7 +543,7 @@ CQueue::SubmitBatch(const CNSClientId &             client,
         }
 
 
-        CFastMutexGuard     guard(m_OperationLock);
+        CWriteLockGuard     guard(m_OperationLock);
 
         if (!scope.empty()) {
             // Check the scope registry limits
@@ -663,7 +664,7 @@ TJobStatus  CQueue::PutResult(const CNSClientId &     client,
         NCBI_THROW(CNetScheduleException, eDataTooLong,
                    "Output is too long");
 
-    CFastMutexGuard     guard(m_OperationLock);
+    CWriteLockGuard     guard(m_OperationLock);
     TJobStatus          old_status = GetJobStatus(job_id);
 
     if (old_status == CNetScheduleAPI::eDone) {
@@ -733,7 +734,7 @@ CQueue::GetJobOrWait(const CNSClientId &       client,
     // We need exactly 1 parameter - m_RunTimeout, so we can access it without
     // CQueueParamAccessor
 
-    CFastMutexGuard     guard(m_OperationLock);
+    CWriteLockGuard     guard(m_OperationLock);
     CNSPreciseTime      curr = CNSPreciseTime::Current();
 
     // This is a worker node command, so mark the node type as a worker
@@ -907,7 +908,7 @@ void  CQueue::CancelWaitGet(const CNSClientId &  client)
     bool    result;
 
     {{
-        CFastMutexGuard     guard(m_OperationLock);
+        CWriteLockGuard     guard(m_OperationLock);
 
         result = x_UnregisterGetListener(client, 0);
     }}
@@ -925,7 +926,7 @@ void  CQueue::CancelWaitRead(const CNSClientId &  client)
     bool    result;
 
     {{
-        CFastMutexGuard     guard(m_OperationLock);
+        CWriteLockGuard     guard(m_OperationLock);
 
         result = m_ClientsRegistry.CancelWaiting(client, eRead);
     }}
@@ -1017,7 +1018,7 @@ CQueue::ChangeAffinity(const CNSClientId &     client,
     vector<string>  already_added_affinities;
 
     {{
-        CFastMutexGuard     guard(m_OperationLock);
+        CWriteLockGuard     guard(m_OperationLock);
 
         // Convert the aff_to_add to the affinity IDs
         for (list<string>::const_iterator  k(aff_to_add.begin());
@@ -1095,7 +1096,7 @@ void  CQueue::SetAffinity(const CNSClientId &     client,
                          m_ClientsRegistry.GetPreferredAffinities(client,
                                                                   cmd_group);
     {{
-        CFastMutexGuard     guard(m_OperationLock);
+        CWriteLockGuard     guard(m_OperationLock);
 
         // Convert the aff to the affinity IDs
         for (list<string>::const_iterator  k(aff.begin());
@@ -1130,7 +1131,7 @@ TJobStatus  CQueue::JobDelayExpiration(unsigned int            job_id,
     CNSPreciseTime      queue_run_timeout = GetRunTimeout();
     CNSPreciseTime      curr = CNSPreciseTime::Current();
 
-    CFastMutexGuard     guard(m_OperationLock);
+    CWriteLockGuard     guard(m_OperationLock);
     TJobStatus          status = GetJobStatus(job_id);
 
     if (status != CNetScheduleAPI::eRunning)
@@ -1177,7 +1178,7 @@ TJobStatus  CQueue::JobDelayReadExpiration(unsigned int            job_id,
     CNSPreciseTime      queue_read_timeout = GetReadTimeout();
     CNSPreciseTime      curr = CNSPreciseTime::Current();
 
-    CFastMutexGuard     guard(m_OperationLock);
+    CWriteLockGuard     guard(m_OperationLock);
     TJobStatus          status = GetJobStatus(job_id);
 
     if (status != CNetScheduleAPI::eReading)
@@ -1227,7 +1228,7 @@ TJobStatus  CQueue::GetStatusAndLifetime(unsigned int      job_id,
                                          string &          progress_msg,
                                          CNSPreciseTime *  lifetime)
 {
-    CFastMutexGuard     guard(m_OperationLock);
+    CReadLockGuard      guard(m_OperationLock);
     TJobStatus          status = GetJobStatus(job_id);
 
     if (status == CNetScheduleAPI::eJobNotFound)
@@ -1253,7 +1254,7 @@ TJobStatus  CQueue::GetStatusAndLifetimeAndTouch(unsigned int      job_id,
                                                  CJob &            job,
                                                  CNSPreciseTime *  lifetime)
 {
-    CFastMutexGuard     guard(m_OperationLock);
+    CWriteLockGuard     guard(m_OperationLock);
     TJobStatus          status = GetJobStatus(job_id);
 
     if (status == CNetScheduleAPI::eJobNotFound)
@@ -1289,7 +1290,7 @@ TJobStatus  CQueue::SetJobListener(unsigned int            job_id,
 {
     CNSPreciseTime      curr = CNSPreciseTime::Current();
     TJobStatus          status = CNetScheduleAPI::eJobNotFound;
-    CFastMutexGuard     guard(m_OperationLock);
+    CWriteLockGuard     guard(m_OperationLock);
 
     auto        job_iter = m_Jobs.find(job_id);
 
@@ -1338,7 +1339,7 @@ bool CQueue::PutProgressMessage(unsigned int    job_id,
                                 const string &  msg)
 {
     CNSPreciseTime      curr = CNSPreciseTime::Current();
-    CFastMutexGuard     guard(m_OperationLock);
+    CWriteLockGuard     guard(m_OperationLock);
 
     auto        job_iter = m_Jobs.find(job_id);
     if (job_iter == m_Jobs.end())
@@ -1367,7 +1368,7 @@ TJobStatus  CQueue::ReturnJob(const CNSClientId &     client,
                               string &                warning,
                               TJobReturnOption        how)
 {
-    CFastMutexGuard     guard(m_OperationLock);
+    CWriteLockGuard     guard(m_OperationLock);
     CNSPreciseTime      current_time = CNSPreciseTime::Current();
     TJobStatus          old_status = GetJobStatus(job_id);
 
@@ -1477,7 +1478,7 @@ TJobStatus  CQueue::RescheduleJob(const CNSClientId &     client,
                                   CJob &                  job)
 {
     CNSPreciseTime      current_time = CNSPreciseTime::Current();
-    CFastMutexGuard     guard(m_OperationLock);
+    CWriteLockGuard     guard(m_OperationLock);
     TJobStatus          old_status = GetJobStatus(job_id);
     unsigned int        affinity_id = 0;
     unsigned int        group_id = 0;
@@ -1593,7 +1594,7 @@ TJobStatus  CQueue::RedoJob(const CNSClientId &     client,
                             CJob &                  job)
 {
     CNSPreciseTime      current_time = CNSPreciseTime::Current();
-    CFastMutexGuard     guard(m_OperationLock);
+    CWriteLockGuard     guard(m_OperationLock);
     TJobStatus          old_status = GetJobStatus(job_id);
 
     if (old_status == CNetScheduleAPI::eJobNotFound ||
@@ -1651,7 +1652,7 @@ TJobStatus  CQueue::ReadAndTouchJob(unsigned int      job_id,
                                     CJob &            job,
                                     CNSPreciseTime *  lifetime)
 {
-    CFastMutexGuard         guard(m_OperationLock);
+    CWriteLockGuard         guard(m_OperationLock);
     TJobStatus              status = GetJobStatus(job_id);
 
     if (status == CNetScheduleAPI::eJobNotFound)
@@ -1684,7 +1685,7 @@ TJobStatus  CQueue::Cancel(const CNSClientId &  client,
     TJobStatus          old_status;
     CNSPreciseTime      current_time = CNSPreciseTime::Current();
 
-    CFastMutexGuard     guard(m_OperationLock);
+    CWriteLockGuard     guard(m_OperationLock);
 
     old_status = m_StatusTracker.GetStatus(job_id);
     if (old_status == CNetScheduleAPI::eJobNotFound)
@@ -1773,7 +1774,7 @@ unsigned int  CQueue::CancelAllJobs(const CNSClientId &  client,
     statuses.push_back(CNetScheduleAPI::eReadFailed);
 
     TNSBitVector        jobs;
-    CFastMutexGuard     guard(m_OperationLock);
+    CWriteLockGuard     guard(m_OperationLock);
     m_StatusTracker.GetJobs(statuses, jobs);
     return x_CancelJobs(client, jobs, logging);
 }
@@ -1909,7 +1910,7 @@ CQueue::CancelSelectedJobs(const CNSClientId &         client,
         statuses = job_statuses;
     }
 
-    CFastMutexGuard     guard(m_OperationLock);
+    CWriteLockGuard     guard(m_OperationLock);
     m_StatusTracker.GetJobs(statuses, jobs_to_cancel);
 
     if (!group.empty()) {
@@ -1951,7 +1952,7 @@ TJobStatus  CQueue::GetJobStatus(unsigned int  job_id) const
 
 bool CQueue::IsEmpty() const
 {
-    CFastMutexGuard     guard(m_OperationLock);
+    CReadLockGuard      guard(m_OperationLock);
     return !m_StatusTracker.AnyJobs();
 }
 
@@ -2024,7 +2025,7 @@ CQueue::GetJobForReadingOrWait(const CNSClientId &       client,
                                CNSRollbackInterface * &  rollback_action,
                                string &                  added_pref_aff)
 {
-    CFastMutexGuard         guard(m_OperationLock);
+    CWriteLockGuard         guard(m_OperationLock);
     CNSPreciseTime          curr = CNSPreciseTime::Current();
     TNSBitVector            group_ids_vector;
     bool                    has_groups = false;
@@ -2262,7 +2263,7 @@ TJobStatus  CQueue::RereadJob(const CNSClientId &     client,
                               bool &                  no_op)
 {
     CNSPreciseTime      current_time = CNSPreciseTime::Current();
-    CFastMutexGuard     guard(m_OperationLock);
+    CWriteLockGuard     guard(m_OperationLock);
     TJobStatus          old_status = GetJobStatus(job_id);
 
     if (old_status == CNetScheduleAPI::eJobNotFound ||
@@ -2352,7 +2353,7 @@ TJobStatus  CQueue::x_ChangeReadingStatus(const CNSClientId &  client,
                                                     CNSPreciseTime::Current();
     CStatisticsCounters::ETransitionPathOption  path_option =
                                                     CStatisticsCounters::eNone;
-    CFastMutexGuard                             guard(m_OperationLock);
+    CWriteLockGuard                             guard(m_OperationLock);
     TJobStatus                                  old_status =
                                                     GetJobStatus(job_id);
 
@@ -3012,7 +3013,7 @@ TJobStatus CQueue::FailJob(const CNSClientId &    client,
     bool                rescheduled = false;
     TJobStatus          old_status;
 
-    CFastMutexGuard     guard(m_OperationLock);
+    CWriteLockGuard     guard(m_OperationLock);
     TJobStatus          new_status = CNetScheduleAPI::eFailed;
 
     old_status = GetJobStatus(job_id);
@@ -3167,7 +3168,7 @@ void CQueue::ClearWorkerNode(const CNSClientId &  client,
     TNSBitVector    reading_jobs;
 
     {{
-        CFastMutexGuard     guard(m_OperationLock);
+        CWriteLockGuard     guard(m_OperationLock);
         m_ClientsRegistry.ClearClient(client, running_jobs, reading_jobs,
                                       client_was_found, old_session,
                                       had_wn_pref_affs, had_reader_pref_affs);
@@ -3187,7 +3188,7 @@ void CQueue::NotifyListenersPeriodically(const CNSPreciseTime &  current_time)
 {
     if (m_MaxPendingWaitTimeout != kTimeZero) {
         // Pending outdated timeout is configured, so check outdated jobs
-        CFastMutexGuard     guard(m_OperationLock);
+        CWriteLockGuard     guard(m_OperationLock);
         TNSBitVector        outdated_jobs =
                                     m_StatusTracker.GetOutdatedPendingJobs(
                                         m_MaxPendingWaitTimeout,
@@ -3201,7 +3202,7 @@ void CQueue::NotifyListenersPeriodically(const CNSPreciseTime &  current_time)
 
     if (m_MaxPendingReadWaitTimeout != kTimeZero) {
         // Read pending timeout is configured, so check read outdated jobs
-        CFastMutexGuard     guard(m_OperationLock);
+        CWriteLockGuard     guard(m_OperationLock);
         TNSBitVector        outdated_jobs =
                                     m_StatusTracker.GetOutdatedReadVacantJobs(
                                         m_MaxPendingReadWaitTimeout,
@@ -3233,7 +3234,7 @@ void CQueue::NotifyListenersPeriodically(const CNSPreciseTime &  current_time)
 
     // The NotifyPeriodically() and CheckTimeout() calls may need to modify
     // the clients and affinity registry so it is safer to take the queue lock.
-    CFastMutexGuard     guard(m_OperationLock);
+    CWriteLockGuard     guard(m_OperationLock);
     if (m_StatusTracker.AnyPending())
         m_NotificationsList.NotifyPeriodically(current_time,
                                                m_NotifLofreqMult,
@@ -3249,9 +3250,12 @@ CNSPreciseTime CQueue::NotifyExactListeners(void)
 }
 
 
+// The lists below are printed under the exclusive lock: the registries
+// lock each other in different orders while printing, so two of them must
+// never be printed at the same time.
 string CQueue::PrintClientsList(bool verbose) const
 {
-    CFastMutexGuard     guard(m_OperationLock);
+    CWriteLockGuard     guard(m_OperationLock);
     return m_ClientsRegistry.PrintClientsList(this,
                                               m_DumpClientBufferSize, verbose);
 }
@@ -3259,7 +3263,7 @@ string CQueue::PrintClientsList(bool verbose) const
 
 string CQueue::PrintNotificationsList(bool verbose) const
 {
-    CFastMutexGuard     guard(m_OperationLock);
+    CWriteLockGuard     guard(m_OperationLock);
     return m_NotificationsList.Print(m_ClientsRegistry, m_AffinityRegistry,
                                      m_GroupRegistry, verbose);
 }
@@ -3270,7 +3274,7 @@ string CQueue::PrintAffinitiesList(const CNSClientId &  client,
 {
     TNSBitVector        scope_jobs;
     string              scope = client.GetScope();
-    CFastMutexGuard     guard(m_OperationLock);
+    CWriteLockGuard     guard(m_OperationLock);
 
     if (scope == kNoScopeOnly)
         scope_jobs = m_ScopeRegistry.GetAllJobsInScopes();
@@ -3288,7 +3292,7 @@ string CQueue::PrintGroupsList(const CNSClientId &  client,
 {
     TNSBitVector        scope_jobs;
     string              scope = client.GetScope();
-    CFastMutexGuard     guard(m_OperationLock);
+    CWriteLockGuard     guard(m_OperationLock);
 
     if (scope == kNoScopeOnly)
         scope_jobs = m_ScopeRegistry.GetAllJobsInScopes();
@@ -3302,7 +3306,7 @@ string CQueue::PrintGroupsList(const CNSClientId &  client,
 
 string CQueue::PrintScopesList(bool verbose) const
 {
-    CFastMutexGuard     guard(m_OperationLock);
+    CWriteLockGuard     guard(m_OperationLock);
     return m_ScopeRegistry.Print(this, 100, verbose);
 }
 
@@ -3345,7 +3349,7 @@ void CQueue::x_CheckExecutionTimeout(const CNSPreciseTime &  queue_run_timeout,
     map<unsigned int, CJob>::iterator   job_iter;
 
     {{
-        CFastMutexGuard         guard(m_OperationLock);
+        CWriteLockGuard         guard(m_OperationLock);
 
         status = GetJobStatus(job_id);
         if (status == CNetScheduleAPI::eRunning) {
@@ -3522,7 +3526,7 @@ CQueue::CheckJobsExpiry(const CNSPreciseTime &  current_time,
     result.job_id = attributes.job_id;
     result.deleted = 0;
     {{
-        CFastMutexGuard     guard(m_OperationLock);
+        CWriteLockGuard     guard(m_OperationLock);
 
         for (result.scans = 0;
              result.scans < attributes.scans; ++result.scans) {
@@ -3561,7 +3565,7 @@ CQueue::CheckJobsExpiry(const CNSPreciseTime &  current_time,
 
     if (result.deleted > 0) {
         TNSBitVector::enumerator    en(job_ids.first());
-        CFastMutexGuard             guard(m_OperationLock);
+        CWriteLockGuard             guard(m_OperationLock);
 
         for (; en.valid(); ++en) {
             unsigned int    id = *en;
@@ -3653,7 +3657,7 @@ unsigned int  CQueue::DeleteBatch(unsigned int  max_deleted)
 
     while (en.valid() && del_rec < max_deleted) {
         {{
-            CFastMutexGuard     guard(m_OperationLock);
+            CWriteLockGuard     guard(m_OperationLock);
 
             for (size_t n = 0;
                  en.valid() && n < chunk_size && del_rec < max_deleted;
@@ -3691,7 +3695,7 @@ unsigned int  CQueue::DeleteBatch(unsigned int  max_deleted)
             }
         }}
 
-        CFastMutexGuard     guard(m_OperationLock);
+        CWriteLockGuard     guard(m_OperationLock);
         if (m_ReadJobsOps >= 1000000) {
             m_ReadJobsOps = 0;
             m_ReadJobs.optimize(0, TNSBitVector::opt_free_0);
@@ -3777,7 +3781,7 @@ void  CQueue::StaleNodes(const CNSPreciseTime &  current_time)
 {
     // Clears the worker nodes affinities if the workers are inactive for
     // the configured timeout
-    CFastMutexGuard     guard(m_OperationLock);
+    CWriteLockGuard     guard(m_OperationLock);
     m_ClientsRegistry.StaleNodes(current_time, 
                                  m_WNodeTimeout, m_ReaderTimeout, m_Log);
 }
@@ -3792,7 +3796,7 @@ void CQueue::PurgeBlacklistedJobs(void)
 
 void  CQueue::PurgeClientRegistry(const CNSPreciseTime &  current_time)
 {
-    CFastMutexGuard     guard(m_OperationLock);
+    CWriteLockGuard     guard(m_OperationLock);
     m_ClientsRegistry.Purge(current_time,
                             m_ClientRegistryTimeoutWorkerNode,
                             m_ClientRegistryMinWorkerNodes,
@@ -3824,7 +3828,7 @@ string CQueue::PrintJobDbStat(const CNSClientId &  client,
 
     string              scope = client.GetScope();
     {{
-        CFastMutexGuard     guard(m_OperationLock);
+        CReadLockGuard      guard(m_OperationLock);
 
         // Check the scope restrictions
         if (scope == kNoScopeOnly) {
@@ -3900,7 +3904,7 @@ string CQueue::PrintAllJobDbStat(const CNSClientId &         client,
 
     {{
         string              scope = client.GetScope();
-        CFastMutexGuard     guard(m_OperationLock);
+        CReadLockGuard      guard(m_OperationLock);
         m_StatusTracker.GetJobs(statuses, jobs_to_dump);
 
         // Check if a certain group has been specified
@@ -3981,7 +3985,7 @@ string CQueue::x_DumpJobs(const TNSBitVector &    jobs_to_dump,
 
         for ( ; en.valid(); ) {
             {{
-                CFastMutexGuard     guard(m_OperationLock);
+                CReadLockGuard      guard(m_OperationLock);
 
                 for ( ; en.valid() && read_jobs < buffer_size; ++en ) {
                     auto        job_iter = m_Jobs.find(*en);
@@ -4077,7 +4081,7 @@ void CQueue::TouchClientsRegistry(CNSClientId &  client,
         // visit notifications first and then a client registry i.e. the very
         // same mutexes are locked in a reverse order.
         // To prevent it the operation lock is locked here.
-        CFastMutexGuard     guard(m_OperationLock);
+        CWriteLockGuard     guard(m_OperationLock);
         m_ClientsRegistry.Touch(client, running_jobs, reading_jobs,
                                 client_was_found, session_was_reset,
                                 old_session, had_wn_pref_affs,
@@ -4102,7 +4106,7 @@ void CQueue::MarkClientAsAdmin(const CNSClientId &  client)
 
 void CQueue::RegisterSocketWriteError(const CNSClientId &  client)
 {
-    CFastMutexGuard     guard(m_OperationLock);
+    CWriteLockGuard     guard(m_OperationLock);
     m_ClientsRegistry.RegisterSocketWriteError(client);
 }
 
@@ -4110,7 +4114,7 @@ void CQueue::RegisterSocketWriteError(const CNSClientId &  client)
 void CQueue::SetClientScope(const CNSClientId &  client)
 {
     // Memorize the last client scope
-    CFastMutexGuard     guard(m_OperationLock);
+    CWriteLockGuard     guard(m_OperationLock);
     m_ClientsRegistry.SetLastScope(client);
 }
 
@@ -4124,7 +4128,7 @@ TJobStatus  CQueue::x_ResetDueTo(const CNSClientId &     client,
                                  CJobEvent::EJobEvent    event_type)
 {
     TJobStatus          new_status;
-    CFastMutexGuard     guard(m_OperationLock);
+    CWriteLockGuard     guard(m_OperationLock);
     auto                job_iter = m_Jobs.find(job_id);
 
     if (job_iter == m_Jobs.end()) {
@@ -4434,7 +4438,7 @@ void CQueue::GetJobsPerState(const CNSClientId &  client,
 {
     TNSBitVector        group_jobs;
     TNSBitVector        aff_jobs;
-    CFastMutexGuard     guard(m_OperationLock);
+    CReadLockGuard      guard(m_OperationLock);
 
     if (!group_token.empty()) {
         try {
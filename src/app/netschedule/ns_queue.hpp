@@ -644,8 +644,10 @@ private:
     string                      m_QueueName;
     TQueueKind                  m_Kind;            // 0 - static, 1 - dynamic
 
-    // Lock for a queue operations
-    mutable CFastMutex          m_OperationLock;
+    // Lock for a queue operations. Job state changes take it exclusively,
+    // lookups which only read the jobs and registries (job dumps, status
+    // and per-state counters) share it.
+    mutable CRWLock             m_OperationLock;
 
     // Registry of all the clients for the queue
     CNSClientsRegistry          m_ClientsRegistry;
@@ -109,6 +109,29 @@ void CNSGetJobRollback::Rollback(CQueue *  queue)
 }
 
 
+void CNSBatchGetJobRollback::Rollback(CQueue *  queue)
+{
+    ERR_POST(Warning << "Rolling back multiple jobs request due to "
+                        "a network error while reporting the job keys.");
+
+    // The same as for a single job: return the jobs without blacklisting
+    for (size_t  k = 0; k < m_JobIds.size(); ++k) {
+        try {
+            string      warning;
+            CJob        job;    // Not used here
+
+            queue->ReturnJob(m_Client, m_JobIds[k],
+                             queue->MakeJobKey(m_JobIds[k]),
+                             job, "", warning, CQueue::eRollback);
+        } catch (const exception &  ex) {
+            ERR_POST("Error while rolling back requested job: " << ex.what());
+        } catch (...) {
+            ERR_POST("Unknown error while rolling back requested job");
+        }
+    }
+}
+
+
 void CNSReadJobRollback::Rollback(CQueue *  queue)
 {
     ERR_POST(Warning << "Rolling back reading job request due to "
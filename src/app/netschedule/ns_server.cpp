@@ -72,6 +72,7 @@ CNetScheduleServer::CNetScheduleServer(const string &  dbpath,
       m_StatInterval(default_stat_interval),
       m_JobCountersInterval(default_job_counters_interval),
       m_MaxClientData(default_max_client_data),
+      m_MaxGetJobs(default_max_get_jobs),
       m_NodeID("not_initialized"),
       m_SessionID("s" + x_GenerateGUID()),
       m_StartIDs(dbpath, diskless),
@@ -182,6 +183,14 @@ CJsonNode CNetScheduleServer::SetNSParameters(const SNS_Parameters &  params,
     }
     m_MaxClientData = params.max_client_data;
 
+    if (m_MaxGetJobs != params.max_get_jobs) {
+        CJsonNode       values = CJsonNode::NewArrayNode();
+        values.AppendInteger(m_MaxGetJobs);
+        values.AppendInteger(params.max_get_jobs);
+        changes.SetByKey("max_get_jobs", values);
+    }
+    m_MaxGetJobs = params.max_get_jobs;
+
     CJsonNode   accepted_hosts = m_AdminHosts.SetHosts(params.admin_hosts);
     if (accepted_hosts.GetSize() > 0)
         changes.SetByKey("admin_host", accepted_hosts);
@@ -247,6 +247,10 @@ void SNS_Parameters::Read(const IRegistry &  reg)
     if (max_client_data <= 0)
         max_client_data = default_max_client_data;
 
+    max_get_jobs = GetIntNoErr("max_get_jobs", default_max_get_jobs);
+    if (max_get_jobs <= 0)
+        max_get_jobs = default_max_get_jobs;
+
     admin_hosts = reg.GetString(sname, "admin_host", kEmptyStr);
     try {
         admin_client_names = reg.GetEncryptedString(sname, "admin_client_name",
@@ -408,6 +408,16 @@ void NS_ValidateServerSection(const IRegistry &  reg,
                      " must be > 0");
     }
 
+    ok = NS_ValidateInt(reg, section, "max_get_jobs", warnings);
+    if (ok) {
+        int     val = reg.GetInt(section, "max_get_jobs",
+                                 default_max_get_jobs);
+        if (val <= 0)
+            warnings.push_back(g_ValidPrefix + "value " +
+                     NS_RegValName(section, "max_get_jobs") +
+                     " must be > 0");
+    }
+
 
     NS_ValidateRegistrySettings(reg, section, "affinity",
                                 default_max_affinities,
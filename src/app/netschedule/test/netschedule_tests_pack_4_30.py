@@ -245,3 +245,46 @@ class Scenario2004(TestBase):
 
         return True
 
+
+
+class Scenario2005(TestBase):
+
+    """Scenario 2005"""
+
+    def __init__(self, netschedule):
+        TestBase.__init__(self, netschedule)
+
+    @staticmethod
+    def getScenario():
+        """Provides the scenario"""
+        return "Set max_get_jobs to 2; submit three jobs; " \
+               "GET2 with count=3 -> two jobs provided; " \
+               "the third job is still pending"
+
+    def execute(self):
+        """Should return True if the execution completed successfully"""
+        self.fromScratch(1300)
+        jobID1 = self.ns.submitJob('TEST1', 'blah')
+        jobID2 = self.ns.submitJob('TEST1', 'blah')
+        jobID3 = self.ns.submitJob('TEST1', 'blah')
+
+        wn_client = self.getNetScheduleService('TEST1', 'scenario2005')
+        wn_client.set_client_identification('node', 'session')
+
+        # Only the first line of the reply is read, the connection
+        # is not used afterwards
+        output = execAny(wn_client, 'GET2 wnode_aff=0 any_aff=1 count=3')
+        if output.strip() != 'jobs=2':
+            raise Exception("Unexpected GET2 output; expected 'jobs=2', "
+                            "received: " + output)
+
+        for jobID in [jobID1, jobID2]:
+            status = self.ns.getJobStatus('TEST1', jobID)
+            if status != 'Running':
+                raise Exception("Unexpected job " + jobID + " status: " +
+                                status + "; expected Running")
+        status = self.ns.getJobStatus('TEST1', jobID3)
+        if status != 'Pending':
+            raise Exception("Unexpected job " + jobID3 + " status: " +
+                            status + "; expected Pending")
+        return True
@@ -0,0 +1,376 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:  NetSchedule multithreaded load test.
+ *                    Each thread runs SUBMIT / GET2 / PUT2 cycles with its
+ *                    own affinity. The test is repeated for 1, 2, 4, ...
+ *                    threads up to the given maximum and the job operations
+ *                    per second are reported for each number of threads.
+ *                    Optionally some threads run affinity based status
+ *                    lookups (STAT JOBS) in parallel.
+ *                    With -batch the jobs are submitted, taken and
+ *                    committed in batches (BSUB, GET2 count=, pipelined
+ *                    PUT2).
+ *
+ */
+
+#include <ncbi_pch.hpp>
+#include <corelib/ncbiapp.hpp>
+#include <corelib/ncbiargs.hpp>
+#include <corelib/ncbithr.hpp>
+#include <corelib/ncbitime.hpp>
+#include <corelib/ncbi_system.hpp>
+
+#include <connect/services/netschedule_api.hpp>
+#include <connect/ncbi_core_cxx.hpp>
+
+#include <sys/types.h>
+#include <unistd.h>
+
+
+USING_NCBI_SCOPE;
+
+
+static CNetScheduleAPI  s_GetAPI(const string &  service,
+                                 const string &  qname,
+                                 unsigned int    thread_no)
+{
+    CNetScheduleAPI     cl(service, "ns_load_test", qname);
+    cl.SetProgramVersion("ns_load_test 1.0.0");
+    cl.SetClientNode("node_" + to_string(getpid()) + "_" +
+                     to_string(thread_no));
+    cl.SetClientSession("ns_load_test_session");
+    return cl;
+}
+
+
+static string  s_GetAffinity(unsigned int  thread_no)
+{
+    return "aff_" + to_string(getpid()) + "_" + to_string(thread_no);
+}
+
+
+/// Base class for the load threads: runs x_Iteration() until
+/// the deadline and counts the performed server operations
+///
+/// @internal
+///
+class CLoadThread : public CThread
+{
+    public:
+        CLoadThread(const string &  service, const string &  qname,
+                    unsigned int  thread_no, const CDeadline &  deadline) :
+            m_API(s_GetAPI(service, qname, thread_no)),
+            m_Affinity(s_GetAffinity(thread_no)),
+            m_Deadline(deadline), m_Ops(0), m_Errors(0)
+        {}
+
+        Uint8  GetOps(void) const { return m_Ops; }
+        Uint8  GetErrors(void) const { return m_Errors; }
+
+    protected:
+        virtual void *  Main(void)
+        {
+            while (!m_Deadline.IsExpired()) {
+                try {
+                    m_Ops += x_Iteration();
+                } catch (const exception &  ex) {
+                    if (++m_Errors <= 10)
+                        ERR_POST(ex.what());
+                }
+            }
+            return NULL;
+        }
+
+        // Returns the number of server operations performed
+        virtual unsigned int  x_Iteration(void) = 0;
+
+        CNetScheduleAPI     m_API;
+        string              m_Affinity;
+
+    private:
+        CDeadline           m_Deadline;
+        Uint8               m_Ops;
+        Uint8               m_Errors;
+};
+
+
+/// SUBMIT, GET2, PUT2 for a single job or for a batch of jobs
+///
+/// @internal
+///
+class CJobThread : public CLoadThread
+{
+    public:
+        CJobThread(const string &  service, const string &  qname,
+                   unsigned int  thread_no, const CDeadline &  deadline) :
+            CLoadThread(service, qname, thread_no, deadline),
+            m_Submitter(m_API.GetSubmitter()),
+            m_Executor(m_API.GetExecutor())
+        {}
+
+        static unsigned int     sm_BatchSize;
+
+    protected:
+        virtual unsigned int  x_Iteration(void)
+        {
+            if (sm_BatchSize > 1)
+                return x_BatchIteration();
+
+            CNetScheduleJob     job("ns_load_test input");
+
+            job.affinity = m_Affinity;
+            m_Submitter.SubmitJob(job);
+
+            job.Reset();
+            if (!m_Executor.GetJob(job, m_Affinity))
+                throw runtime_error("Expected a job for execution, "
+                                    "received nothing");
+
+            job.output = "JOB DONE";
+            m_Executor.PutResult(job);
+            return 3;
+        }
+
+        unsigned int  x_BatchIteration(void)
+        {
+            vector<CNetScheduleJob>     jobs(sm_BatchSize);
+
+            for (auto &  job : jobs) {
+                job.input = "ns_load_test input";
+                job.affinity = m_Affinity;
+            }
+            m_Submitter.SubmitJobBatch(jobs);
+
+            jobs.clear();
+            while (jobs.size() < sm_BatchSize) {
+                if (m_Executor.GetJobs(jobs, sm_BatchSize - jobs.size(),
+                                       m_Affinity) == 0)
+                    throw runtime_error("Expected jobs for execution, "
+                                        "received nothing");
+            }
+
+            for (auto &  job : jobs)
+                job.output = "JOB DONE";
+            m_Executor.PutResults(jobs);
+            return 3 * sm_BatchSize;
+        }
+
+    private:
+        CNetScheduleSubmitter   m_Submitter;
+        CNetScheduleExecutor    m_Executor;
+};
+
+
+unsigned int    CJobThread::sm_BatchSize = 1;
+
+
+/// Per-state job counters for one of the job threads affinity
+///
+/// @internal
+///
+class CLookupThread : public CLoadThread
+{
+    public:
+        CLookupThread(const string &  service, const string &  qname,
+                      unsigned int  thread_no, const CDeadline &  deadline) :
+            CLoadThread(service, qname, thread_no, deadline),
+            m_Admin(m_API.GetAdmin())
+        {
+            // Look at the jobs of the first job thread
+            m_Affinity = s_GetAffinity(0);
+        }
+
+    protected:
+        virtual unsigned int  x_Iteration(void)
+        {
+            CNetScheduleAdmin::TStatusMap   status_map;
+            m_Admin.StatusSnapshot(status_map, m_Affinity);
+            return 1;
+        }
+
+    private:
+        CNetScheduleAdmin       m_Admin;
+};
+
+
+
+/// Test application
+///
+/// @internal
+///
+class CNetScheduleLoadTest : public CNcbiApplication
+{
+    public:
+        void Init(void);
+        int Run(void);
+
+    private:
+        template <class TThread>
+        void  x_RunThreads(unsigned int  first_no, unsigned int  count,
+                           const CDeadline &  deadline,
+                           vector< CRef<CLoadThread> > &  threads);
+        Uint8  x_Join(vector< CRef<CLoadThread> > &  threads);
+
+        string          m_Service;
+        string          m_Queue;
+};
+
+
+
+void CNetScheduleLoadTest::Init(void)
+{
+    // Avoid sockets to stay in TIME_WAIT state
+    GetRWConfig().Set("netservice_api", "use_linger2", "true",
+                      IRegistry::fNoOverride);
+
+    CONNECT_Init();
+
+    unique_ptr<CArgDescriptions> arg_desc(new CArgDescriptions);
+
+    arg_desc->SetUsageContext(GetArguments().GetProgramBasename(),
+                              "NetSchedule multithreaded load test");
+
+    arg_desc->AddKey("service",
+                     "service_name",
+                     "NetSchedule service name "
+                                        "(format: host:port or service_name).",
+                     CArgDescriptions::eString);
+
+    arg_desc->AddKey("queue",
+                     "queue_name",
+                     "NetSchedule queue name (like: noname).",
+                     CArgDescriptions::eString);
+
+    arg_desc->AddDefaultKey("max_threads",
+                            "max_threads",
+                            "Max number of job threads, 0 means "
+                            "the number of CPUs",
+                            CArgDescriptions::eInteger, "0");
+
+    arg_desc->AddDefaultKey("lookup_threads",
+                            "lookup_threads",
+                            "Number of threads running affinity status "
+                            "lookups while the jobs are processed",
+                            CArgDescriptions::eInteger, "0");
+
+    arg_desc->AddDefaultKey("batch",
+                            "batch_size",
+                            "Number of jobs submitted, taken and committed "
+                            "at once by a job thread",
+                            CArgDescriptions::eInteger, "1");
+
+    arg_desc->AddDefaultKey("duration",
+                            "seconds",
+                            "Duration of each step",
+                            CArgDescriptions::eDouble, "10");
+
+    SetupArgDescriptions(arg_desc.release());
+}
+
+
+template <class TThread>
+void  CNetScheduleLoadTest::x_RunThreads(unsigned int  first_no,
+                                         unsigned int  count,
+                                         const CDeadline &  deadline,
+                                         vector< CRef<CLoadThread> > &  threads)
+{
+    for (unsigned int  k = 0; k < count; ++k) {
+        threads.push_back(CRef<CLoadThread>(
+                    new TThread(m_Service, m_Queue, first_no + k, deadline)));
+        threads.back()->Run();
+    }
+}
+
+
+Uint8  CNetScheduleLoadTest::x_Join(vector< CRef<CLoadThread> > &  threads)
+{
+    Uint8       ops = 0;
+    Uint8       errors = 0;
+    for (auto &  thread : threads) {
+        thread->Join();
+        ops += thread->GetOps();
+        errors += thread->GetErrors();
+    }
+    if (errors > 0)
+        ERR_POST(Warning << errors << " errors");
+    threads.clear();
+    return ops;
+}
+
+
+int CNetScheduleLoadTest::Run(void)
+{
+    const CArgs &   args = GetArgs();
+    unsigned int    max_threads = args["max_threads"].AsInteger();
+    unsigned int    lookup_threads = args["lookup_threads"].AsInteger();
+    double          duration = args["duration"].AsDouble();
+
+    CJobThread::sm_BatchSize = args["batch"].AsInteger();
+
+    m_Service = args["service"].AsString();
+    m_Queue = args["queue"].AsString();
+    if (max_threads == 0)
+        max_threads = CSystemInfo::GetCpuCount();
+
+    NcbiCout << "CPUs: " << CSystemInfo::GetCpuCount()
+             << ", batch size: " << CJobThread::sm_BatchSize
+             << ", step duration: " << duration << " s" << NcbiEndl
+             << "threads\tjob ops/s\tper thread\tlookups/s" << NcbiEndl;
+
+    for (unsigned int  threads = 1; ; threads *= 2) {
+        if (threads > max_threads)
+            threads = max_threads;
+
+        vector< CRef<CLoadThread> >     job_threads;
+        vector< CRef<CLoadThread> >     lookups;
+        CDeadline                       deadline{CTimeout(duration)};
+        CStopWatch                      sw(CStopWatch::eStart);
+
+        x_RunThreads<CJobThread>(0, threads, deadline, job_threads);
+        x_RunThreads<CLookupThread>(threads, lookup_threads,
+                                    deadline, lookups);
+
+        Uint8       ops = x_Join(job_threads);
+        Uint8       lookup_ops = x_Join(lookups);
+        double      elapsed = sw.Elapsed();
+
+        NcbiCout << threads << "\t"
+                 << NStr::DoubleToString(ops / elapsed, 0) << "\t\t"
+                 << NStr::DoubleToString(ops / elapsed / threads, 0) << "\t\t"
+                 << NStr::DoubleToString(lookup_ops / elapsed, 0)
+                 << NcbiEndl;
+
+        if (threads == max_threads)
+            break;
+    }
+    return 0;
+}
+
+
+int main(int argc, const char* argv[])
+{
+    return CNetScheduleLoadTest().AppMain(argc, argv, 0, eDS_Default);
+}
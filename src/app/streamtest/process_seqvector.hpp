@@ -44,6 +44,10 @@ public:
     //  ------------------------------------------------------------------------
         : CScopedProcess()
         , m_out( 0 )
+        , m_windows( false )
+        , m_window_count( 0 )
+        , m_single_time( 0 )
+        , m_batch_time( 0 )
     {};
 
     //  ------------------------------------------------------------------------
@@ -61,6 +65,7 @@ public:
 
         m_out = args["o"] ? &(args["o"].AsOutputFile()) : &cout;
         m_gap_mode = args["gap-mode"].AsString();
+        m_windows = args["options"].AsString() == "windows";
 
         m_debug = args["debug"];
 
@@ -72,6 +77,15 @@ public:
     void ProcessFinalize()
     //  ------------------------------------------------------------------------
     {
+        if ( m_windows ) {
+            *m_out << "Windows: " << m_window_count
+                   << ", GetSeqData: " << m_single_time << " s"
+                   << ", batch GetSeqData: " << m_batch_time << " s";
+            if ( m_batch_time > 0 ) {
+                *m_out << ", speedup " << m_single_time / m_batch_time;
+            }
+            *m_out << endl;
+        }
     }
 
     //  ------------------------------------------------------------------------
@@ -139,10 +153,57 @@ public:
         }
     }
 
+    //  ------------------------------------------------------------------------
+    void x_WindowsBenchmark(const CBioseq_Handle& bsh)
+    //  ------------------------------------------------------------------------
+    {
+        // Short overlapping windows, like variant annotation context
+        const TSeqPos kWindowSize = 21;
+        const TSeqPos kWindowStep = 7;
+
+        CSeqVector sv1 = bsh.GetSeqVector(CBioseq_Handle::eCoding_Iupac);
+        CSeqVector sv2 = bsh.GetSeqVector(CBioseq_Handle::eCoding_Iupac);
+
+        vector<TSeqRange> ranges;
+        for ( TSeqPos pos = 0; pos + kWindowSize <= sv1.size(); pos += kWindowStep ) {
+            ranges.push_back(TSeqRange(pos, pos + kWindowSize - 1));
+        }
+
+        CStopWatch sw(CStopWatch::eStart);
+        vector<string> single(ranges.size());
+        for ( size_t i = 0; i < ranges.size(); ++i ) {
+            sv1.GetSeqData(ranges[i].GetFrom(), ranges[i].GetToOpen(), single[i]);
+        }
+        m_single_time += sw.Restart();
+
+        vector<string> batch;
+        sv2.GetSeqData(ranges, batch);
+        m_batch_time += sw.Elapsed();
+
+        if ( single != batch ) {
+            ERR_POST(Error << "batch GetSeqData mismatch on "
+                     << bsh.GetSeqId()->AsFastaString());
+        }
+        m_window_count += ranges.size();
+    }
+
     //  ------------------------------------------------------------------------
     void SeqEntryProcess()
     //  ------------------------------------------------------------------------
     {
+        if ( m_windows ) {
+            try {
+                VISIT_ALL_BIOSEQS_WITHIN_SEQENTRY (bit, *m_entry) {
+                    // !!! NOTE CALL TO OBJECT MANAGER !!!
+                    x_WindowsBenchmark(m_scope->GetBioseqHandle(*bit));
+                }
+            }
+            catch (CException& e) {
+                ERR_POST(Error << "error processing seqentry: " << e.what());
+            }
+            return;
+        }
+
         try {
             CDeflineGenerator gen (m_topseh);
 
@@ -215,6 +276,10 @@ protected:
     string m_gap_mode;
     bool m_debug;
     CStopWatch m_timer;
+    bool m_windows;
+    size_t m_window_count;
+    double m_single_time;
+    double m_batch_time;
 };
 
 #endif
@@ -194,7 +194,8 @@ void CStreamTestApp::Init()
     arg_desc->AddDefaultKey( "options", 
         "Options",
         "Test-specific options. E.g. 'map' for agpwrite tests "
-        "the comp id mapper ",
+        "the comp id mapper, 'windows' for seqvector benchmarks "
+        "batch retrieval of short windows ",
         CArgDescriptions::eString,
         "" );
 
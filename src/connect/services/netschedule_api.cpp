@@ -1002,6 +1002,81 @@ CNetScheduleAPI::EJobStatus SNetScheduleAPIImpl::GetJobStatus(string cmd,
     return CNetScheduleAPI::StringToStatus(parser("job_status"));
 }
 
+class CNetSchedulePipelineExecHandler : public INetServerExecHandler
+{
+public:
+    CNetSchedulePipelineExecHandler(const vector<string>& cmds,
+            vector<string>* responses) :
+        m_Cmds(cmds), m_Responses(responses)
+    {
+    }
+
+    virtual void Exec(CNetServerConnection::TInstance conn_impl,
+            const STimeout* timeout);
+
+    exception_ptr m_FirstError;
+
+private:
+    const vector<string>& m_Cmds;
+    vector<string>* m_Responses;
+};
+
+void CNetSchedulePipelineExecHandler::Exec(
+        CNetServerConnection::TInstance conn_impl, const STimeout* timeout)
+{
+    CTimeoutKeeper timeout_keeper(&conn_impl->m_Socket, timeout);
+
+    // All the commands go in one write
+    string pipeline;
+    for (const auto& cmd : m_Cmds) {
+        if (!pipeline.empty())
+            pipeline += "\r\n";
+        pipeline += cmd;
+    }
+    conn_impl->WriteLine(pipeline);
+
+    if (m_Responses != NULL)
+        m_Responses->resize(m_Cmds.size());
+
+    string response;
+    m_FirstError = nullptr;
+
+    try {
+        for (size_t i = 0; i < m_Cmds.size(); ++i) {
+            // An error reply is consumed entirely before the server
+            // listener throws, so the rest of the replies can be read
+            try {
+                conn_impl->ReadCmdOutputLine(response, false);
+                if (m_Responses != NULL)
+                    (*m_Responses)[i] = response;
+            }
+            catch (CNetServiceException&) {
+                if (!m_FirstError)
+                    m_FirstError = current_exception();
+            }
+        }
+    }
+    catch (...) {
+        // Unread replies must not get to the next user of the connection
+        conn_impl->Abort();
+        throw;
+    }
+}
+
+void SNetScheduleAPIImpl::ExecPipelined(CNetServer server,
+        const vector<string>& cmds, vector<string>* responses)
+{
+    if (cmds.empty())
+        return;
+
+    CNetSchedulePipelineExecHandler exec_handler(cmds, responses);
+
+    server->TryExec(exec_handler);
+
+    if (exec_handler.m_FirstError)
+        rethrow_exception(exec_handler.m_FirstError);
+}
+
 bool SNetScheduleAPIImpl::GetServerByNode(const string& ns_node,
         CNetServer* server)
 {
@@ -125,6 +125,51 @@ void CNetScheduleExecutor::JobDelayExpiration(const CNetScheduleJob& job,
     m_Impl->m_API->ExecOnJobServer(job, cmd, eOn);
 }
 
+size_t g_ParseGetJobsResponse(const string& response, unsigned max_jobs,
+        const function<void(string&)>& read_line,
+        vector<CNetScheduleJob>& jobs)
+{
+    if (!NStr::StartsWith(response, "jobs=")) {
+        CNetScheduleJob job;
+        if (s_ParseGetJobResponse(job, response))
+            jobs.push_back(job);
+        return 0;
+    }
+
+    unsigned job_count = NStr::StringToUInt(
+            CTempString(response).substr(sizeof("jobs=") - 1),
+            NStr::fConvErr_NoThrow);
+
+    if (job_count > max_jobs) {
+        NCBI_THROW(CNetScheduleException, eProtocolSyntaxError,
+                "More jobs than requested in server output for GET2:\n" +
+                response);
+    }
+
+    size_t failed = 0;
+    string line;
+
+    for (unsigned i = 0; i < job_count; ++i) {
+        read_line(line);
+
+        CNetScheduleJob job;
+
+        try {
+            if (s_DoParseGet2JobResponse(job, line)) {
+                jobs.push_back(job);
+                continue;
+            }
+        }
+        catch (CUrlParserException&) {
+        }
+
+        ERR_POST("Cannot parse server output for GET2:\n" << line);
+        ++failed;
+    }
+
+    return failed;
+}
+
 class CGetJobCmdExecutor : public INetServerFinder
 {
 public:
@@ -147,6 +192,30 @@ bool CGetJobCmdExecutor::Consider(CNetServer server)
     return m_Executor->ExecGET(server, m_GetCmd, m_Job);
 }
 
+class CGetJobsCmdExecutor : public INetServerFinder
+{
+public:
+    CGetJobsCmdExecutor(const string& get_cmd, unsigned max_jobs,
+            vector<CNetScheduleJob>& jobs, SNetScheduleExecutorImpl* executor) :
+        m_GetCmd(get_cmd), m_MaxJobs(max_jobs), m_Jobs(jobs),
+        m_Executor(executor)
+    {
+    }
+
+    virtual bool Consider(CNetServer server);
+
+private:
+    const string& m_GetCmd;
+    unsigned m_MaxJobs;
+    vector<CNetScheduleJob>& m_Jobs;
+    SNetScheduleExecutorImpl* m_Executor;
+};
+
+bool CGetJobsCmdExecutor::Consider(CNetServer server)
+{
+    return m_Executor->ExecGETJobs(server, m_GetCmd, m_MaxJobs, m_Jobs);
+}
+
 const CNetScheduleAPI::SServerParams& CNetScheduleExecutor::GetServerParams()
 {
     return m_Impl->m_API->GetServerParams();
@@ -216,13 +285,11 @@ string SNetScheduleExecutorImpl::MkSETAFFCmd()
     return cmd;
 }
 
-bool SNetScheduleExecutorImpl::ExecGET(SNetServerImpl* server,
-        const string& get_cmd, CNetScheduleJob& job)
+void SNetScheduleExecutorImpl::x_ExecGETCmd(SNetServerImpl* server,
+        const string& get_cmd, CNetServer::SExecResult& exec_result)
 {
     CNetScheduleGETCmdListener get_cmd_listener(this);
 
-    CNetServer::SExecResult exec_result;
-
     try {
         server->ConnectAndExec(get_cmd, false,
                 exec_result, NULL, &get_cmd_listener);
@@ -243,6 +310,14 @@ bool SNetScheduleExecutorImpl::ExecGET(SNetServerImpl* server,
         server->ConnectAndExec(get_cmd, false,
                 exec_result, NULL, &get_cmd_listener);
     }
+}
+
+bool SNetScheduleExecutorImpl::ExecGET(SNetServerImpl* server,
+        const string& get_cmd, CNetScheduleJob& job)
+{
+    CNetServer::SExecResult exec_result;
+
+    x_ExecGETCmd(server, get_cmd, exec_result);
 
     if (!s_ParseGetJobResponse(job, exec_result.response))
         return false;
@@ -257,6 +332,42 @@ bool SNetScheduleExecutorImpl::ExecGET(SNetServerImpl* server,
     return true;
 }
 
+bool SNetScheduleExecutorImpl::ExecGETJobs(SNetServerImpl* server,
+        const string& get_cmd, unsigned max_jobs,
+        vector<CNetScheduleJob>& jobs)
+{
+    CNetServer::SExecResult exec_result;
+
+    x_ExecGETCmd(server, get_cmd, exec_result);
+
+    vector<CNetScheduleJob> new_jobs;
+
+    try {
+        g_ParseGetJobsResponse(exec_result.response, max_jobs,
+                [&](string& line) {
+                    exec_result.conn->ReadCmdOutputLine(line, false);
+                }, new_jobs);
+    }
+    catch (...) {
+        // Do not leave the rest of the reply in the connection
+        exec_result.conn->Abort();
+        throw;
+    }
+
+    for (auto& job : new_jobs) {
+        // Remember the server that issued this job.
+        job.server = server;
+
+        // If a new preferred affinity is given by the server,
+        // register it with the rest of servers.
+        ClaimNewPreferredAffinity(server, job.affinity);
+
+        jobs.push_back(job);
+    }
+
+    return !new_jobs.empty();
+}
+
 bool SNetScheduleExecutorImpl::x_GetJobWithAffinityLadder(
         SNetServerImpl* server, const CDeadline& timeout, 
         const string& prio_aff_list, bool any_affinity, CNetScheduleJob& job)
@@ -327,6 +438,46 @@ bool CNetScheduleExecutor::GetJob(CNetScheduleJob& job,
     return false;
 }
 
+// Jobs requested at once at most, so that one worker node does not
+// take too many jobs from others
+static const unsigned kMaxGetJobsCount = 1000;
+
+size_t CNetScheduleExecutor::GetJobs(vector<CNetScheduleJob>& jobs,
+        unsigned max_jobs,
+        const string& affinity_list)
+{
+    if (max_jobs == 0)
+        return 0;
+
+    if (max_jobs > kMaxGetJobsCount)
+        max_jobs = kMaxGetJobsCount;
+
+    string cmd(CNetScheduleNotificationHandler::MkBaseGETCmd(
+            m_Impl->m_AffinityPreference, affinity_list));
+
+    cmd += " count=";
+    cmd += NStr::UIntToString(max_jobs);
+    m_Impl->m_NotificationHandler.CmdAppendTimeoutGroupAndClientInfo(
+            cmd, NULL, m_Impl->m_JobGroup);
+
+    size_t jobs_before = jobs.size();
+    CGetJobsCmdExecutor get_cmd_executor(cmd, max_jobs, jobs, m_Impl);
+
+    CNetServiceIterator it(m_Impl->m_API->m_Service.FindServer(
+            &get_cmd_executor, CNetService::eIncludePenalized));
+
+    if (!it)
+        return 0;
+
+    string cancel_wget_cmd("CWGET");
+    g_AppendClientIPSessionIDHitID(cancel_wget_cmd);
+
+    while (--it)
+        (*it).ExecWithRetry(cancel_wget_cmd, false);
+
+    return jobs.size() - jobs_before;
+}
+
 bool CNetScheduleExecutor::GetJob(CNetScheduleJob& job,
         unsigned wait_time,
         const string& affinity_list)
@@ -449,11 +600,8 @@ void static s_CheckOutputSize(const string& output, size_t max_output_size)
     }
 }
 
-void CNetScheduleExecutor::PutResult(const CNetScheduleJob& job)
+static string s_MkPUT2Cmd(const CNetScheduleJob& job)
 {
-    s_CheckOutputSize(job.output,
-        m_Impl->m_API->GetServerParams().max_output_size);
-
     string cmd("PUT2 job_key=" + job.job_id);
 
     limits::Check<limits::SAuthToken>(job.auth_token);
@@ -468,7 +616,51 @@ void CNetScheduleExecutor::PutResult(const CNetScheduleJob& job)
     cmd.push_back('\"');
 
     g_AppendClientIPSessionIDHitID(cmd);
-    m_Impl->m_API->ExecOnJobServer(job, cmd, m_Impl->retry_on_exception);
+    return cmd;
+}
+
+void CNetScheduleExecutor::PutResult(const CNetScheduleJob& job)
+{
+    s_CheckOutputSize(job.output,
+        m_Impl->m_API->GetServerParams().max_output_size);
+
+    m_Impl->m_API->ExecOnJobServer(job, s_MkPUT2Cmd(job),
+            m_Impl->retry_on_exception);
+}
+
+void CNetScheduleExecutor::PutResults(const vector<CNetScheduleJob>& jobs)
+{
+    size_t max_output_size = m_Impl->m_API->GetServerParams().max_output_size;
+
+    // Commands grouped by the server
+    map<SSocketAddress, pair<CNetServer, vector<string> > > cmds;
+
+    for (const auto& job : jobs) {
+        s_CheckOutputSize(job.output, max_output_size);
+
+        CNetServer server(m_Impl->m_API->GetServer(job));
+        auto& server_cmds = cmds[server.GetAddress()];
+
+        if (!server_cmds.first)
+            server_cmds.first = server;
+        server_cmds.second.push_back(s_MkPUT2Cmd(job));
+    }
+
+    exception_ptr first_error;
+
+    for (auto& server_cmds : cmds) {
+        try {
+            m_Impl->m_API->ExecPipelined(server_cmds.second.first,
+                    server_cmds.second.second);
+        }
+        catch (CException&) {
+            if (!first_error)
+                first_error = current_exception();
+        }
+    }
+
+    if (first_error)
+        rethrow_exception(first_error);
 }
 
 void CNetScheduleExecutor::PutProgressMsg(const CNetScheduleJob& job)
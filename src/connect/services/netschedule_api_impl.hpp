@@ -346,6 +346,12 @@ public:
         return server->ConnectAndExec(cmd, false, retry_on_exception).response;
     }
 
+    // Send all the commands at once and then read their replies from
+    // the same connection. If some of the commands fail, the first error
+    // is rethrown after all the replies have been read.
+    void ExecPipelined(CNetServer server, const vector<string>& cmds,
+            vector<string>* responses = NULL);
+
     bool GetServerByNode(const string& ns_node, CNetServer* server);
 
     void AllocNotificationThread();
@@ -436,6 +442,17 @@ inline SNetScheduleSubmitterImpl::SNetScheduleSubmitterImpl(
 {
 }
 
+// Decode a reply to GET2 with 'count': either 'jobs=N' followed by N lines
+// with one job each, or a single job (from servers that ignore 'count' or
+// when paused). The lines after 'response' are read with 'read_line'; all
+// of them are read, also after a line that cannot be parsed, so that the
+// connection can be reused. Returns the number of job lines that could not
+// be parsed.
+NCBI_XCONNECT_EXPORT
+size_t g_ParseGetJobsResponse(const string& response, unsigned max_jobs,
+        const function<void(string&)>& read_line,
+        vector<CNetScheduleJob>& jobs);
+
 struct SNetScheduleExecutorImpl : public CObject
 {
     SNetScheduleExecutorImpl(CNetScheduleAPI::TInstance ns_api_impl) :
@@ -453,6 +470,10 @@ struct SNetScheduleExecutorImpl : public CObject
     string MkSETAFFCmd();
     bool ExecGET(SNetServerImpl* server,
             const string& get_cmd, CNetScheduleJob& job);
+    bool ExecGETJobs(SNetServerImpl* server, const string& get_cmd,
+            unsigned max_jobs, vector<CNetScheduleJob>& jobs);
+    void x_ExecGETCmd(SNetServerImpl* server,
+            const string& get_cmd, CNetServer::SExecResult& exec_result);
     bool x_GetJobWithAffinityLadder(SNetServerImpl* server,
             const CDeadline& timeout,
             const string& prio_aff_list,
@@ -0,0 +1,131 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   Decoding of GET2 replies with several jobs
+ *
+ */
+
+#include <ncbi_pch.hpp>
+
+#include <corelib/test_boost.hpp>
+
+#include "../netschedule_api_impl.hpp"
+
+#include <common/test_assert.h>  /* This header must go last */
+
+USING_NCBI_SCOPE;
+
+// Reply lines following the first one, as read from the connection
+struct SReply
+{
+    SReply(const vector<string>& lines) : m_Lines(lines) {}
+
+    void operator()(string& line)
+    {
+        BOOST_REQUIRE(m_Read < m_Lines.size());
+        line = m_Lines[m_Read++];
+    }
+
+    vector<string> m_Lines;
+    size_t m_Read = 0;
+};
+
+static string s_JobLine(int n)
+{
+    return "job_key=JSID_01_" + to_string(n) + "_130.14.24.83_9101"
+        "&input=D%20" + to_string(n) + "&affinity=a" + to_string(n) +
+        "&client_ip=&client_sid=&ncbi_phid=&mask=0&auth_token=t";
+}
+
+BOOST_AUTO_TEST_SUITE(NetScheduleGetJobs)
+
+BOOST_AUTO_TEST_CASE(SingleJob)
+{
+    // From servers that ignore 'count'
+    SReply reply({});
+    vector<CNetScheduleJob> jobs;
+
+    BOOST_CHECK_EQUAL(g_ParseGetJobsResponse(s_JobLine(1), 10,
+                ref(reply), jobs), 0u);
+    BOOST_REQUIRE_EQUAL(jobs.size(), 1u);
+    BOOST_CHECK_EQUAL(jobs[0].job_id, "JSID_01_1_130.14.24.83_9101");
+    BOOST_CHECK_EQUAL(jobs[0].input, "D 1");
+
+    jobs.clear();
+    BOOST_CHECK_EQUAL(g_ParseGetJobsResponse("", 10, ref(reply), jobs), 0u);
+    BOOST_CHECK(jobs.empty());
+}
+
+BOOST_AUTO_TEST_CASE(MultipleJobs)
+{
+    SReply reply({ s_JobLine(1), s_JobLine(2), s_JobLine(3) });
+    vector<CNetScheduleJob> jobs;
+
+    BOOST_CHECK_EQUAL(g_ParseGetJobsResponse("jobs=3", 10,
+                ref(reply), jobs), 0u);
+    BOOST_CHECK_EQUAL(reply.m_Read, 3u);
+    BOOST_REQUIRE_EQUAL(jobs.size(), 3u);
+
+    for (int i = 0; i < 3; ++i) {
+        BOOST_CHECK_EQUAL(jobs[i].job_id,
+                "JSID_01_" + to_string(i + 1) + "_130.14.24.83_9101");
+        BOOST_CHECK_EQUAL(jobs[i].affinity, "a" + to_string(i + 1));
+        BOOST_CHECK_EQUAL(jobs[i].auth_token, "t");
+    }
+
+    jobs.clear();
+    BOOST_CHECK_EQUAL(g_ParseGetJobsResponse("jobs=0", 10,
+                ref(reply), jobs), 0u);
+    BOOST_CHECK(jobs.empty());
+}
+
+BOOST_AUTO_TEST_CASE(MalformedJob)
+{
+    // Lines after a bad one are still read and their jobs returned,
+    // so that nothing is left in the connection
+    SReply reply({ s_JobLine(1), "input=no%20key", "job_key=a b",
+            s_JobLine(4) });
+    vector<CNetScheduleJob> jobs;
+
+    BOOST_CHECK_EQUAL(g_ParseGetJobsResponse("jobs=4", 10,
+                ref(reply), jobs), 2u);
+    BOOST_CHECK_EQUAL(reply.m_Read, 4u);
+    BOOST_REQUIRE_EQUAL(jobs.size(), 2u);
+    BOOST_CHECK_EQUAL(jobs[0].job_id, "JSID_01_1_130.14.24.83_9101");
+    BOOST_CHECK_EQUAL(jobs[1].job_id, "JSID_01_4_130.14.24.83_9101");
+}
+
+BOOST_AUTO_TEST_CASE(TooManyJobs)
+{
+    SReply reply({ s_JobLine(1), s_JobLine(2) });
+    vector<CNetScheduleJob> jobs;
+
+    BOOST_CHECK_THROW(g_ParseGetJobsResponse("jobs=2", 1, ref(reply), jobs),
+            CNetScheduleException);
+    BOOST_CHECK_EQUAL(reply.m_Read, 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -414,6 +414,13 @@ CSeq_id_Handle CSeq_id_int_Tree::FindOrCreate(const CSeq_id& id)
     _ASSERT(x_Check(id));
     TPacked value = x_Get(id);
 
+    {{
+        TReadLockGuard guard(m_TreeLock);
+        TIntMap::const_iterator it = m_IntMap.find(value);
+        if ( it != m_IntMap.end() ) {
+            return CSeq_id_Handle(it->second);
+        }
+    }}
     TWriteLockGuard guard(m_TreeLock);
     pair<TIntMap::iterator, bool> ins =
         m_IntMap.insert(TIntMap::value_type(value, nullptr));
@@ -609,6 +616,12 @@ void CSeq_id_Gi_Tree::x_Unindex(const CSeq_id_Info* info)
 CSeq_id_Handle CSeq_id_Gi_Tree::GetGiHandle(TGi gi)
 {
     if ( gi != ZERO_GI ) {
+        {{
+            TReadLockGuard guard(m_TreeLock);
+            if ( m_SharedInfo ) {
+                return CSeq_id_Handle(m_SharedInfo, GI_TO(TPacked, gi));
+            }
+        }}
         TWriteLockGuard guard(m_TreeLock);
         if ( !m_SharedInfo ) {
             m_SharedInfo = new CSeq_id_Gi_Info(m_Mapper);
@@ -616,6 +629,12 @@ CSeq_id_Handle CSeq_id_Gi_Tree::GetGiHandle(TGi gi)
         return CSeq_id_Handle(m_SharedInfo, GI_TO(TPacked, gi));
     }
     else {
+        {{
+            TReadLockGuard guard(m_TreeLock);
+            if ( m_ZeroInfo ) {
+                return CSeq_id_Handle(m_ZeroInfo);
+            }
+        }}
         TWriteLockGuard guard(m_TreeLock);
         if ( !m_ZeroInfo ) {
             CRef<CSeq_id> zero_id(new CSeq_id);
@@ -1168,6 +1187,14 @@ CSeq_id_Handle CSeq_id_Textseq_Tree::FindOrCreate(const CSeq_id& id)
         TPackedKey key = CSeq_id_Textseq_Info::ParseAcc(acc, tid);
         if ( key ) {
             TPacked packed = CSeq_id_Textseq_Info::Pack(key, tid);
+            {{
+                TReadLockGuard guard(m_TreeLock);
+                TPackedMap_CI it = m_PackedMap.find(key);
+                if ( it != m_PackedMap.end() ) {
+                    return CSeq_id_Handle(it->second, packed,
+                                          it->first.ParseCaseVariant(acc));
+                }
+            }}
             CSeq_id_Handle::TVariant variant = 0;
             TWriteLockGuard guard(m_TreeLock);
             TPackedMap_I it = m_PackedMap.lower_bound(key);
@@ -1183,6 +1210,13 @@ CSeq_id_Handle CSeq_id_Textseq_Tree::FindOrCreate(const CSeq_id& id)
             return CSeq_id_Handle(it->second, packed, variant);
         }
     }
+    {{
+        TReadLockGuard guard(m_TreeLock);
+        if ( CSeq_id_Textseq_PlainInfo* info =
+             x_FindStrInfo(id.Which(), tid) ) {
+            return CSeq_id_Handle(info, 0, info->ParseCaseVariant(tid));
+        }
+    }}
     TWriteLockGuard guard(m_TreeLock);
     CSeq_id_Textseq_PlainInfo* info = x_FindStrInfo(id.Which(), tid);
     CSeq_id_Handle::TVariant variant = 0;
@@ -1998,6 +2032,12 @@ CSeq_id_Handle CSeq_id_Local_Tree::FindInfo(const CSeq_id& id) const
 CSeq_id_Handle CSeq_id_Local_Tree::FindOrCreate(const CSeq_id& id)
 {
     const CObject_id& oid = id.GetLocal();
+    {{
+        TReadLockGuard guard(m_TreeLock);
+        if ( CSeq_id_Local_Info* info = x_FindInfo(oid) ) {
+            return CSeq_id_Handle(info, 0, info->ParseCaseVariant(oid));
+        }
+    }}
     TWriteLockGuard guard(m_TreeLock);
     CSeq_id_Local_Info*& info = oid.IsStr()? m_ByStr[oid.GetStr()]: m_ById[oid.GetId()];
     CSeq_id_Handle::TVariant variant = 0;
@@ -2588,6 +2628,14 @@ CSeq_id_Handle CSeq_id_General_Tree::FindOrCreate(const CSeq_id& id)
                 break;
             }
             TPacked packed = CSeq_id_General_Str_Info::Pack(key, dbid);
+            {{
+                TReadLockGuard guard(m_TreeLock);
+                TPackedStrMap::const_iterator it = m_PackedStrMap.find(key);
+                if ( it != m_PackedStrMap.end() ) {
+                    return CSeq_id_Handle(it->second, packed,
+                                          it->first.ParseCaseVariant(dbid));
+                }
+            }}
             TWriteLockGuard guard(m_TreeLock);
             TPackedStrMap::iterator it = m_PackedStrMap.find(key);
             if ( it == m_PackedStrMap.end() ) {
@@ -2607,6 +2655,14 @@ CSeq_id_Handle CSeq_id_General_Tree::FindOrCreate(const CSeq_id& id)
         {
             const string& key = dbid.GetDb();
             TPacked packed = CSeq_id_General_Id_Info::Pack(key, dbid);
+            {{
+                TReadLockGuard guard(m_TreeLock);
+                TPackedIdMap::const_iterator it = m_PackedIdMap.find(key);
+                if ( it != m_PackedIdMap.end() ) {
+                    return CSeq_id_Handle(it->second, packed,
+                        s_ParseCaseVariant(it->first, dbid.GetDb()).first);
+                }
+            }}
             TWriteLockGuard guard(m_TreeLock);
             TPackedIdMap::iterator it = m_PackedIdMap.lower_bound(key);
             CSeq_id_Handle::TVariant variant = 0;
@@ -2626,6 +2682,12 @@ CSeq_id_Handle CSeq_id_General_Tree::FindOrCreate(const CSeq_id& id)
             break;
         }
     }
+    {{
+        TReadLockGuard guard(m_TreeLock);
+        if ( CSeq_id_General_PlainInfo* info = x_FindInfo(dbid) ) {
+            return CSeq_id_Handle(info, 0, info->ParseCaseVariant(dbid));
+        }
+    }}
     TWriteLockGuard guard(m_TreeLock);
     CSeq_id_General_PlainInfo* info = x_FindInfo(dbid);
     CSeq_id_Handle::TVariant variant = 0;
@@ -185,7 +185,10 @@ protected:
         }
     virtual void x_Unindex(const CSeq_id_Info* info) = 0;
 
-    typedef CFastMutex TTreeLock;
+    // Lookups of already known ids are done under the read lock, so they
+    // do not block each other; only creation and removal of CSeq_id_Info
+    // take the write lock.
+    typedef CFastRWLock TTreeLock;
     typedef TTreeLock::TReadLockGuard TReadLockGuard;
     typedef TTreeLock::TWriteLockGuard TWriteLockGuard;
 
@@ -0,0 +1,407 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   Seq-feats in columnar format (CObjectColumnWriter/CObjectColumnReader):
+ *   checks that all columns give back the same features and that selected
+ *   columns give back only the selected members, and that a feature which
+ *   cannot be written leaves no trace; compares the size and the time of
+ *   scanning one member with ASN.1 binary.
+ *
+ */
+
+#include <ncbi_pch.hpp>
+#include <corelib/ncbiapp.hpp>
+#include <corelib/ncbiargs.hpp>
+#include <corelib/ncbitime.hpp>
+#include <util/random_gen.hpp>
+#include <serial/serial.hpp>
+#include <serial/iterator.hpp>
+#include <serial/objcolumn.hpp>
+#include <serial/objectiter.hpp>
+#include <serial/objistr.hpp>
+#include <serial/objostr.hpp>
+#include <objects/general/Object_id.hpp>
+#include <objects/general/User_field.hpp>
+#include <objects/general/User_object.hpp>
+#include <objects/seqfeat/Gb_qual.hpp>
+#include <objects/seqfeat/Gene_ref.hpp>
+#include <objects/seqfeat/Seq_feat.hpp>
+#include <objects/seqfeat/SeqFeatData.hpp>
+#include <objects/seqloc/Seq_id.hpp>
+#include <objects/seqloc/Seq_interval.hpp>
+#include <objects/seqloc/Seq_loc.hpp>
+#include <objects/seqset/Seq_entry.hpp>
+
+#include <common/test_assert.h>  /* This header must go last */
+
+USING_NCBI_SCOPE;
+USING_SCOPE(objects);
+
+
+// String member, with dot separated name of the member of class members
+static bool s_GetMemberString(CConstObjectInfo object, const string& name,
+                              string& value)
+{
+    list<string> path;
+    NStr::Split(name, ".", path);
+    for ( auto& member : path ) {
+        while ( object.GetTypeFamily() == eTypeFamilyPointer ) {
+            object = object.GetPointedObject();
+        }
+        CConstObjectInfoMI m = object.FindClassMember(member);
+        if ( !m.IsSet() ) {
+            return false;
+        }
+        object = m.GetMember();
+    }
+    object.GetPrimitiveValueString(value);
+    return true;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+//  Test application
+
+class CTestApp : public CNcbiApplication
+{
+public:
+    virtual void Init(void);
+    virtual int  Run(void);
+
+private:
+    typedef vector< CConstRef<CSeq_feat> > TFeats;
+
+    void x_MakeFeats(size_t count, TFeats& feats);
+    bool x_CheckMembers(const CSeq_feat& feat, const CSeq_feat& original,
+                        const set<string>& selected);
+    bool x_CheckFailedRow(const TFeats& feats);
+
+    CRandom m_Random;
+};
+
+
+void CTestApp::Init(void)
+{
+    unique_ptr<CArgDescriptions> arg_desc(new CArgDescriptions);
+    arg_desc->SetUsageContext(GetArguments().GetProgramBasename(),
+                              "Seq-feats in columnar format");
+    arg_desc->AddOptionalKey("in", "File",
+                             "Seq-entry in ASN.1 text to take features from, "
+                             "instead of generated ones",
+                             CArgDescriptions::eInputFile);
+    arg_desc->AddDefaultKey("feats", "N", "Generated features",
+                            CArgDescriptions::eInteger, "200000");
+    arg_desc->AddDefaultKey("group", "N", "Rows per row group",
+                            CArgDescriptions::eInteger, "65536");
+    arg_desc->AddDefaultKey("columns", "Names",
+                            "Comma separated Seq-feat members to project",
+                            CArgDescriptions::eString, "comment,location");
+    arg_desc->AddDefaultKey("scan", "Name", "String member to scan",
+                            CArgDescriptions::eString, "comment");
+    SetupArgDescriptions(arg_desc.release());
+}
+
+
+void CTestApp::x_MakeFeats(size_t count, TFeats& feats)
+{
+    static const char* const kComments[] = {
+        "hypothetical protein", "putative transporter", "similar to",
+        "conserved domain", "frameshift"
+    };
+    static const char* const kLoci[] = { "abc", "xyzA", "dnaK", "recA" };
+    for ( size_t i = 0; i < count; ++i ) {
+        CRef<CSeq_feat> feat(new CSeq_feat);
+        if ( m_Random.GetRand(0, 1) ) {
+            feat->SetData().SetGene().SetLocus(kLoci[m_Random.GetRand(0, 3)]);
+        }
+        else {
+            feat->SetData().SetRegion("region " +
+                                      NStr::SizetToString(i % 1000));
+        }
+        CSeq_interval& interval = feat->SetLocation().SetInt();
+        interval.SetId().SetLocal().SetId(int(i / 100));
+        interval.SetFrom(m_Random.GetRand(0, 1000000));
+        interval.SetTo(interval.GetFrom() + m_Random.GetRand(0, 5000));
+        if ( m_Random.GetRand(0, 2) == 0 ) {
+            interval.SetStrand(eNa_strand_minus);
+        }
+        if ( m_Random.GetRand(0, 9) == 0 ) {
+            feat->SetPartial(true);
+        }
+        if ( m_Random.GetRand(0, 1) ) {
+            feat->SetComment(kComments[m_Random.GetRand(0, 4)]);
+        }
+        if ( m_Random.GetRand(0, 3) == 0 ) {
+            CRef<CGb_qual> qual(new CGb_qual("note", "qualifier " +
+                                             NStr::SizetToString(i)));
+            feat->SetQual().push_back(qual);
+        }
+        if ( m_Random.GetRand(0, 4) == 0 ) {
+            feat->SetExp_ev(CSeq_feat::eExp_ev_experimental);
+        }
+        if ( m_Random.GetRand(0, 9) == 0 ) {
+            CUser_object& ext = feat->SetExt();
+            ext.SetType().SetStr("ModelEvidence");
+            ext.SetClass("test");
+            ext.AddField("score", int(i % 97));
+        }
+        feats.push_back(feat);
+    }
+}
+
+
+// Selected members must be equal to the original ones, optional others
+// not set
+bool CTestApp::x_CheckMembers(const CSeq_feat& feat,
+                              const CSeq_feat& original,
+                              const set<string>& selected)
+{
+    CConstObjectInfo info(ConstObjectInfo(feat));
+    CConstObjectInfo orig(ConstObjectInfo(original));
+    for ( CConstObjectInfoMI m = info.BeginMembers(); m; ++m ) {
+        const string& name = m.GetMemberInfo()->GetId().GetName();
+        CConstObjectInfoMI o = orig.FindClassMember(name);
+        if ( selected.count(name) ) {
+            if ( m.IsSet() != o.IsSet() ||
+                 (m.IsSet() &&
+                  !m.GetMember().GetTypeInfo()->
+                  Equals(m.GetMember().GetObjectPtr(),
+                         o.GetMember().GetObjectPtr())) ) {
+                ERR_POST("member " << name << " differs");
+                return false;
+            }
+        }
+        else if ( m.GetMemberInfo()->Optional() && m.IsSet() ) {
+            ERR_POST("member " << name << " is not selected, but is set");
+            return false;
+        }
+    }
+    return true;
+}
+
+
+// A feature without location in the middle of the others is rejected,
+// and the others are read back unchanged
+bool CTestApp::x_CheckFailedRow(const TFeats& feats)
+{
+    TFeats written(feats.begin(), feats.begin() + min(feats.size(),
+                                                      size_t(10)));
+    CRef<CSeq_feat> bad(new CSeq_feat);
+    bad->Assign(*written.front());
+    bad->SetComment("not written");
+    bad->SetLocation().Reset();
+    string columns;
+    bool thrown = false;
+    {{
+        CNcbiOstrstream str;
+        CObjectColumnWriter writer(str, CSeq_feat::GetTypeInfo(), 4);
+        for ( size_t i = 0; i < written.size(); ++i ) {
+            if ( i == written.size() / 2 ) {
+                try {
+                    writer.Write(ConstObjectInfo(*bad));
+                }
+                catch ( CSerialException& ) {
+                    thrown = true;
+                }
+            }
+            writer.Write(ConstObjectInfo(*written[i]));
+        }
+        writer.Close();
+        columns = CNcbiOstrstreamToString(str);
+    }}
+    if ( !thrown ) {
+        ERR_POST("feature without location is written");
+        return false;
+    }
+    // the comment of the failed row must not be left in the dictionary
+    string expected;
+    {{
+        CNcbiOstrstream str;
+        CObjectColumnWriter writer(str, CSeq_feat::GetTypeInfo(), 4);
+        for ( auto& feat : written ) {
+            writer.Write(ConstObjectInfo(*feat));
+        }
+        writer.Close();
+        expected = CNcbiOstrstreamToString(str);
+    }}
+    if ( columns != expected ) {
+        ERR_POST("failed row left data behind");
+        return false;
+    }
+    size_t row_index = 0;
+    CNcbiIstrstream str(columns);
+    CObjectColumnReader reader(str, CSeq_feat::GetTypeInfo());
+    CSeq_feat feat;
+    while ( reader.NextRowGroup() ) {
+        for ( size_t row = 0; row < reader.GetRowCount(); ++row ) {
+            reader.ReadObject(ObjectInfo(feat), row);
+            if ( row_index >= written.size() ||
+                 !feat.Equals(*written[row_index]) ) {
+                ERR_POST("row " << row_index << " differs after failed row");
+                return false;
+            }
+            ++row_index;
+        }
+    }
+    return row_index == written.size();
+}
+
+
+int CTestApp::Run(void)
+{
+    const CArgs& args = GetArgs();
+
+    TFeats feats;
+    if ( args["in"] ) {
+        CSeq_entry entry;
+        args["in"].AsInputFile() >> MSerial_AsnText >> entry;
+        for ( CTypeConstIterator<CSeq_feat> it(Begin(entry)); it; ++it ) {
+            feats.push_back(ConstRef(&*it));
+        }
+    }
+    else {
+        x_MakeFeats(args["feats"].AsInteger(), feats);
+    }
+
+    // columnar and ASN.1 binary
+    CStopWatch sw(CStopWatch::eStart);
+    string columns;
+    {{
+        CNcbiOstrstream str;
+        CObjectColumnWriter writer(str, CSeq_feat::GetTypeInfo(),
+                                   args["group"].AsInteger());
+        for ( auto& feat : feats ) {
+            writer.Write(ConstObjectInfo(*feat));
+        }
+        writer.Close();
+        columns = CNcbiOstrstreamToString(str);
+    }}
+    double write_time = sw.Restart();
+    string asnb;
+    {{
+        CNcbiOstrstream str;
+        unique_ptr<CObjectOStream> out(CObjectOStream::Open(eSerial_AsnBinary,
+                                                            str));
+        for ( auto& feat : feats ) {
+            *out << *feat;
+        }
+        out->Flush();
+        asnb = CNcbiOstrstreamToString(str);
+    }}
+    double asnb_write_time = sw.Restart();
+    NcbiCout << feats.size() << " features; columnar " << columns.size()
+             << " bytes, " << write_time << " s to write; ASN.1 binary "
+             << asnb.size() << " bytes, " << asnb_write_time << " s"
+             << NcbiEndl;
+
+    // all columns
+    bool ok = true;
+    size_t row_index = 0;
+    {{
+        CNcbiIstrstream str(columns);
+        CObjectColumnReader reader(str, CSeq_feat::GetTypeInfo());
+        CSeq_feat feat;
+        while ( reader.NextRowGroup() ) {
+            for ( size_t row = 0; row < reader.GetRowCount(); ++row ) {
+                reader.ReadObject(ObjectInfo(feat), row);
+                ok &= row_index < feats.size() &&
+                    feat.Equals(*feats[row_index]);
+                ++row_index;
+            }
+        }
+        ok &= row_index == feats.size();
+    }}
+    ok &= x_CheckFailedRow(feats);
+
+    // selected members
+    list<string> names;
+    NStr::Split(args["columns"].AsString(), ",", names);
+    set<string> selected(names.begin(), names.end());
+    row_index = 0;
+    {{
+        CNcbiIstrstream str(columns);
+        CObjectColumnReader reader(str, CSeq_feat::GetTypeInfo());
+        reader.SelectColumns(vector<string>(names.begin(), names.end()));
+        CSeq_feat feat;
+        while ( ok && reader.NextRowGroup() ) {
+            for ( size_t row = 0; ok && row < reader.GetRowCount(); ++row ) {
+                reader.ReadObject(ObjectInfo(feat), row);
+                ok &= x_CheckMembers(feat, *feats[row_index++], selected);
+            }
+        }
+    }}
+    NcbiCout << (ok ? "Features match the original ones"
+                 : "MISMATCHES FOUND") << NcbiEndl;
+
+    // scan of one string member
+    const string& scan = args["scan"].AsString();
+    sw.Restart();
+    size_t found = 0;
+    {{
+        CNcbiIstrstream str(columns);
+        CObjectColumnReader reader(str, CSeq_feat::GetTypeInfo());
+        size_t column = reader.GetColumns().FindColumn(scan);
+        reader.SelectColumns(vector<string>(1, scan));
+        while ( reader.NextRowGroup() ) {
+            for ( size_t row = 0; row < reader.GetRowCount(); ++row ) {
+                if ( reader.IsSet(column, row) ) {
+                    found += !reader.GetString(column, row).empty();
+                }
+            }
+        }
+    }}
+    double scan_time = sw.Restart();
+    size_t asnb_found = 0;
+    {{
+        CNcbiIstrstream str(asnb);
+        unique_ptr<CObjectIStream> in(CObjectIStream::Open(eSerial_AsnBinary,
+                                                           str));
+        CSeq_feat feat;
+        while ( !in->EndOfData() ) {
+            *in >> feat;
+            string value;
+            if ( s_GetMemberString(ConstObjectInfo(feat), scan, value) ) {
+                asnb_found += !value.empty();
+            }
+        }
+    }}
+    double asnb_scan_time = sw.Elapsed();
+    ok &= found == asnb_found;
+    NcbiCout << "scan of " << scan << ": " << found << " values; columnar "
+             << scan_time << " s, ASN.1 binary " << asnb_scan_time << " s"
+             << NcbiEndl;
+
+    return ok ? 0 : 1;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+//  MAIN
+
+int main(int argc, const char* argv[])
+{
+    return CTestApp().AppMain(argc, argv);
+}
@@ -0,0 +1,246 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   Reading of Seq-entry JSON with and without the vectorized scanning of
+ *   string values in CObjectIStreamJson, checking that both give the same
+ *   objects.
+ *
+ */
+
+#include <ncbi_pch.hpp>
+#include <corelib/ncbiapp.hpp>
+#include <corelib/ncbiargs.hpp>
+#include <corelib/ncbitime.hpp>
+#include <util/random_gen.hpp>
+#include <serial/serial.hpp>
+#include <serial/objistr.hpp>
+#include <serial/objistrjson.hpp>
+#include <serial/objostr.hpp>
+#include <objects/general/Object_id.hpp>
+#include <objects/seq/Bioseq.hpp>
+#include <objects/seq/IUPACna.hpp>
+#include <objects/seq/Seq_annot.hpp>
+#include <objects/seq/Seq_data.hpp>
+#include <objects/seq/Seq_descr.hpp>
+#include <objects/seq/Seq_inst.hpp>
+#include <objects/seq/Seqdesc.hpp>
+#include <objects/seqfeat/Seq_feat.hpp>
+#include <objects/seqloc/Seq_id.hpp>
+#include <objects/seqloc/Seq_interval.hpp>
+#include <objects/seqloc/Seq_loc.hpp>
+#include <objects/seqset/Bioseq_set.hpp>
+#include <objects/seqset/Seq_entry.hpp>
+
+#include <common/test_assert.h>  /* This header must go last */
+
+USING_NCBI_SCOPE;
+USING_SCOPE(objects);
+
+
+/////////////////////////////////////////////////////////////////////////////
+//  Test application
+
+class CTestApp : public CNcbiApplication
+{
+public:
+    virtual void Init(void);
+    virtual int  Run(void);
+
+private:
+    CRef<CSeq_entry> x_MakeEntry(int seqs, TSeqPos length, int feats);
+    CRef<CSeq_entry> x_Read(const string& json, bool simd,
+                            EEncoding encoding = eEncoding_UTF8);
+    string x_MakeText(size_t length);
+
+    CRandom m_Random;
+};
+
+
+void CTestApp::Init(void)
+{
+    unique_ptr<CArgDescriptions> arg_desc(new CArgDescriptions);
+    arg_desc->SetUsageContext(GetArguments().GetProgramBasename(),
+                              "Vectorized vs char-by-char JSON reading");
+    arg_desc->AddOptionalKey("in", "File",
+                             "Seq-entry in ASN.1 text to read as JSON, "
+                             "instead of generated data",
+                             CArgDescriptions::eInputFile);
+    arg_desc->AddDefaultKey("seqs", "N", "Generated sequences",
+                            CArgDescriptions::eInteger, "200");
+    arg_desc->AddDefaultKey("length", "N", "Generated sequence length, bases",
+                            CArgDescriptions::eInteger, "20000");
+    arg_desc->AddDefaultKey("feats", "N", "Generated features per sequence",
+                            CArgDescriptions::eInteger, "20");
+    arg_desc->AddDefaultKey("iterations", "N", "Timed runs per mode",
+                            CArgDescriptions::eInteger, "5");
+    SetupArgDescriptions(arg_desc.release());
+}
+
+
+// Words with quotes and backslashes, which are escaped in JSON, now and then
+string CTestApp::x_MakeText(size_t length)
+{
+    static const char* const kWords[] = {
+        "protein", "putative", "hypothetical", "similar", "to", "the",
+        "\"quoted\"", "back\\slash", "of"
+    };
+    const size_t kCount = sizeof(kWords) / sizeof(kWords[0]);
+    string text;
+    while ( text.size() < length ) {
+        if ( !text.empty() ) {
+            text += ' ';
+        }
+        text += kWords[m_Random.GetRand(0, kCount - 1)];
+    }
+    return text;
+}
+
+
+CRef<CSeq_entry> CTestApp::x_MakeEntry(int seqs, TSeqPos length, int feats)
+{
+    static const char kBases[] = "ACGT";
+    CRef<CSeq_entry> entry(new CSeq_entry);
+    CBioseq_set& bset = entry->SetSet();
+    bset.SetClass(CBioseq_set::eClass_genbank);
+    for ( int s = 0;  s < seqs;  ++s ) {
+        CRef<CSeq_id> id(new CSeq_id);
+        id->SetLocal().SetStr("seq" + NStr::IntToString(s));
+
+        CRef<CSeq_entry> seq_entry(new CSeq_entry);
+        CBioseq& seq = seq_entry->SetSeq();
+        seq.SetId().push_back(id);
+        CRef<CSeqdesc> title(new CSeqdesc);
+        title->SetTitle(x_MakeText(80));
+        seq.SetDescr().Set().push_back(title);
+
+        CSeq_inst& inst = seq.SetInst();
+        inst.SetRepr(CSeq_inst::eRepr_raw);
+        inst.SetMol(CSeq_inst::eMol_dna);
+        inst.SetLength(length);
+        string& bases = inst.SetSeq_data().SetIupacna().Set();
+        bases.resize(length);
+        for ( TSeqPos i = 0;  i < length;  ++i ) {
+            bases[i] = kBases[m_Random.GetRand(0, 3)];
+        }
+
+        CRef<CSeq_annot> annot(new CSeq_annot);
+        for ( int f = 0;  f < feats;  ++f ) {
+            CRef<CSeq_feat> feat(new CSeq_feat);
+            feat->SetData().SetComment();
+            feat->SetComment(x_MakeText(m_Random.GetRand(10, 200)));
+            CSeq_interval& interval = feat->SetLocation().SetInt();
+            interval.SetId(*id);
+            interval.SetFrom(m_Random.GetRand(0, length / 2));
+            interval.SetTo(interval.GetFrom() + length / 4);
+            annot->SetData().SetFtable().push_back(feat);
+        }
+        seq.SetAnnot().push_back(annot);
+
+        bset.SetSeq_set().push_back(seq_entry);
+    }
+    return entry;
+}
+
+
+CRef<CSeq_entry> CTestApp::x_Read(const string& json, bool simd,
+                                  EEncoding encoding)
+{
+    CNcbiIstrstream str(json);
+    CObjectIStreamJson in(str, eNoOwnership);
+    in.SetSimdEnabled(simd);
+    in.SetDefaultStringEncoding(encoding);
+    CRef<CSeq_entry> entry(new CSeq_entry);
+    in >> *entry;
+    return entry;
+}
+
+
+int CTestApp::Run(void)
+{
+    const CArgs& args = GetArgs();
+    int iterations = args["iterations"].AsInteger();
+
+    CRef<CSeq_entry> entry;
+    if ( args["in"] ) {
+        entry.Reset(new CSeq_entry);
+        args["in"].AsInputFile() >> MSerial_AsnText >> *entry;
+    }
+    else {
+        entry = x_MakeEntry(args["seqs"].AsInteger(),
+                            args["length"].AsInteger(),
+                            args["feats"].AsInteger());
+    }
+    string json;
+    {{
+        CNcbiOstrstream str;
+        str << MSerial_Json << *entry;
+        json = CNcbiOstrstreamToString(str);
+    }}
+
+    {{
+        CNcbiIstrstream str(json);
+        CObjectIStreamJson in(str, eNoOwnership);
+        if ( !in.IsSimdEnabled() ) {
+            NcbiCout << "Vectorized scanning is not available on this CPU"
+                     << NcbiEndl;
+        }
+    }}
+
+    // Correctness: the same objects in both modes, also when visible
+    // strings are converted to another encoding
+    bool ok = x_Read(json, true)->Equals(*x_Read(json, false))  &&
+        x_Read(json, true, eEncoding_ISO8859_1)->
+        Equals(*x_Read(json, false, eEncoding_ISO8859_1));
+    NcbiCout << (ok ? "Results match the char-by-char reading"
+                 : "MISMATCHES FOUND") << NcbiEndl;
+
+    // Throughput
+    NcbiCout << json.size() << " bytes of JSON, " << iterations
+             << " iterations; MB/s:" << NcbiEndl;
+    double rate[2];
+    for ( int simd = 0;  simd < 2;  ++simd ) {
+        CStopWatch sw(CStopWatch::eStart);
+        for ( int i = 0;  i < iterations;  ++i ) {
+            x_Read(json, simd != 0);
+        }
+        rate[simd] = double(json.size()) * iterations / sw.Elapsed() / 1e6;
+    }
+    NcbiCout << fixed << setprecision(2)
+             << "char-by-char " << rate[0]
+             << "  simd " << rate[1]
+             << "  x" << rate[1] / rate[0] << NcbiEndl;
+
+    return ok ? 0 : 1;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+//  MAIN
+
+int main(int argc, const char* argv[])
+{
+    return CTestApp().AppMain(argc, argv);
+}
@@ -44,6 +44,13 @@
 #include <corelib/test_boost.hpp>
 #include <objects/general/Object_id.hpp>
 #include <objects/seqloc/Seq_id.hpp>
+#include <objects/biblio/Auth_list.hpp>
+#include <objects/biblio/Author.hpp>
+#include <objects/general/Name_std.hpp>
+#include <objects/general/Person_id.hpp>
+#include <serial/delaybuf.hpp>
+#include <serial/impl/classinfo.hpp>
+#include <serial/impl/member.hpp>
 #include <corelib/ncbierror.hpp>
 
 /////////////////////////////////////////////////////////////////////////////
@@ -401,3 +408,48 @@ BOOST_AUTO_TEST_CASE(s_TestAsnSerializationCopy)
         CFile(loc_name).Remove();
     }
 }
+
+
+/////////////////////////////////////////////////////////////////////////////
+// Objects parsed later from a delay buffer come from the memory pool
+// of the stream the buffer was read with
+
+BOOST_AUTO_TEST_CASE(s_TestDelayBufferMemoryPool)
+{
+    CAuth_list authors;
+    for ( int i = 0; i < 3; ++i ) {
+        CRef<CAuthor> author(new CAuthor);
+        author->SetName().SetName().SetLast("Author" + NStr::IntToString(i));
+        authors.SetNames().SetStd().push_back(author);
+    }
+    string data;
+    {{
+        CNcbiOstrstream str;
+        str << MSerial_AsnBinary << authors;
+        data = CNcbiOstrstreamToString(str);
+    }}
+
+    CAuth_list read;
+    {{
+        CNcbiIstrstream str(data);
+        unique_ptr<CObjectIStream> in(CObjectIStream::Open(eSerial_AsnBinary,
+                                                           str));
+        in->UseMemoryPool();
+        in->SetDelayBufferParsingPolicy(
+            CObjectIStream::eDelayBufferPolicyNeverParse);
+        *in >> read;
+    }}
+    const CMemberInfo* names =
+        CTypeConverter<CClassTypeInfo>::SafeCast(CAuth_list::GetTypeInfo())->
+        GetMemberInfo("names");
+    BOOST_REQUIRE(names->GetDelayBuffer(&read).Delayed());
+
+    // the stream is gone, the buffer keeps its pool
+    BOOST_REQUIRE(read.Equals(authors));
+    BOOST_CHECK(!names->GetDelayBuffer(&read).Delayed());
+    BOOST_CHECK(!read.IsAllocatedInPool());
+    ITERATE ( CAuth_list::C_Names::TStd, it, read.GetNames().GetStd() ) {
+        BOOST_CHECK((*it)->IsAllocatedInPool());
+        BOOST_CHECK((*it)->GetName().GetName().IsAllocatedInPool());
+    }
+}
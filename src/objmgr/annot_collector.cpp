@@ -750,6 +750,15 @@ public:
 
     const CSeq_loc* GetComplexLoc(bool by_product);
 
+    // Seq-table feature with location in separate columns
+    const CSeqTableInfo* GetColumnLocTable(bool by_product) {
+        if ( by_product || !m_Info || m_Info->IsRegular() ) {
+            return 0;
+        }
+        const CSeqTableInfo& table = m_Ref.GetSeqTableInfo();
+        return table.HasColumnLocation()? &table: 0;
+    }
+
     bool IsSetProduct(void);
     CConstRef<CSeq_id> GetProductId(void);
 
@@ -863,6 +872,10 @@ ENa_strand CCreateFeat::GetStrand(bool by_product)
                 // table SNP or sorted table features have strand in mapping
                 return map.GetMappedStrand();
             }
+            else if ( const CSeqTableInfo* table = GetColumnLocTable(by_product) ) {
+                // strand column of Seq-table
+                return table->GetLocationStrand(m_Ref.GetAnnotIndex());
+            }
             else {
                 // get location from the Seq-feat
                 return GetLoc(GetOriginalFeat(), by_product).GetStrand();
@@ -899,6 +912,10 @@ const CSeq_loc* CCreateFeat::GetComplexLoc(bool by_product)
         return &loc;
     }
     else {
+        if ( GetColumnLocTable(by_product) ) {
+            // Seq-table columns describe simple location -> no mix
+            return 0;
+        }
         // get location from the Seq-feat
         const CSeq_loc& loc = GetLoc(GetOriginalFeat(), by_product);
         return &loc;
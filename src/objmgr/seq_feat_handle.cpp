@@ -213,15 +213,16 @@ CConstRef<CSeq_feat> CSeq_feat_Handle::GetSeq_feat(void) const
 
 bool CSeq_feat_Handle::IsSetPartial(void) const
 {
-    if ( x_HasAnnotObjectInfo() ) {
-        return GetSeq_feat()->IsSetPartial();
+    if ( IsTableFeat() ) {
+        // partial flag is in its own column
+        return x_GetSeq_annot_Info().GetTableInfo()
+            .IsSetPartial(x_GetFeatIndex());
     }
     else if ( IsTableSNP() ) {
         // table SNP features do not have partial
         return false;
     }
     else {
-        // TODO
         return GetSeq_feat()->IsSetPartial();
     }
 }
@@ -229,20 +230,53 @@ bool CSeq_feat_Handle::IsSetPartial(void) const
 
 bool CSeq_feat_Handle::GetPartial(void) const
 {
-    if ( x_HasAnnotObjectInfo() ) {
-        return GetSeq_feat()->GetPartial();
+    if ( IsTableFeat() ) {
+        // partial flag is in its own column
+        return x_GetSeq_annot_Info().GetTableInfo()
+            .IsPartial(x_GetFeatIndex());
     }
     else if ( IsTableSNP() ) {
         // table SNP features do not have partial
         return false;
     }
     else {
-        // TODO
         return GetSeq_feat()->GetPartial();
     }
 }
 
 
+bool CSeq_feat_Handle::IsSetComment(void) const
+{
+    if ( IsTableSNP() ) {
+        // table SNP features may have comment
+        return IsSetSNPComment();
+    }
+    else if ( IsTableFeat() ) {
+        return x_GetSeq_annot_Info().GetTableInfo()
+            .GetComment(x_GetFeatIndex()) != 0;
+    }
+    else {
+        return GetSeq_feat()->IsSetComment();
+    }
+}
+
+
+const string& CSeq_feat_Handle::GetComment(void) const
+{
+    if ( IsTableSNP() ) {
+        // table SNP features may have comment
+        return GetSNPComment();
+    }
+    else if ( IsTableFeat() ) {
+        if ( const string* comment = x_GetSeq_annot_Info().GetTableInfo()
+             .GetComment(x_GetFeatIndex()) ) {
+            return *comment;
+        }
+    }
+    return GetSeq_feat()->GetComment();
+}
+
+
 const CSeq_loc& CSeq_feat_Handle::GetProduct(void) const
 {
     return GetSeq_feat()->GetProduct();
@@ -272,40 +306,38 @@ bool CSeq_feat_Handle::IsSetData(void) const
 
 CSeq_id_Handle CSeq_feat_Handle::GetLocationId(void) const
 {
-    if ( x_HasAnnotObjectInfo() ) {
-        CConstRef<CSeq_loc> loc(&GetLocation());
-        if ( const CSeq_id* id = loc->GetId() ) {
-            return CSeq_id_Handle::GetHandle(*id);
+    if ( IsTableFeat() ) {
+        const CSeqTableInfo& table = x_GetSeq_annot_Info().GetTableInfo();
+        if ( table.HasColumnLocation() ) {
+            // no need to create Seq-feat
+            return table.GetLocation().GetIdHandle(x_GetFeatIndex());
         }
-        return CSeq_id_Handle();
     }
     else if ( IsTableSNP() ) {
         return CSeq_id_Handle::GetHandle(GetSNPSeq_id());
     }
-    else {
-        // TODO
-        CConstRef<CSeq_loc> loc(&GetLocation());
-        if ( const CSeq_id* id = loc->GetId() ) {
-            return CSeq_id_Handle::GetHandle(*id);
-        }
-        return CSeq_id_Handle();
+    CConstRef<CSeq_loc> loc(&GetLocation());
+    if ( const CSeq_id* id = loc->GetId() ) {
+        return CSeq_id_Handle::GetHandle(*id);
     }
+    return CSeq_id_Handle();
 }
 
 
 CSeq_feat_Handle::TRange CSeq_feat_Handle::GetRange(void) const
 {
-    if ( x_HasAnnotObjectInfo() ) {
-        return GetSeq_feat()->GetLocation().GetTotalRange();
+    if ( IsTableFeat() ) {
+        const CSeqTableInfo& table = x_GetSeq_annot_Info().GetTableInfo();
+        if ( table.HasColumnLocation() ) {
+            // no need to create Seq-feat
+            return table.GetLocationRange(x_GetFeatIndex());
+        }
     }
     else if ( IsTableSNP() ) {
         const SSNP_Info& info = x_GetSNP_Info();
         return TRange(info.GetFrom(), info.GetTo());
     }
-    else {
-        // TODO
-        return GetSeq_feat()->GetLocation().GetTotalRange();
-    }
+    return GetSeq_feat()->GetLocation().GetTotalRange();
 }
 
 
@@ -466,6 +498,12 @@ CConstRef<CDbtag> CSeq_feat_Handle::GetNamedDbxref(const CTempString& db) const
 
 const string& CSeq_feat_Handle::GetNamedQual(const CTempString& qual_name) const
 {
+    if ( IsTableFeat() ) {
+        // qualifiers are stored in separate columns
+        const string* value = x_GetSeq_annot_Info().GetTableInfo()
+            .GetNamedQual(x_GetFeatIndex(), qual_name);
+        return value? *value: kEmptyStr;
+    }
     return GetSeq_feat()->GetNamedQual(qual_name);
 }
 
@@ -1088,6 +1088,31 @@ string CSeqTableInfo::GetLabel(size_t index) const
 }
 
 
+const string* CSeqTableInfo::GetComment(size_t row) const
+{
+    if ( const CSeqTableColumnInfo* column =
+         FindColumn(CSeqTable_column_info::eField_id_comment) ) {
+        return column->GetStringPtr(row);
+    }
+    return 0;
+}
+
+
+const string* CSeqTableInfo::GetNamedQual(size_t row,
+                                          const CTempString& qual_name) const
+{
+    // qualifier columns are named "Q.<qual>", see CSeqTableSetQual
+    string name;
+    name.reserve(qual_name.size()+2);
+    name += "Q.";
+    name += qual_name;
+    if ( const CSeqTableColumnInfo* column = FindColumn(name) ) {
+        return column->GetStringPtr(row);
+    }
+    return 0;
+}
+
+
 bool CSeqTableInfo::MatchBitFilter(const SAnnotSelector& sel,
                                    size_t index) const
 {
@@ -308,6 +308,23 @@ void CSeqVector::GetSeqData(TSeqPos start, TSeqPos stop, string& buffer) const
 }
 
 
+void CSeqVector::GetSeqData(const vector<TSeqRange>& ranges,
+                            vector<string>& buffers) const
+{
+    if ( ranges.empty() ) {
+        buffers.clear();
+        return;
+    }
+    TMutexGuard guard(GetMutex());
+    // batch retrieval doesn't need the iterator to be positioned
+    CSeqVector_CI* iter = m_Iterator.get();
+    if ( !iter ) {
+        iter = x_CreateIterator(min(ranges.front().GetFrom(), size()));
+    }
+    iter->GetSeqData(ranges, buffers);
+}
+
+
 void CSeqVector::GetPackedSeqData(string& dst_str,
                                   TSeqPos src_pos,
                                   TSeqPos src_end)
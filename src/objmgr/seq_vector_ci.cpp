@@ -511,25 +511,32 @@ void CSeqVector_CI::x_UpdateCacheDown(TSeqPos pos)
 
 void CSeqVector_CI::x_FillCache(TSeqPos start, TSeqPos count)
 {
-    _ASSERT(m_Seg.GetType() != CSeqMap::eSeqEnd);
-    _ASSERT(start >= m_Seg.GetPosition());
-    _ASSERT(start < m_Seg.GetEndPosition());
-
     x_ResizeCache(count);
+    x_FillData(m_Seg, m_Cache, start, count);
+    m_CachePos = start;
+}
+
 
-    switch ( m_Seg.GetType() ) {
+void CSeqVector_CI::x_FillData(const CSeqMap_CI& seg, char* dst,
+                               TSeqPos start, TSeqPos count)
+{
+    _ASSERT(seg.GetType() != CSeqMap::eSeqEnd);
+    _ASSERT(start >= seg.GetPosition());
+    _ASSERT(start < seg.GetEndPosition());
+
+    switch ( seg.GetType() ) {
     case CSeqMap::eSeqData:
     {
-        const CSeq_data& data = m_Seg.GetRefData();
-        if ( data.IsGap() && m_Seg.GetType() == CSeqMap::eSeqGap ) {
+        const CSeq_data& data = seg.GetRefData();
+        if ( data.IsGap() && seg.GetType() == CSeqMap::eSeqGap ) {
             // workaround for erroneously split gap Seq-data
-            x_FillCache(start, count);
+            x_FillData(seg, dst, start, count);
             return;
         }
         
         TCoding dataCoding = data.Which();
         TCoding cacheCoding = x_GetCoding(m_Coding, dataCoding);
-        bool reverse = m_Seg.GetRefMinusStrand();
+        bool reverse = seg.GetRefMinusStrand();
 
         bool randomize = false;
         if ( cacheCoding != dataCoding &&
@@ -554,51 +561,51 @@ void CSeqVector_CI::x_FillCache(TSeqPos start, TSeqPos count)
         TSeqPos dataPos;
         if ( reverse ) {
             // Revert segment offset
-            dataPos = m_Seg.GetRefEndPosition() -
-                (start - m_Seg.GetPosition()) - count;
+            dataPos = seg.GetRefEndPosition() -
+                (start - seg.GetPosition()) - count;
         }
         else {
-            dataPos = m_Seg.GetRefPosition() +
-                (start - m_Seg.GetPosition());
+            dataPos = seg.GetRefPosition() +
+                (start - seg.GetPosition());
         }
 
         switch ( dataCoding ) {
         case CSeq_data::e_Iupacna:
-            copy_8bit_any(m_Cache, count, data.GetIupacna().Get(), dataPos,
+            copy_8bit_any(dst, count, data.GetIupacna().Get(), dataPos,
                           table, reverse);
             break;
         case CSeq_data::e_Iupacaa:
-            copy_8bit_any(m_Cache, count, data.GetIupacaa().Get(), dataPos,
+            copy_8bit_any(dst, count, data.GetIupacaa().Get(), dataPos,
                           table, reverse);
             break;
         case CSeq_data::e_Ncbi2na:
-            copy_2bit_any(m_Cache, count, data.GetNcbi2na().Get(), dataPos,
+            copy_2bit_any(dst, count, data.GetNcbi2na().Get(), dataPos,
                             table, reverse);
             break;
         case CSeq_data::e_Ncbi4na:
-            copy_4bit_any(m_Cache, count, data.GetNcbi4na().Get(), dataPos,
+            copy_4bit_any(dst, count, data.GetNcbi4na().Get(), dataPos,
                           table, reverse);
             break;
         case CSeq_data::e_Ncbi8na:
-            copy_8bit_any(m_Cache, count, data.GetNcbi8na().Get(), dataPos,
+            copy_8bit_any(dst, count, data.GetNcbi8na().Get(), dataPos,
                           table, reverse);
             break;
         case CSeq_data::e_Ncbipna:
             NCBI_THROW(CSeqVectorException, eCodingError,
                        "Ncbipna conversion not implemented");
         case CSeq_data::e_Ncbi8aa:
-            copy_8bit_any(m_Cache, count, data.GetNcbi8aa().Get(), dataPos,
+            copy_8bit_any(dst, count, data.GetNcbi8aa().Get(), dataPos,
                           table, reverse);
             break;
         case CSeq_data::e_Ncbieaa:
-            copy_8bit_any(m_Cache, count, data.GetNcbieaa().Get(), dataPos,
+            copy_8bit_any(dst, count, data.GetNcbieaa().Get(), dataPos,
                           table, reverse);
             break;
         case CSeq_data::e_Ncbipaa:
             NCBI_THROW(CSeqVectorException, eCodingError,
                        "Ncbipaa conversion not implemented");
         case CSeq_data::e_Ncbistdaa:
-            copy_8bit_any(m_Cache, count, data.GetNcbistdaa().Get(), dataPos,
+            copy_8bit_any(dst, count, data.GetNcbistdaa().Get(), dataPos,
                           table, reverse);
             break;
         default:
@@ -606,25 +613,24 @@ void CSeqVector_CI::x_FillCache(TSeqPos start, TSeqPos count)
                            "Invalid data coding: "<<dataCoding);
         }
         if ( randomize ) {
-            m_Randomizer->RandomizeData(m_Cache, count, start);
+            m_Randomizer->RandomizeData(dst, count, start);
         }
         break;
     }
     case CSeqMap::eSeqGap:
         if (m_Coding == CSeq_data::e_Ncbi2na  &&  m_Randomizer) {
-            fill_n(m_Cache, count,
+            fill_n(dst, count,
                    sx_GetGapChar(CSeq_data::e_Ncbi4na, eCaseConversion_none));
-            m_Randomizer->RandomizeData(m_Cache, count, start);
+            m_Randomizer->RandomizeData(dst, count, start);
         }
         else {
-            fill_n(m_Cache, count, GetGapChar());
+            fill_n(dst, count, GetGapChar());
         }
         break;
     default:
         NCBI_THROW_FMT(CSeqVectorException, eDataError,
-                       "Invalid segment type: "<<m_Seg.GetType());
+                       "Invalid segment type: "<<seg.GetType());
     }
-    m_CachePos = start;
 }
 
 
@@ -754,6 +760,84 @@ void CSeqVector_CI::GetSeqData(string& buffer, TSeqPos count)
 }
 
 
+void CSeqVector_CI::GetSeqData(const vector<TSeqRange>& ranges,
+                               vector<string>& buffers)
+{
+    buffers.resize(ranges.size());
+    TSeqPos size = x_GetSize();
+    // Check the whole span of the ranges at once, and fall back to
+    // the checks of separate ranges only if some part of the span
+    // cannot be resolved
+    bool check_ranges = false;
+    if ( m_TSE ) {
+        TSeqPos span_start = kInvalidSeqPos, span_end = 0;
+        ITERATE ( vector<TSeqRange>, it, ranges ) {
+            if ( !it->Empty() && it->GetFrom() < size ) {
+                span_start = min(span_start, it->GetFrom());
+                span_end = max(span_end, min(it->GetToOpen(), size));
+            }
+        }
+        if ( span_start < span_end &&
+             (span_start < m_ScannedStart || span_end > m_ScannedEnd) ) {
+            check_ranges = !CanGetRange(span_start, span_end);
+        }
+    }
+    // Own segment iterator, the current one must stay in sync with the cache
+    CSeqMap_CI seg;
+    for ( size_t i = 0; i < ranges.size(); ++i ) {
+        string& buffer = buffers[i];
+        buffer.erase();
+        if ( ranges[i].Empty() ) {
+            continue;
+        }
+        TSeqPos pos = ranges[i].GetFrom();
+        TSeqPos end = min(ranges[i].GetToOpen(), size);
+        if ( pos >= end ) {
+            continue;
+        }
+
+        if ( check_ranges &&
+             (pos < m_ScannedStart || end > m_ScannedEnd) &&
+             !CanGetRange(pos, end) ) {
+            NCBI_THROW_FMT(CSeqVectorException, eDataError,
+                           "CSeqVector_CI::GetSeqData: "
+                           "cannot get seq-data in range: "
+                           <<pos<<"-"<<end);
+        }
+
+        buffer.resize(end - pos);
+        char* dst = &buffer[0];
+        while ( pos < end ) {
+            if ( seg && seg.GetEndPosition() <= pos ) {
+                // next range is usually in the same or the next segment
+                do {
+                    ++seg;
+                } while ( seg && seg.GetLength() == 0 );
+            }
+            if ( !seg || pos < seg.GetPosition() ||
+                 pos >= seg.GetEndPosition() ) {
+                // stepping over a reference between the ranges must not
+                // fail, the ranges themselves are checked above
+                SSeqMapSelector sel(CSeqMap::fDefaultFlags |
+                                    CSeqMap::fIgnoreUnresolved, kMax_UInt);
+                sel.SetStrand(m_Strand).SetLinkUsedTSE(m_TSE);
+                seg = CSeqMap_CI(m_SeqMap, m_Scope.GetScopeOrNull(), sel, pos);
+                if ( !seg || pos < seg.GetPosition() ||
+                     pos >= seg.GetEndPosition() ) {
+                    NCBI_THROW_FMT(CSeqVectorException, eDataError,
+                                   "CSeqVector_CI: cannot locate segment at "
+                                   <<pos);
+                }
+            }
+            TSeqPos count = min(end, seg.GetEndPosition()) - pos;
+            x_FillData(seg, dst, pos, count);
+            dst += count;
+            pos += count;
+        }
+    }
+}
+
+
 void CSeqVector_CI::x_NextCacheSeg()
 {
     _ASSERT(m_SeqMap);
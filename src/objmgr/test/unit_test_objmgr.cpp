@@ -55,6 +55,7 @@
 #include <objects/seqtable/seqtable__.hpp>
 #include <objmgr/util/sequence.hpp>
 #include <serial/iterator.hpp>
+#include <util/random_gen.hpp>
 
 #ifdef NCBI_THREADS
 # include <thread>
@@ -893,6 +894,72 @@ BOOST_AUTO_TEST_CASE(TestReResolveMT4)
         BOOST_REQUIRE_EQUAL(c, total_feats);
     }
 }
+
+
+BOOST_AUTO_TEST_CASE(TestSeq_id_HandleMT)
+{
+    // concurrent lookups must return the same handles as serial ones,
+    // including ids that are created and released by other threads
+    const size_t COUNT = 2000;
+    const size_t THREADS = 10;
+    const size_t ROUNDS = 20;
+
+    vector< CRef<CSeq_id> > ids;
+    for ( size_t i = 0; i < COUNT; ++i ) {
+        CRef<CSeq_id> id;
+        switch ( i % 4 ) {
+        case 0:
+            id = new CSeq_id("NC_"+NStr::NumericToString(100000+i)+".1");
+            break;
+        case 1:
+            id = new CSeq_id;
+            id->SetGi(GI_FROM(size_t, 1000+i));
+            break;
+        case 2:
+            id = new CSeq_id("lcl|seq"+NStr::NumericToString(i));
+            break;
+        default:
+            id = new CSeq_id("gnl|TESTDB|"+NStr::NumericToString(i));
+            break;
+        }
+        ids.push_back(id);
+    }
+    // keep every other handle alive, the rest are created on demand
+    vector<CSeq_id_Handle> kept(COUNT);
+    for ( size_t i = 0; i < COUNT; i += 2 ) {
+        kept[i] = CSeq_id_Handle::GetHandle(*ids[i]);
+    }
+    vector< future<size_t> > ff(THREADS);
+    for ( size_t ti = 0; ti < THREADS; ++ti ) {
+        ff[ti] =
+            async(std::launch::async,
+                  [&]() -> size_t
+                  {
+                      size_t errors = 0;
+                      for ( size_t r = 0; r < ROUNDS; ++r ) {
+                          for ( size_t i = 0; i < COUNT; ++i ) {
+                              CSeq_id_Handle idh =
+                                  CSeq_id_Handle::GetHandle(*ids[i]);
+                              if ( kept[i] ) {
+                                  errors += idh != kept[i];
+                              }
+                              errors += !idh.GetSeqId()->Equals(*ids[i]);
+                          }
+                      }
+                      return errors;
+                  });
+    }
+    for ( size_t ti = 0; ti < THREADS; ++ti ) {
+        BOOST_CHECK_EQUAL(ff[ti].get(), 0u);
+    }
+    for ( size_t i = 0; i < COUNT; ++i ) {
+        CSeq_id_Handle idh = CSeq_id_Handle::GetHandle(*ids[i]);
+        BOOST_CHECK(idh == CSeq_id_Handle::GetHandle(*ids[i]));
+        if ( kept[i] ) {
+            BOOST_CHECK(idh == kept[i]);
+        }
+    }
+}
 #endif // NCBI_THREADS
 
 BOOST_AUTO_TEST_CASE(CppIterFeat)
@@ -1187,6 +1254,220 @@ BOOST_AUTO_TEST_CASE(CppIterTable)
 }
 
 
+BOOST_AUTO_TEST_CASE(TestTableFeatColumns)
+{
+    // columnar accessors of table features must agree with the Seq-feat
+    CScope scope(*CObjectManager::GetInstance());
+    CRef<CSeq_id> id = s_GetId(1);
+    CRef<CSeq_entry> entry = s_GetEntry(1, 100);
+    const int kRows = 10;
+    CRef<CSeq_table> table(new CSeq_table);
+    table->SetFeat_type(CSeqFeatData::e_Region);
+    table->SetNum_rows(kRows);
+    {
+        auto col = make_ref<CSeqTable_column>();
+        col->SetHeader().SetField_id(CSeqTable_column_info::eField_id_location_id);
+        col->SetDefault().SetId(*id);
+        table->SetColumns().push_back(col);
+    }
+    {
+        auto col_from = make_ref<CSeqTable_column>();
+        col_from->SetHeader().SetField_id(CSeqTable_column_info::eField_id_location_from);
+        auto col_to = make_ref<CSeqTable_column>();
+        col_to->SetHeader().SetField_id(CSeqTable_column_info::eField_id_location_to);
+        auto col_strand = make_ref<CSeqTable_column>();
+        col_strand->SetHeader().SetField_id(CSeqTable_column_info::eField_id_location_strand);
+        for ( int i = 0; i < kRows; ++i ) {
+            col_from->SetData().SetInt().push_back(i*5);
+            col_to->SetData().SetInt().push_back(i*5+20);
+            col_strand->SetData().SetInt().push_back(i%2? eNa_strand_minus: eNa_strand_plus);
+        }
+        table->SetColumns().push_back(col_from);
+        table->SetColumns().push_back(col_to);
+        table->SetColumns().push_back(col_strand);
+    }
+    {
+        auto col = make_ref<CSeqTable_column>();
+        col->SetHeader().SetField_id(CSeqTable_column_info::eField_id_data_region);
+        col->SetDefault().SetString("test");
+        table->SetColumns().push_back(col);
+    }
+    {
+        // sparse comment column, set on every third row
+        auto col = make_ref<CSeqTable_column>();
+        col->SetHeader().SetField_id(CSeqTable_column_info::eField_id_comment);
+        for ( int i = 0; i < kRows; i += 3 ) {
+            col->SetSparse().SetIndexes().push_back(i);
+            col->SetData().SetString().push_back("comment "+NStr::IntToString(i));
+        }
+        table->SetColumns().push_back(col);
+    }
+    {
+        auto col = make_ref<CSeqTable_column>();
+        col->SetHeader().SetField_id(CSeqTable_column_info::eField_id_qual);
+        col->SetHeader().SetField_name("Q.allele");
+        for ( int i = 0; i < kRows; ++i ) {
+            col->SetData().SetString().push_back(string(1, char('A'+i)));
+        }
+        table->SetColumns().push_back(col);
+    }
+    CRef<CSeq_annot> annot(new CSeq_annot);
+    annot->SetData().SetSeq_table(*table);
+    entry->SetSeq().SetAnnot().push_back(annot);
+    CBioseq_Handle bh = scope.AddTopLevelSeqEntry(*entry).GetSeq();
+
+    size_t count = 0, comments = 0;
+    for ( CFeat_CI it(bh); it; ++it ) {
+        ++count;
+        CSeq_feat_Handle fh = *it;
+        BOOST_CHECK(fh.IsTableFeat());
+        CConstRef<CSeq_feat> feat = fh.GetOriginalSeq_feat();
+        BOOST_CHECK_EQUAL(fh.GetRange(), feat->GetLocation().GetTotalRange());
+        BOOST_CHECK_EQUAL(fh.GetLocationId(),
+                          CSeq_id_Handle::GetHandle(*feat->GetLocation().GetId()));
+        BOOST_CHECK_EQUAL(it->GetLocation().GetStrand(),
+                          feat->GetLocation().GetStrand());
+        BOOST_CHECK_EQUAL(fh.IsSetComment(), feat->IsSetComment());
+        if ( feat->IsSetComment() ) {
+            ++comments;
+            BOOST_CHECK_EQUAL(fh.GetComment(), feat->GetComment());
+        }
+        BOOST_CHECK_EQUAL(fh.GetNamedQual("allele"), feat->GetNamedQual("allele"));
+        BOOST_CHECK_EQUAL(fh.GetNamedQual("note"), kEmptyStr);
+    }
+    BOOST_CHECK_EQUAL(count, size_t(kRows));
+    BOOST_CHECK_EQUAL(comments, size_t((kRows+2)/3));
+}
+
+
+static CRef<CSeq_entry> s_GetNucEntry(int id, const string& data)
+{
+    CRef<CSeq_entry> entry(new CSeq_entry);
+    CBioseq& seq = entry->SetSeq();
+    seq.SetId().push_back(s_GetId2(id));
+    CSeq_inst& inst = seq.SetInst();
+    inst.SetRepr(inst.eRepr_raw);
+    inst.SetMol(inst.eMol_dna);
+    inst.SetLength(TSeqPos(data.size()));
+    inst.SetSeq_data().SetIupacna().Set(data);
+    return entry;
+}
+
+
+static void s_AddLiteral(CBioseq& seq, const string& data, TSeqPos gap = 0)
+{
+    CRef<CDelta_seq> delta(new CDelta_seq);
+    if ( gap ) {
+        delta->SetLiteral().SetLength(gap);
+    }
+    else {
+        delta->SetLiteral().SetLength(TSeqPos(data.size()));
+        delta->SetLiteral().SetSeq_data().SetIupacna().Set(data);
+    }
+    seq.SetInst().SetExt().SetDelta().Set().push_back(delta);
+}
+
+
+static void s_AddReference(CBioseq& seq, int id,
+                           TSeqPos from, TSeqPos to, ENa_strand strand)
+{
+    CRef<CDelta_seq> delta(new CDelta_seq);
+    CSeq_interval& interval = delta->SetLoc().SetInt();
+    interval.SetId(*s_GetId2(id));
+    interval.SetFrom(from);
+    interval.SetTo(to);
+    interval.SetStrand(strand);
+    seq.SetInst().SetExt().SetDelta().Set().push_back(delta);
+}
+
+
+// batch GetSeqData() must give the same data as separate calls
+static void s_CheckBatchSeqData(const CSeqVector& sv,
+                                const vector<TSeqRange>& ranges)
+{
+    vector<string> buffers;
+    sv.GetSeqData(ranges, buffers);
+    BOOST_REQUIRE_EQUAL(buffers.size(), ranges.size());
+    for ( size_t i = 0; i < ranges.size(); ++i ) {
+        string buffer;
+        if ( !ranges[i].Empty() && ranges[i].GetFrom() < sv.size() ) {
+            sv.GetSeqData(ranges[i].GetFrom(),
+                          min(ranges[i].GetToOpen(), sv.size()), buffer);
+        }
+        BOOST_CHECK_EQUAL(buffers[i], buffer);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(TestBatchGetSeqData)
+{
+    CScope scope(*CObjectManager::GetInstance());
+    scope.AddTopLevelSeqEntry
+        (*s_GetNucEntry(101, "AAAAAAAAAACCCCCCCCCCGGGGGGGGGGTTTTTTTTTT"));
+    scope.AddTopLevelSeqEntry
+        (*s_GetNucEntry(102, "ACGGTTTAAACCCCGGGGGTTTTTTAAAAA"));
+
+    // multi-segment sequence with references on both strands and a gap
+    CRef<CSeq_entry> entry(new CSeq_entry);
+    CBioseq& seq = entry->SetSeq();
+    seq.SetId().push_back(s_GetId2(100));
+    seq.SetInst().SetRepr(CSeq_inst::eRepr_delta);
+    seq.SetInst().SetMol(CSeq_inst::eMol_dna);
+    s_AddLiteral(seq, "ACGTACGTTT");
+    s_AddReference(seq, 101, 5, 34, eNa_strand_plus);
+    s_AddLiteral(seq, "", 15);
+    s_AddReference(seq, 102, 0, 29, eNa_strand_minus);
+    s_AddLiteral(seq, "GGGCCCAT");
+    seq.SetInst().SetLength(10+30+15+30+8);
+    CBioseq_Handle bh = scope.AddTopLevelSeqEntry(*entry).GetSeq();
+
+    CRandom rnd(1);
+    vector<TSeqRange> sorted_ranges, random_ranges;
+    for ( TSeqPos pos = 0; pos < 100; pos += 3 ) {
+        sorted_ranges.push_back(TSeqRange(pos, pos+rnd.GetRand(0, 20)));
+    }
+    for ( int i = 0; i < 100; ++i ) {
+        TSeqPos from = rnd.GetRand(0, 110);
+        random_ranges.push_back(TSeqRange(from, from+rnd.GetRand(0, 30)));
+    }
+    random_ranges.push_back(TSeqRange::GetEmpty());
+    random_ranges.push_back(TSeqRange(200, 300));
+    random_ranges.push_back(TSeqRange::GetWhole());
+
+    ITERATE ( vector<ENa_strand>, strand,
+              vector<ENa_strand>({ eNa_strand_plus, eNa_strand_minus }) ) {
+        CSeqVector sv = bh.GetSeqVector(CBioseq_Handle::eCoding_Iupac, *strand);
+        BOOST_REQUIRE_EQUAL(sv.size(), 93u);
+        s_CheckBatchSeqData(sv, sorted_ranges);
+        s_CheckBatchSeqData(sv, random_ranges);
+        s_CheckBatchSeqData(sv, vector<TSeqRange>());
+    }
+
+    // unresolvable reference fails only the ranges that overlap it
+    CRef<CSeq_entry> entry2(new CSeq_entry);
+    CBioseq& seq2 = entry2->SetSeq();
+    seq2.SetId().push_back(s_GetId2(200));
+    seq2.SetInst().SetRepr(CSeq_inst::eRepr_delta);
+    seq2.SetInst().SetMol(CSeq_inst::eMol_dna);
+    s_AddLiteral(seq2, "ACGTACGTACGTACGTACGT");
+    s_AddReference(seq2, 999, 0, 9, eNa_strand_plus);
+    s_AddLiteral(seq2, "TTTTTGGGGGCCCCCAAAAA");
+    seq2.SetInst().SetLength(50);
+    CBioseq_Handle bh2 = scope.AddTopLevelSeqEntry(*entry2).GetSeq();
+    CSeqVector sv2 = bh2.GetSeqVector(CBioseq_Handle::eCoding_Iupac);
+    vector<TSeqRange> ranges;
+    ranges.push_back(TSeqRange(0, 9));
+    ranges.push_back(TSeqRange(35, 49));
+    vector<string> buffers;
+    sv2.GetSeqData(ranges, buffers);
+    BOOST_REQUIRE_EQUAL(buffers.size(), 2u);
+    BOOST_CHECK_EQUAL(buffers[0], "ACGTACGTAC");
+    BOOST_CHECK_EQUAL(buffers[1], "GGGGGCCCCCAAAAA");
+    ranges.push_back(TSeqRange(15, 24));
+    BOOST_CHECK_THROW(sv2.GetSeqData(ranges, buffers), CException);
+}
+
+
 // verify error message
 class CExpectDiagHandler : public CDiagHandler
 {
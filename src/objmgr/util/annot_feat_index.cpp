@@ -0,0 +1,480 @@
+/*  $Id$
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+* File Description:
+*   Read-only feature index over Seq-annots, without CScope
+*/
+
+#include <ncbi_pch.hpp>
+#include <objmgr/util/annot_feat_index.hpp>
+#include <objects/seq/Seq_annot.hpp>
+#include <objects/seqfeat/Seq_feat.hpp>
+#include <objects/seqfeat/SeqFeatXref.hpp>
+#include <objects/seqfeat/Feat_id.hpp>
+#include <objects/seqfeat/Gene_ref.hpp>
+#include <objects/seqloc/Seq_loc.hpp>
+#include <objects/general/Object_id.hpp>
+
+BEGIN_NCBI_SCOPE
+BEGIN_SCOPE(objects)
+BEGIN_SCOPE(feature)
+
+USING_SCOPE(sequence);
+
+
+namespace {
+    typedef vector< pair<CSeq_id_Handle, CRange<TSeqPos> > > TIdRanges;
+
+    // Extremes of the location on each Seq-id it refers to.
+    void s_GetIdRanges(const CSeq_loc& loc, TIdRanges& ranges)
+    {
+        ranges.clear();
+        if ( const CSeq_id* id = loc.GetId() ) {
+            CRange<TSeqPos> range = loc.GetTotalRange();
+            if ( !range.Empty() ) {
+                ranges.push_back(make_pair(CSeq_id_Handle::GetHandle(*id),
+                                           range));
+            }
+            return;
+        }
+        for ( CSeq_loc_CI it(loc, CSeq_loc_CI::eEmpty_Skip); it; ++it ) {
+            const CSeq_id_Handle& idh = it.GetSeq_id_Handle();
+            if ( !idh ) {
+                continue;
+            }
+            TIdRanges::iterator r = ranges.begin();
+            while ( r != ranges.end() && r->first != idh ) {
+                ++r;
+            }
+            if ( r == ranges.end() ) {
+                ranges.push_back(make_pair(idh, it.GetRange()));
+            }
+            else {
+                r->second.CombineWith(it.GetRange());
+            }
+        }
+    }
+
+
+    bool s_CanHaveGene(CSeqFeatData::ESubtype subtype)
+    {
+        switch ( subtype ) {
+        case CSeqFeatData::eSubtype_gene:
+        case CSeqFeatData::eSubtype_operon:
+        case CSeqFeatData::eSubtype_gap:
+            // these do not inherit gene, see STypeLink in feature.cpp
+        case CSeqFeatData::eSubtype_prot:
+        case CSeqFeatData::eSubtype_mat_peptide:
+        case CSeqFeatData::eSubtype_sig_peptide:
+        case CSeqFeatData::eSubtype_transit_peptide:
+            // protein features are linked via CDS product, not indexed
+            return false;
+        default:
+            return true;
+        }
+    }
+
+
+    bool s_OppositeStrands(const CSeq_loc& loc1, const CSeq_loc& loc2)
+    {
+        return IsReverse(loc1.GetStrand()) != IsReverse(loc2.GetStrand());
+    }
+
+
+    // intervals within one level differ in length at most 16 times
+    const int kLevelShift = 4;
+    const size_t kLevelCount = 32/kLevelShift+1;
+
+    size_t s_GetLevel(TSeqPos length)
+    {
+        size_t level = 0;
+        while ( length >>= kLevelShift ) {
+            ++level;
+        }
+        return level;
+    }
+}
+
+
+const CAnnotFeatIndex::TFeatIndex CAnnotFeatIndex::kNoFeat;
+
+
+CAnnotFeatIndex::CAnnotFeatIndex(const CSeq_annot& annot)
+{
+    x_AddAnnot(annot);
+    x_Index();
+    x_LinkParents();
+}
+
+
+CAnnotFeatIndex::CAnnotFeatIndex(const TAnnots& annots)
+{
+    ITERATE ( TAnnots, it, annots ) {
+        x_AddAnnot(**it);
+    }
+    x_Index();
+    x_LinkParents();
+}
+
+
+CAnnotFeatIndex::~CAnnotFeatIndex(void)
+{
+}
+
+
+void CAnnotFeatIndex::x_AddAnnot(const CSeq_annot& annot)
+{
+    if ( !annot.IsFtable() ) {
+        return;
+    }
+    m_Annots.push_back(ConstRef(&annot));
+    const CSeq_annot::TData::TFtable& ftable = annot.GetData().GetFtable();
+    ITERATE ( CSeq_annot::TData::TFtable, it, ftable ) {
+        x_AddFeat(**it);
+    }
+}
+
+
+void CAnnotFeatIndex::x_AddFeat(const CSeq_feat& feat)
+{
+    if ( m_Feats.size() >= kNoFeat ) {
+        NCBI_THROW(CException, eUnknown,
+                   "CAnnotFeatIndex: too many features");
+    }
+    SFeatInfo info;
+    info.m_Feat = &feat;
+    info.m_Subtype = feat.GetData().GetSubtype();
+    info.m_Parent = kNoFeat;
+    m_Feats.push_back(info);
+}
+
+
+void CAnnotFeatIndex::x_Index(void)
+{
+    TIdRanges ranges;
+    for ( TFeatIndex i = 0; i < m_Feats.size(); ++i ) {
+        const SFeatInfo& info = m_Feats[i];
+        const CSeq_feat& feat = *info.m_Feat;
+        s_GetIdRanges(feat.GetLocation(), ranges);
+        ITERATE ( TIdRanges, r, ranges ) {
+            SInterval interval;
+            interval.m_From = r->second.GetFrom();
+            interval.m_To = r->second.GetTo();
+            interval.m_Feat = i;
+            TIntervals& levels =
+                m_Intervals[TIntervalsKey(r->first, info.m_Subtype)];
+            if ( levels.empty() ) {
+                levels.resize(kLevelCount);
+            }
+            SLevel& level = levels[s_GetLevel(r->second.GetLength())];
+            level.m_MaxLength = max(level.m_MaxLength,
+                                    r->second.GetLength());
+            level.m_Intervals.push_back(interval);
+        }
+        if ( feat.IsSetId() && feat.GetId().IsLocal() ) {
+            m_FeatsById.insert(TFeatIdMap::value_type(&feat.GetId().GetLocal(), i));
+        }
+        if ( info.m_Subtype == CSeqFeatData::eSubtype_gene ) {
+            const CGene_ref& gene = feat.GetData().GetGene();
+            if ( gene.IsSetLocus_tag() ) {
+                m_GenesByLocusTag.insert
+                    (TGeneNameMap::value_type(gene.GetLocus_tag(), i));
+            }
+            if ( gene.IsSetLocus() ) {
+                m_GenesByLocus.insert
+                    (TGeneNameMap::value_type(gene.GetLocus(), i));
+            }
+        }
+    }
+    NON_CONST_ITERATE ( TIntervalsMap, it, m_Intervals ) {
+        TIntervals& levels = it->second;
+        // drop empty levels
+        levels.erase(remove_if(levels.begin(), levels.end(),
+                               [](const SLevel& level) {
+                                   return level.m_Intervals.empty();
+                               }),
+                     levels.end());
+        NON_CONST_ITERATE ( TIntervals, level, levels ) {
+            sort(level->m_Intervals.begin(), level->m_Intervals.end());
+            level->m_Intervals.shrink_to_fit();
+        }
+        levels.shrink_to_fit();
+    }
+}
+
+
+void CAnnotFeatIndex::x_LinkParents(void)
+{
+    vector<TFeatIndex> child_count(m_Feats.size()+1);
+    for ( TFeatIndex i = 0; i < m_Feats.size(); ++i ) {
+        SFeatInfo& info = m_Feats[i];
+        if ( !s_CanHaveGene(info.m_Subtype) ) {
+            continue;
+        }
+        const CSeq_loc& loc = info.m_Feat->GetLocation();
+        if ( info.m_Subtype == CSeqFeatData::eSubtype_cdregion ) {
+            info.m_Parent = x_FindParentByXref(i, CSeqFeatData::eSubtype_mRNA);
+            if ( info.m_Parent == kNoFeat ) {
+                info.m_Parent = x_FindBestParent(loc,
+                                                 CSeqFeatData::eSubtype_mRNA,
+                                                 eOverlap_CheckIntervals);
+            }
+        }
+        if ( info.m_Parent == kNoFeat ) {
+            bool suppressed = false;
+            info.m_Parent = x_FindGeneByGeneXref(i, suppressed);
+            if ( info.m_Parent == kNoFeat && !suppressed ) {
+                info.m_Parent =
+                    x_FindParentByXref(i, CSeqFeatData::eSubtype_gene);
+                if ( info.m_Parent == kNoFeat ) {
+                    info.m_Parent =
+                        x_FindBestParent(loc, CSeqFeatData::eSubtype_gene,
+                                         eOverlap_Subset);
+                }
+            }
+        }
+        if ( info.m_Parent != kNoFeat ) {
+            ++child_count[info.m_Parent+1];
+        }
+    }
+    // convert counts into start offsets and fill children in index order
+    for ( size_t i = 1; i < child_count.size(); ++i ) {
+        child_count[i] += child_count[i-1];
+    }
+    m_ChildStart = child_count;
+    m_Children.resize(m_ChildStart.back());
+    for ( TFeatIndex i = 0; i < m_Feats.size(); ++i ) {
+        TFeatIndex parent = m_Feats[i].m_Parent;
+        if ( parent != kNoFeat ) {
+            m_Children[child_count[parent]++] = i;
+        }
+    }
+}
+
+
+CAnnotFeatIndex::TFeatIndex
+CAnnotFeatIndex::x_FindParentByXref(TFeatIndex feat,
+                                    CSeqFeatData::ESubtype parent_type) const
+{
+    const CSeq_feat& seq_feat = *m_Feats[feat].m_Feat;
+    if ( !seq_feat.IsSetXref() ) {
+        return kNoFeat;
+    }
+    ITERATE ( CSeq_feat::TXref, it, seq_feat.GetXref() ) {
+        const CSeqFeatXref& xref = **it;
+        if ( !xref.IsSetId() || !xref.GetId().IsLocal() ) {
+            continue;
+        }
+        const CObject_id* id = &xref.GetId().GetLocal();
+        for ( TFeatIdMap::const_iterator p = m_FeatsById.lower_bound(id);
+              p != m_FeatsById.end() && !(*id < *p->first); ++p ) {
+            if ( m_Feats[p->second].m_Subtype == parent_type ) {
+                return p->second;
+            }
+        }
+    }
+    return kNoFeat;
+}
+
+
+CAnnotFeatIndex::TFeatIndex
+CAnnotFeatIndex::x_FindGeneByGeneXref(TFeatIndex feat, bool& suppressed) const
+{
+    const CSeq_feat& seq_feat = *m_Feats[feat].m_Feat;
+    const CGene_ref* gene_xref = seq_feat.GetGeneXref();
+    if ( !gene_xref ) {
+        return kNoFeat;
+    }
+    if ( gene_xref->IsSuppressed() ) {
+        suppressed = true;
+        return kNoFeat;
+    }
+    pair<TGeneNameMap::const_iterator, TGeneNameMap::const_iterator> genes;
+    if ( gene_xref->IsSetLocus_tag() ) {
+        genes = m_GenesByLocusTag.equal_range(gene_xref->GetLocus_tag());
+    }
+    else if ( gene_xref->IsSetLocus() ) {
+        genes = m_GenesByLocus.equal_range(gene_xref->GetLocus());
+    }
+    else {
+        return kNoFeat;
+    }
+    // among genes with the same name prefer the best overlapping one
+    const CSeq_loc& loc = seq_feat.GetLocation();
+    TFeatIndex best = kNoFeat;
+    Int8 best_diff = -1;
+    for ( TGeneNameMap::const_iterator it = genes.first;
+          it != genes.second; ++it ) {
+        const CSeq_loc& gene_loc = m_Feats[it->second].m_Feat->GetLocation();
+        Int8 diff = TestForOverlap64(gene_loc, loc, eOverlap_Simple);
+        if ( diff < 0 ) {
+            continue;
+        }
+        if ( best == kNoFeat || diff < best_diff ) {
+            best = it->second;
+            best_diff = diff;
+        }
+    }
+    return best;
+}
+
+
+CAnnotFeatIndex::TFeatIndex
+CAnnotFeatIndex::x_FindBestParent(const CSeq_loc& loc,
+                                  CSeqFeatData::ESubtype parent_type,
+                                  EOverlapType overlap_type) const
+{
+    TIdRanges ranges;
+    s_GetIdRanges(loc, ranges);
+    if ( ranges.empty() ) {
+        return kNoFeat;
+    }
+    // the parent has to cover all ids, so candidates on the first are enough
+    TIntervalsMap::const_iterator it =
+        m_Intervals.find(TIntervalsKey(ranges[0].first, parent_type));
+    if ( it == m_Intervals.end() ) {
+        return kNoFeat;
+    }
+    TFeatList candidates;
+    x_CollectOverlapping(it->second, ranges[0].second, candidates);
+    TFeatIndex best = kNoFeat;
+    Int8 best_diff = -1;
+    ITERATE ( TFeatList, c, candidates ) {
+        const CSeq_loc& parent_loc = m_Feats[*c].m_Feat->GetLocation();
+        if ( s_OppositeStrands(parent_loc, loc) ) {
+            continue;
+        }
+        Int8 diff = TestForOverlap64(parent_loc, loc, overlap_type);
+        if ( diff < 0 ) {
+            continue;
+        }
+        if ( best == kNoFeat || diff < best_diff ||
+             (diff == best_diff && *c < best) ) {
+            best = *c;
+            best_diff = diff;
+        }
+    }
+    return best;
+}
+
+
+void CAnnotFeatIndex::x_CollectOverlapping(const TIntervals& levels,
+                                           const CRange<TSeqPos>& range,
+                                           TFeatList& feats) const
+{
+    if ( range.Empty() ) {
+        return;
+    }
+    ITERATE ( TIntervals, level, levels ) {
+        // first interval that may reach the range
+        SInterval key;
+        key.m_From = range.GetFrom() > level->m_MaxLength?
+            range.GetFrom() - level->m_MaxLength: 0;
+        key.m_To = 0;
+        key.m_Feat = 0;
+        for ( vector<SInterval>::const_iterator it =
+                  lower_bound(level->m_Intervals.begin(),
+                              level->m_Intervals.end(), key);
+              it != level->m_Intervals.end() &&
+                  it->m_From <= range.GetTo(); ++it ) {
+            if ( it->m_To >= range.GetFrom() ) {
+                feats.push_back(it->m_Feat);
+            }
+        }
+    }
+}
+
+
+void CAnnotFeatIndex::GetChildren(TFeatIndex feat, TFeatList& children) const
+{
+    children.assign(m_Children.begin()+m_ChildStart[feat],
+                    m_Children.begin()+m_ChildStart[feat+1]);
+}
+
+
+CAnnotFeatIndex::TFeatIndex
+CAnnotFeatIndex::GetBestGene(TFeatIndex feat) const
+{
+    for ( TFeatIndex p = GetParent(feat); p != kNoFeat; p = GetParent(p) ) {
+        if ( GetSubtype(p) == CSeqFeatData::eSubtype_gene ) {
+            return p;
+        }
+    }
+    return kNoFeat;
+}
+
+
+CAnnotFeatIndex::TFeatIndex
+CAnnotFeatIndex::GetBestGene(const CSeq_loc& loc) const
+{
+    return x_FindBestParent(loc, CSeqFeatData::eSubtype_gene,
+                            eOverlap_Contained);
+}
+
+
+void CAnnotFeatIndex::GetOverlappingFeats(const CSeq_id_Handle& id,
+                                          const CRange<TSeqPos>& range,
+                                          CSeqFeatData::ESubtype subtype,
+                                          TFeatList& feats) const
+{
+    feats.clear();
+    if ( subtype == CSeqFeatData::eSubtype_any ) {
+        for ( TIntervalsMap::const_iterator it =
+                  m_Intervals.lower_bound(TIntervalsKey(id, CSeqFeatData::eSubtype_bad));
+              it != m_Intervals.end() && it->first.first == id; ++it ) {
+            x_CollectOverlapping(it->second, range, feats);
+        }
+    }
+    else {
+        TIntervalsMap::const_iterator it =
+            m_Intervals.find(TIntervalsKey(id, subtype));
+        if ( it != m_Intervals.end() ) {
+            x_CollectOverlapping(it->second, range, feats);
+        }
+    }
+    sort(feats.begin(), feats.end());
+}
+
+
+void CAnnotFeatIndex::GetOverlappingFeats(const CSeq_loc& loc,
+                                          CSeqFeatData::ESubtype subtype,
+                                          TFeatList& feats) const
+{
+    TIdRanges ranges;
+    s_GetIdRanges(loc, ranges);
+    TFeatList id_feats;
+    feats.clear();
+    ITERATE ( TIdRanges, r, ranges ) {
+        GetOverlappingFeats(r->first, r->second, subtype, id_feats);
+        feats.insert(feats.end(), id_feats.begin(), id_feats.end());
+    }
+    sort(feats.begin(), feats.end());
+    feats.erase(unique(feats.begin(), feats.end()), feats.end());
+}
+
+
+END_SCOPE(feature)
+END_SCOPE(objects)
+END_NCBI_SCOPE
@@ -0,0 +1,229 @@
+/*  $Id$
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+* File Description:
+*   Unit tests for CAnnotFeatIndex.
+*
+* ===========================================================================
+*/
+
+#include <ncbi_pch.hpp>
+
+// This header must be included before all Boost.Test headers if there are any
+#include <corelib/test_boost.hpp>
+
+#include <objmgr/util/annot_feat_index.hpp>
+#include <objects/seq/Seq_annot.hpp>
+#include <objects/seqloc/seqloc__.hpp>
+#include <objects/seqfeat/seqfeat__.hpp>
+#include <objects/general/general__.hpp>
+
+
+USING_NCBI_SCOPE;
+USING_SCOPE(objects);
+USING_SCOPE(feature);
+
+
+typedef CAnnotFeatIndex::TFeatList TFeatList;
+typedef vector< pair<TSeqPos, TSeqPos> > TIntervals;
+
+static CRef<CSeq_loc> s_MakeLoc(const string& seq,
+                                const TIntervals& intervals,
+                                ENa_strand strand = eNa_strand_plus)
+{
+    CRef<CSeq_id> id(new CSeq_id(CSeq_id::e_Local, seq));
+    CRef<CSeq_loc> loc(new CSeq_loc);
+    if ( intervals.size() == 1 ) {
+        loc->SetInt().SetId(*id);
+        loc->SetInt().SetFrom(intervals[0].first);
+        loc->SetInt().SetTo(intervals[0].second);
+        loc->SetInt().SetStrand(strand);
+        return loc;
+    }
+    ITERATE ( TIntervals, it, intervals ) {
+        CRef<CSeq_interval> interval
+            (new CSeq_interval(*id, it->first, it->second, strand));
+        loc->SetPacked_int().Set().push_back(interval);
+    }
+    return loc;
+}
+
+
+static CRef<CSeq_feat> s_AddFeat(CSeq_annot& annot,
+                                 CSeqFeatData::E_Choice type,
+                                 const TIntervals& intervals,
+                                 ENa_strand strand = eNa_strand_plus,
+                                 const string& seq = "chr1")
+{
+    CRef<CSeq_feat> feat(new CSeq_feat);
+    switch ( type ) {
+    case CSeqFeatData::e_Gene:
+        feat->SetData().SetGene();
+        break;
+    case CSeqFeatData::e_Cdregion:
+        feat->SetData().SetCdregion();
+        break;
+    case CSeqFeatData::e_Rna:
+        feat->SetData().SetRna().SetType(CRNA_ref::eType_mRNA);
+        break;
+    default:
+        feat->SetData().SetImp().SetKey("misc_feature");
+        break;
+    }
+    feat->SetLocation(*s_MakeLoc(seq, intervals, strand));
+    annot.SetData().SetFtable().push_back(feat);
+    return feat;
+}
+
+
+static TIntervals s_Int(TSeqPos from, TSeqPos to)
+{
+    return TIntervals(1, make_pair(from, to));
+}
+
+
+static TFeatList s_List(const char* list)
+{
+    TFeatList ret;
+    vector<string> parts;
+    NStr::Split(list, " ", parts, NStr::fSplit_Tokenize);
+    ITERATE ( vector<string>, it, parts ) {
+        ret.push_back(NStr::StringToNumeric<CAnnotFeatIndex::TFeatIndex>(*it));
+    }
+    return ret;
+}
+
+
+static CRef<CSeq_annot> s_GetAnnot(void)
+{
+    CRef<CSeq_annot> annot(new CSeq_annot);
+    TIntervals exons;
+    exons.push_back(make_pair(100, 200));
+    exons.push_back(make_pair(300, 400));
+    exons.push_back(make_pair(600, 1000));
+    TIntervals cds_exons;
+    cds_exons.push_back(make_pair(150, 200));
+    cds_exons.push_back(make_pair(300, 400));
+    cds_exons.push_back(make_pair(600, 700));
+
+    // 0: gene G1
+    s_AddFeat(*annot, CSeqFeatData::e_Gene, s_Int(100, 1000))
+        ->SetData().SetGene().SetLocus_tag("G1");
+    // 1: mRNA in G1
+    s_AddFeat(*annot, CSeqFeatData::e_Rna, exons);
+    // 2: CDS with matching intervals -> 1
+    s_AddFeat(*annot, CSeqFeatData::e_Cdregion, cds_exons);
+    // 3: gene g2 on minus strand
+    s_AddFeat(*annot, CSeqFeatData::e_Gene, s_Int(2000, 3000), eNa_strand_minus)
+        ->SetData().SetGene().SetLocus("g2");
+    // 4: CDS without mRNA -> 3
+    s_AddFeat(*annot, CSeqFeatData::e_Cdregion, s_Int(2100, 2900), eNa_strand_minus);
+    // 5: misc_feature with suppressed gene xref -> no gene
+    s_AddFeat(*annot, CSeqFeatData::e_Imp, s_Int(500, 520))
+        ->SetGeneXref();
+    // 6: big gene g3 covering G1
+    s_AddFeat(*annot, CSeqFeatData::e_Gene, s_Int(100, 5000))
+        ->SetData().SetGene().SetLocus("g3");
+    // 7: misc_feature inside G1 with gene xref to g3 -> 6
+    s_AddFeat(*annot, CSeqFeatData::e_Imp, s_Int(150, 160))
+        ->SetGeneXref().SetLocus("g3");
+    // 8: gene on another sequence
+    s_AddFeat(*annot, CSeqFeatData::e_Gene, s_Int(0, 100),
+              eNa_strand_plus, "chr2");
+    // 9: second mRNA in G1, with feature id
+    s_AddFeat(*annot, CSeqFeatData::e_Rna, s_Int(100, 1000))
+        ->SetId().SetLocal().SetId(10);
+    // 10: CDS linked to 9 by feature id xref
+    CRef<CSeqFeatXref> xref(new CSeqFeatXref);
+    xref->SetId().SetLocal().SetId(10);
+    s_AddFeat(*annot, CSeqFeatData::e_Cdregion, s_Int(150, 700))
+        ->SetXref().push_back(xref);
+    return annot;
+}
+
+
+BOOST_AUTO_TEST_CASE(Test_Parents)
+{
+    CRef<CAnnotFeatIndex> index(new CAnnotFeatIndex(*s_GetAnnot()));
+    BOOST_REQUIRE_EQUAL(index->GetSize(), 11u);
+    const CAnnotFeatIndex::TFeatIndex kNoFeat = CAnnotFeatIndex::kNoFeat;
+
+    BOOST_CHECK_EQUAL(index->GetParent(0), kNoFeat);
+    BOOST_CHECK_EQUAL(index->GetParent(1), 0u);
+    BOOST_CHECK_EQUAL(index->GetParent(2), 1u);
+    BOOST_CHECK_EQUAL(index->GetParent(4), 3u);
+    BOOST_CHECK_EQUAL(index->GetParent(5), kNoFeat);
+    BOOST_CHECK_EQUAL(index->GetParent(7), 6u);
+    BOOST_CHECK_EQUAL(index->GetParent(8), kNoFeat);
+    BOOST_CHECK_EQUAL(index->GetParent(9), 0u);
+    BOOST_CHECK_EQUAL(index->GetParent(10), 9u);
+
+    BOOST_CHECK_EQUAL(index->GetBestGene(2), 0u);
+    BOOST_CHECK_EQUAL(index->GetBestGene(4), 3u);
+    BOOST_CHECK_EQUAL(index->GetBestGene(10), 0u);
+    BOOST_CHECK_EQUAL(index->GetBestGene(0), kNoFeat);
+
+    TFeatList children;
+    index->GetChildren(0, children);
+    BOOST_CHECK(children == s_List("1 9"));
+    index->GetChildren(6, children);
+    BOOST_CHECK(children == s_List("7"));
+    index->GetChildren(5, children);
+    BOOST_CHECK(children.empty());
+}
+
+
+BOOST_AUTO_TEST_CASE(Test_Overlaps)
+{
+    CRef<CAnnotFeatIndex> index(new CAnnotFeatIndex(*s_GetAnnot()));
+    CSeq_id_Handle chr1 =
+        CSeq_id_Handle::GetHandle(CSeq_id(CSeq_id::e_Local, "chr1"));
+    CSeq_id_Handle chr2 =
+        CSeq_id_Handle::GetHandle(CSeq_id(CSeq_id::e_Local, "chr2"));
+    TFeatList feats;
+
+    index->GetOverlappingFeats(chr1, TSeqRange(390, 410),
+                               CSeqFeatData::eSubtype_any, feats);
+    BOOST_CHECK(feats == s_List("0 1 2 6 9 10"));
+    index->GetOverlappingFeats(chr1, TSeqRange(2950, 2960),
+                               CSeqFeatData::eSubtype_gene, feats);
+    BOOST_CHECK(feats == s_List("3 6"));
+    index->GetOverlappingFeats(chr1, TSeqRange(1001, 1999),
+                               CSeqFeatData::eSubtype_cdregion, feats);
+    BOOST_CHECK(feats.empty());
+    index->GetOverlappingFeats(chr2, TSeqRange(100, 200),
+                               CSeqFeatData::eSubtype_any, feats);
+    BOOST_CHECK(feats == s_List("8"));
+    index->GetOverlappingFeats(*s_MakeLoc("chr1", s_Int(1000, 2000)),
+                               CSeqFeatData::eSubtype_gene, feats);
+    BOOST_CHECK(feats == s_List("0 3 6"));
+
+    BOOST_CHECK_EQUAL(index->GetBestGene(*s_MakeLoc("chr1", s_Int(4000, 4010))), 6u);
+    BOOST_CHECK_EQUAL(index->GetBestGene(*s_MakeLoc("chr1", s_Int(2500, 2600),
+                                                    eNa_strand_minus)), 3u);
+    BOOST_CHECK_EQUAL(index->GetBestGene(*s_MakeLoc("chr1", s_Int(2500, 2600))), 6u);
+    BOOST_CHECK_EQUAL(index->GetBestGene(*s_MakeLoc("chr1", s_Int(5000, 5010))),
+                      CAnnotFeatIndex::kNoFeat);
+}
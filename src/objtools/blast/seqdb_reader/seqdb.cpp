@@ -756,6 +756,35 @@ void CSeqDB::ResetInternalChunkBookmark()
     m_Impl->ResetInternalChunkBookmark();
 }
 
+void CSeqDB::GetScanParts(int                              num_parts,
+                          vector< CRef<CSeqDBScanPart> > & parts) const
+{
+    typedef vector< pair<int,int> > TRanges;
+
+    vector<SSeqDBVolRegion> regions;
+    TRanges                 ranges;
+
+    int flush_count = m_Impl->GetFlushCount();
+    m_Impl->GetScanRegions(num_parts, regions, ranges);
+
+    parts.clear();
+    parts.reserve(ranges.size());
+
+    ITERATE(TRanges, range, ranges) {
+        CRef<CSeqDBScanPart> part
+            (new CSeqDBScanPart(this, range->first, range->second,
+                                flush_count));
+
+        ITERATE(vector<SSeqDBVolRegion>, region, regions) {
+            if (region->oid_end   > range->first  &&
+                region->oid_start < range->second) {
+                part->m_Regions.push_back(*region);
+            }
+        }
+        parts.push_back(part);
+    }
+}
+
 const string & CSeqDB::GetDBNameList() const
 {
     return m_Impl->GetDBNameList();
@@ -983,6 +1012,61 @@ CSeqDBIter & CSeqDBIter::operator++()
     return *this;
 }
 
+bool CSeqDBScanPart::Next()
+{
+    // The regions are not mapped any more after a flush.
+    _ASSERT(m_DB->m_Impl->GetFlushCount() == m_FlushCount);
+
+    int oid = m_OID + 1;
+
+    // The OID list was set up by GetScanParts(), so this does not
+    // need the atlas lock.
+    if (oid >= m_End  ||  ! m_DB->CheckOrFindOID(oid)  ||  oid >= m_End) {
+        m_OID = m_End;
+        return false;
+    }
+
+    m_OID = oid;
+    while (m_Regions[m_RegionIdx].oid_end <= oid) {
+        ++m_RegionIdx;
+    }
+
+    return true;
+}
+
+int CSeqDBScanPart::GetSequence(const char ** buffer) const
+{
+    const SSeqDBVolRegion & region = m_Regions[m_RegionIdx];
+    int vol_oid = m_OID - region.oid_start;
+
+    Int8 start = SeqDB_GetStdOrd(& region.seq_offsets[vol_oid]);
+    *buffer = region.seq_data + start;
+
+    if (region.seq_type == 'p') {
+        // Subtract one, for the inter-sequence null.
+        Int8 end = SeqDB_GetStdOrd(& region.seq_offsets[vol_oid + 1]) - 1;
+        return int(end - start);
+    }
+
+    // The last two bits of the last byte store the number of
+    // nucleotides in the last byte.
+    Int8 end = SeqDB_GetStdOrd(& region.amb_offsets[vol_oid]);
+    int whole_bytes = int(end - start - 1);
+
+    return whole_bytes * 4 + ((*buffer)[whole_bytes] & 3);
+}
+
+CTempString CSeqDBScanPart::GetRawHeader() const
+{
+    const SSeqDBVolRegion & region = m_Regions[m_RegionIdx];
+    int vol_oid = m_OID - region.oid_start;
+
+    Int8 start = SeqDB_GetStdOrd(& region.hdr_offsets[vol_oid]);
+    Int8 end   = SeqDB_GetStdOrd(& region.hdr_offsets[vol_oid + 1]);
+
+    return CTempString(region.hdr_data + start, size_t(end - start));
+}
+
 CRef<CBioseq>
 CSeqDB::GiToBioseq(TGi gi) const
 {
@@ -401,6 +401,93 @@ void CSeqDBImpl::ResetInternalChunkBookmark()
     m_NextChunkOID = 0;
 }
 
+/// Amount of sequence data stored before an OID in the mapped volumes
+static Int8 s_ScanDataPos(const vector<SSeqDBVolRegion> & regions, int oid)
+{
+    Int8 pos = 0;
+
+    ITERATE(vector<SSeqDBVolRegion>, region, regions) {
+        Int8 first = SeqDB_GetStdOrd(& region->seq_offsets[0]);
+
+        if (oid < region->oid_end) {
+            if (oid > region->oid_start) {
+                int vol_oid = oid - region->oid_start;
+                pos += SeqDB_GetStdOrd(& region->seq_offsets[vol_oid]) - first;
+            }
+            break;
+        }
+
+        int num_oids = region->oid_end - region->oid_start;
+        pos += SeqDB_GetStdOrd(& region->seq_offsets[num_oids]) - first;
+    }
+
+    return pos;
+}
+
+void CSeqDBImpl::GetScanRegions(int                       num_parts,
+                                vector<SSeqDBVolRegion> & regions,
+                                vector< pair<int,int> > & ranges)
+{
+    CHECK_MARKER();
+    CSeqDBLockHold locked(m_Atlas);
+
+    if (! m_OidListSetup) {
+        x_GetOidList(locked);
+    }
+
+    regions.clear();
+    ranges.clear();
+
+    // Everything is mapped here, under the lock; the scan itself only
+    // reads from the mapped regions.
+    m_Atlas.Lock(locked);
+    for (int i = 0; i < m_VolSet.GetNumVols(); ++i) {
+        SSeqDBVolRegion region;
+        m_VolSet.GetVol(i)->GetScanRegion(region, locked);
+        if (region.oid_start < region.oid_end) {
+            regions.push_back(region);
+        }
+    }
+    m_Atlas.Unlock(locked);
+
+    int begin = m_RestrictBegin;
+    int end   = min(m_RestrictEnd, m_NumOIDs);
+
+    if (begin >= end  ||  regions.empty()) {
+        return;
+    }
+    if (num_parts < 1) {
+        num_parts = 1;
+    }
+
+    // Balance the parts by the amount of sequence data; the OID
+    // boundaries are found by bisection over the offset tables.
+    Int8 begin_pos = s_ScanDataPos(regions, begin);
+    Int8 end_pos   = s_ScanDataPos(regions, end);
+
+    for (int part = 1; part <= num_parts  &&  begin < end; ++part) {
+        int cut = end;
+
+        if (part < num_parts) {
+            Int8 target = begin_pos + (end_pos - begin_pos) * part / num_parts;
+            int lo = begin + 1;
+            int hi = end;
+            while (lo < hi) {
+                int mid = lo + (hi - lo) / 2;
+                if (s_ScanDataPos(regions, mid) < target) {
+                    lo = mid + 1;
+                } else {
+                    hi = mid;
+                }
+            }
+            cut = lo;
+        }
+
+        ranges.push_back(make_pair(begin, cut));
+        begin = cut;
+    }
+}
+
 int CSeqDBImpl::GetSeqLength(int oid) const
 {
     CHECK_MARKER();
@@ -1105,6 +1192,7 @@ string CSeqDBImpl::x_FixString(const string & s) const
 
 void CSeqDBImpl::FlushSeqMemory()
 {
+    ++m_FlushCount;
     m_VolSet.UnLease();
 }
 
@@ -46,6 +46,7 @@
 #include "seqdbgimask.hpp"
 #include "seqdblmdbset.hpp"
 #include <shared_mutex>
+#include <atomic>
 
 BEGIN_NCBI_SCOPE
 
@@ -562,6 +563,23 @@ public:
     /// Restart chunk iteration at the beginning of the database.
     void ResetInternalChunkBookmark();
 
+    /// Prepare a scan of the iteration range by several threads.
+    ///
+    /// The files of all volumes are mapped and their tables returned
+    /// in regions.  The iteration range is split into at most
+    /// num_parts contiguous OID ranges holding roughly the same
+    /// amount of sequence data.
+    ///
+    /// @param num_parts
+    ///   Maximum number of OID ranges to return.
+    /// @param regions
+    ///   Mapped tables of all non-empty volumes.
+    /// @param ranges
+    ///   Begin and end OIDs of the parts.
+    void GetScanRegions(int                       num_parts,
+                        vector<SSeqDBVolRegion> & regions,
+                        vector< pair<int,int> > & ranges);
+
     /// Get list of database names.
     ///
     /// This returns the database name list used at construction.
@@ -603,9 +621,16 @@ public:
     /// gc is running, it should not count references held by the
     /// volset.  Thus, the no-longer-in-action volumes can be flushed
     /// out (currently, idx files are still kept for all volumes).
-    /// The atlas should be locked when calling this method.
+    /// The atlas should be locked when calling this method.  The
+    /// regions returned by GetScanRegions() are not valid afterwards.
     void FlushSeqMemory();
 
+    /// Get the number of FlushSeqMemory() calls so far.
+    int GetFlushCount() const
+    {
+        return m_FlushCount;
+    }
+
     /// Translate a PIG to an OID.
     bool PigToOid(int pig, int & oid) const;
 
@@ -1313,6 +1338,9 @@ private:
     /// "Bookmark" for multithreaded chunk-type OID iteration.
     int m_NextChunkOID;
 
+    /// Number of FlushSeqMemory() calls, for checks of scan parts.
+    atomic<int> m_FlushCount{0};
+
     /// Number of sequences in the overall database.
     int m_NumSeqs;
 
@@ -114,6 +114,30 @@ CSeqDBVol::OpenSeqFile(CSeqDBLockHold & locked) const{
     if (!m_SeqFileOpened) x_OpenSeqFile();
 }
 
+void
+CSeqDBVol::GetScanRegion(SSeqDBVolRegion & region,
+                         CSeqDBLockHold  & locked) const
+{
+    region.oid_start = m_VolStart;
+    region.oid_end   = m_VolEnd;
+    region.seq_type  = m_Idx->GetSeqType();
+
+    // Empty volumes have no sequence or header files.
+    if (m_VolStart == m_VolEnd) {
+        return;
+    }
+
+    if (!m_SeqFileOpened) x_OpenSeqFile();
+    if (!m_HdrFileOpened) x_OpenHdrFile();
+
+    m_Idx->GetOffsetTables(region.hdr_offsets,
+                           region.seq_offsets,
+                           region.amb_offsets);
+
+    region.seq_data = m_Seq->GetFileDataPtr(0);
+    region.hdr_data = m_Hdr->GetFileDataPtr(0);
+}
+
 void
 CSeqDBVol::x_OpenSeqFile(void) const {
     CFastMutexGuard mtx_gurad(m_MtxSeq);
@@ -105,6 +105,12 @@ private:
     /// Processes all requests except printing the BLAST database information
     /// @return 0 on success; 1 if some sequences were not retrieved
     int x_ScanDatabase();
+
+    /// Scans the database by parts returned by CSeqDB::GetScanParts(), one
+    /// part per thread, sharing one CSeqDB object (e.g.: handles
+    /// -scan_parts command line option)
+    /// @return 0 on success; 1 if some sequences were not retrieved
+    int x_ScanDatabaseParts();
 };
 
 void
@@ -184,6 +190,53 @@ CSeqDBPerfApp::x_ScanDatabase()
     return 0;
 }
 
+int
+CSeqDBPerfApp::x_ScanDatabaseParts()
+{
+    CStopWatch sw;
+    sw.Start();
+    const int kNumThreads = static_cast<int>(m_DbHandles.size());
+    CSeqDB& db = *m_DbHandles.front();
+    vector< CRef<CSeqDBScanPart> > parts;
+    db.GetScanParts(kNumThreads, parts);
+    LOG_POST(Info << "Will go over " << parts.size() << " parts");
+
+    Uint8 num_letters = 0;
+    Uint8 num_hdr_bytes = 0;
+    int num_seqs = 0;
+
+    #pragma omp parallel for num_threads(kNumThreads) schedule(static, 1) \
+                             reduction(+:num_letters,num_hdr_bytes,num_seqs) \
+                             if(kNumThreads > 1)
+    for (int i = 0; i < static_cast<int>(parts.size()); i++) {
+        CSeqDBScanPart& part = *parts[i];
+        while (part.Next()) {
+            const char* buffer = NULL;
+            int seqlen = part.GetSequence(&buffer);
+            int seqbytes = m_DbIsProtein ? seqlen : seqlen / 4;
+            for (int j = 0; j < seqbytes; j++) {
+                char base = buffer[j];
+                (void)base;    // pacify compiler warnings
+            }
+            num_hdr_bytes += part.GetRawHeader().size();
+            num_letters += seqlen;
+            num_seqs++;
+        }
+    }
+    // Memory maps are shared by all threads, so this is not per thread
+    x_UpdateMemoryUsage();
+
+    sw.Stop();
+    Uint8 bases = static_cast<Uint8>(num_letters / sw.Elapsed());
+    cout << "Scanned " << num_seqs << " sequences, "
+         << NStr::UInt8ToString_DataSize(num_hdr_bytes) << " of headers"
+         << endl
+         << "Scanning rate: "
+         << NStr::NumericToString(bases, NStr::fWithCommas)
+         << " bases/second" << endl;
+    return (num_letters == db.GetTotalLength()) ? 0 : 1;
+}
+
 void
 CSeqDBPerfApp::x_InitApplicationData()
 {
@@ -225,7 +278,10 @@ CSeqDBPerfApp::x_InitApplicationData()
 
         m_DbHandles.reserve(kNumThreads);
         m_DbHandles.push_back(m_BlastDb);
-        if (kNumThreads > 1) {
+        if (args["scan_parts"]) {
+            // All threads share one CSeqDB object
+            m_DbHandles.resize(kNumThreads, m_BlastDb);
+        } else if (kNumThreads > 1) {
             for (int i = 1; i < kNumThreads; i++) {
                 m_BlastDb.Reset(new CSeqDBExpert(kDbName, kSeqType));
                 m_DbHandles.push_back(m_BlastDb);
@@ -304,7 +360,7 @@ void CSeqDBPerfApp::Init()
     arg_desc->AddFlag("multi_threaded_creation",
                       "Create multiple CSeqDB objects in a multi-threaded environment", true);
     arg_desc->SetDependency("multi_threaded_creation", CArgDescriptions::eRequires, "num_threads");
-    const char* exclusions[]  = { "scan_compressed", "scan_uncompressed", "get_metadata" };
+    const char* exclusions[]  = { "scan_compressed", "scan_uncompressed", "scan_parts", "get_metadata" };
     for (size_t i = 0; i < sizeof(exclusions)/sizeof(*exclusions); i++)
         arg_desc->SetDependency("multi_threaded_creation", CArgDescriptions::eExcludes, string(exclusions[i]));
 
@@ -313,6 +369,10 @@ void CSeqDBPerfApp::Init()
                       "Do a full database scan of uncompressed sequence data", true);
     arg_desc->AddFlag("scan_compressed",
                       "Do a full database scan of compressed sequence data", true);
+    arg_desc->AddFlag("scan_parts",
+                      "Do a full database scan of compressed sequence data "
+                      "and headers, one CSeqDB::GetScanParts() part per thread",
+                      true);
     arg_desc->AddFlag("get_metadata",
                       "Retrieve BLAST database metadata", true);
 
@@ -322,6 +382,12 @@ void CSeqDBPerfApp::Init()
                             "get_metadata");
     arg_desc->SetDependency("scan_uncompressed", CArgDescriptions::eExcludes,
                             "get_metadata");
+    arg_desc->SetDependency("scan_parts", CArgDescriptions::eExcludes,
+                            "scan_compressed");
+    arg_desc->SetDependency("scan_parts", CArgDescriptions::eExcludes,
+                            "scan_uncompressed");
+    arg_desc->SetDependency("scan_parts", CArgDescriptions::eExcludes,
+                            "get_metadata");
 
     arg_desc->AddDefaultKey("num_threads", "number",
                             "Number of threads to use (requires OpenMP)",
@@ -348,6 +414,8 @@ int CSeqDBPerfApp::Run(void)
             return status;
         if (args["get_metadata"]) {
             status = x_PrintBlastDatabaseInformation();
+        } else if (args["scan_parts"]) {
+            status = x_ScanDatabaseParts();
         } else {
             status = x_ScanDatabase();
         }
@@ -41,12 +41,18 @@
 #include <objtools/data_loaders/asn_cache/Cache_blob.hpp>
 
 #include <corelib/rwstream.hpp>
+#include <corelib/ncbifile.hpp>
+#include <corelib/ncbimtx.hpp>
+#include <corelib/ncbi_safe_static.hpp>
+#include <util/checksum.hpp>
 #include <util/compress/stream.hpp>
 #include <util/compress/zlib.hpp>
+#include <util/compress/zstd.hpp>
 
 #include "md5_writer.hpp"
 
 #include <serial/serial.hpp>
+#include <serial/objistr.hpp>
 #include <serial/objostrasnb.hpp>
 #include <serial/objistrasnb.hpp>
 
@@ -60,6 +66,38 @@ BEGIN_NCBI_SCOPE
 BEGIN_objects_SCOPE // namespace ncbi::objects::
 
 
+/// eZstd blob data starts with the uncompressed size and the dictionary id,
+/// both little-endian, followed by a single zstd frame
+static const size_t kZstdHeaderSize = 8;
+
+
+static void s_PutUint4(char* dst, Uint4 value)
+{
+    for (int i = 0;  i < 4;  ++i) {
+        dst[i] = char(value >> (8 * i));
+    }
+}
+
+
+static Uint4 s_GetUint4(const char* src)
+{
+    Uint4 value = 0;
+    for (int i = 0;  i < 4;  ++i) {
+        value |= Uint4((unsigned char)src[i]) << (8 * i);
+    }
+    return value;
+}
+
+
+#if !defined(HAVE_LIBZSTD)
+NCBI_NORETURN static void s_NoZstd(void)
+{
+    NCBI_THROW(CException, eUnknown,
+               "ASN cache: zstd compression is not available in this build");
+}
+#endif
+
+
 // constructor
 CCache_blob::CCache_blob(void)
 {
@@ -72,8 +110,41 @@ CCache_blob::~CCache_blob(void)
 }
 
 
-void CCache_blob::Pack(const CSeq_entry& entry)
+void CCache_blob::Pack(const CSeq_entry& entry,
+                       ECompression compression,
+                       const CCache_blob_Dictionary* dict)
 {
+    if (compression == eZstd) {
+        // zstd is much faster on one whole buffer than on a stream
+        CNcbiOstrstream ostr;
+        {{
+            CObjectOStreamAsnBinary asn_stream(ostr);
+            asn_stream << entry;
+            asn_stream.Flush();
+        }}
+        string raw_data = CNcbiOstrstreamToString(ostr);
+        if (raw_data.size() > kMax_UI4) {
+            NCBI_THROW(CException, eUnknown,
+                       "Seq-entry is too big for ASN cache blob");
+        }
+
+        const CCache_blob_Dictionary& zstd_dict =
+            dict ? *dict : CCache_blob_Dictionary::x_GetEmpty();
+        TBlob& blob = SetBlob();
+        blob.resize(kZstdHeaderSize);
+        s_PutUint4(&blob[0], Uint4(raw_data.size()));
+        s_PutUint4(&blob[4], zstd_dict.GetId());
+        zstd_dict.x_Compress(raw_data.data(), raw_data.size(), blob);
+
+        CChecksum md5(CChecksum::eMD5);
+        md5.AddChars(&blob[0], blob.size());
+        vector<char>& blob_md5_digest = SetMd5_digest();
+        blob_md5_digest.resize(kMD5Size);
+        md5.GetMD5Digest((unsigned char*)&blob_md5_digest[0]);
+        SetMagic(kMagicNumZstd);
+        return;
+    }
+
     CMD5StreamWriter<TBlob> md5_buffer(SetBlob());
 
     {{
@@ -95,8 +166,52 @@ void CCache_blob::Pack(const CSeq_entry& entry)
 }
 
 
+CCache_blob::ECompression CCache_blob::GetCompression(void) const
+{
+    return GetMagic() == kMagicNumZstd ? eZstd : eZlib;
+}
+
+
+void CCache_blob::x_UnPackZstd(vector<unsigned char>& raw_bytes) const
+{
+    const TBlob& data = GetBlob();
+    if (data.size() < kZstdHeaderSize) {
+        NCBI_THROW(CException, eUnknown, "truncated zstd ASN cache blob");
+    }
+    Uint4 raw_size = s_GetUint4(&data[0]);
+    Uint4 dict_id  = s_GetUint4(&data[4]);
+
+    CConstRef<CCache_blob_Dictionary> dict;
+    if (dict_id) {
+        dict = CCache_blob_Dictionary::Find(dict_id);
+        if ( !dict ) {
+            NCBI_THROW_FMT(CException, eUnknown,
+                           "ASN cache blob needs zstd dictionary "
+                           << dict_id << " which is not loaded");
+        }
+    }
+    const CCache_blob_Dictionary& zstd_dict =
+        dict ? *dict : CCache_blob_Dictionary::x_GetEmpty();
+    raw_bytes.resize(raw_size);
+    zstd_dict.x_Decompress(&data[kZstdHeaderSize],
+                           data.size() - kZstdHeaderSize,
+                           raw_bytes.data(), raw_size);
+}
+
+
 void CCache_blob::UnPack(CSeq_entry& entry) const
 {
+    if (GetCompression() == eZstd) {
+        vector<unsigned char> raw_bytes;
+        x_UnPackZstd(raw_bytes);
+        unique_ptr<CObjectIStream> asn_str
+            (CObjectIStream::CreateFromBuffer(eSerial_AsnBinary,
+                                              (const char*)raw_bytes.data(),
+                                              raw_bytes.size()));
+        *asn_str >> entry;
+        return;
+    }
+
     const TBlob& raw_data = GetBlob();
 
     istrstream istr(&raw_data[0], raw_data.size() );
@@ -110,6 +225,11 @@ void CCache_blob::UnPack(CSeq_entry& entry) const
 
 void CCache_blob::UnPack(vector<unsigned char>& raw_bytes) const
 {
+    if (GetCompression() == eZstd) {
+        x_UnPackZstd(raw_bytes);
+        return;
+    }
+
     const TBlob& raw_data = GetBlob();
 
     istrstream istr(&raw_data[0], raw_data.size() );
@@ -133,6 +253,218 @@ void CCache_blob::UnPack(vector<unsigned char>& raw_bytes) const
 
 
 
+/////////////////////////////////////////////////////////////////////////////
+//  CCache_blob_Dictionary
+
+
+struct CCache_blob_Dictionary::SCodecPool
+{
+    CFastMutex                  m_Mutex;
+    vector<CZstdCompression*>   m_Codecs;
+
+    ~SCodecPool(void);
+};
+
+
+CCache_blob_Dictionary::SCodecPool::~SCodecPool(void)
+{
+#if defined(HAVE_LIBZSTD)
+    ITERATE (vector<CZstdCompression*>, it, m_Codecs) {
+        delete *it;
+    }
+#endif
+}
+
+
+typedef map<Uint4, CRef<CCache_blob_Dictionary> > TBlobDictionaries;
+static CSafeStatic<TBlobDictionaries> s_Dictionaries;
+DEFINE_STATIC_FAST_MUTEX(s_DictionariesMutex);
+
+
+CCache_blob_Dictionary::CCache_blob_Dictionary(void)
+    : m_Id(0),
+      m_Pool(new SCodecPool)
+{
+}
+
+
+CCache_blob_Dictionary::CCache_blob_Dictionary(const vector<char>& data)
+    : m_Data(data),
+      m_Id(0),
+      m_Pool(new SCodecPool)
+{
+    if (m_Data.empty()) {
+        NCBI_THROW(CException, eUnknown, "empty ASN cache dictionary");
+    }
+    CChecksum crc(CChecksum::eCRC32);
+    crc.AddChars(&m_Data[0], m_Data.size());
+    m_Id = crc.GetChecksum();
+    if ( !m_Id ) {
+        // 0 is reserved for blobs without a dictionary
+        m_Id = 1;
+    }
+}
+
+
+CCache_blob_Dictionary::~CCache_blob_Dictionary(void)
+{
+}
+
+
+const CCache_blob_Dictionary& CCache_blob_Dictionary::x_GetEmpty(void)
+{
+    static CCache_blob_Dictionary s_Empty;
+    return s_Empty;
+}
+
+
+CRef<CCache_blob_Dictionary>
+CCache_blob_Dictionary::Load(const string& file_name)
+{
+    Int8 size = CFile(file_name).GetLength();
+    vector<char> data(size > 0 ? size_t(size) : 0);
+    CNcbiIfstream istr(file_name.c_str(), IOS_BASE::in | IOS_BASE::binary);
+    if (data.empty()  ||  !istr.read(&data[0], data.size())) {
+        NCBI_THROW(CException, eUnknown,
+                   "cannot read ASN cache dictionary: " + file_name);
+    }
+    CRef<CCache_blob_Dictionary> dict(new CCache_blob_Dictionary(data));
+    Register(*dict);
+    return dict;
+}
+
+
+void CCache_blob_Dictionary::Save(const string& file_name) const
+{
+    CNcbiOfstream ostr(file_name.c_str(),
+                       IOS_BASE::out | IOS_BASE::trunc | IOS_BASE::binary);
+    ostr.write(&m_Data[0], m_Data.size());
+    ostr.close();
+    if ( !ostr ) {
+        NCBI_THROW(CException, eUnknown,
+                   "cannot write ASN cache dictionary: " + file_name);
+    }
+}
+
+
+CRef<CCache_blob_Dictionary>
+CCache_blob_Dictionary::Train(const vector< vector<unsigned char> >& samples,
+                              size_t max_size)
+{
+#if defined(HAVE_LIBZSTD)
+    vector<char> buffer;
+    vector<size_t> sizes;
+    ITERATE (vector< vector<unsigned char> >, it, samples) {
+        if ( !it->empty() ) {
+            buffer.insert(buffer.end(), it->begin(), it->end());
+            sizes.push_back(it->size());
+        }
+    }
+    vector<char> data;
+    if (sizes.empty()  ||
+        !CZstdCompression::TrainDictionary(&buffer[0], sizes, max_size, data)) {
+        return CRef<CCache_blob_Dictionary>();
+    }
+    return Ref(new CCache_blob_Dictionary(data));
+#else
+    s_NoZstd();
+#endif
+}
+
+
+void CCache_blob_Dictionary::Register(CCache_blob_Dictionary& dict)
+{
+    CFastMutexGuard guard(s_DictionariesMutex);
+    (*s_Dictionaries)[dict.GetId()] = Ref(&dict);
+}
+
+
+CConstRef<CCache_blob_Dictionary> CCache_blob_Dictionary::Find(Uint4 id)
+{
+    CFastMutexGuard guard(s_DictionariesMutex);
+    TBlobDictionaries::const_iterator it = s_Dictionaries->find(id);
+    if (it == s_Dictionaries->end()) {
+        return CConstRef<CCache_blob_Dictionary>();
+    }
+    return it->second;
+}
+
+
+// zstd contexts are expensive to create and to load a dictionary into,
+// so they are kept in a pool and reused by all threads
+CZstdCompression* CCache_blob_Dictionary::x_AcquireCodec(void) const
+{
+#if defined(HAVE_LIBZSTD)
+    {{
+        CFastMutexGuard guard(m_Pool->m_Mutex);
+        if ( !m_Pool->m_Codecs.empty() ) {
+            CZstdCompression* codec = m_Pool->m_Codecs.back();
+            m_Pool->m_Codecs.pop_back();
+            return codec;
+        }
+    }}
+    unique_ptr<CZstdCompression> codec(new CZstdCompression);
+    if ( !m_Data.empty() ) {
+        codec->SetDictionary(*new CCompressionDictionary(&m_Data[0],
+                                                         m_Data.size()),
+                             eTakeOwnership);
+    }
+    return codec.release();
+#else
+    s_NoZstd();
+#endif
+}
+
+
+void CCache_blob_Dictionary::x_ReleaseCodec(CZstdCompression* codec) const
+{
+    CFastMutexGuard guard(m_Pool->m_Mutex);
+    m_Pool->m_Codecs.push_back(codec);
+}
+
+
+void CCache_blob_Dictionary::x_Compress(const void* src, size_t src_size,
+                                        vector<char>& dst) const
+{
+#if defined(HAVE_LIBZSTD)
+    CZstdCompression* codec = x_AcquireCodec();
+    size_t pos = dst.size();
+    dst.resize(pos + codec->EstimateCompressionBufferSize(src_size));
+    size_t dst_size = 0;
+    bool ok = codec->CompressBuffer(src, src_size, &dst[pos],
+                                    dst.size() - pos, &dst_size);
+    string error = ok ? kEmptyStr : codec->GetErrorDescription();
+    x_ReleaseCodec(codec);
+    if ( !ok ) {
+        NCBI_THROW(CException, eUnknown,
+                   "zstd compression of ASN cache blob failed: " + error);
+    }
+    dst.resize(pos + dst_size);
+#else
+    s_NoZstd();
+#endif
+}
+
+
+void CCache_blob_Dictionary::x_Decompress(const char* src, size_t src_size,
+                                          void* dst, size_t dst_size) const
+{
+#if defined(HAVE_LIBZSTD)
+    CZstdCompression* codec = x_AcquireCodec();
+    size_t size = 0;
+    bool ok = codec->DecompressBuffer(src, src_size, dst, dst_size, &size);
+    string error = ok ? kEmptyStr : codec->GetErrorDescription();
+    x_ReleaseCodec(codec);
+    if ( !ok  ||  size != dst_size ) {
+        NCBI_THROW(CException, eUnknown,
+                   "zstd decompression of ASN cache blob failed: " +
+                   (ok ? string("size mismatch") : error));
+    }
+#else
+    s_NoZstd();
+#endif
+}
+
 
 END_objects_SCOPE // namespace ncbi::objects::
 
@@ -84,6 +84,12 @@ CAsnCacheStore::CAsnCacheStore(const string& db_path)
 
     m_Index->Open(main_fname, CBDB_RawFile::eReadOnly);
 
+    // Blobs in zstd format find their dictionary in the registry
+    string dict_fname = NASNCacheFileName::GetZstdDictionary(db_path);
+    if (CFile(dict_fname).Exists()) {
+        CCache_blob_Dictionary::Load(dict_fname);
+    }
+
     string fname = NASNCacheFileName::GetBDBIndex(db_path, CAsnIndex::e_seq_id);
     if (CFile(fname).Exists()) {
         try {
@@ -0,0 +1,249 @@
+/*  $Id$
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+* File Description:
+*   Unit tests for ASN cache blobs: zlib and zstd packing, dictionaries
+*
+* ===========================================================================
+*/
+
+#include <ncbi_pch.hpp>
+#include <corelib/ncbifile.hpp>
+#include <serial/serial.hpp>
+#include <serial/objostrasnb.hpp>
+#include <util/random_gen.hpp>
+#include <objects/seq/Bioseq.hpp>
+#include <objects/seq/Seq_inst.hpp>
+#include <objects/seq/Seq_data.hpp>
+#include <objects/seq/IUPACna.hpp>
+#include <objects/seq/Seqdesc.hpp>
+#include <objects/seq/Seq_descr.hpp>
+#include <objects/seqloc/Seq_id.hpp>
+#include <objects/seqset/Seq_entry.hpp>
+#include <objtools/data_loaders/asn_cache/Cache_blob.hpp>
+
+// This header must be included before all Boost.Test headers if there are any
+#include <corelib/test_boost.hpp>
+
+USING_NCBI_SCOPE;
+USING_SCOPE(objects);
+
+
+static CRef<CSeq_entry> s_MakeEntry(int index)
+{
+    static const char kBases[] = "ACGT";
+    CRandom rnd(index);
+    string bases;
+    for (size_t i = 100 + rnd.GetRand(0, 200);  i > 0;  --i) {
+        bases += kBases[rnd.GetRand(0, 3)];
+    }
+
+    CRef<CSeq_entry> entry(new CSeq_entry);
+    CBioseq& seq = entry->SetSeq();
+    seq.SetId().push_back
+        (Ref(new CSeq_id("lcl|test_seq_" + NStr::IntToString(index))));
+    CRef<CSeqdesc> title(new CSeqdesc);
+    title->SetTitle("Test sequence " + NStr::IntToString(index) +
+                    ", ASN cache blob unit test");
+    seq.SetDescr().Set().push_back(title);
+    CSeq_inst& inst = seq.SetInst();
+    inst.SetRepr(CSeq_inst::eRepr_raw);
+    inst.SetMol(CSeq_inst::eMol_dna);
+    inst.SetLength(TSeqPos(bases.size()));
+    inst.SetSeq_data().SetIupacna(CIUPACna(bases));
+    return entry;
+}
+
+
+static vector<unsigned char> s_Serialize(const CSeq_entry& entry)
+{
+    CNcbiOstrstream ostr;
+    {{
+        CObjectOStreamAsnBinary asn_stream(ostr);
+        asn_stream << entry;
+    }}
+    string data = CNcbiOstrstreamToString(ostr);
+    return vector<unsigned char>(data.begin(), data.end());
+}
+
+
+static void s_CheckRoundTrip(const CSeq_entry& entry,
+                             CCache_blob::ECompression compression,
+                             const CCache_blob_Dictionary* dict = NULL)
+{
+    CCache_blob blob;
+    blob.Pack(entry, compression, dict);
+    BOOST_CHECK_EQUAL(blob.GetCompression(), compression);
+    BOOST_CHECK_EQUAL(blob.GetMagic(),
+                      Uint4(compression == CCache_blob::eZstd ?
+                            CCache_blob::kMagicNumZstd :
+                            CCache_blob::kMagicNum));
+    BOOST_CHECK_EQUAL(blob.GetMd5_digest().size(),
+                      size_t(CCache_blob::kMD5Size));
+
+    CSeq_entry unpacked;
+    blob.UnPack(unpacked);
+    BOOST_CHECK(unpacked.Equals(entry));
+
+    vector<unsigned char> raw_bytes;
+    blob.UnPack(raw_bytes);
+    BOOST_CHECK(raw_bytes == s_Serialize(entry));
+}
+
+
+static CRef<CCache_blob_Dictionary> s_TrainDictionary(void)
+{
+    vector< vector<unsigned char> > samples;
+    for (int i = 0;  i < 1000;  ++i) {
+        samples.push_back(s_Serialize(*s_MakeEntry(i)));
+    }
+    return CCache_blob_Dictionary::Train(samples, 4096);
+}
+
+
+BOOST_AUTO_TEST_CASE(TestZlibRoundTrip)
+{
+    for (int i = 0;  i < 10;  ++i) {
+        s_CheckRoundTrip(*s_MakeEntry(i), CCache_blob::eZlib);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(TestDictionaryId)
+{
+    vector<char> data(1000, 'A');
+    CCache_blob_Dictionary dict1(data);
+    data[500] = 'C';
+    CCache_blob_Dictionary dict2(data);
+    BOOST_CHECK(dict1.GetId() != 0);
+    BOOST_CHECK(dict2.GetId() != 0);
+    BOOST_CHECK(dict1.GetId() != dict2.GetId());
+    BOOST_CHECK(dict2.GetData() == data);
+
+    vector<char> empty;
+    BOOST_CHECK_THROW(CCache_blob_Dictionary dict(empty), CException);
+}
+
+
+BOOST_AUTO_TEST_CASE(TestRegisterAndFind)
+{
+    vector<char> data(1000, 'G');
+    CRef<CCache_blob_Dictionary> dict(new CCache_blob_Dictionary(data));
+    BOOST_CHECK( !CCache_blob_Dictionary::Find(dict->GetId()) );
+    CCache_blob_Dictionary::Register(*dict);
+    BOOST_CHECK(CCache_blob_Dictionary::Find(dict->GetId()).GetPointer() ==
+                dict.GetPointer());
+    BOOST_CHECK( !CCache_blob_Dictionary::Find(dict->GetId() + 1) );
+}
+
+
+#if defined(HAVE_LIBZSTD)
+
+BOOST_AUTO_TEST_CASE(TestZstdRoundTrip)
+{
+    for (int i = 0;  i < 10;  ++i) {
+        s_CheckRoundTrip(*s_MakeEntry(i), CCache_blob::eZstd);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(TestZstdDictionaryRoundTrip)
+{
+    CRef<CCache_blob_Dictionary> dict = s_TrainDictionary();
+    BOOST_REQUIRE(dict);
+    BOOST_CHECK( !dict->GetData().empty() );
+    CCache_blob_Dictionary::Register(*dict);
+
+    for (int i = 0;  i < 10;  ++i) {
+        s_CheckRoundTrip(*s_MakeEntry(i), CCache_blob::eZstd, dict.GetPointer());
+    }
+
+    // Saved and loaded dictionary has the same id and unpacks the blobs
+    CRef<CSeq_entry> entry = s_MakeEntry(2000);
+    CCache_blob blob;
+    blob.Pack(*entry, CCache_blob::eZstd, dict.GetPointer());
+    string file_name = CFile::GetTmpName();
+    dict->Save(file_name);
+    CRef<CCache_blob_Dictionary> loaded =
+        CCache_blob_Dictionary::Load(file_name);
+    CFile(file_name).Remove();
+    BOOST_CHECK_EQUAL(loaded->GetId(), dict->GetId());
+    BOOST_CHECK(CCache_blob_Dictionary::Find(dict->GetId()).GetPointer() ==
+                loaded.GetPointer());
+
+    CSeq_entry unpacked;
+    blob.UnPack(unpacked);
+    BOOST_CHECK(unpacked.Equals(*entry));
+}
+
+
+BOOST_AUTO_TEST_CASE(TestTrainTooFewSamples)
+{
+    vector< vector<unsigned char> > samples;
+    BOOST_CHECK( !CCache_blob_Dictionary::Train(samples, 4096) );
+    samples.push_back(vector<unsigned char>());
+    BOOST_CHECK( !CCache_blob_Dictionary::Train(samples, 4096) );
+}
+
+
+BOOST_AUTO_TEST_CASE(TestMissingDictionary)
+{
+    // Raw content dictionary, never registered
+    CNcbiOstrstream ostr;
+    for (int i = 0;  i < 20;  ++i) {
+        vector<unsigned char> sample = s_Serialize(*s_MakeEntry(3000 + i));
+        ostr.write((const char*)sample.data(), sample.size());
+    }
+    string content = CNcbiOstrstreamToString(ostr);
+    CRef<CCache_blob_Dictionary> dict
+        (new CCache_blob_Dictionary(vector<char>(content.begin(),
+                                                 content.end())));
+    BOOST_REQUIRE( !CCache_blob_Dictionary::Find(dict->GetId()) );
+
+    CRef<CSeq_entry> entry = s_MakeEntry(3000);
+    CCache_blob blob;
+    blob.Pack(*entry, CCache_blob::eZstd, dict.GetPointer());
+
+    CSeq_entry unpacked;
+    BOOST_CHECK_THROW(blob.UnPack(unpacked), CException);
+    vector<unsigned char> raw_bytes;
+    BOOST_CHECK_THROW(blob.UnPack(raw_bytes), CException);
+
+    CCache_blob_Dictionary::Register(*dict);
+    blob.UnPack(unpacked);
+    BOOST_CHECK(unpacked.Equals(*entry));
+}
+
+#else
+
+BOOST_AUTO_TEST_CASE(TestZstdNotAvailable)
+{
+    CCache_blob blob;
+    BOOST_CHECK_THROW(blob.Pack(*s_MakeEntry(0), CCache_blob::eZstd),
+                      CException);
+    BOOST_CHECK_THROW(s_TrainDictionary(), CException);
+}
+
+#endif
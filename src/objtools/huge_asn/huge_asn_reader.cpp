@@ -39,6 +39,8 @@
 #include <objects/seq/Seq_inst.hpp>
 
 #include <serial/objistr.hpp>
+#include <serial/objostr.hpp>
+#include <serial/serial.hpp>
 #include <corelib/ncbifile.hpp>
 
 #include <objtools/edit/huge_asn_reader.hpp>
@@ -49,6 +51,9 @@
 #include <objects/general/Object_id.hpp>
 #include <objects/seq/Seq_annot.hpp>
 
+#include <atomic>
+#include <thread>
+
 BEGIN_NCBI_SCOPE
 BEGIN_SCOPE(objects)
 BEGIN_SCOPE(edit)
@@ -56,6 +61,11 @@ BEGIN_SCOPE(edit)
 
 CHugeAsnReader::~CHugeAsnReader()
 {
+    if (m_index_out) {
+        // incomplete index is not kept
+        m_index_out.reset();
+        CFile(m_index_file + ".tmp").Remove();
+    }
 }
 
 CHugeAsnReader::CHugeAsnReader()
@@ -238,10 +248,20 @@ unique_ptr<CObjectIStream> CHugeAsnReader::MakeObjStream(TFileSize pos) const
 
 bool CHugeAsnReader::GetNextBlob()
 {
-    if (m_next_pos >= m_file->m_filesize)
+    if (!m_index_file_opened) {
+        m_index_file_opened = true;
+        x_OpenIndexFile();
+    }
+
+    if (m_next_pos >= m_file->m_filesize) {
+        x_CommitIndexFile();
         return false;
+    }
 
-    x_IndexNextAsn1();
+    if (!x_ReadIndexRecord()) {
+        x_IndexNextAsn1();
+        x_WriteIndexRecord();
+    }
     return true;
 }
 
@@ -299,16 +319,21 @@ void CHugeAsnReader::x_SetHooks(CObjectIStream& objStream, CHugeAsnReader::TCont
     x_SetFeatIdHooks(objStream, context);
 
     SetLocalReadHook(bioseqset_seqset_mi, objStream,
-            [](CObjectIStream& in, const CObjectInfoMI& member)
+            [&context](CObjectIStream& in, const CObjectInfoMI& member)
             {
+                // the class goes before the entries, let the entry hooks see it
+                auto* pBioseqSet = CTypeConverter<CBioseq_set>::SafeCast(member.GetClassObject().GetObjectPtr());
+                if (pBioseqSet->IsSetClass() && !context.bioseq_set_stack.empty()) {
+                    context.bioseq_set_stack.back()->m_class = pBioseqSet->GetClass();
+                }
                 (*member).GetTypeInfo()->DefaultSkipData(in);
             });
 
 
     SetLocalReadHook(bioseqset_annot_mi, objStream,
-            [&context, this](CObjectIStream& in, const CObjectInfoMI& member)
+            [&context](CObjectIStream& in, const CObjectInfoMI& member)
             {
-                auto pos = in.GetStreamPos() + m_next_pos;
+                auto pos = in.GetStreamPos() + context.base_pos;
                 auto& set_rec = context.bioseq_set_stack.back();
                 set_rec->m_annot_pos = pos;
                 (*member).GetTypeInfo()->DefaultSkipData(in);
@@ -344,9 +369,9 @@ void CHugeAsnReader::x_SetBioseqHooks(CObjectIStream& objStream, CHugeAsnReader:
     CObjectTypeInfo bioseq_info = CType<CBioseq>();
 
     SetLocalSkipHook(bioseq_info, objStream,
-        [this, &context](CObjectIStream& in, const CObjectTypeInfo& type)
+        [&context](CObjectIStream& in, const CObjectTypeInfo& type)
     {
-        auto pos = in.GetStreamPos() + m_next_pos;
+        auto pos = in.GetStreamPos() + context.base_pos;
 
         context.bioseq_stack.push_back({});
         auto parent = context.bioseq_set_stack.back();
@@ -354,7 +379,7 @@ void CHugeAsnReader::x_SetBioseqHooks(CObjectIStream& objStream, CHugeAsnReader:
         type.GetTypeInfo()->DefaultSkipData(in);
 
         auto& bioseqinfo = context.bioseq_stack.back();
-        m_bioseq_list.push_back({pos, parent, bioseqinfo.m_length, bioseqinfo.m_descr, bioseqinfo.m_ids, bioseqinfo.m_mol, bioseqinfo.m_repr});
+        context.bioseq_list->push_back({pos, parent, bioseqinfo.m_length, bioseqinfo.m_descr, bioseqinfo.m_ids, bioseqinfo.m_mol, bioseqinfo.m_repr});
         context.bioseq_stack.pop_back();
     });
 }
@@ -365,13 +390,13 @@ void CHugeAsnReader::x_SetBioseqSetHooks(CObjectIStream& objStream, CHugeAsnRead
     CObjectTypeInfo bioseq_set_info = CType<CBioseq_set>();
 
     SetLocalSkipHook(bioseq_set_info, objStream,
-            [this, &context](CObjectIStream& in, const CObjectTypeInfo& type)
+            [&context](CObjectIStream& in, const CObjectTypeInfo& type)
             {
-                auto pos = in.GetStreamPos() + m_next_pos;
+                auto pos = in.GetStreamPos() + context.base_pos;
                 auto parent = context.bioseq_set_stack.back();
-                m_bioseq_set_list.push_back({pos, parent});
+                context.bioseq_set_list->push_back({pos, parent});
 
-                auto last = prev(m_bioseq_set_list.end());
+                auto last = prev(context.bioseq_set_list->end());
 
                 context.bioseq_set_stack.push_back(last);
                 auto pBioseqSet = Ref(new CBioseq_set());
@@ -388,7 +413,7 @@ void CHugeAsnReader::x_SetBioseqSetHooks(CObjectIStream& objStream, CHugeAsnRead
 
                 if (IsHugeSet(last->m_class) &&
                     last->HasAnnot()) {
-                    m_HasHugeSetAnnot = true;
+                    context.has_huge_set_annot = true;
                 }
 
                 context.bioseq_set_stack.pop_back();
@@ -399,25 +424,25 @@ void CHugeAsnReader::x_SetBioseqSetHooks(CObjectIStream& objStream, CHugeAsnRead
 void CHugeAsnReader::x_SetFeatIdHooks(CObjectIStream& objStream, CHugeAsnReader::TContext& context)
 {
     SetLocalSkipHook(CType<CFeat_id>(), objStream,
-        [this, &context](CObjectIStream& in, const CObjectTypeInfo& type)
+        [&context](CObjectIStream& in, const CObjectTypeInfo& type)
     {
         auto pFeatId = Ref(new CFeat_id());
         type.GetTypeInfo()->DefaultReadData(in, pFeatId);
         if (pFeatId->IsLocal() && pFeatId->GetLocal().IsId())
         {
-            m_max_local_id = std::max(m_max_local_id, pFeatId->GetLocal().GetId());
+            context.max_local_id = std::max(context.max_local_id, pFeatId->GetLocal().GetId());
         }
     });
 
     SetLocalReadHook(CType<CFeat_id>(), objStream,
-            [this](CObjectIStream& in, const CObjectInfo& object)
+            [&context](CObjectIStream& in, const CObjectInfo& object)
     {
         auto* pObject = object.GetObjectPtr();
         object.GetTypeInfo()->DefaultReadData(in, pObject);
         auto* pFeatId = CTypeConverter<CFeat_id>::SafeCast(pObject);
         if (pFeatId->IsLocal() && pFeatId->GetLocal().IsId())
         {
-            m_max_local_id = std::max(m_max_local_id, pFeatId->GetLocal().GetId());
+            context.max_local_id = std::max(context.max_local_id, pFeatId->GetLocal().GetId());
         }
     });
 }
@@ -427,6 +452,148 @@ void CHugeAsnReader::ResetTopEntry()
     m_top_entry.Reset();
 }
 
+void CHugeAsnReader::x_InitContext(TContext& context, TBioseqList& bioseq_list,
+                                   TBioseqSetList& bioseq_set_list, TFileSize base_pos)
+{
+    context.bioseq_list = &bioseq_list;
+    context.bioseq_set_list = &bioseq_set_list;
+    context.base_pos = base_pos;
+}
+
+// A run of top level entries skipped by the main pass,
+// indexed separately and spliced back in file order
+struct CHugeAsnReader::SIndexChunk
+{
+    TFileSize m_pos = 0;
+    TFileSize m_end = 0;
+    size_t    m_count = 0;
+    TBioseqSetList::iterator m_parent;
+    // last records of the main lists when the chunk was started
+    TBioseqList::iterator    m_bioseq_anchor;
+    TBioseqSetList::iterator m_set_anchor;
+
+    TBioseqList    m_bioseq_list;
+    TBioseqSetList m_bioseq_set_list;
+    int            m_max_local_id = 0;
+    bool           m_has_huge_set_annot = false;
+    std::exception_ptr m_error;
+};
+
+bool CHugeAsnReader::x_UseParallelIndex() const
+{
+    // the entries must be found by skipping bytes, and the hooks of
+    // the caller may be not thread-safe
+    return m_index_threads > 1 &&
+        m_file->m_memory &&
+        m_file->m_serial_format == eSerial_AsnBinary &&
+        m_more_hooks.empty();
+}
+
+void CHugeAsnReader::x_SetDispatchHook(CObjectIStream& objStream, TContext& context, TIndexChunks& chunks)
+{
+    static const TFileSize kChunkSize = 4 * 1024 * 1024;
+
+    SetLocalSkipHook(CType<CSeq_entry>(), objStream,
+        [this, &context, &chunks](CObjectIStream& in, const CObjectTypeInfo& type)
+    {
+        auto parent = context.bioseq_set_stack.back();
+        // entries of top level objects are indexed in place,
+        // so that a Seq-submit or Seq-entry wrapper is not one big chunk
+        if (context.bioseq_set_stack.size() < 2 || !IsHugeSet(parent->m_class)) {
+            type.GetTypeInfo()->DefaultSkipData(in);
+            return;
+        }
+
+        TFileSize pos = in.GetStreamPos() + context.base_pos;
+        in.SkipAnyContentObject();
+        TFileSize end = in.GetStreamPos() + context.base_pos;
+
+        auto bioseq_anchor = m_bioseq_list.empty() ? m_bioseq_list.end() : prev(m_bioseq_list.end());
+        auto set_anchor = prev(m_bioseq_set_list.end());
+        if (!chunks.empty()) {
+            auto& last = chunks.back();
+            if (last.m_end == pos && last.m_parent == parent &&
+                last.m_bioseq_anchor == bioseq_anchor && last.m_set_anchor == set_anchor &&
+                last.m_end - last.m_pos < kChunkSize) {
+                last.m_end = end;
+                ++last.m_count;
+                return;
+            }
+        }
+        chunks.emplace_back();
+        auto& chunk = chunks.back();
+        chunk.m_pos = pos;
+        chunk.m_end = end;
+        chunk.m_count = 1;
+        chunk.m_parent = parent;
+        chunk.m_bioseq_anchor = bioseq_anchor;
+        chunk.m_set_anchor = set_anchor;
+    });
+}
+
+void CHugeAsnReader::x_IndexChunk(SIndexChunk& chunk)
+{
+    try {
+        auto obj_stream = m_file->MakeObjStream(chunk.m_pos);
+
+        TContext context;
+        x_InitContext(context, chunk.m_bioseq_list, chunk.m_bioseq_set_list, chunk.m_pos);
+        x_SetHooks(*obj_stream, context);
+
+        context.bioseq_set_stack.push_back(chunk.m_parent);
+        for (size_t i = 0; i < chunk.m_count; ++i) {
+            obj_stream->Skip(CSeq_entry::GetTypeInfo(), CObjectIStream::eNoFileHeader);
+        }
+        _ASSERT(chunk.m_pos + TFileSize(obj_stream->GetStreamPos()) == chunk.m_end);
+        chunk.m_max_local_id = context.max_local_id;
+        chunk.m_has_huge_set_annot = context.has_huge_set_annot;
+    }
+    catch (...) {
+        chunk.m_error = std::current_exception();
+    }
+}
+
+void CHugeAsnReader::x_IndexChunks(TIndexChunks& chunks)
+{
+    if (chunks.empty())
+        return;
+
+    std::atomic<size_t> next_chunk{0};
+    auto worker = [this, &chunks, &next_chunk]()
+    {
+        for (size_t i; (i = next_chunk++) < chunks.size(); ) {
+            x_IndexChunk(chunks[i]);
+        }
+    };
+
+    size_t num_threads = min(size_t(m_index_threads), chunks.size());
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < num_threads; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thr : threads) {
+        thr.join();
+    }
+
+    // Splice the records in the order of the file. Chunks started after
+    // the same main list record go right after it, so the last goes first.
+    for (auto it = chunks.rbegin(); it != chunks.rend(); ++it) {
+        auto& chunk = *it;
+        if (chunk.m_error) {
+            std::rethrow_exception(chunk.m_error);
+        }
+        m_bioseq_set_list.splice(next(chunk.m_set_anchor), chunk.m_bioseq_set_list);
+        auto bioseq_pos = chunk.m_bioseq_anchor == m_bioseq_list.end() ?
+            m_bioseq_list.begin() : next(chunk.m_bioseq_anchor);
+        m_bioseq_list.splice(bioseq_pos, chunk.m_bioseq_list);
+        m_max_local_id = std::max(m_max_local_id, chunk.m_max_local_id);
+        if (chunk.m_has_huge_set_annot) {
+            m_HasHugeSetAnnot = true;
+        }
+    }
+}
+
 void CHugeAsnReader::x_IndexNextAsn1()
 {
     x_ResetIndex();
@@ -436,8 +603,14 @@ void CHugeAsnReader::x_IndexNextAsn1()
     auto obj_stream = m_file->MakeObjStream(m_current_pos);
 
     TContext context;
+    x_InitContext(context, m_bioseq_list, m_bioseq_set_list, m_next_pos);
     x_SetHooks(*obj_stream, context);
 
+    TIndexChunks chunks;
+    if (x_UseParallelIndex()) {
+        x_SetDispatchHook(*obj_stream, context, chunks);
+    }
+
     m_HasHugeSetAnnot = false;
     // Ensure there is at least one bioseq_set_info object exists
     obj_stream->SkipFileHeader(object_type);
@@ -445,9 +618,244 @@ void CHugeAsnReader::x_IndexNextAsn1()
     context.bioseq_set_stack.push_back(m_bioseq_set_list.begin());
     obj_stream->Skip(object_type, CObjectIStream::eNoFileHeader);
     obj_stream->EndOfData(); // force to SkipWhiteSpace
+
+    m_max_local_id = std::max(m_max_local_id, context.max_local_id);
+    if (context.has_huge_set_annot) {
+        m_HasHugeSetAnnot = true;
+    }
+    x_IndexChunks(chunks);
+
     m_next_pos += obj_stream->GetStreamPos();
 }
 
+// Index file: the header identifying the input file, followed by
+// a record of each blob, numbers are 8 bytes little-endian,
+// objects are length prefixed binary ASN.1
+static const char kIndexFileMagic[8] = { 'N', 'C', 'B', 'I', 'H', 'A', 'I', 1 };
+
+static void s_WriteInt(CNcbiOstream& out, Int8 value)
+{
+    char buffer[8];
+    for (size_t i = 0; i < sizeof(buffer); ++i, value >>= 8) {
+        buffer[i] = char(value & 0xff);
+    }
+    out.write(buffer, sizeof(buffer));
+}
+
+static Int8 s_ReadInt(CNcbiIstream& in)
+{
+    unsigned char buffer[8];
+    in.read(reinterpret_cast<char*>(buffer), sizeof(buffer));
+    Uint8 value = 0;
+    for (size_t i = sizeof(buffer); i > 0; --i) {
+        value = (value << 8) | buffer[i-1];
+    }
+    return Int8(value);
+}
+
+static void s_WriteObject(CNcbiOstream& out, const CSerialObject* obj)
+{
+    if (!obj) {
+        s_WriteInt(out, 0);
+        return;
+    }
+    CNcbiOstrstream str;
+    str << MSerial_AsnBinary << *obj;
+    string data = CNcbiOstrstreamToString(str);
+    s_WriteInt(out, data.size());
+    out.write(data.data(), data.size());
+}
+
+template<class TObject>
+static CRef<TObject> s_ReadObject(CNcbiIstream& in)
+{
+    size_t size = size_t(s_ReadInt(in));
+    if (size == 0) {
+        return {};
+    }
+    vector<char> data(size);
+    in.read(data.data(), size);
+    auto obj = Ref(new TObject);
+    unique_ptr<CObjectIStream> obj_stream(CObjectIStream::CreateFromBuffer(eSerial_AsnBinary, data.data(), size));
+    *obj_stream >> *obj;
+    return obj;
+}
+
+void CHugeAsnReader::x_OpenIndexFile()
+{
+    if (m_index_file.empty() || m_file->m_filename.empty())
+        return;
+
+    time_t mtime = 0;
+    CFile(m_file->m_filename).GetTimeT(&mtime);
+
+    // the extra hooks must see the data
+    if (m_more_hooks.empty() && CFile(m_index_file).Exists()) {
+        m_index_in.reset(new CNcbiIfstream(m_index_file.c_str(), IOS_BASE::in | IOS_BASE::binary));
+        char magic[sizeof(kIndexFileMagic)];
+        m_index_in->read(magic, sizeof(magic));
+        if (*m_index_in &&
+            memcmp(magic, kIndexFileMagic, sizeof(magic)) == 0 &&
+            s_ReadInt(*m_index_in) == Int8(m_file->m_filesize) &&
+            s_ReadInt(*m_index_in) == Int8(mtime) &&
+            *m_index_in) {
+            m_index_in->exceptions(IOS_BASE::failbit | IOS_BASE::badbit);
+            return;
+        }
+        m_index_in.reset();
+    }
+    x_CreateIndexFile(mtime);
+}
+
+void CHugeAsnReader::x_CreateIndexFile(time_t mtime)
+{
+    string tmp_file = m_index_file + ".tmp";
+    m_index_out.reset(new CNcbiOfstream(tmp_file.c_str(), IOS_BASE::out | IOS_BASE::trunc | IOS_BASE::binary));
+    m_index_out->write(kIndexFileMagic, sizeof(kIndexFileMagic));
+    s_WriteInt(*m_index_out, m_file->m_filesize);
+    s_WriteInt(*m_index_out, mtime);
+    if (!*m_index_out) {
+        ERR_POST(Warning << "Cannot write index file " << tmp_file);
+        m_index_out.reset();
+        CFile(tmp_file).Remove();
+    }
+}
+
+bool CHugeAsnReader::x_ReadIndexRecord()
+{
+    if (!m_index_in)
+        return false;
+
+    try {
+        auto& in = *m_index_in;
+        if (s_ReadInt(in) != Int8(m_next_pos)) {
+            NCBI_THROW(CHugeFileException, eIndexFile, "blob position mismatch");
+        }
+        x_ResetIndex();
+        m_current_pos = m_next_pos;
+        TStreamPos next_pos = s_ReadInt(in);
+        m_max_local_id = int(s_ReadInt(in));
+        m_HasHugeSetAnnot = s_ReadInt(in) != 0;
+        m_submit_block = s_ReadObject<CSubmit_block>(in);
+
+        vector<TBioseqSetList::iterator> sets;
+        for (Int8 count = s_ReadInt(in); count > 0; --count) {
+            TFileSize pos = s_ReadInt(in);
+            Int8 parent = s_ReadInt(in);
+            if (parent < -1 || parent >= Int8(sets.size())) {
+                NCBI_THROW(CHugeFileException, eIndexFile, "invalid parent set");
+            }
+            m_bioseq_set_list.push_back({pos, parent < 0 ? m_bioseq_set_list.end() : sets[parent]});
+            auto& info = m_bioseq_set_list.back();
+            info.m_class = CBioseq_set::TClass(s_ReadInt(in));
+            if (s_ReadInt(in)) {
+                info.m_Level = int(s_ReadInt(in));
+            }
+            info.m_annot_pos = s_ReadInt(in);
+            info.m_descr = s_ReadObject<CSeq_descr>(in);
+            sets.push_back(prev(m_bioseq_set_list.end()));
+        }
+        for (Int8 count = s_ReadInt(in); count > 0; --count) {
+            TFileSize pos = s_ReadInt(in);
+            Int8 parent = s_ReadInt(in);
+            if (parent < 0 || parent >= Int8(sets.size())) {
+                NCBI_THROW(CHugeFileException, eIndexFile, "invalid parent set");
+            }
+            m_bioseq_list.push_back({pos, sets[parent]});
+            auto& info = m_bioseq_list.back();
+            info.m_length = TSeqPos(s_ReadInt(in));
+            info.m_mol = CSeq_inst::TMol(s_ReadInt(in));
+            info.m_repr = CSeq_inst::TRepr(s_ReadInt(in));
+            info.m_descr = s_ReadObject<CSeq_descr>(in);
+            for (Int8 ids = s_ReadInt(in); ids > 0; --ids) {
+                info.m_ids.push_back(s_ReadObject<CSeq_id>(in));
+            }
+        }
+        m_next_pos = next_pos;
+        return true;
+    }
+    catch (exception& e) {
+        ERR_POST(Warning << "Index file " << m_index_file << " is not used: " << e.what());
+    }
+    // don't let later runs stumble on the same bad file; if nothing was
+    // taken from it yet, write a new one while indexing
+    m_index_in.reset();
+    CFile(m_index_file).Remove();
+    if (m_next_pos == 0) {
+        time_t mtime = 0;
+        CFile(m_file->m_filename).GetTimeT(&mtime);
+        x_CreateIndexFile(mtime);
+    }
+    return false;
+}
+
+void CHugeAsnReader::x_WriteIndexRecord()
+{
+    if (!m_index_out)
+        return;
+
+    auto& out = *m_index_out;
+    s_WriteInt(out, m_current_pos);
+    s_WriteInt(out, m_next_pos);
+    s_WriteInt(out, m_max_local_id);
+    s_WriteInt(out, m_HasHugeSetAnnot);
+    s_WriteObject(out, m_submit_block.GetPointerOrNull());
+
+    map<const TBioseqSetInfo*, Int8> set_index;
+    auto get_parent = [&set_index, this](TBioseqSetList::const_iterator parent) -> Int8
+    {
+        return parent == m_bioseq_set_list.end() ? -1 : set_index[&*parent];
+    };
+    s_WriteInt(out, m_bioseq_set_list.size());
+    for (auto& info : m_bioseq_set_list) {
+        s_WriteInt(out, info.m_pos);
+        s_WriteInt(out, get_parent(info.m_parent_set));
+        s_WriteInt(out, info.m_class);
+        s_WriteInt(out, info.m_Level.has_value());
+        if (info.m_Level) {
+            s_WriteInt(out, info.m_Level.value());
+        }
+        s_WriteInt(out, info.m_annot_pos);
+        s_WriteObject(out, info.m_descr.GetPointerOrNull());
+        set_index.emplace(&info, set_index.size());
+    }
+    s_WriteInt(out, m_bioseq_list.size());
+    for (auto& info : m_bioseq_list) {
+        s_WriteInt(out, info.m_pos);
+        s_WriteInt(out, get_parent(info.m_parent_set));
+        s_WriteInt(out, info.m_length);
+        s_WriteInt(out, info.m_mol);
+        s_WriteInt(out, info.m_repr);
+        s_WriteObject(out, info.m_descr.GetPointerOrNull());
+        s_WriteInt(out, info.m_ids.size());
+        for (auto& id : info.m_ids) {
+            s_WriteObject(out, id.GetPointerOrNull());
+        }
+    }
+
+    if (!out) {
+        ERR_POST(Warning << "Cannot write index file " << m_index_file << ".tmp");
+        m_index_out.reset();
+        CFile(m_index_file + ".tmp").Remove();
+    }
+}
+
+void CHugeAsnReader::x_CommitIndexFile()
+{
+    m_index_in.reset();
+    if (!m_index_out)
+        return;
+
+    m_index_out->close();
+    bool ok = !m_index_out->fail();
+    m_index_out.reset();
+    CFile tmp_file(m_index_file + ".tmp");
+    if (!ok || !tmp_file.Rename(m_index_file, CDirEntry::fRF_Overwrite)) {
+        ERR_POST(Warning << "Cannot write index file " << m_index_file);
+        tmp_file.Remove();
+    }
+}
+
 CRef<CSerialObject> CHugeAsnReader::ReadAny()
 {
     if (m_current_pos >= m_file->m_filesize)
@@ -56,6 +56,10 @@
 #include <objtools/huge_asn/huge_file_process.hpp>
 #include <objtools/data_loaders/genbank/gbloader.hpp>
 #include <objmgr/feat_ci.hpp>
+#include <objects/seq/Seq_data.hpp>
+#include <objects/seq/IUPACna.hpp>
+#include <objects/general/Object_id.hpp>
+#include <corelib/ncbifile.hpp>
 
 // This header must be included before all Boost.Test headers if there are any
 #include <corelib/test_boost.hpp>
@@ -150,3 +154,135 @@ BOOST_AUTO_TEST_CASE(Test_RemoteSequences)
     }
 }
 
+
+
+// Genbank set of generated sequences followed by a small second blob,
+// in binary ASN.1, large enough to be indexed in several chunks
+static void s_WriteGenbankSets(const string& filename, const string& prefix, int count)
+{
+    CNcbiOfstream out(filename.c_str(), IOS_BASE::out | IOS_BASE::trunc | IOS_BASE::binary);
+    for (int blob = 0; blob < 2; ++blob) {
+        auto entry = Ref(new CSeq_entry);
+        auto& bioseq_set = entry->SetSet();
+        bioseq_set.SetClass(CBioseq_set::eClass_genbank);
+        for (int i = 0; i < (blob ? 3 : count); ++i) {
+            auto seq_entry = Ref(new CSeq_entry);
+            auto& bioseq = seq_entry->SetSeq();
+            auto id = Ref(new CSeq_id);
+            id->SetLocal().SetStr(prefix + NStr::IntToString(blob) + "_" + NStr::IntToString(i));
+            bioseq.SetId().push_back(id);
+            if (i % 3 == 0) {
+                auto title = Ref(new CSeqdesc);
+                title->SetTitle("sequence " + NStr::IntToString(i));
+                bioseq.SetDescr().Set().push_back(title);
+            }
+            auto& inst = bioseq.SetInst();
+            inst.SetRepr(CSeq_inst::eRepr_raw);
+            inst.SetMol(i % 2 ? CSeq_inst::eMol_dna : CSeq_inst::eMol_rna);
+            string bases(2000 + i % 100, 'A');
+            for (size_t pos = 0; pos < bases.size(); pos += 7) {
+                bases[pos] = "CGT"[(pos + i) % 3];
+            }
+            inst.SetLength(TSeqPos(bases.size()));
+            inst.SetSeq_data().SetIupacna().Set(bases);
+            bioseq_set.SetSeq_set().push_back(seq_entry);
+        }
+        out << MSerial_AsnBinary << *entry;
+    }
+}
+
+static string s_DescribeIndex(const CHugeAsnReader& reader)
+{
+    map<const CHugeAsnReader::TBioseqSetInfo*, size_t> set_index;
+    auto parent_index = [&](CHugeAsnReader::TBioseqSetList::const_iterator parent) {
+        return parent == reader.GetBiosets().end() ? string("-") : NStr::NumericToString(set_index[&*parent]);
+    };
+    CNcbiOstrstream str;
+    for (auto& info : reader.GetBiosets()) {
+        str << "set " << info.m_pos << " " << parent_index(info.m_parent_set) << " " << info.m_class
+            << " " << info.m_annot_pos << " " << info.m_Level.value_or(-1) << "\n";
+        if (info.m_descr) {
+            str << MSerial_AsnText << *info.m_descr;
+        }
+        set_index.emplace(&info, set_index.size());
+    }
+    for (auto& info : reader.GetBioseqs()) {
+        str << "seq " << info.m_pos << " " << parent_index(info.m_parent_set) << " " << info.m_length
+            << " " << info.m_mol << " " << info.m_repr;
+        for (auto& id : info.m_ids) {
+            str << " " << id->AsFastaString();
+        }
+        str << "\n";
+        if (info.m_descr) {
+            str << MSerial_AsnText << *info.m_descr;
+        }
+    }
+    str << "max local id " << reader.GetMaxLocalId() << "\n";
+    return CNcbiOstrstreamToString(str);
+}
+
+static string s_Index(const string& filename, unsigned threads, const string& index_file = kEmptyStr)
+{
+    CHugeFileProcess process;
+    process.Open(filename);
+    auto& reader = process.GetReader();
+    reader.SetIndexThreads(threads);
+    if (!index_file.empty()) {
+        reader.SetIndexFile(index_file);
+    }
+    string result;
+    while (reader.GetNextBlob()) {
+        result += s_DescribeIndex(reader);
+    }
+    return result;
+}
+
+BOOST_AUTO_TEST_CASE(Test_ParallelIndex)
+{
+    string filename = CFile::GetTmpName();
+    s_WriteGenbankSets(filename, "seq", 3000);
+
+    string sequential = s_Index(filename, 0);
+    BOOST_CHECK(!sequential.empty());
+    BOOST_CHECK_EQUAL(sequential, s_Index(filename, 4));
+
+    CFile(filename).Remove();
+}
+
+BOOST_AUTO_TEST_CASE(Test_IndexFile)
+{
+    string filename = CFile::GetTmpName();
+    string index_file = filename + ".idx";
+    s_WriteGenbankSets(filename, "seq", 3000);
+    string expected = s_Index(filename, 0);
+
+    // written by the first run, loaded by the next one
+    BOOST_CHECK_EQUAL(expected, s_Index(filename, 0, index_file));
+    BOOST_REQUIRE(CFile(index_file).Exists());
+    Int8 index_size = CFile(index_file).GetLength();
+    BOOST_CHECK_EQUAL(expected, s_Index(filename, 4, index_file));
+
+    // same size, other ids and newer time: the index is stale
+    time_t mtime = 0;
+    CFile(filename).GetTimeT(&mtime);
+    s_WriteGenbankSets(filename, "SEQ", 3000);
+    mtime += 10;
+    CFile(filename).SetTimeT(&mtime, &mtime);
+    string changed = s_Index(filename, 0);
+    BOOST_CHECK(changed != expected);
+    BOOST_CHECK_EQUAL(changed, s_Index(filename, 0, index_file));
+    BOOST_CHECK_EQUAL(changed, s_Index(filename, 0, index_file));
+
+    // cut short: the data are indexed again and the index is rewritten
+    {
+        vector<char> data(size_t(index_size / 2));
+        CNcbiIfstream(index_file.c_str(), IOS_BASE::binary).read(data.data(), data.size());
+        CNcbiOfstream(index_file.c_str(), IOS_BASE::binary | IOS_BASE::trunc).write(data.data(), data.size());
+    }
+    BOOST_CHECK_EQUAL(changed, s_Index(filename, 0, index_file));
+    BOOST_CHECK_EQUAL(CFile(index_file).GetLength(), index_size);
+    BOOST_CHECK_EQUAL(changed, s_Index(filename, 0, index_file));
+
+    CFile(index_file).Remove();
+    CFile(filename).Remove();
+}
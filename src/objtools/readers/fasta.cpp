@@ -42,6 +42,8 @@
 #include <objtools/error_codes.hpp>
 
 #include <corelib/ncbiutil.hpp>
+#include <corelib/ncbifile.hpp>
+#include <corelib/ncbi_system.hpp>
 #include <util/format_guess.hpp>
 #include <util/sequtil/sequtil_convert.hpp>
 
@@ -84,6 +86,10 @@
 #include <objtools/readers/mod_reader.hpp>
 
 #include <ctype.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 // The "49518053" is just a random number to minimize the chance of the
 // variable name conflicting with another variable name and has no
@@ -471,6 +477,528 @@ CRef<CSeq_entry> CFastaReader::ReadSet(int max_seqs, ILineErrorListener * pMessa
     }
 }
 
+// Line reader over one chunk of a memory-mapped file; positions and line
+// numbers are reported relative to the whole file.
+class CFastaChunkLineReader : public CMemoryLineReader
+{
+public:
+    CFastaChunkLineReader(const char* start, const char* end,
+                          Int8 offset, Uint8 first_line)
+        : CMemoryLineReader(start, end),
+          m_Offset(offset), m_FirstLine(first_line) {}
+
+    CT_POS_TYPE GetPosition(void) const override
+    {
+        return NcbiInt8ToStreampos(
+            NcbiStreamposToInt8(CMemoryLineReader::GetPosition()) + m_Offset);
+    }
+    Uint8 GetLineNumber(void) const override
+    {
+        return CMemoryLineReader::GetLineNumber() + m_FirstLine;
+    }
+
+private:
+    Int8  m_Offset;
+    Uint8 m_FirstLine;
+};
+
+
+// Collects the messages posted while a chunk is parsed on a worker thread,
+// so that they can be passed on to the caller's listener in file order.
+class CFastaChunkListener : public ILineErrorListener
+{
+public:
+    CFastaChunkListener(const ILineErrorListener* pTarget)
+        : m_pTarget(pTarget), m_Replayed(0) {}
+
+    bool SevEnabled(EDiagSev severity) const override
+    {
+        return m_pTarget ? m_pTarget->SevEnabled(severity) : false;
+    }
+
+    bool PutError(const ILineError& err) override
+    {
+        m_Events.emplace_back();
+        m_Events.back().m_Error.reset(err.Clone());
+        m_Errors.push_back(m_Events.back().m_Error.get());
+        return true;
+    }
+
+    void PutProgress(const string& sMessage,
+                     const Uint8   iNumDone,
+                     const Uint8   iNumTotal) override
+    {
+        m_Events.emplace_back();
+        m_Events.back().m_Progress  = sMessage;
+        m_Events.back().m_NumDone   = iNumDone;
+        m_Events.back().m_NumTotal  = iNumTotal;
+    }
+
+    const ILineError& GetError(size_t index) const override
+        { return *m_Errors[index]; }
+    size_t Count(void) const override
+        { return m_Errors.size(); }
+    size_t LevelCount(EDiagSev eSev) override
+    {
+        return count_if(m_Errors.begin(), m_Errors.end(),
+            [eSev](const ILineError* err) { return err->GetSeverity() == eSev; });
+    }
+    void ClearAll(void) override
+    {
+        m_Events.clear();
+        m_Errors.clear();
+        m_Replayed = 0;
+    }
+
+    /// Position to pass to Replay() to cover everything posted so far.
+    size_t GetMark(void) const { return m_Events.size(); }
+
+    /// Pass the messages posted before the given mark on to the target,
+    /// throwing as the reporting code would if the target refuses one.
+    void Replay(size_t mark, ILineErrorListener& target);
+
+private:
+    struct SEvent {
+        unique_ptr<ILineError> m_Error;
+        string                 m_Progress;
+        Uint8                  m_NumDone  = 0;
+        Uint8                  m_NumTotal = 0;
+    };
+
+    const ILineErrorListener* m_pTarget;
+    deque<SEvent>             m_Events;
+    vector<const ILineError*> m_Errors;
+    size_t                    m_Replayed;
+};
+
+
+void CFastaChunkListener::Replay(size_t mark, ILineErrorListener& target)
+{
+    for ( ;  m_Replayed < mark;  ++m_Replayed) {
+        SEvent& event = m_Events[m_Replayed];
+        if ( !event.m_Error ) {
+            target.PutProgress(event.m_Progress,
+                               event.m_NumDone, event.m_NumTotal);
+        } else if ( !target.PutError(*event.m_Error) ) {
+            const ILineError& err = *event.m_Error;
+            auto code = CObjReaderParseException::eFormat;
+            auto pLineExpt = dynamic_cast<const CObjReaderLineException*>(&err);
+            if (pLineExpt) {
+                code = static_cast<CObjReaderParseException::EErrCode>(
+                    pLineExpt->GetErrCode());
+            }
+            throw CObjReaderParseException(DIAG_COMPILE_INFO, 0, code,
+                err.ErrorMessage(), err.Line(), err.Severity());
+        }
+        event.m_Error.reset();
+    }
+}
+
+
+struct CFastaReader::SParallelChunk
+{
+    SParallelChunk(const char* start, const char* end,
+                   Int8 offset, Uint8 first_line, TSeqPos first_defline)
+        : m_Start(start), m_End(end),
+          m_Offset(offset), m_FirstLine(first_line),
+          m_FirstDefLine(first_defline)
+        {}
+
+    // What ParseDefLine() did, as far as it matters beyond the chunk
+    struct SDefLine {
+        Uint8                  m_LineNumber;
+        vector<CSeq_id_Handle> m_Ids;
+        CRef<CSeq_id>          m_BestID;
+        size_t                 m_Mark;
+    };
+    struct SRecord {
+        CRef<CSeq_entry> m_Entry;
+        bool             m_HasDefLine = false;
+        SDefLine         m_DefLine;
+        size_t           m_Mark = 0;
+    };
+
+    const char* m_Start;
+    const char* m_End;
+    Int8        m_Offset;
+    Uint8       m_FirstLine;
+    TSeqPos     m_FirstDefLine; // number of deflines in preceding chunks
+
+    // filled in by the worker thread
+    CSeqIdGenerator::TCount   m_IdCounter = 0; // counter value assumed at start
+    TSeqPos                   m_GeneratedIds = 0;
+    vector<SRecord>           m_Records;
+    TMasks                    m_Masks;
+    TPostponedModMap          m_PostponedModMap;
+    CRef<CFastaChunkListener> m_Listener;
+    bool                      m_HitEOF = false;
+    exception_ptr             m_Error;
+    bool                      m_Done = false;
+};
+
+
+// Parses one chunk on behalf of ReadSetParallel(), recording what it takes
+// to check ID uniqueness and number generated IDs across chunks.
+class CFastaChunkReader : public CFastaReader
+{
+public:
+    typedef CFastaReader TParent;
+
+    CFastaChunkReader(ILineReader& reader, SParallelChunk& chunk,
+                      TFlags flags, FIdCheck f_idcheck)
+        : TParent(reader, flags, f_idcheck), m_Chunk(chunk) {}
+
+    void ReadChunk(ILineErrorListener* pMessageListener);
+
+protected:
+    void ParseDefLine(const TStr& s, ILineErrorListener * pMessageListener) override;
+    void GenerateID(void) override;
+
+private:
+    SParallelChunk&          m_Chunk;
+    SParallelChunk::SRecord  m_Record;
+};
+
+
+void CFastaChunkReader::ReadChunk(ILineErrorListener* pMessageListener)
+{
+    SaveMasks(&m_Chunk.m_Masks);
+    while ( !GetLineReader().AtEOF() ) {
+        m_Record = SParallelChunk::SRecord();
+        try {
+            m_Record.m_Entry = ReadOneSeq(pMessageListener);
+        } catch (const CObjReaderParseException& e) {
+            if (e.GetErrCode() == CObjReaderParseException::eEOF) {
+                m_Chunk.m_HitEOF = true;
+                break;
+            } else {
+                throw;
+            }
+        }
+        if (m_Chunk.m_Listener) {
+            m_Record.m_Mark = m_Chunk.m_Listener->GetMark();
+        }
+        m_Chunk.m_Records.push_back(std::move(m_Record));
+    }
+    m_Chunk.m_PostponedModMap = GetPostponedModMap();
+}
+
+
+void CFastaChunkReader::ParseDefLine(const TStr& s, ILineErrorListener * pMessageListener)
+{
+    TParent::ParseDefLine(s, pMessageListener);
+    m_Record.m_HasDefLine = true;
+    SParallelChunk::SDefLine& defline = m_Record.m_DefLine;
+    defline.m_LineNumber = LineNumber();
+    for (const auto& id : GetIDs()) {
+        defline.m_Ids.push_back(CSeq_id_Handle::GetHandle(*id));
+    }
+    defline.m_BestID = m_BestID;
+    defline.m_Mark = m_Chunk.m_Listener ? m_Chunk.m_Listener->GetMark() : 0;
+}
+
+
+void CFastaChunkReader::GenerateID(void)
+{
+    TParent::GenerateID();
+    ++m_Chunk.m_GeneratedIds;
+}
+
+
+void CFastaReader::x_CopySettings(CFastaReader& reader) const
+{
+    reader.m_iFlags = m_iFlags;
+    reader.m_ModHandler = m_ModHandler;
+    reader.m_bModifiedMaxIdLength = m_bModifiedMaxIdLength;
+    reader.m_MaxIDLength = m_MaxIDLength;
+    reader.m_gapNmin = m_gapNmin;
+    reader.m_gap_Unknown_length = m_gap_Unknown_length;
+    reader.m_GapsizeToLinkageEvidence = m_GapsizeToLinkageEvidence;
+    reader.m_DefaultLinkageEvidence = m_DefaultLinkageEvidence;
+    reader.m_gap_type = m_gap_type;
+    reader.m_ignorable = m_ignorable;
+    reader.m_fModFilter = m_fModFilter;
+    reader.m_PostponedMods = m_PostponedMods;
+}
+
+
+void CFastaReader::x_ReadParallelChunk(SParallelChunk& chunk,
+                                       ILineErrorListener* pMessageListener) const
+{
+    try {
+        CRef<ILineReader> lr(new CFastaChunkLineReader(
+            chunk.m_Start, chunk.m_End, chunk.m_Offset, chunk.m_FirstLine));
+        // uniqueness of IDs is checked file-wide when merging
+        CFastaChunkReader reader(*lr, chunk, GetFlags() & ~fUniqueIDs, m_fIdCheck);
+        x_CopySettings(reader);
+        const CSeqIdGenerator& gen = GetIDGenerator();
+        CRef<CSeqIdGenerator> chunk_gen(new CSeqIdGenerator(
+            chunk.m_IdCounter, gen.GetPrefix(), gen.GetSuffix()));
+        reader.SetIDGenerator(*chunk_gen);
+        if (pMessageListener) {
+            chunk.m_Listener.Reset(new CFastaChunkListener(pMessageListener));
+        }
+        reader.ReadChunk(chunk.m_Listener);
+    } catch (...) {
+        chunk.m_Error = current_exception();
+    }
+}
+
+
+bool CFastaReader::x_MergeParallelChunk(SParallelChunk& chunk,
+                                        CSeq_entry& entry,
+                                        ILineErrorListener* pMessageListener)
+{
+    CSeqIdGenerator& gen = SetIDGenerator();
+    if (chunk.m_GeneratedIds > 0
+        &&  (chunk.m_IdCounter != gen.GetCounter()  ||  TestFlag(fUniqueIDs))) {
+        // The generated IDs depend on the preceding chunks; parse again,
+        // sharing this reader's ID state.
+        CRef<ILineReader> lr(new CFastaChunkLineReader(
+            chunk.m_Start, chunk.m_End, chunk.m_Offset, chunk.m_FirstLine));
+        CFastaReader reader(*lr, GetFlags(), m_fIdCheck);
+        x_CopySettings(reader);
+        reader.m_IDHandler = m_IDHandler;
+        reader.SaveMasks(m_MaskVec);
+        reader.m_PostponedModMap.swap(m_PostponedModMap);
+        bool more = true;
+        try {
+            while (more  &&  !lr->AtEOF()) {
+                try {
+                    CRef<CSeq_entry> entry2(reader.ReadOneSeq(pMessageListener));
+                    if (entry2.NotEmpty()) {
+                        entry.SetSet().SetSeq_set().push_back(entry2);
+                    }
+                } catch (const CObjReaderParseException& e) {
+                    if (e.GetErrCode() != CObjReaderParseException::eEOF) {
+                        throw;
+                    }
+                    more = false;
+                }
+            }
+        } catch (...) {
+            reader.m_PostponedModMap.swap(m_PostponedModMap);
+            throw;
+        }
+        reader.m_PostponedModMap.swap(m_PostponedModMap);
+        return more;
+    }
+
+    gen.SetCounter(gen.GetCounter() + CSeqIdGenerator::TCount(chunk.m_GeneratedIds));
+
+    CFastaChunkListener* pChunkListener = chunk.m_Listener;
+    try {
+        for (auto& record : chunk.m_Records) {
+            if (record.m_HasDefLine  &&  TestFlag(fUniqueIDs)) {
+                const SParallelChunk::SDefLine& defline = record.m_DefLine;
+                if (pChunkListener) {
+                    pChunkListener->Replay(defline.m_Mark, *pMessageListener);
+                }
+                m_BestID = defline.m_BestID;
+                for (const auto& h : defline.m_Ids) {
+                    if ( !m_IDHandler->CacheIdHandle(h) ) {
+                        FASTA_ERROR(defline.m_LineNumber,
+                            "CFastaReader: Seq-id " << h.AsString()
+                            << " is a duplicate around line " << defline.m_LineNumber,
+                            CObjReaderParseException::eDuplicateID );
+                    }
+                }
+            }
+            if (pChunkListener) {
+                pChunkListener->Replay(record.m_Mark, *pMessageListener);
+            }
+            if (record.m_Entry.NotEmpty()) {
+                entry.SetSet().SetSeq_set().push_back(record.m_Entry);
+            }
+        }
+        if (pChunkListener) {
+            pChunkListener->Replay(pChunkListener->GetMark(), *pMessageListener);
+        }
+    } catch (const CObjReaderParseException& e) {
+        if (e.GetErrCode() != CObjReaderParseException::eEOF) {
+            throw;
+        }
+        return false;
+    }
+    m_BestID.Reset();
+
+    if (m_MaskVec) {
+        m_MaskVec->insert(m_MaskVec->end(),
+                          chunk.m_Masks.begin(), chunk.m_Masks.end());
+    }
+    for (auto& it : chunk.m_PostponedModMap) {
+        auto mit = m_PostponedModMap.find(it.first);
+        if (mit == m_PostponedModMap.end()) {
+            m_PostponedModMap.emplace(it.first, std::move(it.second));
+        } else {
+            auto& mods = mit->second.second;
+            mods.splice(mods.end(), it.second.second);
+        }
+    }
+
+    if (chunk.m_Error) {
+        rethrow_exception(chunk.m_Error);
+    }
+    return !chunk.m_HitEOF;
+}
+
+
+// Start of the line following the one at p, with the same notion of line
+// breaks as CMemoryLineReader.
+static const char* s_NextLine(const char* p, const char* end)
+{
+    const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+    if ( !eol ) {
+        eol = end;
+    }
+    const char* cr = static_cast<const char*>(memchr(p, '\r', eol - p));
+    if (cr) {
+        eol = cr;
+    }
+    if (eol + 1 < end  &&  *eol == '\r'  &&  eol[1] == '\n') {
+        return eol + 2;
+    }
+    return eol < end ? eol + 1 : end;
+}
+
+
+CRef<CSeq_entry> CFastaReader::ReadSetParallel(const string& path,
+                                               unsigned int num_threads,
+                                               ILineErrorListener* pMessageListener)
+{
+    if (CFile(path).GetLength() == 0) {
+        // nothing to map; empty entry, as ReadSet() gives
+        return CRef<CSeq_entry>(new CSeq_entry);
+    }
+    CRef<CSeq_entry> entry(new CSeq_entry);
+    unique_ptr<CMemoryFile> mem_file(new CMemoryFile(path));
+    const char* start = static_cast<const char*>(mem_file->GetPtr());
+    const char* end   = start + mem_file->GetSize();
+
+    if (TestFlag(fOneSeq)) {
+        CRef<ILineReader> lr(new CMemoryLineReader(mem_file.release(), eTakeOwnership));
+        return ReadSeqEntry(*lr, pMessageListener);
+    }
+    mem_file->MemMapAdvise(CMemoryFile::eMMA_Sequential);
+
+    // Split at deflines; "?" lines are assembly gaps within a sequence.
+    const bool count_ids = TestFlag(fNoParseID)  &&  !TestFlag(fUniqueIDs);
+    const CSeqIdGenerator::TCount first_id = GetIDGenerator().GetCounter();
+    const size_t chunk_size = max(m_ParallelChunkSize, size_t(1));
+    deque<SParallelChunk> chunks;
+    const char* chunk_start = start;
+    Uint8   chunk_line = 0,  line = 0;
+    TSeqPos chunk_deflines = 0,  deflines = 0;
+    for (const char* p = start;  p < end;  p = s_NextLine(p, end), ++line) {
+        if (*p != '>'  ||  (p + 1 < end  &&  p[1] == '?')) {
+            continue;
+        }
+        if (size_t(p - chunk_start) >= chunk_size) {
+            chunks.emplace_back(chunk_start, p, chunk_start - start,
+                                chunk_line, chunk_deflines);
+            chunk_start = p;
+            chunk_line = line;
+            chunk_deflines = deflines;
+        }
+        ++deflines;
+    }
+    chunks.emplace_back(chunk_start, end, chunk_start - start,
+                        chunk_line, chunk_deflines);
+    for (auto& chunk : chunks) {
+        // assume one generated ID per defline when IDs are not parsed;
+        // merging checks the guess
+        chunk.m_IdCounter = first_id +
+            (count_ids ? CSeqIdGenerator::TCount(chunk.m_FirstDefLine) : 0);
+    }
+
+    if (num_threads == 0) {
+        num_threads = CSystemInfo::GetCpuCount();
+    }
+    num_threads = (unsigned int) min(size_t(num_threads), chunks.size());
+
+    // Parsed chunks are kept until they are merged in file order; a worker
+    // does not start a chunk more than max_ahead chunks past the one being
+    // merged, so that fast parsing does not buffer the whole file.
+    const size_t       max_ahead = 2 * size_t(num_threads);
+    mutex              done_mutex;
+    condition_variable done_cond;
+    size_t             merged = 0; // guarded by done_mutex
+    atomic<size_t>     next_chunk(0);
+    atomic<bool>       canceled(false);
+    auto worker = [&]() {
+        for (size_t i = next_chunk++;
+             i < chunks.size()  &&  !canceled;  i = next_chunk++) {
+            {{
+                unique_lock<mutex> guard(done_mutex);
+                done_cond.wait(guard, [&]() {
+                    return i < merged + max_ahead  ||  canceled;
+                });
+            }}
+            if (canceled) {
+                break;
+            }
+            x_ReadParallelChunk(chunks[i], pMessageListener);
+            lock_guard<mutex> guard(done_mutex);
+            chunks[i].m_Done = true;
+            done_cond.notify_all();
+        }
+    };
+
+    struct SWorkers {
+        vector<thread>&     m_Threads;
+        atomic<bool>&       m_Canceled;
+        mutex&              m_Mutex;
+        condition_variable& m_Cond;
+        ~SWorkers() {
+            {{
+                lock_guard<mutex> guard(m_Mutex);
+                m_Canceled = true;
+            }}
+            m_Cond.notify_all();
+            for (auto& t : m_Threads) {
+                t.join();
+            }
+        }
+    };
+    vector<thread> threads;
+    SWorkers workers{threads, canceled, done_mutex, done_cond};
+    for (unsigned int i = 0;  i < num_threads;  ++i) {
+        threads.emplace_back(worker);
+    }
+
+    for (auto& chunk : chunks) {
+        {{
+            unique_lock<mutex> guard(done_mutex);
+            done_cond.wait(guard, [&chunk]() { return chunk.m_Done; });
+        }}
+        bool more = x_MergeParallelChunk(chunk, *entry, pMessageListener);
+        // release the parsed data as soon as it is merged
+        chunk.m_Records.clear();
+        chunk.m_Masks.clear();
+        chunk.m_Listener.Reset();
+        if ( !more ) {
+            break;
+        }
+        {{
+            lock_guard<mutex> guard(done_mutex);
+            ++merged;
+        }}
+        done_cond.notify_all();
+    }
+
+    if ( !entry->IsSet() ) {
+        // no sequences at all, the entry is empty as with ReadSet()
+        return entry;
+    }
+    if (entry->GetSet().GetSeq_set().size() == 1) {
+        return entry->SetSet().SetSeq_set().front();
+    } else {
+        entry->Parentize();
+        return entry;
+    }
+}
+
+
 CRef<CSeq_loc> CFastaReader::SaveMask(void)
 {
     m_NextMask.Reset(new CSeq_loc);
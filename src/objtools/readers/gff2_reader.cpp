@@ -1430,7 +1430,7 @@ CGff2Reader::xNeedsNewSeqAnnot(
     const string& line)
 //  ---------------------------------------------------------------------------
 {
-    if (IsInGenbankMode()) {
+    if (IsInGenbankMode()  ||  (m_iFlags & fStreaming)) {
         vector<string> columns;
         NStr::Split(line, "\t ", columns, NStr::eMergeDelims);
         string seqId = columns[0];
@@ -242,6 +242,9 @@ CGff3Reader::ReadSeqAnnot(
     mParsingAlignment = false;
     mAlignmentData.Reset();
     mpLocations->Reset();
+    if (m_iFlags & fStreaming) {
+        xReleaseRegionData();
+    }
     auto pAnnot = CReaderBase::ReadSeqAnnot(lr, pEC);
     if (pAnnot  &&  pAnnot->GetData().Which() == CSeq_annot::TData::e_not_set) {
         return CRef<CSeq_annot>();
@@ -249,6 +252,18 @@ CGff3Reader::ReadSeqAnnot(
     return pAnnot;
 }
 
+//  ----------------------------------------------------------------------------
+void CGff3Reader::xReleaseRegionData()
+//  ----------------------------------------------------------------------------
+{
+    // the features themselves now belong to the annot already returned
+    m_MapIdToFeature.clear();
+    mIdToSeqIdMap.clear();
+    mCdsParentMap.clear();
+    mCdsParents.clear();
+    mMrnaLocs.clear();
+}
+
 //  ----------------------------------------------------------------------------
 void
 CGff3Reader::xProcessData(
@@ -471,3 +471,87 @@ BOOST_AUTO_TEST_CASE(RunTests)
         BOOST_CHECK_NO_THROW(sRunTest(sName, testInfo, args["keep-diffs"]));
     }
 }
+
+
+BOOST_AUTO_TEST_CASE(ParallelReadMatchesSequential)
+{
+    // Enough small records for many chunks, with a duplicate ID, an
+    // ID-less defline, assembly gap lines and modifier warnings, so that
+    // every cross-chunk case is exercised.
+    const string path = CDirEntry::GetTmpName();
+    {{
+        CNcbiOfstream ostr(path.c_str());
+        ostr << "; leading comment" << endl;
+        for (int i = 0; i < 300; ++i) {
+            if (i % 97 == 50) {
+                ostr << ">" << endl;
+            } else if (i % 101 == 77) {
+                ostr << ">seq5 duplicate" << endl;
+            } else {
+                ostr << ">seq" << i << " [organism=Homo sapiens]" << endl;
+            }
+            ostr << "ACGTACGTACGTNNNNNNNNNNNNACGT" << endl;
+            if (i % 7 == 0) {
+                ostr << ">?100" << endl;
+            }
+            ostr << "acgtacgtACGTACGT" << endl << endl;
+        }
+    }}
+
+    const CFastaReader::TFlags flags = CFastaReader::fAssumeNuc |
+        CFastaReader::fParseGaps | CFastaReader::fUniqueIDs;
+
+    CMessageListenerLenient seqListener;
+    CRef<ILineReader> pLineReader = ILineReader::New(path);
+    CFastaReader seqReader(*pLineReader, flags);
+    CFastaReader::TMasks seqMasks;
+    seqReader.SaveMasks(&seqMasks);
+    CRef<CSeq_entry> pSeqEntry = seqReader.ReadSet(kMax_Int, &seqListener);
+    pLineReader.Reset();
+
+    CMessageListenerLenient parListener;
+    CFastaReader parReader(CReaderBase::TReaderFlags(0), flags);
+    CFastaReader::TMasks parMasks;
+    parReader.SaveMasks(&parMasks);
+    parReader.SetParallelChunkSize(1000);
+    CRef<CSeq_entry> pParEntry = parReader.ReadSetParallel(path, 4, &parListener);
+
+    BOOST_CHECK(pSeqEntry->Equals(*pParEntry));
+    BOOST_CHECK_EQUAL(seqMasks.size(), parMasks.size());
+    BOOST_CHECK_EQUAL(seqListener.Count(), parListener.Count());
+    CNcbiOstrstream seqErrors, parErrors;
+    seqListener.Dump(seqErrors);
+    parListener.Dump(parErrors);
+    BOOST_CHECK_EQUAL(string(CNcbiOstrstreamToString(seqErrors)),
+                      string(CNcbiOstrstreamToString(parErrors)));
+
+    CDirEntry(path).Remove();
+}
+
+
+BOOST_AUTO_TEST_CASE(ParallelReadEmptyInput)
+{
+    // Neither an empty file nor one without deflines has sequences,
+    // both give the same empty entry as ReadSet()
+    const string path = CDirEntry::GetTmpName();
+    const char* const kInputs[] = { "", "; comment only\n\n" };
+    for ( auto input : kInputs ) {
+        {{
+            CNcbiOfstream ostr(path.c_str());
+            ostr << input;
+        }}
+        CRef<ILineReader> pLineReader = ILineReader::New(path);
+        CFastaReader seqReader(*pLineReader, CFastaReader::fAssumeNuc);
+        CRef<CSeq_entry> pSeqEntry = seqReader.ReadSet();
+        pLineReader.Reset();
+        CFastaReader parReader(CReaderBase::TReaderFlags(0),
+                               CFastaReader::fAssumeNuc);
+        CRef<CSeq_entry> pParEntry = parReader.ReadSetParallel(path, 4);
+        BOOST_REQUIRE( pSeqEntry );
+        BOOST_REQUIRE( pParEntry );
+        BOOST_CHECK( pParEntry->Which() == CSeq_entry::e_not_set );
+        BOOST_CHECK( pParEntry->Equals(*pSeqEntry) );
+    }
+
+    CDirEntry(path).Remove();
+}
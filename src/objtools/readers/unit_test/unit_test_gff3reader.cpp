@@ -38,6 +38,7 @@
 
 #include <objtools/readers/gff3_reader.hpp>
 #include <objtools/readers/read_util.hpp>
+#include <util/line_reader.hpp>
 #include "tc_message_listener.hpp"
 
 #include <cstdio>
@@ -326,3 +327,47 @@ BOOST_AUTO_TEST_CASE(RunTests)
         BOOST_CHECK_NO_THROW(sRunTest(sName, testInfo, args["keep-diffs"]));
     }
 }
+
+BOOST_AUTO_TEST_CASE(StreamingMode)
+{
+    // two regions, no directives between them; the CDS spans two lines
+    const string kGff3 =
+        "##gff-version 3\n"
+        "chr1\t.\tgene\t100\t900\t.\t+\t.\tID=gene1\n"
+        "chr1\t.\tmRNA\t100\t900\t.\t+\t.\tID=rna1;Parent=gene1\n"
+        "chr1\t.\texon\t100\t300\t.\t+\t.\tParent=rna1\n"
+        "chr1\t.\texon\t500\t900\t.\t+\t.\tParent=rna1\n"
+        "chr1\t.\tCDS\t150\t300\t.\t+\t0\tID=cds1;Parent=rna1\n"
+        "chr1\t.\tCDS\t500\t800\t.\t+\t0\tID=cds1;Parent=rna1\n"
+        "chr2\t.\tgene\t10\t90\t.\t-\t.\tID=gene2\n"
+        "chr2\t.\tCDS\t10\t30\t.\t-\t0\tID=cds2;Parent=gene2\n"
+        "chr2\t.\tCDS\t60\t90\t.\t-\t0\tID=cds2;Parent=gene2\n";
+
+    CNcbiIstrstream istr(kGff3);
+    CStreamLineReader lr(istr);
+    CGff3Reader reader(CGff3Reader::fStreaming);
+    vector<CRef<CSeq_annot>> annots;
+    while (!lr.AtEOF()  &&  !reader.AtSequenceData()) {
+        CRef<CSeq_annot> pAnnot = reader.ReadSeqAnnot(lr);
+        if (pAnnot) {
+            annots.push_back(pAnnot);
+        }
+    }
+    BOOST_REQUIRE_EQUAL(annots.size(), 2u);
+
+    const char* const kSeqIds[] = { "chr1", "chr2" };
+    const size_t kFeatCounts[] = { 3, 2 };
+    for (size_t i = 0;  i < annots.size();  ++i) {
+        const auto& ftable = annots[i]->GetData().GetFtable();
+        BOOST_CHECK_EQUAL(ftable.size(), kFeatCounts[i]);
+        for (const auto& pFeat : ftable) {
+            const CSeq_id* pId = pFeat->GetLocation().GetId();
+            BOOST_REQUIRE(pId);
+            BOOST_CHECK_EQUAL(pId->GetSeqIdString(), kSeqIds[i]);
+            if (pFeat->GetData().IsCdregion()) {
+                // both CDS lines merged into one feature
+                BOOST_CHECK(pFeat->GetLocation().IsMix());
+            }
+        }
+    }
+}
@@ -35,6 +35,7 @@
 #include <corelib/ncbimtx.hpp>
 
 #include <serial/impl/classinfo.hpp>
+#include <serial/impl/classdirect.hpp>
 #include <serial/objistr.hpp>
 #include <serial/objostr.hpp>
 #include <serial/objcopy.hpp>
@@ -84,6 +85,8 @@ void CClassTypeInfo::InitClassTypeInfo(void)
 {
     m_ClassType = eSequential;
     m_ParentClassInfo = 0;
+    m_DirectReadFunction = 0;
+    m_DirectWriteFunction = 0;
 
     UpdateFunctions();
 }
@@ -262,8 +265,23 @@ void CClassTypeInfo::UpdateFunctions(void)
         SetWriteFunction(&WriteImplicitMember);
         SetCopyFunction(&CopyImplicitMember);
         SetSkipFunction(&SkipImplicitMember);
-        break;
+        // implicit classes have just one member, nothing to dispatch
+        return;
+    }
+    if ( m_DirectReadFunction ) {
+        SetReadFunction(&ReadClassDirect);
     }
+    if ( m_DirectWriteFunction ) {
+        SetWriteFunction(&WriteClassDirect);
+    }
+}
+
+void CClassTypeInfo::SetDirectFunctions(TDirectReadFunction readFunc,
+                                        TDirectWriteFunction writeFunc)
+{
+    m_DirectReadFunction = readFunc;
+    m_DirectWriteFunction = writeFunc;
+    UpdateFunctions();
 }
 
 void CClassTypeInfo::ReadClassSequential(CObjectIStream& in,
@@ -313,6 +331,112 @@ void CClassTypeInfo::ReadImplicitMember(CObjectIStream& in,
     in.UnsetMemberNillable();
 }
 
+static inline
+void s_ReadMemberDirect(CObjectIStream& in,
+                        const CMemberInfo* memberInfo,
+                        TObjectPtr classPtr,
+                        CClassTypeInfo::TDirectReadFunction readFunc)
+{
+    if ( memberInfo->HaveReadHooks() ||
+         memberInfo->GetTypeInfo()->HaveReadHooks() ||
+         !readFunc(in, memberInfo, classPtr) ) {
+        memberInfo->ReadMember(in, classPtr);
+    }
+}
+
+void CClassTypeInfo::ReadClassDirect(CObjectIStream& in,
+                                     TTypeInfo objectType,
+                                     TObjectPtr objectPtr)
+{
+    const CClassTypeInfo* classType =
+        CTypeConverter<CClassTypeInfo>::SafeCast(objectType);
+
+    ESerialDataFormat format = in.GetDataFormat();
+    if ( format != eSerial_AsnBinary  &&  format != eSerial_Json ) {
+        if ( classType->RandomOrder() ) {
+            in.ReadClassRandom(classType, objectPtr);
+        }
+        else {
+            in.ReadClassSequential(classType, objectPtr);
+        }
+        return;
+    }
+
+    // same member loops as CObjectIStream::ReadClassSequential()
+    // and CObjectIStream::ReadClassRandom(), but with the generated
+    // function tried first on each member
+    TDirectReadFunction readFunc = classType->m_DirectReadFunction;
+    BEGIN_OBJECT_FRAME_OF3(in, eFrameClass, classType, objectPtr);
+    in.BeginClass(classType);
+
+    TMemberIndex index;
+    if ( classType->RandomOrder()  ||  format == eSerial_Json ) {
+        const size_t kStaticFlags = 64;
+        Uint1 staticFlags[kStaticFlags];
+        vector<Uint1> dynamicFlags;
+        size_t count = classType->GetMembers().LastIndex() + 1;
+        Uint1* read = staticFlags;
+        if ( count > kStaticFlags ) {
+            dynamicFlags.resize(count);
+            read = dynamicFlags.data();
+        }
+        else {
+            memset(staticFlags, 0, count);
+        }
+
+        BEGIN_OBJECT_FRAME_OF(in, eFrameClassMember);
+        while ( (index = in.BeginClassMember(classType)) != kInvalidMember ) {
+            const CMemberInfo* memberInfo = classType->GetMemberInfo(index);
+            in.SetTopMemberId(memberInfo->GetId());
+            _ASSERT(index >= kFirstMemberIndex && index < count);
+            if ( read[index] ) {
+                in.DuplicatedMember(memberInfo);
+            }
+            else {
+                read[index] = true;
+                s_ReadMemberDirect(in, memberInfo, objectPtr, readFunc);
+            }
+            in.EndClassMember();
+        }
+        END_OBJECT_FRAME_OF(in);
+
+        for ( CIterator i(classType); i.Valid(); ++i ) {
+            if ( !read[*i] ) {
+                classType->GetMemberInfo(i)->ReadMissingMember(in, objectPtr);
+            }
+        }
+    }
+    else {
+        CIterator pos(classType);
+        TMemberIndex prevIndex = kInvalidMember;
+        BEGIN_OBJECT_FRAME_OF(in, eFrameClassMember);
+        while ( (index = in.BeginClassMember(classType, *pos)) != kInvalidMember ) {
+            const CMemberInfo* memberInfo = classType->GetMemberInfo(index);
+            if ( prevIndex != kInvalidMember  &&  prevIndex >= index  &&
+                 memberInfo->GetId().HaveNoPrefix() ) {
+                in.UndoClassMember();
+                break;
+            }
+            prevIndex = index;
+            in.SetTopMemberId(memberInfo->GetId());
+            for ( TMemberIndex i = *pos; i < index; ++i ) {
+                classType->GetMemberInfo(i)->ReadMissingMember(in, objectPtr);
+            }
+            s_ReadMemberDirect(in, memberInfo, objectPtr, readFunc);
+            pos.SetIndex(index + 1);
+            in.EndClassMember();
+        }
+        END_OBJECT_FRAME_OF(in);
+
+        for ( ; pos.Valid(); ++pos ) {
+            classType->GetMemberInfo(pos)->ReadMissingMember(in, objectPtr);
+        }
+    }
+
+    in.EndClass();
+    END_OBJECT_FRAME_OF(in);
+}
+
 void CClassTypeInfo::WriteClassRandom(CObjectOStream& out,
                                       TTypeInfo objectType,
                                       TConstObjectPtr objectPtr)
@@ -375,6 +499,41 @@ do_write:
                        memberInfo->GetItemPtr(objectPtr));
 }
 
+void CClassTypeInfo::WriteClassDirect(CObjectOStream& out,
+                                      TTypeInfo objectType,
+                                      TConstObjectPtr objectPtr)
+{
+    const CClassTypeInfo* classType =
+        CTypeConverter<CClassTypeInfo>::SafeCast(objectType);
+
+    ESerialDataFormat format = out.GetDataFormat();
+    if ( format != eSerial_AsnBinary  &&  format != eSerial_Json ) {
+        if ( classType->RandomOrder() ) {
+            out.WriteClassRandom(classType, objectPtr);
+        }
+        else {
+            out.WriteClassSequential(classType, objectPtr);
+        }
+        return;
+    }
+
+    TDirectWriteFunction writeFunc = classType->m_DirectWriteFunction;
+    BEGIN_OBJECT_FRAME_OF2(out, eFrameClass, classType);
+    out.BeginClass(classType);
+
+    for ( CIterator i(classType); i.Valid(); ++i ) {
+        const CMemberInfo* memberInfo = classType->GetMemberInfo(i);
+        if ( memberInfo->HaveWriteHooks() ||
+             memberInfo->GetTypeInfo()->HaveWriteHooks() ||
+             !writeFunc(out, memberInfo, objectPtr) ) {
+            memberInfo->WriteMember(out, objectPtr);
+        }
+    }
+
+    out.EndClass();
+    END_OBJECT_FRAME_OF(out);
+}
+
 void CClassTypeInfo::CopyClassRandom(CObjectStreamCopier& copier,
                                      TTypeInfo objectType)
 {
@@ -556,4 +715,32 @@ void CClassTypeInfo::SetGlobalHook(const CTempString& members,
 }
 
 
+
+void CClassDirectIO::x_ReadFailed(CObjectIStream& in,
+                                  const CMemberInfo* memberInfo,
+                                  TObjectPtr classPtr,
+                                  CSerialException& e)
+{
+    if (e.GetErrCode() == CSerialException::eNullValue) {
+        memberInfo->UpdateSetFlagNo(classPtr);
+    } else if (e.GetErrCode() == CSerialException::eMissingValue) {
+        if ( memberInfo->Optional() ) {
+            in.SetFailFlags(CObjectIStream::fNoError);
+            if ( memberInfo->UpdateSetFlagNo(classPtr) ) {
+                memberInfo->GetTypeInfo()->SetDefault(
+                    memberInfo->GetItemPtr(classPtr));
+                if (memberInfo->GetDefault()) {
+                    memberInfo->GetTypeInfo()->Assign(memberInfo->GetItemPtr(classPtr),memberInfo->GetDefault());
+                }
+            }
+        } else {
+            NCBI_RETHROW(e, CSerialException, eFormatError,
+                "missing value " + memberInfo->GetId().GetName());
+        }
+    } else {
+        NCBI_RETHROW_SAME(e,
+            "error while reading " + memberInfo->GetId().GetName());
+    }
+}
+
 END_NCBI_SCOPE
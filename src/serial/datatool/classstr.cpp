@@ -109,6 +109,55 @@ bool CClassTypeStrings::x_IsUniSeq(TMembers::const_iterator i) const
     return i->dataType && i->dataType->IsUniSeq();
 }
 
+// Members which the -ocd read/write functions handle themselves: plain
+// primitive and string members, everything else goes through member info
+bool CClassTypeStrings::x_IsDirectIOMember(TMembers::const_iterator i) const
+{
+    if ( i->ref || !i->haveFlag || i->delayed || !i->defaultValue.empty() ||
+         i->attlist || i->noTag || x_IsNullType(i) || x_IsAnyContentType(i) ) {
+        return false;
+    }
+    EKind kind = i->type->GetKind();
+    if ( (kind != eKindStd && kind != eKindString) ||
+         i->type->HaveSpecialRef() ) {
+        return false;
+    }
+    // only types CObjectIStream::ReadStd() and CObjectOStream::WriteStd()
+    // handle the same way as their type info does (not CStrictId etc.)
+    static const char* const kDirectTypes[] = {
+        "bool", "int", "unsigned", "Int4", "Uint4", "Int8", "Uint8",
+        "TSeqPos", "TSignedSeqPos", "double", "float", "string"
+    };
+    string ctype = i->type->GetCType(CNamespace::KEmptyNamespace);
+    if ( i->type->GetStorageType(CNamespace::KEmptyNamespace) != ctype ) {
+        return false;
+    }
+    SIZE_TYPE colon = ctype.rfind("::");
+    if ( colon != NPOS ) {
+        string ns = ctype.substr(0, colon);
+        ctype.erase(0, colon + 2);
+        if ( ctype != "string" ||
+             (ns != "std" && ns != "NCBI_NS_STD" && ns != "::std") ) {
+            return false;
+        }
+    }
+    if ( find(begin(kDirectTypes), end(kDirectTypes), ctype) ==
+         end(kDirectTypes) ) {
+        return false;
+    }
+    const CDataMember* member = i->dataType ? i->dataType->GetDataMember() : 0;
+    if ( member ) {
+        if ( member->Nillable() ) {
+            return false;
+        }
+        if ( !DataTool().IsSetCodeGenerationStyle(CDataTool::eNoRestrictions) &&
+             !member->GetRestrictions().empty() ) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void CClassTypeStrings::AddMember(const string& external_name,
                                   const string& name,
                                   const AutoPtr<CTypeStrings>& type,
@@ -1244,6 +1293,28 @@ mem_simple = false;
         }
     }
 
+    // statically dispatched member I/O
+    bool directIO = false;
+    if ( DataTool().IsSetCodeGenerationStyle(CDataTool::eDirectIO) &&
+         !wrapperClass && m_ParentClassName.empty() ) {
+        for ( TMembers::const_iterator i = m_Members.begin();
+              !directIO && i != m_Members.end(); ++i ) {
+            directIO = x_IsDirectIOMember(i);
+        }
+    }
+    if ( directIO ) {
+        code.CPPIncludes().insert("serial/impl/classdirect");
+        code.ClassPrivate() <<
+            "    // ASN.1 binary and JSON I/O of simple members\n"
+            "    static bool x_ReadMemberDirect(NCBI_NS_NCBI::CObjectIStream& in,\n"
+            "                                   const NCBI_NS_NCBI::CMemberInfo* memberInfo,\n"
+            "                                   NCBI_NS_NCBI::TObjectPtr classPtr);\n"
+            "    static bool x_WriteMemberDirect(NCBI_NS_NCBI::CObjectOStream& out,\n"
+            "                                    const NCBI_NS_NCBI::CMemberInfo* memberInfo,\n"
+            "                                    NCBI_NS_NCBI::TConstObjectPtr classPtr);\n"
+            "\n";
+    }
+
     // generate member data
     {
         code.ClassPrivate() <<
@@ -1639,12 +1710,59 @@ mem_simple = false;
             methods << "    info->RandomOrder();\n";
         }
     }
+    if ( directIO ) {
+        methods << "    info->SetDirectFunctions(&x_ReadMemberDirect, &x_WriteMemberDirect);\n";
+    }
     methods <<  "    info->CodeVersion(" << DATATOOL_VERSION << ");\n";
     methods <<  "    info->DataSpec(" << CDataType::GetSourceDataSpecString() << ");\n";
     methods <<
         "}\n"
         "END_CLASS_INFO\n"
         "\n";
+
+    if ( directIO ) {
+        string className = code.GetClassNameDT();
+        string readCases, writeCases;
+        TMemberIndex index = kFirstMemberIndex;
+        for ( TMembers::const_iterator i = m_Members.begin();
+              i != m_Members.end(); ++i, ++index ) {
+            if ( !x_IsDirectIOMember(i) ) {
+                continue;
+            }
+            string label = "    case " + NStr::NumericToString(index) + ":\n";
+            readCases += label +
+                "        return NCBI_NS_NCBI::CClassDirectIO::ReadStd(in, memberInfo, classPtr, obj." +
+                i->mName + ");\n";
+            writeCases += label +
+                "        return NCBI_NS_NCBI::CClassDirectIO::WriteStd(out, memberInfo, classPtr, obj." +
+                i->mName + ");\n";
+        }
+        methods <<
+            "bool "<<methodPrefix<<"x_ReadMemberDirect(NCBI_NS_NCBI::CObjectIStream& in,\n"
+            "    const NCBI_NS_NCBI::CMemberInfo* memberInfo,\n"
+            "    NCBI_NS_NCBI::TObjectPtr classPtr)\n"
+            "{\n"
+            "    "<<className<<"& obj = *static_cast<"<<className<<"*>(classPtr);\n"
+            "    switch ( memberInfo->GetIndex() ) {\n"
+            << readCases <<
+            "    default:\n"
+            "        return false;\n"
+            "    }\n"
+            "}\n"
+            "\n"
+            "bool "<<methodPrefix<<"x_WriteMemberDirect(NCBI_NS_NCBI::CObjectOStream& out,\n"
+            "    const NCBI_NS_NCBI::CMemberInfo* memberInfo,\n"
+            "    NCBI_NS_NCBI::TConstObjectPtr classPtr)\n"
+            "{\n"
+            "    const "<<className<<"& obj = *static_cast<const "<<className<<"*>(classPtr);\n"
+            "    switch ( memberInfo->GetIndex() ) {\n"
+            << writeCases <<
+            "    default:\n"
+            "        return false;\n"
+            "    }\n"
+            "}\n"
+            "\n";
+    }
 }
 
 void CClassTypeStrings::GenerateUserHPPCode(CNcbiOstream& out) const
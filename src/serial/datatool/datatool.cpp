@@ -234,6 +234,8 @@ void CDataTool::Init(void)
                "combine all -or* prefixes");
     d->AddFlag("ocvs",
                "create \".cvsignore\" files");
+    d->AddFlag("ocd",
+               "generate statically dispatched ASN.1 binary and JSON member I/O");
     d->AddOptionalKey("oR", "rootDirectory",
                       "set \"-o*\" arguments for NCBI directory tree",
                       CArgDescriptions::eString);
@@ -281,11 +283,16 @@ bool CDataTool::ProcessModules(void)
                 m_codestyle |= FCodeGenerationStyle(eXmlElementEnums);
             } else if (NStr::CompareNocase(v,"no_restrictions")==0) {
                 m_codestyle |= FCodeGenerationStyle(eNoRestrictions);
+            } else if (NStr::CompareNocase(v,"direct_io")==0) {
+                m_codestyle |= FCodeGenerationStyle(eDirectIO);
             } else {
                 ERR_POST_X(1, Warning << "Unknown code generation value: " << v);
             }
         }
     }
+    if ( generator.GetOpt("ocd") ) {
+        m_codestyle |= FCodeGenerationStyle(eDirectIO);
+    }
 
     if ( generator.GetOpt("oR", &opt) ) {
         // NCBI directory tree
@@ -49,10 +49,19 @@ CDelayBuffer::~CDelayBuffer(void)
 void CDelayBuffer::SetData(const CItemInfo* itemInfo, TObjectPtr object,
                            ESerialDataFormat dataFormat, TFormatFlags flags,
                            CByteSource& data)
+{
+    SetData(itemInfo, object, dataFormat, flags, data, 0);
+}
+
+void CDelayBuffer::SetData(const CItemInfo* itemInfo, TObjectPtr object,
+                           ESerialDataFormat dataFormat, TFormatFlags flags,
+                           CByteSource& data,
+                           CObjectMemoryPool* memoryPool)
 {
     _ASSERT(!Delayed());
 
-    m_Info.reset(new SInfo(itemInfo, object, dataFormat, flags, data));
+    m_Info.reset(new SInfo(itemInfo, object, dataFormat, flags, data,
+                           memoryPool));
 }
 
 void CDelayBuffer::Forget(void)
@@ -76,6 +85,7 @@ void CDelayBuffer::DoUpdate(void)
         unique_ptr<CObjectIStream> in(CObjectIStream::Create(info.m_DataFormat,
                                                            *info.m_Source));
         in->SetFlags(info.m_Flags);
+        in->SetMemoryPool(info.m_MemoryPool);
         info.m_ItemInfo->UpdateDelayedBuffer(*in, info.m_Object);
         _VERIFY(in->EndOfData());
     }
@@ -94,10 +104,11 @@ TMemberIndex CDelayBuffer::GetIndex(void) const
 
 CDelayBuffer::SInfo::SInfo(const CItemInfo* itemInfo, TObjectPtr object,
                            ESerialDataFormat format, TFormatFlags flags,
-                           CByteSource& source)
+                           CByteSource& source,
+                           CObjectMemoryPool* memoryPool)
     : m_ItemInfo(itemInfo), m_Object(object),
       m_DataFormat(format), m_Flags(flags),
-      m_Source(&source)
+      m_Source(&source), m_MemoryPool(memoryPool)
 {
 }
 
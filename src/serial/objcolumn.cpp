@@ -0,0 +1,1023 @@
+/*  $Id$
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+* File Description:
+*   Columnar storage of many objects of the same class: every member is
+*   stored in its own column, and readers decode only the columns they need
+*
+*   Data layout (numbers are unsigned LEB128 varints, strings are length
+*   and bytes):
+*     "NCBICOL1", type name, number of columns,
+*     name and type (one byte) of each column,
+*     row groups: number of rows (non-zero), then size and data of each
+*       column chunk,
+*     zero (end of data).
+*   Column chunk: presence bitmap of the rows, then the values of present
+*   rows: bitmap for bool, zigzag varints for Int, varints for Uint,
+*   8 little-endian bytes for Double; String and Binary chunks have one
+*   byte of encoding (plain or dictionary), followed by the values, or by
+*   the dictionary and indexes of the values in it.
+*/
+
+#include <ncbi_pch.hpp>
+#include <corelib/ncbistd.hpp>
+#include <serial/objcolumn.hpp>
+#include <serial/objistr.hpp>
+#include <serial/objostr.hpp>
+#include <serial/serialimpl.hpp>
+#include <serial/impl/classinfo.hpp>
+#include <serial/impl/member.hpp>
+#include <serial/impl/ptrinfo.hpp>
+#include <serial/delaybuf.hpp>
+
+#include <unordered_map>
+
+BEGIN_NCBI_SCOPE
+
+
+static const char   kColumnsMagic[] = "NCBICOL1";
+static const size_t kColumnsMagicSize = sizeof(kColumnsMagic) - 1;
+static const size_t kDefaultRowGroupSize = 64 * 1024;
+
+enum EStringEncoding {
+    eStrings_Plain,
+    eStrings_Dictionary
+};
+
+
+/////////////////////////////////////////////////////////////////////////////
+// Encoding primitives
+
+static
+void s_PutUint(string& buf, Uint8 value)
+{
+    while ( value >= 0x80 ) {
+        buf += char((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    buf += char(value);
+}
+
+
+static
+void s_PutString(string& buf, const string& value)
+{
+    s_PutUint(buf, value.size());
+    buf += value;
+}
+
+
+static
+void s_PutBits(string& buf, const vector<char>& bits)
+{
+    size_t start = buf.size();
+    buf.resize(start + (bits.size() + 7) / 8);
+    for ( size_t i = 0; i < bits.size(); ++i ) {
+        if ( bits[i] ) {
+            buf[start + i / 8] |= char(1 << (i % 8));
+        }
+    }
+}
+
+
+NCBI_NORETURN static
+void s_FormatError(const string& message)
+{
+    NCBI_THROW(CSerialException, eFormatError,
+               "columnar data: " + message);
+}
+
+
+// Reading of a column chunk, or of the header from a stream
+class CColumnDataReader
+{
+public:
+    CColumnDataReader(const string& data)
+        : m_Pos(data.data()), m_End(data.data() + data.size())
+        {
+        }
+
+    bool AtEnd(void) const
+        {
+            return m_Pos == m_End;
+        }
+
+    char GetByte(void)
+        {
+            if ( m_Pos == m_End ) {
+                s_FormatError("unexpected end of column");
+            }
+            return *m_Pos++;
+        }
+
+    Uint8 GetUint(void)
+        {
+            Uint8 value = 0;
+            for ( int shift = 0; ; shift += 7 ) {
+                Uint1 c = Uint1(GetByte());
+                if ( shift > 63 || (shift == 63 && (c & 0x7E)) ) {
+                    s_FormatError("number is too big");
+                }
+                value |= Uint8(c & 0x7F) << shift;
+                if ( !(c & 0x80) ) {
+                    return value;
+                }
+            }
+        }
+
+    size_t GetSize(void)
+        {
+            Uint8 size = GetUint();
+            if ( size > Uint8(m_End - m_Pos) ) {
+                s_FormatError("unexpected end of column");
+            }
+            return size_t(size);
+        }
+
+    string GetString(void)
+        {
+            size_t size = GetSize();
+            string value(m_Pos, size);
+            m_Pos += size;
+            return value;
+        }
+
+    void GetBits(vector<char>& bits, size_t count)
+        {
+            if ( (count + 7) / 8 > size_t(m_End - m_Pos) ) {
+                s_FormatError("unexpected end of column");
+            }
+            bits.resize(count);
+            for ( size_t i = 0; i < count; ++i ) {
+                bits[i] = (m_Pos[i / 8] >> (i % 8)) & 1;
+            }
+            m_Pos += (count + 7) / 8;
+        }
+
+private:
+    const char* m_Pos;
+    const char* m_End;
+};
+
+
+static
+Uint8 s_ReadUint(CNcbiIstream& in)
+{
+    Uint8 value = 0;
+    for ( int shift = 0; ; shift += 7 ) {
+        int c = in.get();
+        if ( c == EOF ) {
+            s_FormatError("unexpected end of data");
+        }
+        if ( shift > 63 || (shift == 63 && (c & 0x7E)) ) {
+            s_FormatError("number is too big");
+        }
+        value |= Uint8(c & 0x7F) << shift;
+        if ( !(c & 0x80) ) {
+            return value;
+        }
+    }
+}
+
+
+static
+void s_ReadChunk(CNcbiIstream& in, string& chunk, Uint8 size)
+{
+    if ( size > Uint8(numeric_limits<streamsize>::max()) ) {
+        s_FormatError("column chunk is too big");
+    }
+    chunk.resize(size_t(size));
+    if ( !in.read(&chunk[0], streamsize(size)) ) {
+        s_FormatError("unexpected end of data");
+    }
+}
+
+
+static
+string s_ReadString(CNcbiIstream& in)
+{
+    string value;
+    s_ReadChunk(in, value, s_ReadUint(in));
+    return value;
+}
+
+
+static
+void s_SkipChunk(CNcbiIstream& in, Uint8 size)
+{
+    if ( size > Uint8(numeric_limits<streamsize>::max()) ) {
+        s_FormatError("column chunk is too big");
+    }
+    // seek where possible, to skip the data without reading it
+    if ( in.rdbuf()->pubseekoff(CNcbiStreamoff(size),
+                                IOS_BASE::cur, IOS_BASE::in) ==
+         CNcbiStreampos(-1) ) {
+        in.ignore(streamsize(size));
+        if ( in.gcount() != streamsize(size) ) {
+            s_FormatError("unexpected end of data");
+        }
+    }
+}
+
+
+static inline
+Uint8 s_ZigZag(Int8 value)
+{
+    return (Uint8(value) << 1) ^ Uint8(value >> 63);
+}
+
+
+static inline
+Int8 s_UnZigZag(Uint8 value)
+{
+    return Int8(value >> 1) ^ -Int8(value & 1);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+// CObjectColumns
+
+const size_t CObjectColumns::kInvalidColumn;
+
+
+CObjectColumns::CObjectColumns(TTypeInfo type)
+    : m_TypeInfo(type)
+{
+    if ( type->GetTypeFamily() != eTypeFamilyClass ||
+         CTypeConverter<CClassTypeInfo>::SafeCast(type)->Implicit() ) {
+        NCBI_THROW(CSerialException, eNotImplemented,
+                   "columnar data: " + type->GetName() + " is not a class");
+    }
+    TPath path(1, type);
+    x_AddMembers(CTypeConverter<CClassTypeInfo>::SafeCast(type),
+                 kEmptyStr, kInvalidColumn, path);
+}
+
+
+static
+CObjectColumns::EColumnType s_GetColumnType(TTypeInfo type)
+{
+    switch ( type->GetTypeFamily() ) {
+    case eTypeFamilyClass:
+        if ( !CTypeConverter<CClassTypeInfo>::SafeCast(type)->Implicit() ) {
+            return CObjectColumns::eColumn_Struct;
+        }
+        break;
+    case eTypeFamilyPrimitive:
+        switch ( CObjectTypeInfo(type).GetPrimitiveValueType() ) {
+        case ePrimitiveValueSpecial:
+            return CObjectColumns::eColumn_Null;
+        case ePrimitiveValueBool:
+            return CObjectColumns::eColumn_Bool;
+        case ePrimitiveValueChar:
+        case ePrimitiveValueEnum:
+            return CObjectColumns::eColumn_Int;
+        case ePrimitiveValueInteger:
+            return CObjectTypeInfo(type).IsPrimitiveValueSigned()?
+                CObjectColumns::eColumn_Int: CObjectColumns::eColumn_Uint;
+        case ePrimitiveValueReal:
+            return CObjectColumns::eColumn_Double;
+        case ePrimitiveValueString:
+            return CObjectColumns::eColumn_String;
+        default:
+            break;
+        }
+        break;
+    default:
+        break;
+    }
+    return CObjectColumns::eColumn_Binary;
+}
+
+
+void CObjectColumns::x_AddMembers(const CClassTypeInfo* classType,
+                                  const string& prefix, size_t parent,
+                                  TPath& path)
+{
+    for ( CClassTypeInfo::CIterator i(classType); i.Valid(); ++i ) {
+        const CMemberInfo* memberInfo = classType->GetMemberInfo(*i);
+        SColumn column;
+        column.m_Name = prefix + memberInfo->GetId().GetName();
+        column.m_Parent = parent;
+        column.m_Member = memberInfo;
+        column.m_ValueType = memberInfo->GetTypeInfo();
+        if ( column.m_ValueType->GetTypeFamily() == eTypeFamilyPointer ) {
+            // only classes are split through CRef<>
+            TTypeInfo pointedType =
+                CTypeConverter<CPointerTypeInfo>::SafeCast(
+                    column.m_ValueType)->GetPointedType();
+            if ( s_GetColumnType(pointedType) == eColumn_Struct ) {
+                column.m_ValueType = pointedType;
+            }
+        }
+        column.m_Type = s_GetColumnType(column.m_ValueType);
+        if ( column.m_Type == eColumn_Struct &&
+             find(path.begin(), path.end(), column.m_ValueType) !=
+             path.end() ) {
+            // recursive type, would be split endlessly
+            column.m_ValueType = memberInfo->GetTypeInfo();
+            column.m_Type = eColumn_Binary;
+        }
+        size_t index = m_Columns.size();
+        m_Columns.push_back(column);
+        if ( column.m_Type == eColumn_Struct ) {
+            path.push_back(column.m_ValueType);
+            x_AddMembers(CTypeConverter<CClassTypeInfo>::SafeCast(
+                             column.m_ValueType),
+                         column.m_Name + '.', index, path);
+            path.pop_back();
+        }
+        m_Columns[index].m_End = m_Columns.size();
+    }
+}
+
+
+size_t CObjectColumns::FindColumn(const string& name) const
+{
+    for ( size_t i = 0; i < m_Columns.size(); ++i ) {
+        if ( m_Columns[i].m_Name == name ) {
+            return i;
+        }
+    }
+    return kInvalidColumn;
+}
+
+
+// Member value, or null if it is not set;
+// for classes split through CRef<> - the pointed object
+static
+TConstObjectPtr s_GetValuePtr(const CObjectColumns::SColumn& column,
+                              TConstObjectPtr classPtr)
+{
+    const CMemberInfo* memberInfo = column.m_Member;
+    if ( memberInfo->CanBeDelayed() ) {
+        const CDelayBuffer& buffer = memberInfo->GetDelayBuffer(classPtr);
+        if ( buffer.Delayed() ) {
+            const_cast<CDelayBuffer&>(buffer).Update();
+        }
+    }
+    TConstObjectPtr valuePtr = memberInfo->GetMemberPtr(classPtr);
+    // same as CObjectTypeInfoMI::IsSet()
+    if ( memberInfo->HaveSetFlag() ) {
+        if ( !memberInfo->GetSetFlagYes(classPtr) ) {
+            return 0;
+        }
+    }
+    else if ( memberInfo->Optional() ) {
+        TConstObjectPtr defaultPtr = memberInfo->GetDefault();
+        TTypeInfo memberType = memberInfo->GetTypeInfo();
+        if ( defaultPtr? memberType->Equals(valuePtr, defaultPtr):
+             memberType->IsDefault(valuePtr) ) {
+            return 0;
+        }
+    }
+    if ( column.m_ValueType != memberInfo->GetTypeInfo() ) {
+        valuePtr = CTypeConverter<CPointerTypeInfo>::SafeCast(
+            memberInfo->GetTypeInfo())->GetObjectPointer(valuePtr);
+    }
+    return valuePtr;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+// CObjectColumnWriter
+
+struct CObjectColumnWriter::SColumnData
+{
+    vector<char>  m_Set;     // per row
+    vector<Uint8> m_Values;  // per row; strings - index in m_Strings
+    vector<string> m_Strings;
+    unordered_map<string, Uint8> m_Dictionary;
+};
+
+
+CObjectColumnWriter::CObjectColumnWriter(CNcbiOstream& out, TTypeInfo type,
+                                         size_t row_group_size)
+    : m_Output(out),
+      m_Columns(type),
+      m_RowGroupSize(row_group_size? row_group_size: kDefaultRowGroupSize),
+      m_Rows(0),
+      m_Closed(false),
+      m_Data(m_Columns.GetColumnCount()),
+      m_ValueStream(new CNcbiOstrstream)
+{
+    m_ValueOut.reset(CObjectOStream::Open(eSerial_AsnBinary, *m_ValueStream));
+
+    string header(kColumnsMagic, kColumnsMagicSize);
+    s_PutString(header, type->GetName());
+    s_PutUint(header, m_Columns.GetColumnCount());
+    for ( size_t i = 0; i < m_Columns.GetColumnCount(); ++i ) {
+        s_PutString(header, m_Columns.GetColumn(i).m_Name);
+        header += char(m_Columns.GetColumn(i).m_Type);
+    }
+    m_Output.write(header.data(), header.size());
+}
+
+
+CObjectColumnWriter::~CObjectColumnWriter(void)
+{
+    try {
+        Close();
+    }
+    NCBI_CATCH_ALL("Cannot close columnar object writer")
+}
+
+
+void CObjectColumnWriter::Write(const CConstObjectInfo& object)
+{
+    if ( m_Closed ) {
+        NCBI_THROW(CSerialException, eIllegalCall,
+                   "columnar data: writer is closed");
+    }
+    if ( object.GetTypeInfo() != m_Columns.GetTypeInfo() ) {
+        NCBI_THROW(CSerialException, eIllegalCall,
+                   "columnar data: cannot write " +
+                   object.GetTypeInfo()->GetName() + " as " +
+                   m_Columns.GetTypeInfo()->GetName());
+    }
+    try {
+        x_WriteRow(0, m_Columns.GetColumnCount(), object.GetObjectPtr());
+    }
+    catch ( ... ) {
+        x_DropRow();
+        throw;
+    }
+    if ( ++m_Rows >= m_RowGroupSize ) {
+        Flush();
+    }
+}
+
+
+void CObjectColumnWriter::x_WriteRow(size_t begin, size_t end,
+                                     TConstObjectPtr classPtr)
+{
+    for ( size_t i = begin; i < end; ) {
+        const CObjectColumns::SColumn& column = m_Columns.GetColumn(i);
+        TConstObjectPtr valuePtr = s_GetValuePtr(column, classPtr);
+        if ( !valuePtr ) {
+            x_SetNull(i, column.m_End);
+        }
+        else {
+            x_SetValue(i, valuePtr);
+            if ( column.m_Type == CObjectColumns::eColumn_Struct ) {
+                x_WriteRow(i + 1, column.m_End, valuePtr);
+            }
+        }
+        i = column.m_End;
+    }
+}
+
+
+// Remove values of the row being written from the columns it reached
+void CObjectColumnWriter::x_DropRow(void)
+{
+    for ( auto& data : m_Data ) {
+        data.m_Set.resize(m_Rows);
+        data.m_Values.resize(m_Rows);
+        if ( data.m_Strings.empty() ) {
+            continue;
+        }
+        // strings are numbered in order of addition, so the ones added
+        // by the dropped row follow all strings of the remaining rows
+        size_t keep = 0;
+        for ( size_t row = 0; row < m_Rows; ++row ) {
+            if ( data.m_Set[row] ) {
+                keep = max(keep, size_t(data.m_Values[row]) + 1);
+            }
+        }
+        for ( size_t i = keep; i < data.m_Strings.size(); ++i ) {
+            data.m_Dictionary.erase(data.m_Strings[i]);
+        }
+        data.m_Strings.resize(keep);
+    }
+    // the value stream can be left in the middle of the failed value
+    m_ValueOut.reset();
+    m_ValueStream.reset(new CNcbiOstrstream);
+    m_ValueOut.reset(CObjectOStream::Open(eSerial_AsnBinary, *m_ValueStream));
+}
+
+
+void CObjectColumnWriter::x_SetNull(size_t begin, size_t end)
+{
+    for ( size_t i = begin; i < end; ++i ) {
+        m_Data[i].m_Set.push_back(false);
+        m_Data[i].m_Values.push_back(0);
+    }
+}
+
+
+void CObjectColumnWriter::x_AddString(size_t index, const string& value)
+{
+    SColumnData& data = m_Data[index];
+    auto ins = data.m_Dictionary.insert(make_pair(value,
+                                                  data.m_Strings.size()));
+    if ( ins.second ) {
+        data.m_Strings.push_back(value);
+    }
+    data.m_Values.push_back(ins.first->second);
+}
+
+
+void CObjectColumnWriter::x_SetValue(size_t index, TConstObjectPtr valuePtr)
+{
+    const CObjectColumns::SColumn& column = m_Columns.GetColumn(index);
+    SColumnData& data = m_Data[index];
+    data.m_Set.push_back(true);
+    CConstObjectInfo value(valuePtr, column.m_ValueType);
+    switch ( column.m_Type ) {
+    case CObjectColumns::eColumn_Struct:
+    case CObjectColumns::eColumn_Null:
+        data.m_Values.push_back(0);
+        break;
+    case CObjectColumns::eColumn_Bool:
+        data.m_Values.push_back(value.GetPrimitiveValueBool());
+        break;
+    case CObjectColumns::eColumn_Int:
+        if ( value.GetPrimitiveValueType() == ePrimitiveValueChar ) {
+            data.m_Values.push_back(
+                s_ZigZag(Int8(value.GetPrimitiveValueChar())));
+        }
+        else {
+            data.m_Values.push_back(s_ZigZag(value.GetPrimitiveValueInt8()));
+        }
+        break;
+    case CObjectColumns::eColumn_Uint:
+        data.m_Values.push_back(value.GetPrimitiveValueUint8());
+        break;
+    case CObjectColumns::eColumn_Double:
+        {{
+            double d = value.GetPrimitiveValueDouble();
+            Uint8 bits;
+            memcpy(&bits, &d, sizeof(bits));
+            data.m_Values.push_back(bits);
+        }}
+        break;
+    case CObjectColumns::eColumn_String:
+        x_AddString(index, value.GetPrimitiveValueString());
+        break;
+    case CObjectColumns::eColumn_Binary:
+        m_ValueStream->str(kEmptyStr);
+        m_ValueOut->Write(valuePtr, column.m_ValueType);
+        m_ValueOut->Flush();
+        x_AddString(index, CNcbiOstrstreamToString(*m_ValueStream));
+        break;
+    }
+}
+
+
+void CObjectColumnWriter::Flush(void)
+{
+    if ( m_Rows == 0 ) {
+        return;
+    }
+    string header;
+    s_PutUint(header, m_Rows);
+    m_Output.write(header.data(), header.size());
+
+    string chunk;
+    for ( size_t i = 0; i < m_Columns.GetColumnCount(); ++i ) {
+        CObjectColumns::EColumnType type = m_Columns.GetColumn(i).m_Type;
+        SColumnData& data = m_Data[i];
+        _ASSERT(data.m_Set.size() == m_Rows);
+        chunk.clear();
+        s_PutBits(chunk, data.m_Set);
+        size_t count = 0;
+        switch ( type ) {
+        case CObjectColumns::eColumn_Struct:
+        case CObjectColumns::eColumn_Null:
+            break;
+        case CObjectColumns::eColumn_Bool:
+            {{
+                vector<char> bits;
+                for ( size_t row = 0; row < m_Rows; ++row ) {
+                    if ( data.m_Set[row] ) {
+                        bits.push_back(data.m_Values[row] != 0);
+                    }
+                }
+                s_PutBits(chunk, bits);
+            }}
+            break;
+        case CObjectColumns::eColumn_Int:
+        case CObjectColumns::eColumn_Uint:
+            for ( size_t row = 0; row < m_Rows; ++row ) {
+                if ( data.m_Set[row] ) {
+                    s_PutUint(chunk, data.m_Values[row]);
+                }
+            }
+            break;
+        case CObjectColumns::eColumn_Double:
+            for ( size_t row = 0; row < m_Rows; ++row ) {
+                if ( data.m_Set[row] ) {
+                    Uint8 bits = data.m_Values[row];
+                    for ( int b = 0; b < 8; ++b, bits >>= 8 ) {
+                        chunk += char(bits & 0xFF);
+                    }
+                }
+            }
+            break;
+        case CObjectColumns::eColumn_String:
+        case CObjectColumns::eColumn_Binary:
+            for ( size_t row = 0; row < m_Rows; ++row ) {
+                count += data.m_Set[row];
+            }
+            if ( data.m_Strings.size() < count ) {
+                chunk += char(eStrings_Dictionary);
+                s_PutUint(chunk, data.m_Strings.size());
+                for ( auto& s : data.m_Strings ) {
+                    s_PutString(chunk, s);
+                }
+                for ( size_t row = 0; row < m_Rows; ++row ) {
+                    if ( data.m_Set[row] ) {
+                        s_PutUint(chunk, data.m_Values[row]);
+                    }
+                }
+            }
+            else {
+                chunk += char(eStrings_Plain);
+                for ( size_t row = 0; row < m_Rows; ++row ) {
+                    if ( data.m_Set[row] ) {
+                        s_PutString(chunk, data.m_Strings[data.m_Values[row]]);
+                    }
+                }
+            }
+            break;
+        }
+        header.clear();
+        s_PutUint(header, chunk.size());
+        m_Output.write(header.data(), header.size());
+        m_Output.write(chunk.data(), chunk.size());
+
+        data.m_Set.clear();
+        data.m_Values.clear();
+        data.m_Strings.clear();
+        data.m_Dictionary.clear();
+    }
+    m_Rows = 0;
+    if ( !m_Output ) {
+        NCBI_THROW(CSerialException, eIoError,
+                   "columnar data: cannot write");
+    }
+}
+
+
+void CObjectColumnWriter::Close(void)
+{
+    if ( m_Closed ) {
+        return;
+    }
+    m_Closed = true;
+    Flush();
+    m_Output.put(0);
+    m_Output.flush();
+    if ( !m_Output ) {
+        NCBI_THROW(CSerialException, eIoError,
+                   "columnar data: cannot write");
+    }
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+// CObjectColumnReader
+
+struct CObjectColumnReader::SColumnData
+{
+    vector<char>   m_Set;     // per row
+    vector<Uint8>  m_Values;  // per row; strings - index in m_Strings
+    vector<string> m_Strings;
+};
+
+
+CObjectColumnReader::CObjectColumnReader(CNcbiIstream& in, TTypeInfo type)
+    : m_Input(in),
+      m_Columns(type),
+      m_Selected(m_Columns.GetColumnCount(), true),
+      m_Rows(0),
+      m_End(false),
+      m_Data(m_Columns.GetColumnCount()),
+      m_ValueIn(CObjectIStream::Create(eSerial_AsnBinary))
+{
+    char magic[kColumnsMagicSize];
+    if ( !m_Input.read(magic, kColumnsMagicSize) ||
+         memcmp(magic, kColumnsMagic, kColumnsMagicSize) != 0 ) {
+        s_FormatError("bad header");
+    }
+    string name = s_ReadString(m_Input);
+    bool match = name == type->GetName() &&
+        s_ReadUint(m_Input) == m_Columns.GetColumnCount();
+    for ( size_t i = 0; match && i < m_Columns.GetColumnCount(); ++i ) {
+        const CObjectColumns::SColumn& column = m_Columns.GetColumn(i);
+        match = s_ReadString(m_Input) == column.m_Name &&
+            m_Input.get() == column.m_Type;
+    }
+    if ( !match ) {
+        s_FormatError("columns of " + name + " do not match type " +
+                      type->GetName());
+    }
+}
+
+
+CObjectColumnReader::~CObjectColumnReader(void)
+{
+}
+
+
+void CObjectColumnReader::SelectColumns(const vector<string>& names)
+{
+    m_Selected.assign(m_Columns.GetColumnCount(), false);
+    for ( auto& name : names ) {
+        size_t index = m_Columns.FindColumn(name);
+        if ( index == CObjectColumns::kInvalidColumn ) {
+            NCBI_THROW(CSerialException, eInvalidData,
+                       "columnar data: no column " + name + " in " +
+                       m_Columns.GetTypeInfo()->GetName());
+        }
+        const CObjectColumns::SColumn& column = m_Columns.GetColumn(index);
+        for ( size_t i = index; i < column.m_End; ++i ) {
+            m_Selected[i] = true;
+        }
+        for ( size_t i = column.m_Parent;
+              i != CObjectColumns::kInvalidColumn;
+              i = m_Columns.GetColumn(i).m_Parent ) {
+            m_Selected[i] = true;
+        }
+    }
+}
+
+
+void CObjectColumnReader::SelectAllColumns(void)
+{
+    m_Selected.assign(m_Columns.GetColumnCount(), true);
+}
+
+
+bool CObjectColumnReader::NextRowGroup(void)
+{
+    m_Rows = 0;
+    if ( m_End ) {
+        return false;
+    }
+    Uint8 rows = s_ReadUint(m_Input);
+    if ( rows == 0 ) {
+        m_End = true;
+        return false;
+    }
+    for ( size_t i = 0; i < m_Columns.GetColumnCount(); ++i ) {
+        SColumnData& data = m_Data[i];
+        data.m_Set.clear();
+        data.m_Values.clear();
+        data.m_Strings.clear();
+        Uint8 size = s_ReadUint(m_Input);
+        if ( !m_Selected[i] ) {
+            s_SkipChunk(m_Input, size);
+            continue;
+        }
+        s_ReadChunk(m_Input, m_Chunk, size);
+        CColumnDataReader chunk(m_Chunk);
+        chunk.GetBits(data.m_Set, size_t(rows));
+        data.m_Values.resize(size_t(rows));
+        switch ( m_Columns.GetColumn(i).m_Type ) {
+        case CObjectColumns::eColumn_Struct:
+        case CObjectColumns::eColumn_Null:
+            break;
+        case CObjectColumns::eColumn_Bool:
+            {{
+                size_t count = 0;
+                for ( size_t row = 0; row < rows; ++row ) {
+                    count += data.m_Set[row];
+                }
+                vector<char> bits;
+                chunk.GetBits(bits, count);
+                for ( size_t row = 0, k = 0; row < rows; ++row ) {
+                    if ( data.m_Set[row] ) {
+                        data.m_Values[row] = bits[k++];
+                    }
+                }
+            }}
+            break;
+        case CObjectColumns::eColumn_Int:
+        case CObjectColumns::eColumn_Uint:
+            for ( size_t row = 0; row < rows; ++row ) {
+                if ( data.m_Set[row] ) {
+                    data.m_Values[row] = chunk.GetUint();
+                }
+            }
+            break;
+        case CObjectColumns::eColumn_Double:
+            for ( size_t row = 0; row < rows; ++row ) {
+                if ( data.m_Set[row] ) {
+                    Uint8 bits = 0;
+                    for ( int b = 0; b < 8; ++b ) {
+                        bits |= Uint8(Uint1(chunk.GetByte())) << (b * 8);
+                    }
+                    data.m_Values[row] = bits;
+                }
+            }
+            break;
+        case CObjectColumns::eColumn_String:
+        case CObjectColumns::eColumn_Binary:
+            if ( chunk.GetByte() == eStrings_Dictionary ) {
+                data.m_Strings.resize(chunk.GetSize());
+                for ( auto& s : data.m_Strings ) {
+                    s = chunk.GetString();
+                }
+                for ( size_t row = 0; row < rows; ++row ) {
+                    if ( data.m_Set[row] ) {
+                        Uint8 value = chunk.GetUint();
+                        if ( value >= data.m_Strings.size() ) {
+                            s_FormatError("bad dictionary index");
+                        }
+                        data.m_Values[row] = value;
+                    }
+                }
+            }
+            else {
+                for ( size_t row = 0; row < rows; ++row ) {
+                    if ( data.m_Set[row] ) {
+                        data.m_Values[row] = data.m_Strings.size();
+                        data.m_Strings.push_back(chunk.GetString());
+                    }
+                }
+            }
+            break;
+        }
+        if ( !chunk.AtEnd() ) {
+            s_FormatError("extra data in column " +
+                          m_Columns.GetColumn(i).m_Name);
+        }
+    }
+    m_Rows = size_t(rows);
+    return true;
+}
+
+
+bool CObjectColumnReader::IsSet(size_t column, size_t row) const
+{
+    if ( !m_Selected[column] ) {
+        NCBI_THROW(CSerialException, eIllegalCall,
+                   "columnar data: column " +
+                   m_Columns.GetColumn(column).m_Name + " is not selected");
+    }
+    return m_Data[column].m_Set[row] != 0;
+}
+
+
+const CObjectColumnReader::SColumnData&
+CObjectColumnReader::x_GetValue(size_t column, size_t row,
+                                CObjectColumns::EColumnType type) const
+{
+    const CObjectColumns::SColumn& info = m_Columns.GetColumn(column);
+    if ( info.m_Type != type &&
+         !(type == CObjectColumns::eColumn_String &&
+           info.m_Type == CObjectColumns::eColumn_Binary) ) {
+        NCBI_THROW(CSerialException, eIllegalCall,
+                   "columnar data: wrong type of column " + info.m_Name);
+    }
+    if ( !IsSet(column, row) ) {
+        NCBI_THROW(CSerialException, eNullValue,
+                   "columnar data: no value of " + info.m_Name);
+    }
+    return m_Data[column];
+}
+
+
+bool CObjectColumnReader::GetBool(size_t column, size_t row) const
+{
+    return x_GetValue(column, row, CObjectColumns::eColumn_Bool).
+        m_Values[row] != 0;
+}
+
+
+Int8 CObjectColumnReader::GetInt8(size_t column, size_t row) const
+{
+    return s_UnZigZag(x_GetValue(column, row, CObjectColumns::eColumn_Int).
+                      m_Values[row]);
+}
+
+
+Uint8 CObjectColumnReader::GetUint8(size_t column, size_t row) const
+{
+    return x_GetValue(column, row, CObjectColumns::eColumn_Uint).
+        m_Values[row];
+}
+
+
+double CObjectColumnReader::GetDouble(size_t column, size_t row) const
+{
+    Uint8 bits = x_GetValue(column, row, CObjectColumns::eColumn_Double).
+        m_Values[row];
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+
+const string& CObjectColumnReader::GetString(size_t column, size_t row) const
+{
+    const SColumnData& data =
+        x_GetValue(column, row, CObjectColumns::eColumn_String);
+    return data.m_Strings[data.m_Values[row]];
+}
+
+
+void CObjectColumnReader::ReadObject(const CObjectInfo& object, size_t row)
+{
+    if ( object.GetTypeInfo() != m_Columns.GetTypeInfo() ) {
+        NCBI_THROW(CSerialException, eIllegalCall,
+                   "columnar data: cannot read " +
+                   m_Columns.GetTypeInfo()->GetName() + " into " +
+                   object.GetTypeInfo()->GetName());
+    }
+    object.GetTypeInfo()->SetDefault(object.GetObjectPtr());
+    x_ReadRow(0, m_Columns.GetColumnCount(), object.GetObjectPtr(), row);
+}
+
+
+void CObjectColumnReader::x_ReadRow(size_t begin, size_t end,
+                                    TObjectPtr classPtr, size_t row)
+{
+    for ( size_t i = begin; i < end; ) {
+        const CObjectColumns::SColumn& column = m_Columns.GetColumn(i);
+        if ( m_Selected[i] && m_Data[i].m_Set[row] ) {
+            const CMemberInfo* memberInfo = column.m_Member;
+            TObjectPtr valuePtr = memberInfo->GetMemberPtr(classPtr);
+            if ( column.m_ValueType != memberInfo->GetTypeInfo() ) {
+                // class through CRef<>
+                valuePtr = CObjectInfo(valuePtr, memberInfo->GetTypeInfo()).
+                    SetPointedObject().GetObjectPtr();
+            }
+            x_ReadValue(i, valuePtr, row);
+            memberInfo->UpdateSetFlagYes(classPtr);
+            if ( column.m_Type == CObjectColumns::eColumn_Struct ) {
+                x_ReadRow(i + 1, column.m_End, valuePtr, row);
+            }
+        }
+        i = column.m_End;
+    }
+}
+
+
+void CObjectColumnReader::x_ReadValue(size_t index, TObjectPtr valuePtr,
+                                      size_t row)
+{
+    const CObjectColumns::SColumn& column = m_Columns.GetColumn(index);
+    CObjectInfo value(valuePtr, column.m_ValueType);
+    switch ( column.m_Type ) {
+    case CObjectColumns::eColumn_Struct:
+    case CObjectColumns::eColumn_Null:
+        break;
+    case CObjectColumns::eColumn_Bool:
+        value.SetPrimitiveValueBool(GetBool(index, row));
+        break;
+    case CObjectColumns::eColumn_Int:
+        if ( value.GetPrimitiveValueType() == ePrimitiveValueChar ) {
+            value.SetPrimitiveValueChar(char(GetInt8(index, row)));
+        }
+        else {
+            value.SetPrimitiveValueInt8(GetInt8(index, row));
+        }
+        break;
+    case CObjectColumns::eColumn_Uint:
+        value.SetPrimitiveValueUint8(GetUint8(index, row));
+        break;
+    case CObjectColumns::eColumn_Double:
+        value.SetPrimitiveValueDouble(GetDouble(index, row));
+        break;
+    case CObjectColumns::eColumn_String:
+        value.SetPrimitiveValueString(GetString(index, row));
+        break;
+    case CObjectColumns::eColumn_Binary:
+        {{
+            const string& data = GetString(index, row);
+            m_ValueIn->OpenFromBuffer(data.data(), data.size());
+            m_ValueIn->Read(valuePtr, column.m_ValueType,
+                            CObjectIStream::eNoFileHeader);
+            m_ValueIn->Close();
+        }}
+        break;
+    }
+}
+
+
+END_NCBI_SCOPE
@@ -38,6 +38,7 @@
 #include <corelib/ncbimtx.hpp>
 #include <corelib/ncbithr.hpp>
 #include <corelib/ncbi_param.hpp>
+#include <corelib/ncbifile.hpp>
 
 #include <exception>
 
@@ -204,6 +205,14 @@ CObjectIStream* CObjectIStream::Open(ESerialDataFormat format,
                                      const string& fileName,
                                      TSerialOpenFlags openFlags)
 {
+    if ( (openFlags & eSerial_MemoryMap) &&
+         !((openFlags & eSerial_StdWhenEmpty) && fileName.empty()) &&
+         !((openFlags & eSerial_StdWhenDash) && fileName == "-") &&
+         !((openFlags & eSerial_StdWhenStd) && fileName == "stdin") ) {
+        AutoPtr<CObjectIStream> stream(Create(format));
+        stream->OpenFromMemoryFile(fileName);
+        return stream.release();
+    }
     CRef<CByteSource> src = GetSource(format, fileName, openFlags);
     return Create(format, *src);
 }
@@ -506,6 +515,21 @@ void CObjectIStream::OpenFromBuffer(const char* buffer, size_t size)
     m_Fail = 0;
 }
 
+void CObjectIStream::OpenFromMemoryFile(const string& fileName)
+{
+    Close();
+    _ASSERT(m_Fail == fNotOpen);
+    AutoPtr<CMemoryFile> mfile(new CMemoryFile(fileName));
+    const char* data = static_cast<const char*>(mfile->GetPtr());
+    size_t size = data ? mfile->GetSize() : 0;
+    if ( size ) {
+        mfile->MemMapAdvise(CMemoryFile::eMMA_Sequential);
+    }
+    m_Input.Open(data, size);
+    m_MemoryFile = mfile;
+    m_Fail = 0;
+}
+
 void CObjectIStream::Open(CByteSource& source)
 {
     CRef<CByteSourceReader> reader = source.Open();
@@ -540,6 +564,10 @@ void CObjectIStream::Close(void)
 {
     if (m_Fail != fNotOpen) {
         m_Input.Close();
+        if ( m_MemoryFile ) {
+            m_Input.Open(0, 0);
+            m_MemoryFile.reset();
+        }
         if ( m_Objects )
             m_Objects->Clear();
         ClearStack();
@@ -1026,7 +1054,8 @@ void CObjectIStream::EndDelayBuffer(CDelayBuffer& buffer,
                                     TObjectPtr objectPtr)
 {
     CRef<CByteSource> src = EndDelayBuffer();
-    buffer.SetData(itemInfo, objectPtr, GetDataFormat(), GetFlags(), *src);
+    buffer.SetData(itemInfo, objectPtr, GetDataFormat(), GetFlags(), *src,
+                   GetMemoryPool());
 }
 
 bool CObjectIStream::ExpectedMember(const CMemberInfo* memberInfo)
@@ -1604,6 +1633,19 @@ size_t CObjectIStream::ByteBlock::Read(void* dst, size_t needLength,
     return length;
 }
 
+CTempString CObjectIStream::ByteBlock::ReadInPlace(size_t length)
+{
+    if ( !KnownLength() || length == 0 ) {
+        return CTempString();
+    }
+    if ( m_Length < length ) {
+        length = m_Length;
+    }
+    CTempString data = GetStream().ReadBytesInPlace(*this, length);
+    m_Length -= data.size();
+    return data;
+}
+
 ///////////////////////////////////////////////////////////////////////
 //
 // CObjectIStream::CharBlock
@@ -1668,6 +1710,13 @@ size_t CObjectIStream::CharBlock::Read(char* dst, size_t needLength,
 }
 
 
+CTempString CObjectIStream::ReadBytesInPlace(ByteBlock& /*b*/,
+                                             size_t /*count*/)
+{
+    // formats which encode bytes (hex, base64) cannot share the input
+    return CTempString();
+}
+
 void CObjectIStream::EndBytes(const ByteBlock& /*b*/)
 {
 }
@@ -452,6 +452,26 @@ void CObjectIStreamAsnBinary::ReadBytes(string& str, size_t count)
     m_Input.GetChars(str, count);
 }
 
+// Return pointer to the data bytes if they are all in the input buffer,
+// so they can be used without copying; null if they have to be read
+inline
+const char* CObjectIStreamAsnBinary::GetBytesInBuffer(size_t count)
+{
+#if CHECK_INSTREAM_STATE
+    if ( m_CurrentTagState != eData ) {
+        ThrowError(fIllegalCall, "illegal ReadBytes call");
+    }
+#endif
+#if CHECK_INSTREAM_LIMITS
+    Int8 cur_pos = m_Input.GetStreamPosAsInt8();
+    Int8 end_pos = cur_pos + count;
+    if ( end_pos < cur_pos ||
+        (m_CurrentTagLimit != 0 && end_pos > m_CurrentTagLimit) )
+        ThrowError(fOverflow, "tag size overflow");
+#endif
+    return m_Input.GetCharsInBuffer(count);
+}
+
 inline
 void CObjectIStreamAsnBinary::SkipBytes(size_t count)
 {
@@ -762,22 +782,34 @@ void CObjectIStreamAsnBinary::ReadPackedString(string& s,
                         type == eStringTypeVisible? x_FixCharsMethod(): eFNP_Allow);
     }
     else {
-        ReadBytes(buffer, length);
+        // look up the bytes right in the input buffer if possible,
+        // it's the whole file when the stream is memory mapped
+        const char* data = GetBytesInBuffer(length);
+        if ( !data ) {
+            ReadBytes(buffer, length);
+            data = buffer;
+        }
         EndOfTag();
         pair<CPackString::iterator, bool> found =
-            pack_string.Locate(buffer, length);
+            pack_string.Locate(data, length);
         if ( found.second ) {
             pack_string.AddOld(s, found.first);
         }
         else {
             if ( type == eStringTypeVisible &&
-                 x_FixCharsMethod() != eFNP_Allow &&
-                 FixVisibleChars(buffer, length, x_FixCharsMethod()) ) {
-                // do not remember fixed strings
-                pack_string.Pack(s, buffer, length);
-                return;
+                 x_FixCharsMethod() != eFNP_Allow ) {
+                if ( data != buffer ) {
+                    // input buffer may be read-only
+                    memcpy(buffer, data, length);
+                    data = buffer;
+                }
+                if ( FixVisibleChars(buffer, length, x_FixCharsMethod()) ) {
+                    // do not remember fixed strings
+                    pack_string.Pack(s, buffer, length);
+                    return;
+                }
             }
-            pack_string.AddNew(s, buffer, length, found.first);
+            pack_string.AddNew(s, data, length, found.first);
         }
     }
 }
@@ -814,13 +846,18 @@ void CObjectIStreamAsnBinary::ReadStringValue(size_t length,
     }
     else {
         char buffer[BUFFER_SIZE];
-        // try to reuse old value
-        ReadBytes(buffer, length);
-        if (fix_method != eFNP_Allow) {
-            FixVisibleChars(buffer, length, fix_method);
+        // try to reuse old value, compare in place if possible
+        const char* data = fix_method == eFNP_Allow?
+            GetBytesInBuffer(length): 0;
+        if ( !data ) {
+            ReadBytes(buffer, length);
+            if (fix_method != eFNP_Allow) {
+                FixVisibleChars(buffer, length, fix_method);
+            }
+            data = buffer;
         }
-        if ( memcmp(s.data(), buffer, length) != 0 ) {
-            s.assign(buffer, length);
+        if ( memcmp(s.data(), data, length) != 0 ) {
+            s.assign(data, length);
         } 
     }
     EndOfTag();
@@ -1479,6 +1516,13 @@ size_t CObjectIStreamAsnBinary::ReadBytes(ByteBlock& ,
     return length;
 }
 
+CTempString CObjectIStreamAsnBinary::ReadBytesInPlace(ByteBlock& ,
+                                                      size_t length)
+{
+    const char* data = GetBytesInBuffer(length);
+    return data? CTempString(data, length): CTempString();
+}
+
 void CObjectIStreamAsnBinary::EndBytes(const ByteBlock& )
 {
     EndOfTag();
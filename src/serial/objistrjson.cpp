@@ -33,13 +33,125 @@
 #include <ncbi_pch.hpp>
 #include <corelib/ncbistd.hpp>
 #include <corelib/ncbi_limits.h>
+#include <corelib/ncbi_system.hpp>
 
 #include <serial/objistrjson.hpp>
 
+#if defined(__GNUC__)  &&  (defined(__x86_64__)  ||  defined(__i386__))
+#  define NCBI_JSON_SIMD_X86  1
+#  include <immintrin.h>
+#endif
+
 #define NCBI_USE_ERRCODE_X   Serial_OStream
 
 BEGIN_NCBI_SCOPE
 
+
+/////////////////////////////////////////////////////////////////////////////
+// Scanning of string values
+//
+// Each scanner returns the length of the leading run of chars which
+// ReadEncodedChar() would return as is: anything but quote, backslash,
+// end of line and, if 'high' is set, non-ASCII chars (they are converted
+// when the string encoding is not UTF-8).
+
+namespace {
+
+typedef size_t (*FPlainCharsScanner)(const char* data, size_t size, bool high);
+
+inline bool s_IsPlainChar(char c, bool high)
+{
+    return c != '\"'  &&  c != '\\'  &&  c != '\r'  &&  c != '\n'  &&
+        !(high  &&  (c & 0x80));
+}
+
+size_t s_ScanPlainChars(const char* data, size_t size, bool high)
+{
+    size_t pos = 0;
+    while ( pos < size  &&  s_IsPlainChar(data[pos], high) ) {
+        ++pos;
+    }
+    return pos;
+}
+
+#if defined(NCBI_JSON_SIMD_X86)
+
+__attribute__((target("sse2")))
+size_t s_ScanPlainCharsSSE2(const char* data, size_t size, bool high)
+{
+    const __m128i quote  = _mm_set1_epi8('\"');
+    const __m128i escape = _mm_set1_epi8('\\');
+    const __m128i cr     = _mm_set1_epi8('\r');
+    const __m128i lf     = _mm_set1_epi8('\n');
+    size_t pos = 0;
+    for ( ;  pos + 16 <= size;  pos += 16 ) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+        __m128i special =
+            _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, quote),
+                                      _mm_cmpeq_epi8(v, escape)),
+                         _mm_or_si128(_mm_cmpeq_epi8(v, cr),
+                                      _mm_cmpeq_epi8(v, lf)));
+        unsigned mask = _mm_movemask_epi8(special);
+        if ( high ) {
+            mask |= _mm_movemask_epi8(v);
+        }
+        if ( mask ) {
+            return pos + __builtin_ctz(mask);
+        }
+    }
+    return pos + s_ScanPlainChars(data + pos, size - pos, high);
+}
+
+__attribute__((target("avx2")))
+size_t s_ScanPlainCharsAVX2(const char* data, size_t size, bool high)
+{
+    const __m256i quote  = _mm256_set1_epi8('\"');
+    const __m256i escape = _mm256_set1_epi8('\\');
+    const __m256i cr     = _mm256_set1_epi8('\r');
+    const __m256i lf     = _mm256_set1_epi8('\n');
+    size_t pos = 0;
+    for ( ;  pos + 32 <= size;  pos += 32 ) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+        __m256i special =
+            _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, quote),
+                                            _mm256_cmpeq_epi8(v, escape)),
+                            _mm256_or_si256(_mm256_cmpeq_epi8(v, cr),
+                                            _mm256_cmpeq_epi8(v, lf)));
+        unsigned mask = unsigned(_mm256_movemask_epi8(special));
+        if ( high ) {
+            mask |= unsigned(_mm256_movemask_epi8(v));
+        }
+        if ( mask ) {
+            return pos + __builtin_ctz(mask);
+        }
+    }
+    return pos + s_ScanPlainCharsSSE2(data + pos, size - pos, high);
+}
+
+#endif  // NCBI_JSON_SIMD_X86
+
+FPlainCharsScanner s_SelectScanner(void)
+{
+#if defined(NCBI_JSON_SIMD_X86)
+    if ( CCpuFeatures::AVX2() ) {
+        return s_ScanPlainCharsAVX2;
+    }
+    if ( CCpuFeatures::SSE2() ) {
+        return s_ScanPlainCharsSSE2;
+    }
+#endif
+    return 0;
+}
+
+inline FPlainCharsScanner s_GetScanner(void)
+{
+    static const FPlainCharsScanner scanner = s_SelectScanner();
+    return scanner;
+}
+
+} // namespace
+
+
 CObjectIStream* CObjectIStream::CreateObjectIStreamJson()
 {
     return new CObjectIStreamJson();
@@ -54,7 +166,8 @@ CObjectIStreamJson::CObjectIStreamJson(void)
     m_GotNameless(false),
     m_Closing(0),
     m_StringEncoding( eEncoding_UTF8 ),
-    m_BinaryFormat(eDefault)
+    m_BinaryFormat(eDefault),
+    m_SimdEnabled(true)
 {
     m_Utf8Pos = m_Utf8Buf.begin();
 }
@@ -67,7 +180,8 @@ CObjectIStreamJson::CObjectIStreamJson(CNcbiIstream& in, EOwnership deleteIn)
     m_GotNameless(false),
     m_Closing(0),
     m_StringEncoding( eEncoding_UTF8 ),
-    m_BinaryFormat(eDefault)
+    m_BinaryFormat(eDefault),
+    m_SimdEnabled(true)
 {
     m_Utf8Pos = m_Utf8Buf.begin();
     Open(in, deleteIn);
@@ -128,6 +242,16 @@ void CObjectIStreamJson::SetBinaryDataFormat(CObjectIStreamJson::EBinaryDataForm
     m_BinaryFormat = fmt;
 }
 
+void CObjectIStreamJson::SetSimdEnabled(bool enable)
+{
+    m_SimdEnabled = enable;
+}
+
+bool CObjectIStreamJson::IsSimdEnabled(void) const
+{
+    return m_SimdEnabled  &&  s_GetScanner() != 0;
+}
+
 char CObjectIStreamJson::GetChar(void)
 {
     return m_Input.GetChar();
@@ -310,12 +434,33 @@ TUnicodeSymbol CObjectIStreamJson::ReadUtf8Char(char c)
     return chU;
 }
 
+// Take chars which need no decoding, as many as there are in the buffer;
+// str == 0 means skip them
+void CObjectIStreamJson::x_ReadPlainChars(EStringType type, string* str)
+{
+    // chars of a multibyte symbol must be returned first
+    if ( !IsSimdEnabled()  ||  !m_Utf8Buf.empty()  ||  !m_Input.HasMore() ) {
+        return;
+    }
+    EEncoding enc_out( type == eStringTypeUTF8 ? eEncoding_UTF8 : m_StringEncoding);
+    bool high = enc_out != eEncoding_UTF8  &&  enc_out != eEncoding_Unknown;
+    const char* data = m_Input.GetCurrentPos();
+    size_t count = s_GetScanner()(data, m_Input.GetAvailableChars(), high);
+    if ( count ) {
+        if ( str ) {
+            str->append(data, count);
+        }
+        m_Input.SkipChars(count);
+    }
+}
+
 string CObjectIStreamJson::x_ReadString(EStringType type)
 {
     m_ExpectValue = false;
     Expect('\"',true);
     string str;
     for (;;) {
+        x_ReadPlainChars(type, &str);
         bool encoded = false;
         char c = ReadEncodedChar(type, encoded);
         if (!encoded) {
@@ -373,6 +518,9 @@ void  CObjectIStreamJson::x_SkipData(void)
     m_ExpectValue = false;
     char to = GetChar(true);
     for (;;) {
+        if (to == '\"') {
+            x_ReadPlainChars(eStringTypeUTF8, 0);
+        }
         bool encoded = false;
         char c = ReadEncodedChar(eStringTypeUTF8, encoded);
         if (!encoded) {
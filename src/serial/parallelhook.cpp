@@ -0,0 +1,290 @@
+/*  $Id$
+* ===========================================================================
+*
+*                            PUBLIC DOMAIN NOTICE
+*               National Center for Biotechnology Information
+*
+*  This software/database is a "United States Government Work" under the
+*  terms of the United States Copyright Act.  It was written as part of
+*  the author's official duties as a United States Government employee and
+*  thus cannot be copyrighted.  This software/database is freely available
+*  to the public for use. The National Library of Medicine and the U.S.
+*  Government have not placed any restriction on its use or reproduction.
+*
+*  Although all reasonable efforts have been taken to ensure the accuracy
+*  and reliability of the software and data, the NLM and the U.S.
+*  Government do not and cannot warrant the performance or results that
+*  may be obtained by using this software or data. The NLM and the U.S.
+*  Government disclaim all warranties, express or implied, including
+*  warranties of performance, merchantability or fitness for any particular
+*  purpose.
+*
+*  Please cite the author in any work or product based on this material.
+*
+* ===========================================================================
+*
+* File Description:
+*   Read hooks which parse elements of a large SEQUENCE OF / SET OF
+*   in parallel threads
+*/
+
+#include <ncbi_pch.hpp>
+#include <corelib/ncbistd.hpp>
+#include <corelib/ncbi_system.hpp>
+#include <serial/parallelhook.hpp>
+#include <serial/objectinfo.hpp>
+#include <serial/objistr.hpp>
+#include <serial/impl/continfo.hpp>
+#include <serial/impl/member.hpp>
+#include <serial/impl/ptrinfo.hpp>
+#include <util/bytesrc.hpp>
+
+#include <deque>
+#include <future>
+
+BEGIN_NCBI_SCOPE
+
+
+static const size_t kDefaultBatchSize = 256 * 1024;
+
+// set in parsing threads, so that nested containers are read sequentially
+static thread_local bool s_InParsingThread = false;
+
+class CParsingThreadGuard
+{
+public:
+    CParsingThreadGuard(void)
+        : m_Saved(s_InParsingThread)
+        {
+            s_InParsingThread = true;
+        }
+    ~CParsingThreadGuard(void)
+        {
+            s_InParsingThread = m_Saved;
+        }
+private:
+    bool m_Saved;
+};
+
+
+struct CParallelContainerReader::SSettings
+{
+    CObjectIStream::TFlags m_Flags;
+    ESerialVerifyData      m_VerifyData;
+    ESerialSkipUnknown     m_SkipUnknownMembers;
+    ESerialSkipUnknown     m_SkipUnknownVariants;
+    bool                   m_UseMemoryPool;
+};
+
+
+CParallelContainerReader::CParallelContainerReader(unsigned max_threads,
+                                                   size_t batch_size)
+    : m_MaxThreads(max_threads? max_threads: CSystemInfo::GetCpuCount()),
+      m_BatchSize(batch_size? batch_size: kDefaultBatchSize)
+{
+}
+
+
+CParallelContainerReader::~CParallelContainerReader(void)
+{
+}
+
+
+bool CParallelContainerReader::CanReadInParallel(CObjectIStream& in,
+                                                 const CObjectTypeInfo& type) const
+{
+    if ( m_MaxThreads <= 1 ||
+         s_InParsingThread ||
+         in.GetDataFormat() != eSerial_AsnBinary ||
+         in.DetectLoops() ||
+         type.GetTypeFamily() != eTypeFamilyContainer ) {
+        return false;
+    }
+    TTypeInfo elementType = type.GetContainerTypeInfo()->GetElementType();
+    return elementType->GetTypeFamily() == eTypeFamilyPointer &&
+        CTypeConverter<CPointerTypeInfo>::SafeCast(elementType)->
+        GetPointedType()->IsCObject();
+}
+
+
+void CParallelContainerReader::InitElementStream(CObjectIStream& /*in*/)
+{
+}
+
+
+CParallelContainerReader::TBatch
+CParallelContainerReader::x_ParseBatch(CRef<CByteSource> data,
+                                       TTypeInfo objectType,
+                                       const SSettings& settings)
+{
+    CParsingThreadGuard thread_guard;
+    unique_ptr<CObjectIStream> in(CObjectIStream::Create(eSerial_AsnBinary,
+                                                         *data));
+    in->SetFlags(settings.m_Flags);
+    in->SetVerifyData(settings.m_VerifyData);
+    in->SetSkipUnknownMembers(settings.m_SkipUnknownMembers);
+    in->SetSkipUnknownVariants(settings.m_SkipUnknownVariants);
+    if ( settings.m_UseMemoryPool ) {
+        // memory pool cannot be shared between threads
+        in->UseMemoryPool();
+    }
+    InitElementStream(*in);
+
+    TBatch batch;
+    BEGIN_OBJECT_FRAME_OF2(*in, eFrameArrayElement, objectType);
+    while ( !in->EndOfData() ) {
+        in->SetDiscardCurrObject(false);
+        CRef<CObject> object;
+        TObjectPtr objectPtr = in->ReadPointer(objectType).first;
+        if ( objectPtr ) {
+            object.Reset(static_cast<CObject*>(objectPtr));
+        }
+        if ( in->GetDiscardCurrObject() ) {
+            in->SetDiscardCurrObject(false);
+            continue;
+        }
+        batch.push_back(object);
+    }
+    END_OBJECT_FRAME_OF(*in);
+    return batch;
+}
+
+
+static
+void s_AppendElements(const CContainerTypeInfo* containerType,
+                      TObjectPtr containerPtr,
+                      vector< CRef<CObject> > batch)
+{
+    const CPointerTypeInfo* pointerType =
+        CTypeConverter<CPointerTypeInfo>::SafeCast(
+            containerType->GetElementType());
+    for ( auto& object : batch ) {
+        TObjectPtr elementPtr = containerType->AddElement(containerPtr, 0);
+        if ( object ) {
+            // the container takes ownership
+            pointerType->SetObjectPointer(elementPtr, object.Release());
+        }
+    }
+}
+
+
+void CParallelContainerReader::ReadContainer(CObjectIStream& in,
+                                             const CObjectInfo& container)
+{
+    if ( !CanReadInParallel(in, container) ) {
+        in.ReadObject(container);
+        return;
+    }
+    const CContainerTypeInfo* containerType = container.GetContainerTypeInfo();
+    TObjectPtr containerPtr = container.GetObjectPtr();
+    TTypeInfo elementType = containerType->GetElementType();
+    TTypeInfo objectType =
+        CTypeConverter<CPointerTypeInfo>::SafeCast(elementType)->
+        GetPointedType();
+    containerType->SetDefault(containerPtr);
+
+    SSettings settings;
+    settings.m_Flags = in.GetFlags();
+    settings.m_VerifyData = in.GetVerifyData();
+    settings.m_SkipUnknownMembers = in.GetSkipUnknownMembers();
+    settings.m_SkipUnknownVariants = in.GetSkipUnknownVariants();
+    settings.m_UseMemoryPool = in.GetMemoryPool() != 0;
+
+    // parsed batches, in the order of elements
+    deque< future<TBatch> > batches;
+
+    BEGIN_OBJECT_FRAME_OF2(in, eFrameArray, containerType);
+    in.BeginContainer(containerType);
+    BEGIN_OBJECT_FRAME_OF2(in, eFrameArrayElement, elementType);
+
+    CStreamDelayBufferGuard guard;
+    CNcbiStreampos batch_end = 0;
+    bool have_batch = false;
+    for ( ;; ) {
+        bool more = in.BeginContainerElement(elementType);
+        if ( more ) {
+            if ( !have_batch ) {
+                guard.StartDelayBuffer(in);
+                batch_end = in.GetStreamPos() + CNcbiStreampos(m_BatchSize);
+                have_batch = true;
+            }
+            in.SkipAnyContentObject();
+            in.EndContainerElement();
+        }
+        if ( have_batch && (!more || in.GetStreamPos() >= batch_end) ) {
+            if ( batches.size() >= m_MaxThreads ) {
+                s_AppendElements(containerType, containerPtr,
+                                 batches.front().get());
+                batches.pop_front();
+            }
+            batches.push_back(async(launch::async,
+                                    &CParallelContainerReader::x_ParseBatch,
+                                    this, guard.EndDelayBuffer(),
+                                    objectType, cref(settings)));
+            have_batch = false;
+        }
+        if ( !more ) {
+            break;
+        }
+    }
+
+    END_OBJECT_FRAME_OF(in);
+    in.EndContainer();
+    END_OBJECT_FRAME_OF(in);
+
+    for ( ; !batches.empty(); batches.pop_front() ) {
+        s_AppendElements(containerType, containerPtr,
+                         batches.front().get());
+    }
+}
+
+
+CParallelReadClassMemberHook::CParallelReadClassMemberHook(unsigned max_threads,
+                                                           size_t batch_size)
+    : CParallelContainerReader(max_threads, batch_size)
+{
+}
+
+
+CParallelReadClassMemberHook::~CParallelReadClassMemberHook(void)
+{
+}
+
+
+void CParallelReadClassMemberHook::ReadClassMember(CObjectIStream& in,
+                                                   const CObjectInfoMI& member)
+{
+    if ( !CanReadInParallel(in, member.GetMemberType()) ) {
+        DefaultRead(in, member);
+        return;
+    }
+    ReadContainer(in, *member);
+    member.GetMemberInfo()->
+        UpdateSetFlagYes(member.GetClassObject().GetObjectPtr());
+}
+
+
+CParallelReadChoiceVariantHook::CParallelReadChoiceVariantHook(unsigned max_threads,
+                                                               size_t batch_size)
+    : CParallelContainerReader(max_threads, batch_size)
+{
+}
+
+
+CParallelReadChoiceVariantHook::~CParallelReadChoiceVariantHook(void)
+{
+}
+
+
+void CParallelReadChoiceVariantHook::ReadChoiceVariant(CObjectIStream& in,
+                                                       const CObjectInfoCV& variant)
+{
+    if ( !CanReadInParallel(in, variant.GetVariantType()) ) {
+        DefaultRead(in, variant);
+        return;
+    }
+    ReadContainer(in, *variant);
+}
+
+
+END_NCBI_SCOPE
@@ -1545,7 +1545,20 @@ public:
                 size_t length = block.GetExpectedLength();
 #if 1
                 o.clear();
+                // share the input buffer if the whole block is there,
+                // e.g. when the stream is memory mapped
+                CTempString data = block.ReadInPlace(length);
+                if ( data.size() == length ) {
+                    const Char* ptr = reinterpret_cast<const Char*>(data.data());
+                    o.assign(ptr, ptr + length);
+                    block.End();
+                    return;
+                }
                 o.reserve(length);
+                if ( !data.empty() ) {
+                    const Char* ptr = reinterpret_cast<const Char*>(data.data());
+                    o.insert(o.end(), ptr, ptr + data.size());
+                }
                 Char buf[2048];
                 size_t count;
                 while ( (count = block.Read(ToChar(buf), sizeof(buf))) != 0 ) {
@@ -0,0 +1,269 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   Statically dispatched member I/O of classes generated with
+ *   "CodeGenerationStyle = direct_io" (datatool -ocd): the data are the
+ *   same as written by type info, hooks are called, and invalid data are
+ *   rejected.
+ *
+ */
+
+#include <ncbi_pch.hpp>
+#include <serial/serial.hpp>
+#include <serial/objistr.hpp>
+#include <serial/objostr.hpp>
+#include <serial/objhook.hpp>
+#include <serial/impl/classinfo.hpp>
+#include <serial/test/Direct_Item.hpp>
+#include <serial/test/Direct_Items.hpp>
+#include <serial/test/Direct_Info.hpp>
+
+#include <corelib/test_boost.hpp>
+
+#include <common/test_assert.h>  /* This header must go last */
+
+USING_NCBI_SCOPE;
+
+
+static CRef<CDirect_Items> s_MakeItems(void)
+{
+    CRef<CDirect_Items> items(new CDirect_Items);
+    for ( int i = 0; i < 100; ++i ) {
+        CRef<CDirect_Item> item(new CDirect_Item);
+        item->SetName("item " + NStr::IntToString(i));
+        item->SetId(i - 50);
+        if ( i % 2 ) {
+            item->SetBig(Int8(i) << 40);
+        }
+        if ( i % 3 ) {
+            item->SetScore(i / 7.);
+        }
+        if ( i % 4 ) {
+            item->SetFlag(i % 8 == 1);
+        }
+        if ( i % 5 ) {
+            item->SetComment(string(i, 'c') + "\"quoted\"");
+        }
+        // JSON writes DEFAULT members which are not set, so they come back
+        // set; have them set in all items for the round trips to compare
+        item->SetLevel(i % 6 ? 1 : i);
+        if ( i % 7 == 0 ) {
+            item->SetTags().push_back("tag");
+        }
+        if ( i % 9 == 0 ) {
+            item->SetInfo().SetName("info");
+            item->SetInfo().SetCount(i);
+        }
+        items->Set().push_back(item);
+    }
+    return items;
+}
+
+
+static string s_Write(const CDirect_Items& items, ESerialDataFormat format)
+{
+    CNcbiOstrstream str;
+    {
+        unique_ptr<CObjectOStream> out(CObjectOStream::Open(format, str));
+        *out << items;
+    }
+    return CNcbiOstrstreamToString(str);
+}
+
+
+static CRef<CDirect_Items> s_Read(const string& data,
+                                  ESerialDataFormat format)
+{
+    CNcbiIstrstream str(data);
+    unique_ptr<CObjectIStream> in(CObjectIStream::Open(format, str));
+    CRef<CDirect_Items> items(new CDirect_Items);
+    *in >> *items;
+    return items;
+}
+
+
+static void s_ReadItem(const string& data, ESerialDataFormat format)
+{
+    CNcbiIstrstream str(data);
+    unique_ptr<CObjectIStream> in(CObjectIStream::Open(format, str));
+    CDirect_Item item;
+    *in >> item;
+}
+
+
+static const ESerialDataFormat kFormats[] = {
+    eSerial_AsnText, eSerial_AsnBinary, eSerial_Json
+};
+
+
+BOOST_AUTO_TEST_CASE(s_TestRoundTrip)
+{
+    CRef<CDirect_Items> items = s_MakeItems();
+    for ( auto format : kFormats ) {
+        BOOST_CHECK(s_Read(s_Write(*items, format), format)->Equals(*items));
+    }
+}
+
+
+class CCountReadNameHook : public CReadClassMemberHook
+{
+public:
+    CCountReadNameHook(int& count)
+        : m_Count(count) {}
+    virtual void ReadClassMember(CObjectIStream& in,
+                                 const CObjectInfoMI& member)
+        {
+            DefaultRead(in, member);
+            ++m_Count;
+        }
+private:
+    int& m_Count;
+};
+
+
+class CCountWriteNameHook : public CWriteClassMemberHook
+{
+public:
+    CCountWriteNameHook(int& count)
+        : m_Count(count) {}
+    virtual void WriteClassMember(CObjectOStream& out,
+                                  const CConstObjectInfoMI& member)
+        {
+            DefaultWrite(out, member);
+            ++m_Count;
+        }
+private:
+    int& m_Count;
+};
+
+
+BOOST_AUTO_TEST_CASE(s_TestMemberHooks)
+{
+    CRef<CDirect_Items> items = s_MakeItems();
+    const int kCount = int(items->Get().size());
+    for ( auto format : kFormats ) {
+        int count = 0;
+        string data;
+        {{
+            CNcbiOstrstream str;
+            unique_ptr<CObjectOStream> out(CObjectOStream::Open(format, str));
+            CObjectTypeInfo(CType<CDirect_Item>()).FindMember("name").
+                SetLocalWriteHook(*out, new CCountWriteNameHook(count));
+            *out << *items;
+            out->Flush();
+            data = CNcbiOstrstreamToString(str);
+        }}
+        BOOST_CHECK_EQUAL(count, kCount);
+
+        count = 0;
+        {{
+            CNcbiIstrstream str(data);
+            unique_ptr<CObjectIStream> in(CObjectIStream::Open(format, str));
+            CObjectTypeInfo(CType<CDirect_Item>()).FindMember("name").
+                SetLocalReadHook(*in, new CCountReadNameHook(count));
+            CDirect_Items items_copy;
+            *in >> items_copy;
+            BOOST_CHECK(items_copy.Equals(*items));
+        }}
+        BOOST_CHECK_EQUAL(count, kCount);
+
+        count = 0;
+        {{
+            CNcbiIstrstream str(data);
+            unique_ptr<CObjectIStream> in(CObjectIStream::Open(format, str));
+            // elements of SEQUENCE OF add nothing to the path
+            in->SetPathReadMemberHook("Direct-Items.name",
+                                      new CCountReadNameHook(count));
+            CDirect_Items items_copy;
+            *in >> items_copy;
+            BOOST_CHECK(items_copy.Equals(*items));
+        }}
+        BOOST_CHECK_EQUAL(count, kCount);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(s_TestInvalidData)
+{
+    // Direct-Item ::= { name "a", id 1 } in ASN.1 binary:
+    //   30 80  A0 80 1A 01 61 00 00  A1 80 02 01 01 00 00  00 00
+    {{
+        CDirect_Item item;
+        item.SetName("a");
+        item.SetId(1);
+        CNcbiOstrstream str;
+        str << MSerial_AsnBinary << item;
+        BOOST_REQUIRE_EQUAL(CNcbiOstrstreamToString(str),
+                            string("\x30\x80\xA0\x80\x1A\x01" "a" "\0\0"
+                                   "\xA1\x80\x02\x01\x01\0\0\0\0", 18));
+    }}
+    // missing mandatory member id
+    BOOST_CHECK_THROW(s_ReadItem(string("\x30\x80\xA0\x80\x1A\x01" "a"
+                                        "\0\0\0\0", 11),
+                                 eSerial_AsnBinary),
+                      CSerialException);
+    // name twice
+    BOOST_CHECK_THROW(s_ReadItem(string("\x30\x80\xA0\x80\x1A\x01" "a" "\0\0"
+                                        "\xA0\x80\x1A\x01" "b" "\0\0"
+                                        "\xA1\x80\x02\x01\x01\0\0\0\0", 27),
+                                 eSerial_AsnBinary),
+                      CSerialException);
+
+    BOOST_CHECK_NO_THROW(s_ReadItem("{ \"Direct_Item\": "
+                                    "{ \"name\": \"a\", \"id\": 1 } }",
+                                    eSerial_Json));
+    BOOST_CHECK_THROW(s_ReadItem("{ \"Direct_Item\": { \"name\": \"a\" } }",
+                                 eSerial_Json),
+                      CSerialException);
+    BOOST_CHECK_THROW(s_ReadItem("{ \"Direct_Item\": "
+                                 "{ \"name\": \"a\", \"id\": 1, \"id\": 2 } }",
+                                 eSerial_Json),
+                      CSerialException);
+}
+
+
+// Must be the last test: switches the classes to type info I/O for good
+BOOST_AUTO_TEST_CASE(s_TestSameAsTypeInfo)
+{
+    CRef<CDirect_Items> items = s_MakeItems();
+    vector<string> direct;
+    for ( auto format : kFormats ) {
+        direct.push_back(s_Write(*items, format));
+    }
+
+    const CClassTypeInfo* item_type = CTypeConverter<CClassTypeInfo>::
+        SafeCast(CDirect_Item::GetTypeInfo());
+    const CClassTypeInfo* info_type = CTypeConverter<CClassTypeInfo>::
+        SafeCast(CDirect_Info::GetTypeInfo());
+    const_cast<CClassTypeInfo*>(item_type)->SetDirectFunctions(0, 0);
+    const_cast<CClassTypeInfo*>(info_type)->SetDirectFunctions(0, 0);
+
+    for ( size_t i = 0; i < ArraySize(kFormats); ++i ) {
+        string data = s_Write(*items, kFormats[i]);
+        BOOST_CHECK(data == direct[i]);
+        BOOST_CHECK(s_Read(direct[i], kFormats[i])->Equals(*items));
+    }
+}
@@ -709,6 +709,99 @@ BOOST_AUTO_TEST_CASE(s_TestMemberHooks)
 #endif
 }
 
+#ifndef HAVE_NCBI_C
+/////////////////////////////////////////////////////////////////////////////
+// TestParallelReadHook
+
+// Local read hook of element streams, counting parsed arguments
+class CCountArgumentHook : public CReadObjectHook
+{
+public:
+    CCountArgumentHook(atomic<int>& count)
+        : m_Count(count) {}
+    virtual void ReadObject(CObjectIStream& in, const CObjectInfo& object)
+        {
+            DefaultRead(in, object);
+            ++m_Count;
+        }
+private:
+    atomic<int>& m_Count;
+};
+
+class CCountingParallelReadHook : public CParallelReadClassMemberHook
+{
+public:
+    CCountingParallelReadHook(atomic<int>& count)
+        : CParallelReadClassMemberHook(4, 256), m_Count(count) {}
+protected:
+    virtual void InitElementStream(CObjectIStream& in)
+        {
+            CObjectTypeInfo(CType<CArgument>()).SetLocalReadHook(
+                in, new CCountArgumentHook(m_Count));
+        }
+private:
+    atomic<int>& m_Count;
+};
+
+BOOST_AUTO_TEST_CASE(s_TestParallelReadHook)
+{
+    const int kCount = 1000;
+    CWeb_Env env;
+    for ( int i = 0; i < kCount; ++i ) {
+        CRef<CArgument> arg(new CArgument);
+        arg->SetName("arg" + NStr::IntToString(i));
+        arg->SetValue(string(i % 50, 'v'));
+        env.SetArguments().push_back(arg);
+    }
+    string data;
+    {
+        CNcbiOstrstream ostrs;
+        ostrs << MSerial_AsnBinary << env;
+        data = CNcbiOstrstreamToString(ostrs);
+    }
+    {
+        // sequential read, for comparison
+        CNcbiIstrstream istrs(data);
+        CWeb_Env env_copy;
+        istrs >> MSerial_AsnBinary >> env_copy;
+        BOOST_CHECK(SerialEquals<CWeb_Env>(env, env_copy));
+    }
+    {
+        // parallel read gives the same elements in the same order,
+        // and they are parsed by the element streams
+        atomic<int> count(0);
+        CNcbiIstrstream istrs(data);
+        unique_ptr<CObjectIStream> is(
+            CObjectIStream::Open(eSerial_AsnBinary, istrs));
+        is->SetPathReadMemberHook("Web-Env.arguments",
+                                  new CCountingParallelReadHook(count));
+        CWeb_Env env_copy;
+        *is >> env_copy;
+        BOOST_CHECK(SerialEquals<CWeb_Env>(env, env_copy));
+        BOOST_CHECK_EQUAL(count.load(), kCount);
+    }
+    {
+        // unknown member in one element is reported to the caller;
+        // the element is still skipped fine by the main stream
+        string name("arg500");
+        size_t pos = data.find(name);
+        BOOST_REQUIRE(pos != NPOS);
+        pos += name.size();
+        // end of name member, then tag of value member
+        BOOST_REQUIRE(data.substr(pos, 3) == string("\0\0\xa1", 3));
+        data[pos + 2] = '\xa5';
+        atomic<int> count(0);
+        CNcbiIstrstream istrs(data);
+        unique_ptr<CObjectIStream> is(
+            CObjectIStream::Open(eSerial_AsnBinary, istrs));
+        is->SetPathReadMemberHook("Web-Env.arguments",
+                                  new CCountingParallelReadHook(count));
+        CWeb_Env env_copy;
+        BOOST_CHECK_THROW(*is >> env_copy, CSerialException);
+    }
+}
+#endif
+
 /////////////////////////////////////////////////////////////////////////////
 // Test iterators
 
@@ -970,6 +1063,18 @@ BOOST_AUTO_TEST_CASE(s_TestSerialization2)
                 CObjectIStream::Open(bin_in,eSerial_AsnBinary));
             in->Skip(ObjectType(read));
         }
+        {
+            // read ASN binary directly from memory mapped file
+            CTestSerialObject read_mapped;
+            unique_ptr<CObjectIStream> in(
+                CObjectIStream::Open(eSerial_AsnBinary, bin_in,
+                                     eSerial_MemoryMap));
+            BOOST_CHECK(in->IsMemoryMapped());
+            *in >> read_mapped;
+            BOOST_CHECK(SerialEquals<CTestSerialObject>(read_mapped, read));
+            in->Close();
+            BOOST_CHECK( !in->IsMemoryMapped() );
+        }
 #endif
     }
 #ifdef HAVE_NCBI_C
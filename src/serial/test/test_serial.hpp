@@ -15,12 +15,14 @@
 #include "cppwebenv.hpp"
 #include <serial/serialimpl.hpp>
 #include <serial/streamiter.hpp>
+#include <serial/parallelhook.hpp>
 
 #ifdef HAVE_NCBI_C
 # include <asn.h>
 # include "twebenv.h"
 #else
 # include <serial/test/Web_Env.hpp>
+# include <serial/test/Argument.hpp>
 #endif
 
 #include <corelib/ncbifile.hpp>
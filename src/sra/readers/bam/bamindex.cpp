@@ -38,6 +38,9 @@
 #include <corelib/rwstream.hpp>
 #include <util/util_exception.hpp>
 #include <util/timsort.hpp>
+#include <util/checksum.hpp>
+#include <corelib/ncbifile.hpp>
+#include <corelib/ncbi_process.hpp>
 #include <objects/seq/Seq_annot.hpp>
 #include <objects/seqres/seqres__.hpp>
 #include <objects/seqloc/seqloc__.hpp>
@@ -73,6 +76,10 @@ NCBI_PARAM_DEF_EX(bool, BAM, PREFER_CSI, false, eParam_NoThread, BAM_PREFER_CSI)
 #endif
 static const float kEstimatedCompression = 0.25;
 
+static const char kIndexCacheExt[] = ".bamidx";
+NCBI_PARAM_DECL(string, BAM, INDEX_CACHE_DIR);
+NCBI_PARAM_DEF_EX(string, BAM, INDEX_CACHE_DIR, "", eParam_NoThread, BAM_INDEX_CACHE_DIR);
+
 static inline
 void s_Read(CNcbiIstream& in, char* dst, size_t len)
 {
@@ -1160,6 +1167,249 @@ static size_t ReadVDBFile(AutoArray<char>& data, const string& path)
 }
 
 
+/////////////////////////////////////////////////////////////////////////////
+// CBamIndex::CCacheFile
+/////////////////////////////////////////////////////////////////////////////
+
+// Cache file layout, all numbers are little-endian, sections are 8-aligned:
+//   header (kIndexCacheHeaderSize bytes, see offsets below)
+//   SAM header text
+//   reference table: { u64 data offset, u32 ref length, u32 name size }
+//   reference names
+//   reference data blocks:
+//     block header (kIndexCacheRefHeaderSize bytes, see offsets below)
+//     bins: { u32 bin, u32 chunk count, u64 overlap }
+//     chunks of all bins: { u64 begin, u64 end }
+//     linear index: { u64 overlap }
+static const size_t kIndexCacheMagicLength = 8;
+static const char kIndexCacheMagic[] = "NCBIBAMC";
+static const Uint4 kIndexCacheVersion = 1;
+
+enum EIndexCacheHeader {
+    eCache_Magic         = 0,
+    eCache_Version       = 8,
+    eCache_IsCSI         = 12,
+    eCache_MinShift      = 16,
+    eCache_Depth         = 20,
+    eCache_BamSize       = 24,
+    eCache_BamTime       = 32,
+    eCache_IndexSize     = 40,
+    eCache_IndexTime     = 48,
+    eCache_TotalSize     = 56,
+    eCache_UnmappedCount = 64,
+    eCache_AlignStart    = 72,
+    eCache_TextSize      = 80,
+    eCache_RefCount      = 88,
+    kIndexCacheHeaderSize = 96
+};
+
+enum EIndexCacheRefHeader {
+    eCacheRef_BinCount      = 0,
+    eCacheRef_OverlapCount  = 4,
+    eCacheRef_ChunkCount    = 8,
+    eCacheRef_UnmappedBegin = 16,
+    eCacheRef_UnmappedEnd   = 24,
+    eCacheRef_MappedCount   = 32,
+    eCacheRef_UnmappedCount = 40,
+    eCacheRef_Length        = 48,
+    kIndexCacheRefHeaderSize = 56
+};
+
+static const size_t kIndexCacheRefEntrySize = 16;
+static const size_t kIndexCacheBinSize = 16;
+static const size_t kIndexCacheChunkSize = 16;
+static const size_t kIndexCacheOverlapSize = 8;
+
+
+static inline
+void s_Append(string& dst, Uint4 value)
+{
+    char buf[4];
+    for ( int i = 0; i < 4; ++i ) {
+        buf[i] = char(value >> (8*i));
+    }
+    dst.append(buf, 4);
+}
+
+
+static inline
+void s_Append(string& dst, Uint8 value)
+{
+    char buf[8];
+    for ( int i = 0; i < 8; ++i ) {
+        buf[i] = char(value >> (8*i));
+    }
+    dst.append(buf, 8);
+}
+
+
+static inline
+void s_Set(string& dst, size_t offset, Uint8 value)
+{
+    for ( int i = 0; i < 8; ++i ) {
+        dst[offset+i] = char(value >> (8*i));
+    }
+}
+
+
+static inline
+void s_AlignCache(string& dst)
+{
+    dst.resize((dst.size()+7)&~size_t(7));
+}
+
+
+static inline
+size_t s_AlignCache(size_t offset)
+{
+    return (offset+7)&~size_t(7);
+}
+
+
+// return false if the file isn't a local file
+static bool s_GetFileStamp(const string& file_name, Uint8& size, Uint8& mtime)
+{
+    CFile file(file_name);
+    if ( !file.IsFile() ) {
+        return false;
+    }
+    time_t modification;
+    if ( !file.GetTimeT(&modification) ) {
+        return false;
+    }
+    Int8 length = file.GetLength();
+    if ( length < 0 ) {
+        return false;
+    }
+    size = Uint8(length);
+    mtime = Uint8(Int8(modification));
+    return true;
+}
+
+
+class CBamIndex::CCacheFile : public CObject
+{
+public:
+    explicit
+    CCacheFile(const string& file_name)
+        : m_File(file_name, CMemoryFile::eMMP_Read, CMemoryFile::eMMS_Shared)
+        {
+            m_Ptr = static_cast<const char*>(m_File.Map());
+            m_Size = m_File.GetSize();
+            if ( !m_Ptr ) {
+                NCBI_THROW_FMT(CBamException, eInvalidBAIFormat,
+                               "Cannot map BAM index cache "<<file_name);
+            }
+        }
+
+    const char* GetPtr() const
+        {
+            return m_Ptr;
+        }
+    size_t GetSize() const
+        {
+            return m_Size;
+        }
+
+    void SetRefOffsets(vector<size_t>&& offsets)
+        {
+            m_RefOffsets = move(offsets);
+            m_RefLoaded.reset(new atomic<bool>[m_RefOffsets.size()]);
+            for ( size_t i = 0; i < m_RefOffsets.size(); ++i ) {
+                m_RefLoaded[i].store(false, memory_order_relaxed);
+            }
+        }
+    bool IsLoaded(size_t ref_index) const
+        {
+            return m_RefLoaded[ref_index].load(memory_order_acquire);
+        }
+    void LoadRef(size_t ref_index, SBamIndexRefIndex& ref, SBamIndexParams params) const
+        {
+            if ( IsLoaded(ref_index) ) {
+                return;
+            }
+            CFastMutexGuard guard(m_Mutex);
+            if ( IsLoaded(ref_index) ) {
+                return;
+            }
+            x_LoadRef(m_RefOffsets[ref_index], ref, params);
+            m_RefLoaded[ref_index].store(true, memory_order_release);
+        }
+
+private:
+    void x_LoadRef(size_t offset, SBamIndexRefIndex& ref, SBamIndexParams params) const;
+
+    CMemoryFile m_File;
+    const char* m_Ptr;
+    size_t m_Size;
+    vector<size_t> m_RefOffsets;
+    unique_ptr<atomic<bool>[]> m_RefLoaded;
+    mutable CFastMutex m_Mutex;
+};
+
+
+static inline
+const char* s_ReadArray(const char*& ptr, const char* end,
+                        Uint8 count, size_t element_size)
+{
+    if ( ptr > end || count > Uint8(end-ptr)/element_size ) {
+        NCBI_THROW(CBamException, eInvalidBAIFormat,
+                   "BAM index cache is truncated");
+    }
+    return s_Read(ptr, end, size_t(count)*element_size);
+}
+
+
+void CBamIndex::CCacheFile::x_LoadRef(size_t offset,
+                                      SBamIndexRefIndex& ref,
+                                      SBamIndexParams params) const
+{
+    // the data was validated when the cache was written,
+    // so only the bounds are checked here
+    const char* ptr = m_Ptr + offset;
+    const char* end = m_Ptr + m_Size;
+    const char* header = s_ReadArray(ptr, end, 1, kIndexCacheRefHeaderSize);
+    size_t n_bins = SBamUtil::MakeUint4(header+eCacheRef_BinCount);
+    size_t n_overlaps = SBamUtil::MakeUint4(header+eCacheRef_OverlapCount);
+    Uint8 n_chunks = SBamUtil::MakeUint8(header+eCacheRef_ChunkCount);
+    const char* bins = s_ReadArray(ptr, end, n_bins, kIndexCacheBinSize);
+    const char* chunks = s_ReadArray(ptr, end, n_chunks, kIndexCacheChunkSize);
+    const char* overlaps = s_ReadArray(ptr, end, n_overlaps, kIndexCacheOverlapSize);
+    
+    ref.SBamIndexParams::operator=(params);
+    ref.m_UnmappedChunk =
+        CBGZFRange(CBGZFPos(SBamUtil::MakeUint8(header+eCacheRef_UnmappedBegin)),
+                   CBGZFPos(SBamUtil::MakeUint8(header+eCacheRef_UnmappedEnd)));
+    ref.m_MappedCount = SBamUtil::MakeUint8(header+eCacheRef_MappedCount);
+    ref.m_UnmappedCount = SBamUtil::MakeUint8(header+eCacheRef_UnmappedCount);
+    ref.m_EstimatedLength = SBamUtil::MakeUint4(header+eCacheRef_Length);
+
+    ref.m_Bins.resize(n_bins);
+    const char* chunks_end = chunks + n_chunks*kIndexCacheChunkSize;
+    for ( size_t i = 0; i < n_bins; ++i ) {
+        const char* bin_ptr = bins + i*kIndexCacheBinSize;
+        SBamIndexBinInfo& bin = ref.m_Bins[i];
+        bin.m_Bin = SBamUtil::MakeUint4(bin_ptr);
+        size_t bin_chunks = SBamUtil::MakeUint4(bin_ptr+4);
+#ifdef BAM_SUPPORT_CSI
+        bin.m_Overlap = CBGZFPos(SBamUtil::MakeUint8(bin_ptr+8));
+#endif
+        const char* data = s_ReadArray(chunks, chunks_end,
+                                       bin_chunks, kIndexCacheChunkSize);
+        bin.m_Chunks.resize(bin_chunks);
+        for ( size_t j = 0; j < bin_chunks; ++j ) {
+            bin.m_Chunks[j] =
+                CBGZFRange(CBGZFPos(SBamUtil::MakeUint8(data+j*16)),
+                           CBGZFPos(SBamUtil::MakeUint8(data+j*16+8)));
+        }
+    }
+    ref.m_Overlaps.resize(n_overlaps);
+    for ( size_t i = 0; i < n_overlaps; ++i ) {
+        ref.m_Overlaps[i] = CBGZFPos(SBamUtil::MakeUint8(overlaps+i*8));
+    }
+}
+
+
 /////////////////////////////////////////////////////////////////////////////
 // CBamIndex
 /////////////////////////////////////////////////////////////////////////////
@@ -1192,6 +1442,7 @@ void CBamIndex::Read(const string& index_file_name)
     m_FileName = index_file_name;
     m_Refs.clear();
     m_UnmappedCount = 0;
+    m_CacheFile = null;
 
     AutoArray<char> data;
     CStopWatch sw(CStopWatch::eStart);
@@ -1249,6 +1500,7 @@ END_LOCAL_NAMESPACE;
 
 void CBamIndex::Read(CNcbiIstream& in)
 {
+    m_CacheFile = null;
 #ifdef BAM_SUPPORT_CSI
     is_CSI = false;
     min_shift = kBAI_min_shift;
@@ -1317,6 +1569,7 @@ void CBamIndex::Read(const char* buffer_ptr, size_t buffer_size)
     }
     
     const char* buffer_end = buffer_ptr + buffer_size;
+    m_CacheFile = null;
 
 #ifdef BAM_SUPPORT_CSI
     is_CSI = false;
@@ -1366,6 +1619,9 @@ const SBamIndexRefIndex& CBamIndex::GetRef(size_t ref_index) const
         NCBI_THROW(CBamException, eInvalidArg,
                    "Bad reference sequence index");
     }
+    if ( m_CacheFile ) {
+        m_CacheFile->LoadRef(ref_index, m_Refs[ref_index], *this);
+    }
     return m_Refs[ref_index];
 }
 
@@ -1378,6 +1634,10 @@ void CBamIndex::SetLengthFromHeader(const CBamHeader& header)
                        GetRefCount()<<" <> "<<header.GetRefCount());
     }
     for ( size_t i = 0; i < GetRefCount(); ++i ) {
+        if ( m_CacheFile && !m_CacheFile->IsLoaded(i) ) {
+            // cached length already includes the header's one
+            continue;
+        }
         m_Refs[i].SetLengthFromHeader(header.GetRef(i).m_Length);
     }
 }
@@ -1398,6 +1658,230 @@ CBGZFRange CBamIndex::GetTotalFileRange(size_t ref_index) const
 }
 
 
+bool CBamIndex::ReadCache(const string& cache_file_name,
+                          const string& bam_file_name,
+                          const string& index_file_name,
+                          CBamHeader& header)
+{
+    Uint8 bam_size, bam_time, index_size, index_time;
+    if ( !s_GetFileStamp(bam_file_name, bam_size, bam_time) ||
+         !s_GetFileStamp(index_file_name, index_size, index_time) ||
+         !CFile(cache_file_name).IsFile() ) {
+        return false;
+    }
+    CStopWatch sw(CStopWatch::eStart);
+    CRef<CCacheFile> cache;
+    const char* ptr;
+    const char* end;
+    try {
+        cache = new CCacheFile(cache_file_name);
+        ptr = cache->GetPtr();
+        end = ptr + cache->GetSize();
+        const char* data = s_ReadArray(ptr, end, 1, kIndexCacheHeaderSize);
+        if ( memcmp(data+eCache_Magic, kIndexCacheMagic, kIndexCacheMagicLength) != 0 ||
+             SBamUtil::MakeUint4(data+eCache_Version) != kIndexCacheVersion ||
+             SBamUtil::MakeUint8(data+eCache_TotalSize) != cache->GetSize() ) {
+            ERR_POST(Warning<<"BAM: ignoring bad index cache "<<cache_file_name);
+            return false;
+        }
+        if ( SBamUtil::MakeUint8(data+eCache_BamSize) != bam_size ||
+             SBamUtil::MakeUint8(data+eCache_BamTime) != bam_time ||
+             SBamUtil::MakeUint8(data+eCache_IndexSize) != index_size ||
+             SBamUtil::MakeUint8(data+eCache_IndexTime) != index_time ) {
+            // stale cache, will be overwritten
+            return false;
+        }
+        
+        SBamIndexParams params;
+#ifdef BAM_SUPPORT_CSI
+        params.is_CSI = SBamUtil::MakeUint4(data+eCache_IsCSI) != 0;
+        params.min_shift = TShift(SBamUtil::MakeUint4(data+eCache_MinShift));
+        params.depth = TIndexLevel(SBamUtil::MakeUint4(data+eCache_Depth));
+#else
+        if ( SBamUtil::MakeUint4(data+eCache_IsCSI) ) {
+            return false;
+        }
+#endif
+        Uint8 unmapped_count = SBamUtil::MakeUint8(data+eCache_UnmappedCount);
+        CBGZFPos align_start(SBamUtil::MakeUint8(data+eCache_AlignStart));
+        Uint8 text_size = SBamUtil::MakeUint8(data+eCache_TextSize);
+        Uint8 n_ref = SBamUtil::MakeUint8(data+eCache_RefCount);
+
+        const char* text = s_ReadArray(ptr, end, text_size, 1);
+        ptr = cache->GetPtr() + s_AlignCache(ptr - cache->GetPtr());
+        const char* ref_table = s_ReadArray(ptr, end, n_ref, kIndexCacheRefEntrySize);
+        
+        CBamHeader::TRefs header_refs(n_ref);
+        vector<size_t> ref_offsets(n_ref);
+        for ( size_t i = 0; i < n_ref; ++i ) {
+            const char* entry = ref_table + i*kIndexCacheRefEntrySize;
+            Uint8 offset = SBamUtil::MakeUint8(entry);
+            if ( offset > cache->GetSize()-kIndexCacheRefHeaderSize ) {
+                NCBI_THROW(CBamException, eInvalidBAIFormat,
+                           "BAM index cache is truncated");
+            }
+            ref_offsets[i] = size_t(offset);
+            header_refs[i].m_Length = SBamUtil::MakeUint4(entry+8);
+            size_t name_size = SBamUtil::MakeUint4(entry+12);
+            header_refs[i].m_Name.assign(s_ReadArray(ptr, end, name_size, 1), name_size);
+        }
+        cache->SetRefOffsets(move(ref_offsets));
+
+        // everything is valid, now update the objects
+        header.m_Text.assign(text, size_t(text_size));
+        header.m_Refs.swap(header_refs);
+        header.m_RefByName.clear();
+        for ( size_t i = 0; i < header.m_Refs.size(); ++i ) {
+            header.m_RefByName[header.m_Refs[i].m_Name] = i;
+        }
+        header.m_AlignStart = align_start;
+
+        SBamIndexParams::operator=(params);
+        m_FileName = index_file_name;
+        m_UnmappedCount = unmapped_count;
+        m_Refs.clear();
+        m_Refs.resize(n_ref);
+        m_CacheFile = cache;
+    }
+    catch ( CException& exc ) {
+        ERR_POST(Warning<<"BAM: cannot read index cache "<<cache_file_name<<": "<<exc);
+        return false;
+    }
+    // the index data is loaded lazily, so there's no read statistics
+    m_TotalReadBytes = 0;
+    m_TotalReadSeconds = 0;
+    if ( CBamDb::GetDebugLevel() >= 3 ) {
+        LOG_POST("BAM: mapped index cache "<<cache_file_name<<
+                 " in "<<sw.Elapsed()<<" s");
+    }
+    return true;
+}
+
+
+void CBamIndex::WriteCache(const string& cache_file_name,
+                           const string& bam_file_name,
+                           const CBamHeader& header) const
+{
+    Uint8 bam_size, bam_time, index_size, index_time;
+    if ( !s_GetFileStamp(bam_file_name, bam_size, bam_time) ||
+         !s_GetFileStamp(GetFileName(), index_size, index_time) ) {
+        NCBI_THROW_FMT(CBamException, eInvalidArg,
+                       "BAM index cache requires local files: "<<
+                       bam_file_name<<" "<<GetFileName());
+    }
+    const TRefs& refs = GetRefs();
+    if ( refs.size() != header.GetRefCount() ) {
+        NCBI_THROW_FMT(CBamException, eInvalidBAIFormat,
+                       "Wrong index ref count: "<<
+                       refs.size()<<" <> "<<header.GetRefCount());
+    }
+
+    string data;
+    data.append(kIndexCacheMagic, kIndexCacheMagicLength);
+    s_Append(data, kIndexCacheVersion);
+    s_Append(data, Uint4(is_CSI));
+    s_Append(data, Uint4(GetMinLevelBinShift()));
+    s_Append(data, Uint4(GetMaxIndexLevel()));
+    s_Append(data, bam_size);
+    s_Append(data, bam_time);
+    s_Append(data, index_size);
+    s_Append(data, index_time);
+    s_Append(data, Uint8(0)); // total size, set at the end
+    s_Append(data, m_UnmappedCount);
+    s_Append(data, header.GetAlignStart().GetVirtualPos());
+    s_Append(data, Uint8(header.GetText().size()));
+    s_Append(data, Uint8(refs.size()));
+    _ASSERT(data.size() == kIndexCacheHeaderSize);
+    data += header.GetText();
+    s_AlignCache(data);
+
+    size_t ref_table = data.size();
+    size_t names_size = 0;
+    for ( auto& ref : header.GetRefs() ) {
+        s_Append(data, Uint8(0)); // data offset, set below
+        s_Append(data, Uint4(ref.m_Length));
+        s_Append(data, Uint4(ref.m_Name.size()));
+        names_size += ref.m_Name.size();
+    }
+    data.reserve(s_AlignCache(data.size()+names_size));
+    for ( auto& ref : header.GetRefs() ) {
+        data += ref.m_Name;
+    }
+    s_AlignCache(data);
+
+    for ( size_t i = 0; i < refs.size(); ++i ) {
+        const SBamIndexRefIndex& ref = refs[i];
+        s_Set(data, ref_table + i*kIndexCacheRefEntrySize, data.size());
+        Uint8 n_chunks = 0;
+        for ( auto& bin : ref.m_Bins ) {
+            n_chunks += bin.m_Chunks.size();
+        }
+        s_Append(data, Uint4(ref.m_Bins.size()));
+        s_Append(data, Uint4(ref.m_Overlaps.size()));
+        s_Append(data, n_chunks);
+        s_Append(data, ref.m_UnmappedChunk.first.GetVirtualPos());
+        s_Append(data, ref.m_UnmappedChunk.second.GetVirtualPos());
+        s_Append(data, ref.m_MappedCount);
+        s_Append(data, ref.m_UnmappedCount);
+        s_Append(data, Uint4(ref.m_EstimatedLength));
+        s_Append(data, Uint4(0));
+        for ( auto& bin : ref.m_Bins ) {
+            s_Append(data, Uint4(bin.m_Bin));
+            s_Append(data, Uint4(bin.m_Chunks.size()));
+#ifdef BAM_SUPPORT_CSI
+            s_Append(data, bin.m_Overlap.GetVirtualPos());
+#else
+            s_Append(data, Uint8(0));
+#endif
+        }
+        for ( auto& bin : ref.m_Bins ) {
+            for ( auto& chunk : bin.m_Chunks ) {
+                s_Append(data, chunk.first.GetVirtualPos());
+                s_Append(data, chunk.second.GetVirtualPos());
+            }
+        }
+        for ( auto& overlap : ref.m_Overlaps ) {
+            s_Append(data, overlap.GetVirtualPos());
+        }
+    }
+    s_Set(data, eCache_TotalSize, data.size());
+
+    // write into a temporary file and rename it to make the update atomic
+    // for concurrent readers and writers
+    string tmp_file_name =
+        cache_file_name+'.'+NStr::NumericToString(CCurrentProcess::GetPid())+".tmp";
+    try {
+        {{
+            CNcbiOfstream out(tmp_file_name.c_str(), IOS_BASE::binary);
+            out.write(data.data(), data.size());
+            if ( !out ) {
+                NCBI_THROW_FMT(CIOException, eWrite,
+                               "Cannot write BAM index cache "<<tmp_file_name);
+            }
+        }}
+        if ( !CFile(tmp_file_name).Rename(cache_file_name, CFile::fRF_Overwrite) ) {
+            NCBI_THROW_FMT(CIOException, eWrite,
+                           "Cannot rename BAM index cache "<<tmp_file_name);
+        }
+    }
+    catch ( ... ) {
+        CFile(tmp_file_name).Remove();
+        throw;
+    }
+}
+
+
+const CBamIndex::TRefs& CBamIndex::GetRefs() const
+{
+    if ( m_CacheFile ) {
+        for ( size_t i = 0; i < m_Refs.size(); ++i ) {
+            m_CacheFile->LoadRef(i, m_Refs[i], *this);
+        }
+    }
+    return m_Refs;
+}
+
+
 static void sx_SetTitle(CSeq_graph& graph, CSeq_annot& annot,
                         string title, string name)
 {
@@ -1982,6 +2466,39 @@ static void s_AddReplacedExt(vector<string>& dst,
 }
 
 
+string CBamRawDb::GetIndexCacheDir()
+{
+    return NCBI_PARAM_TYPE(BAM, INDEX_CACHE_DIR)::GetDefault();
+}
+
+
+void CBamRawDb::SetIndexCacheDir(const string& dir)
+{
+    NCBI_PARAM_TYPE(BAM, INDEX_CACHE_DIR)::SetDefault(dir);
+}
+
+
+// return index cache file name, or empty string if the cache is disabled
+static string s_GetIndexCacheFileName(const string& bam_path,
+                                      const string& index_path)
+{
+    string cache_dir = CBamRawDb::GetIndexCacheDir();
+    if ( cache_dir.empty() ||
+         !CFile(bam_path).IsFile() || !CFile(index_path).IsFile() ) {
+        return string();
+    }
+    // different BAM files may have the same name
+    Uint8 hash;
+    CHash::Calculate(CDirEntry::CreateAbsolutePath(bam_path)+'\n'+
+                     CDirEntry::CreateAbsolutePath(index_path),
+                     CHash::eCityHash64, hash);
+    return CDirEntry::MakePath(cache_dir,
+                               CFile(bam_path).GetName()+'.'+
+                               NStr::UInt8ToString(hash, 0, 16)+
+                               kIndexCacheExt);
+}
+
+
 void CBamRawDb::Open(const string& bam_path, const string& index_path)
 {
     vector<string> index_name_candidates;
@@ -2005,7 +2522,16 @@ void CBamRawDb::Open(const string& bam_path, const string& index_path)
     else {
         index_name_candidates.push_back(index_path);
     }
+    string cache_file_name;
     for ( size_t i = 0; i < index_name_candidates.size(); ++i ) {
+        cache_file_name =
+            s_GetIndexCacheFileName(bam_path, index_name_candidates[i]);
+        if ( !cache_file_name.empty() &&
+             m_Index.ReadCache(cache_file_name, bam_path,
+                               index_name_candidates[i], m_Header) ) {
+            m_File = new CBGZFFile(bam_path);
+            return;
+        }
         try {
             m_Index.Read(index_name_candidates[i]);
             break;
@@ -2026,6 +2552,16 @@ void CBamRawDb::Open(const string& bam_path, const string& index_path)
     CBGZFStream stream(*m_File);
     m_Header.Read(stream);
     m_Index.SetLengthFromHeader(m_Header);
+    if ( !cache_file_name.empty() ) {
+        try {
+            CDir(CFile(cache_file_name).GetDir()).CreatePath();
+            m_Index.WriteCache(cache_file_name, bam_path, m_Header);
+        }
+        catch ( CException& exc ) {
+            ERR_POST(Warning<<"BAM: cannot write index cache "<<
+                     cache_file_name<<": "<<exc);
+        }
+    }
 }
 
 
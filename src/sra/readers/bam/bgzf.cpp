@@ -33,8 +33,10 @@
 #include <ncbi_pch.hpp>
 #include <sra/readers/bam/bgzf.hpp>
 #include <util/util_exception.hpp>
-#include <util/checksum.hpp>
 #include <util/compress/zlib/zlib.h>
+#include <algorithm>
+#include <thread>
+#include <condition_variable>
 
 BEGIN_NCBI_SCOPE
 
@@ -56,6 +58,17 @@ static int s_GetDebug(void)
 }
 
 
+NCBI_PARAM_DECL(int, BGZF, DECOMPRESS_THREADS);
+NCBI_PARAM_DEF_EX(int, BGZF, DECOMPRESS_THREADS, 0, eParam_NoThread, BGZF_DECOMPRESS_THREADS);
+
+
+static unsigned s_GetDecompressThreads(void)
+{
+    static int value = NCBI_PARAM_TYPE(BGZF, DECOMPRESS_THREADS)::GetDefault();
+    return max(value, 0);
+}
+
+
 enum EFileMode {
     eUseFileIO,
     eUseMemFile,
@@ -63,6 +76,8 @@ enum EFileMode {
 };
 static const EFileMode kFileMode = eUseVDBFile;
 static const bool kCheckBlockCRC32 = true;
+static const size_t kBlockCacheSize = 10;
+static const size_t kReadAheadBlocksPerThread = 4;
 #ifdef USE_RANGE_CACHE
 static const size_t kSegmentSizePow2Max = 22; // 4 MB
 static const size_t kSegmentSizePow2Min = 18; // 256 KB
@@ -360,17 +375,106 @@ CBGZFBlock::~CBGZFBlock()
 }
 
 
+class CBGZFFile::CDecompressPool
+{
+public:
+    CDecompressPool(CBGZFFile& file, unsigned threads, size_t max_queue)
+        : m_File(file),
+          m_MaxQueue(max_queue),
+          m_Stop(false)
+        {
+            for ( unsigned i = 0; i < threads; ++i ) {
+                m_Threads.push_back(thread([this] { x_Run(); }));
+            }
+        }
+    ~CDecompressPool()
+        {
+            {{
+                lock_guard<mutex> guard(m_Mutex);
+                m_Stop = true;
+            }}
+            m_Cond.notify_all();
+            for ( auto& t : m_Threads ) {
+                t.join();
+            }
+        }
+
+    bool Schedule(TFileBlockPos file_pos)
+        {
+            {{
+                lock_guard<mutex> guard(m_Mutex);
+                if ( m_Queue.size() >= m_MaxQueue ) {
+                    return false;
+                }
+                m_Queue.push_back(file_pos);
+            }}
+            m_Cond.notify_one();
+            return true;
+        }
+
+    void Cancel(const deque<TFileBlockPos>& file_poses)
+        {
+            lock_guard<mutex> guard(m_Mutex);
+            for ( auto file_pos : file_poses ) {
+                // other streams may have scheduled the same block, drop one
+                auto it = find(m_Queue.begin(), m_Queue.end(), file_pos);
+                if ( it != m_Queue.end() ) {
+                    m_Queue.erase(it);
+                }
+            }
+        }
+
+private:
+    void x_Run()
+        {
+            CPagedFile::TPage page;
+            CSimpleBufferT<char> buffer(CBGZFBlock::kMaxFileBlockSize);
+            for ( ;; ) {
+                TFileBlockPos file_pos;
+                {{
+                    unique_lock<mutex> guard(m_Mutex);
+                    m_Cond.wait(guard, [this] { return m_Stop || !m_Queue.empty(); });
+                    if ( m_Stop ) {
+                        break;
+                    }
+                    file_pos = m_Queue.front();
+                    m_Queue.pop_front();
+                }}
+                try {
+                    // decompressed block stays in the block cache
+                    m_File.GetBlock(file_pos, page, buffer);
+                }
+                catch ( exception& /*ignored*/ ) {
+                    // the error will be reported when the block is read
+                }
+                page.Reset();
+            }
+        }
+
+    CBGZFFile& m_File;
+    mutex m_Mutex;
+    condition_variable m_Cond;
+    deque<TFileBlockPos> m_Queue;
+    size_t m_MaxQueue;
+    bool m_Stop;
+    vector<thread> m_Threads;
+};
+
+
 CBGZFFile::CBGZFFile(const string& file_name)
     : m_File(new CPagedFile(file_name)),
-      m_BlockCache(new TBlockCache(10)),
+      m_BlockCache(new TBlockCache(kBlockCacheSize)),
       m_TotalUncompressBytes(0),
-      m_TotalUncompressSeconds(0)
+      m_TotalUncompressSeconds(0),
+      m_DecompressThreads(0)
 {
+    SetDecompressThreads(s_GetDecompressThreads());
 }
 
 
 CBGZFFile::~CBGZFFile()
 {
+    m_DecompressPool.reset();
     if ( s_GetDebug() >= 1 ) {
         auto stat = GetUncompressStatistics();
         if ( stat.first ) {
@@ -399,6 +503,43 @@ CBGZFFile::TBlock CBGZFFile::GetBlock(TFileBlockPos file_pos,
 }
 
 
+void CBGZFFile::SetDecompressThreads(unsigned threads)
+{
+    if ( threads == m_DecompressThreads ) {
+        return;
+    }
+    m_DecompressPool.reset();
+    m_DecompressThreads = threads;
+    if ( threads ) {
+        // several streams may read ahead in the same file
+        m_DecompressPool.reset(new CDecompressPool(*this, threads,
+                                                   2*GetReadAheadBlocks()));
+    }
+    // keep read-ahead blocks in cache until they are used
+    m_BlockCache->set_size_limit(kBlockCacheSize + 2*GetReadAheadBlocks());
+}
+
+
+size_t CBGZFFile::GetReadAheadBlocks() const
+{
+    return m_DecompressThreads*kReadAheadBlocksPerThread;
+}
+
+
+bool CBGZFFile::x_ScheduleBlock(TFileBlockPos file_pos)
+{
+    return m_DecompressPool && m_DecompressPool->Schedule(file_pos);
+}
+
+
+void CBGZFFile::x_CancelBlocks(const deque<TFileBlockPos>& file_poses)
+{
+    if ( m_DecompressPool ) {
+        m_DecompressPool->Cancel(file_poses);
+    }
+}
+
+
 pair<Uint8, double> CBGZFFile::GetUncompressStatistics() const
 {
     CFastMutexGuard guard(m_StatMutex);
@@ -416,7 +557,8 @@ void CBGZFFile::x_AddUncompressStatistics(Uint8 bytes, double seconds)
 
 CBGZFStream::CBGZFStream()
     : m_ReadPos(0),
-      m_EndPos(CBGZFPos::GetInvalid())
+      m_EndPos(CBGZFPos::GetInvalid()),
+      m_ReadAheadPos(0)
 {
 }
 
@@ -424,7 +566,8 @@ CBGZFStream::CBGZFStream()
 CBGZFStream::CBGZFStream(CBGZFFile& file)
     : m_ReadPos(0),
       m_InReadBuffer(CBGZFBlock::kMaxFileBlockSize),
-      m_EndPos(CBGZFPos::GetInvalid())
+      m_EndPos(CBGZFPos::GetInvalid()),
+      m_ReadAheadPos(0)
 {
     Open(file);
 }
@@ -439,6 +582,10 @@ void CBGZFStream::Close()
 {
     m_Block.Reset();
     m_Page.Reset();
+    m_ReadAheadPage.Reset();
+    if ( m_File ) {
+        x_CancelReadAhead();
+    }
     m_File.Reset();
 }
 
@@ -455,23 +602,87 @@ bool CBGZFStream::x_NextBlock()
 {
     m_Block = m_File->GetBlock(GetNextBlockFilePos(), m_Page, m_InReadBuffer);
     m_ReadPos = 0;
+    x_ReadAhead();
     return m_Block;
 }
 
 
+void CBGZFStream::x_ReadAhead()
+{
+    size_t max_blocks = m_File->GetReadAheadBlocks();
+    if ( !max_blocks || !m_Block ) {
+        return;
+    }
+    // forget already reached blocks
+    CBGZFPos::TFileBlockPos block_pos = GetBlockFilePos();
+    while ( !m_ReadAheadBlocks.empty() && m_ReadAheadBlocks.front() <= block_pos ) {
+        m_ReadAheadBlocks.pop_front();
+    }
+    if ( m_ReadAheadBlocks.empty() ||
+         m_ReadAheadBlocks.front() != GetNextBlockFilePos() ) {
+        // new sequence of blocks after seek
+        x_CancelReadAhead();
+        m_ReadAheadPos = GetNextBlockFilePos();
+    }
+    if ( m_ReadAheadBuffer.size() < CBGZFBlock::kMaxFileBlockSize ) {
+        m_ReadAheadBuffer.resize(CBGZFBlock::kMaxFileBlockSize);
+    }
+    // only headers are parsed here to find next blocks' positions
+    while ( m_ReadAheadBlocks.size() < max_blocks &&
+            CBGZFPos(m_ReadAheadPos, 0) < m_EndPos ) {
+        CBGZFBlock::TFileBlockSize block_size;
+        try {
+            size_t header_size;
+            block_size = m_File->x_ReadBlockHeader(m_ReadAheadPos,
+                                                   m_ReadAheadPage,
+                                                   m_ReadAheadBuffer,
+                                                   header_size);
+        }
+        catch ( CException& /*ignored*/ ) {
+            // EOF or bad block, it will be reported by regular read
+            break;
+        }
+        if ( !m_File->x_ScheduleBlock(m_ReadAheadPos) ) {
+            // the queue is full, try again on the next block
+            break;
+        }
+        m_ReadAheadBlocks.push_back(m_ReadAheadPos);
+        m_ReadAheadPos += block_size;
+    }
+}
+
+
+void CBGZFStream::x_CancelReadAhead()
+{
+    if ( !m_ReadAheadBlocks.empty() ) {
+        m_File->x_CancelBlocks(m_ReadAheadBlocks);
+        m_ReadAheadBlocks.clear();
+    }
+}
+
+
 void CBGZFStream::Seek(CBGZFPos pos, CBGZFPos end_pos)
 {
     m_EndPos = end_pos;
     if ( pos == GetPos() ) {
         return;
     }
-    m_Block = m_File->GetBlock(pos.GetFileBlockPos(), m_Page, m_InReadBuffer);
+    CBGZFPos::TFileBlockPos block_pos = pos.GetFileBlockPos();
+    if ( (!m_Block || block_pos != GetBlockFilePos()) &&
+         find(m_ReadAheadBlocks.begin(), m_ReadAheadBlocks.end(),
+              block_pos) == m_ReadAheadBlocks.end() ) {
+        // blocks scheduled for the old position are not needed now,
+        // don't let them delay decompression of the new ones
+        x_CancelReadAhead();
+    }
+    m_Block = m_File->GetBlock(block_pos, m_Page, m_InReadBuffer);
     m_ReadPos = pos.GetByteOffset();
     if ( m_ReadPos && !HaveBytesInBlock() ) {
         NCBI_THROW_FMT(CBGZFException, eInvalidArg,
                        "Bad BGZF("<<pos.GetFileBlockPos()<<") offset: "<<
                        m_ReadPos<<" vs "<<GetBlockDataSize());
     }
+    x_ReadAhead();
 }
 
 
@@ -481,23 +692,54 @@ static const size_t kRequiredExtraSize = kExtraHeaderSize + 2; // BSIZE block
 static const size_t kInitialExtraSize = kRequiredExtraSize;
 static const size_t kFooterSize = 8; // CRC & ISIZE
 
-bool CBGZFFile::x_ReadBlock(CBGZFBlock& block,
-                            TFileBlockPos file_pos0,
-                            CPagedFile::TPage& page,
-                            CSimpleBufferT<char>& buffer)
+
+// Raw inflate stream is allocated once per thread and reset for each block,
+// instead of allocating inflate state and window for every block.
+class CBGZFInflater
 {
-    try {
-        page = m_File->GetPage(file_pos0);
-    }
-    catch ( CBGZFException& exc ) {
-        if ( exc.GetErrCode() == exc.eFormatError &&
-             (page->GetFilePos()+page->GetPageSize() == file_pos0) ) {
-            // read past of the file
-            return false;
+public:
+    CBGZFInflater()
+        : m_Initialized(false)
+        {
+            memset(&m_Stream, 0, sizeof(m_Stream));
         }
-        throw;
-    }
-    
+    ~CBGZFInflater()
+        {
+            if ( m_Initialized ) {
+                inflateEnd(&m_Stream);
+            }
+        }
+
+    z_stream& GetStream()
+        {
+            int err;
+            if ( m_Initialized ) {
+                err = inflateReset(&m_Stream);
+            }
+            else {
+                err = inflateInit2(&m_Stream, -15);
+                m_Initialized = err == Z_OK;
+            }
+            if ( err != Z_OK ) {
+                NCBI_THROW_FMT(CBGZFException, eOtherError,
+                               "BGZF: cannot initialize inflate: "<<err);
+            }
+            return m_Stream;
+        }
+
+private:
+    z_stream m_Stream;
+    bool m_Initialized;
+};
+static thread_local CBGZFInflater s_Inflater;
+
+
+CBGZFBlock::TFileBlockSize
+CBGZFFile::x_ReadBlockHeader(TFileBlockPos file_pos0,
+                             CPagedFile::TPage& page,
+                             CSimpleBufferT<char>& buffer,
+                             size_t& header_size)
+{
     CBGZFPos::TFileBlockPos file_pos = file_pos0;
 
     // parse header
@@ -540,7 +782,7 @@ bool CBGZFFile::x_ReadBlock(CBGZFBlock& block,
         }
         extra = buffer.data();
     }
-    size_t real_header_size = kFixedHeaderSize + extra_size;
+    header_size = kFixedHeaderSize + extra_size;
 
     // parse extra data to determine BGZF block size
     CBGZFBlock::TFileBlockSize block_size = 0;
@@ -558,11 +800,37 @@ bool CBGZFFile::x_ReadBlock(CBGZFBlock& block,
         extra_size -= extra_block_size;
         extra += extra_block_size;
     }
-    if ( block_size <= real_header_size + kFooterSize ) {
+    if ( block_size <= header_size + kFooterSize ) {
         NCBI_THROW_FMT(CBGZFException, eFormatError,
                        "Bad BGZF("<<file_pos0<<") SIZE: "<<block_size);
     }
     
+    return block_size;
+}
+
+
+bool CBGZFFile::x_ReadBlock(CBGZFBlock& block,
+                            TFileBlockPos file_pos0,
+                            CPagedFile::TPage& page,
+                            CSimpleBufferT<char>& buffer)
+{
+    try {
+        page = m_File->GetPage(file_pos0);
+    }
+    catch ( CBGZFException& exc ) {
+        if ( exc.GetErrCode() == exc.eFormatError &&
+             (page->GetFilePos()+page->GetPageSize() == file_pos0) ) {
+            // read past of the file
+            return false;
+        }
+        throw;
+    }
+    
+    size_t real_header_size;
+    CBGZFBlock::TFileBlockSize block_size =
+        x_ReadBlockHeader(file_pos0, page, buffer, real_header_size);
+    CBGZFPos::TFileBlockPos file_pos = file_pos0 + real_header_size;
+    
     // read compressed data and footer
     _ASSERT(block_size <= CBGZFBlock::kMaxFileBlockSize);
     const char* compressed_data =
@@ -580,13 +848,11 @@ bool CBGZFFile::x_ReadBlock(CBGZFBlock& block,
         char* dst = block.m_Data.get();
         size_t dst_size = CBGZFBlock::kMaxDataSize;
 
-        z_stream stream;
+        z_stream& stream = s_Inflater.GetStream();
         stream.next_in = (Bytef*)src;
         stream.avail_in = (uInt)src_size;
         stream.next_out = (Bytef*)dst;
         stream.avail_out = (uInt)dst_size;
-        stream.zalloc = (alloc_func)0;
-        stream.zfree = (free_func)0;
         
         // Check for source > 64K on 16-bit machine:
         if ( stream.avail_in != src_size ||
@@ -596,13 +862,9 @@ bool CBGZFFile::x_ReadBlock(CBGZFBlock& block,
                            src_size<<" -> "<<dst_size);
         }
         
-        int err = inflateInit2(&stream, -15);
-        if ( err == Z_OK ) {
-            err = inflate(&stream, Z_FINISH);
-            if ( err == Z_STREAM_END ) {
-                decompressed_size = stream.total_out;
-            }
-            inflateEnd(&stream);
+        int err = inflate(&stream, Z_FINISH);
+        if ( err == Z_STREAM_END ) {
+            decompressed_size = stream.total_out;
         }
 
         double seconds = sw.Elapsed();
@@ -633,12 +895,14 @@ bool CBGZFFile::x_ReadBlock(CBGZFBlock& block,
                        decompressed_size<<" vs "<<data_size);
     }
     if ( kCheckBlockCRC32 ) {
-        CChecksum checksum(CChecksum::eCRC32ZIP);
-        checksum.AddChars(block.m_Data.get(), decompressed_size);
-        if ( checksum.GetChecksum() != crc32 ) {
+        // zlib's CRC32 is the same as CChecksum::eCRC32ZIP, but faster
+        CBGZFBlock::TCRC32 checksum =
+            CBGZFBlock::TCRC32(::crc32(0, (const Bytef*)block.m_Data.get(),
+                                       uInt(decompressed_size)));
+        if ( checksum != crc32 ) {
             NCBI_THROW_FMT(CBGZFException, eFormatError,
                            "Bad BGZF("<<file_pos0<<") CRC32: "<<
-                           hex<<Uint4(checksum.GetChecksum())<<" vs "<<crc32);
+                           hex<<checksum<<" vs "<<crc32);
         }
     }
 
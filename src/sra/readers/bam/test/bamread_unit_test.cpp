@@ -33,7 +33,9 @@
 #define NCBI_TEST_APPLICATION
 #include <ncbi_pch.hpp>
 #include <sra/readers/bam/bamread.hpp>
+#include <sra/readers/bam/bgzf.hpp>
 #include <corelib/ncbi_system.hpp>
+#include <util/random_gen.hpp>
 
 #include <corelib/test_boost.hpp>
 #include <common/test_data_path.h>
@@ -231,3 +233,180 @@ BOOST_AUTO_TEST_CASE(BamQuery4Start)
                              CBamAlignIterator::eSearchByStart,
                              { 131077, 200000, 11928, 26, 0 }));
 }
+
+
+typedef vector<pair<CBGZFBlock::TFileBlockPos, CBGZFBlock::TDataSize>> TBGZFBlocks;
+
+// read up to limit bytes starting at pos, and remember blocks read
+static string s_ReadBGZF(CBGZFStream& stream,
+                         CBGZFPos pos, size_t limit,
+                         TBGZFBlocks* blocks = 0)
+{
+    stream.Seek(pos);
+    string data;
+    char buffer[4096];
+    while ( data.size() < limit && stream.HaveNextAvailableBytes() ) {
+        if ( blocks && (blocks->empty() ||
+                        blocks->back().first != stream.GetBlockFilePos()) ) {
+            blocks->push_back(make_pair(stream.GetBlockFilePos(),
+                                        stream.GetBlockDataSize()));
+        }
+        data.append(buffer,
+                    stream.Read(buffer, min(sizeof(buffer), limit-data.size())));
+    }
+    return data;
+}
+
+
+BOOST_AUTO_TEST_CASE(BGZFDecompressThreads)
+{
+    string bam_path = CFile::MakePath(NCBI_GetTestDataPath(),
+                                      "bam/hs108_sra.fil_sort.chr1.bam");
+    CRef<CBGZFFile> file0(new CBGZFFile(bam_path));
+    CRef<CBGZFFile> fileN(new CBGZFFile(bam_path));
+    fileN->SetDecompressThreads(4);
+    BOOST_REQUIRE_EQUAL(file0->GetDecompressThreads(), 0u);
+    BOOST_REQUIRE_EQUAL(fileN->GetDecompressThreads(), 4u);
+    CBGZFStream stream0(*file0);
+    CBGZFStream streamN(*fileN);
+
+    // sequential read
+    const size_t kSequentialSize = 16<<20;
+    TBGZFBlocks blocks;
+    string data0 = s_ReadBGZF(stream0, CBGZFPos(), kSequentialSize, &blocks);
+    BOOST_REQUIRE(!blocks.empty());
+    BOOST_CHECK(s_ReadBGZF(streamN, CBGZFPos(), kSequentialSize) == data0);
+
+    // seeks forward and backward, some reads are short enough to leave
+    // scheduled read-ahead blocks unused
+    CRandom random(1);
+    for ( int i = 0; i < 500; ++i ) {
+        const auto& block = blocks[random.GetRandIndexSize_t(blocks.size())];
+        CBGZFPos pos(block.first, random.GetRandIndex(block.second));
+        size_t size = random.GetRandIndex(2)?
+            random.GetRandSize_t(1, 1000):
+            random.GetRandSize_t(1, 1<<20);
+        string data = s_ReadBGZF(stream0, pos, size);
+        BOOST_CHECK(!data.empty());
+        BOOST_CHECK(s_ReadBGZF(streamN, pos, size) == data);
+    }
+
+    // after all seeks the read-ahead stream still reads the same data
+    BOOST_CHECK(s_ReadBGZF(streamN, CBGZFPos(), kSequentialSize) == data0);
+}
+
+
+static void s_CheckSameIndex(const CBamRawDb& db0, const CBamRawDb& db)
+{
+    BOOST_CHECK(db.GetHeader().GetText() == db0.GetHeader().GetText());
+    BOOST_CHECK(db.GetHeader().GetAlignStart() == db0.GetHeader().GetAlignStart());
+    BOOST_REQUIRE_EQUAL(db.GetRefCount(), db0.GetRefCount());
+    BOOST_REQUIRE_EQUAL(db.GetIndex().GetRefCount(), db0.GetIndex().GetRefCount());
+    for ( size_t i = 0; i < db0.GetRefCount(); ++i ) {
+        BOOST_CHECK_EQUAL(db.GetRefName(i), db0.GetRefName(i));
+        BOOST_CHECK_EQUAL(db.GetRefSeqLength(i), db0.GetRefSeqLength(i));
+        const SBamIndexRefIndex& ref0 = db0.GetIndex().GetRef(i);
+        const SBamIndexRefIndex& ref = db.GetIndex().GetRef(i);
+        BOOST_CHECK(ref.m_UnmappedChunk == ref0.m_UnmappedChunk);
+        BOOST_CHECK_EQUAL(ref.m_MappedCount, ref0.m_MappedCount);
+        BOOST_CHECK_EQUAL(ref.m_UnmappedCount, ref0.m_UnmappedCount);
+        BOOST_CHECK_EQUAL(ref.m_EstimatedLength, ref0.m_EstimatedLength);
+        BOOST_CHECK(ref.m_Overlaps == ref0.m_Overlaps);
+        BOOST_REQUIRE_EQUAL(ref.m_Bins.size(), ref0.m_Bins.size());
+        for ( size_t j = 0; j < ref0.m_Bins.size(); ++j ) {
+            BOOST_CHECK_EQUAL(ref.m_Bins[j].m_Bin, ref0.m_Bins[j].m_Bin);
+#ifdef BAM_SUPPORT_CSI
+            BOOST_CHECK(ref.m_Bins[j].m_Overlap == ref0.m_Bins[j].m_Overlap);
+#endif
+            BOOST_CHECK(ref.m_Bins[j].m_Chunks == ref0.m_Bins[j].m_Chunks);
+        }
+    }
+}
+
+
+// open BAM file with index cache and compare it with the one opened without,
+// return true if the index was taken from the cache
+static bool s_OpenCached(const CBamRawDb& db0,
+                         const string& bam_path, const string& index_path)
+{
+    CBamRawDb db(bam_path, index_path);
+    s_CheckSameIndex(db0, db);
+    // the index is loaded from cache lazily, without read statistics
+    return db.GetIndex().GetReadStatistics().first == 0;
+}
+
+
+static void s_WriteFile(const string& file_name, const string& data)
+{
+    CNcbiOfstream out(file_name.c_str(), IOS_BASE::binary);
+    out.write(data.data(), data.size());
+    BOOST_REQUIRE(out);
+}
+
+
+static string s_ReadFile(const string& file_name)
+{
+    CNcbiIfstream in(file_name.c_str(), IOS_BASE::binary);
+    CNcbiOstrstream str;
+    str << in.rdbuf();
+    return CNcbiOstrstreamToString(str);
+}
+
+
+BOOST_AUTO_TEST_CASE(BamIndexCache)
+{
+    string bam_path = CFile::MakePath(NCBI_GetTestDataPath(),
+                                      "bam/hs108_sra.fil_sort.chr1.bam");
+    // the index is copied to change its size and time
+    CDir tmp_dir(CDirEntry::GetTmpName());
+    BOOST_REQUIRE(tmp_dir.CreatePath());
+    string index_path = CFile::MakePath(tmp_dir.GetPath(), "test.bam.bai");
+    BOOST_REQUIRE(CFile(bam_path+".bai").Copy(index_path));
+    string cache_dir = CFile::MakePath(tmp_dir.GetPath(), "cache");
+
+    string saved_cache_dir = CBamRawDb::GetIndexCacheDir();
+    CBamRawDb::SetIndexCacheDir(string());
+    CBamRawDb db0(bam_path, index_path);
+    CBamRawDb::SetIndexCacheDir(cache_dir);
+
+    // the first open writes the cache, the next one uses it
+    BOOST_CHECK(!s_OpenCached(db0, bam_path, index_path));
+    CDir::TEntries cache_files = CDir(cache_dir).GetEntries("*.bamidx");
+    BOOST_REQUIRE_EQUAL(cache_files.size(), 1u);
+    string cache_path = cache_files.front()->GetPath();
+    BOOST_CHECK(s_OpenCached(db0, bam_path, index_path));
+
+    // stale cache after the index time change
+    CTime index_time;
+    BOOST_REQUIRE(CFile(index_path).GetTime(&index_time));
+    index_time.AddSecond(-100);
+    BOOST_REQUIRE(CFile(index_path).SetTime(&index_time));
+    BOOST_CHECK(!s_OpenCached(db0, bam_path, index_path));
+    BOOST_CHECK(s_OpenCached(db0, bam_path, index_path));
+
+    // stale cache after the index size change,
+    // extra bytes at the end of index are ignored
+    {{
+        CNcbiOfstream out(index_path.c_str(),
+                          IOS_BASE::binary | IOS_BASE::app);
+        out.write("\0\0\0\0", 4);
+        BOOST_REQUIRE(out);
+    }}
+    BOOST_CHECK(!s_OpenCached(db0, bam_path, index_path));
+    BOOST_CHECK(s_OpenCached(db0, bam_path, index_path));
+
+    // corrupt cache: truncated, and with bad magic
+    string cache_data = s_ReadFile(cache_path);
+    BOOST_REQUIRE(cache_data.size() > 8);
+    s_WriteFile(cache_path, cache_data.substr(0, cache_data.size()/2));
+    BOOST_CHECK(!s_OpenCached(db0, bam_path, index_path));
+    BOOST_CHECK(s_ReadFile(cache_path) == cache_data);
+    BOOST_CHECK(s_OpenCached(db0, bam_path, index_path));
+    s_WriteFile(cache_path, "XXXXXXXX"+cache_data.substr(8));
+    BOOST_CHECK(!s_OpenCached(db0, bam_path, index_path));
+    BOOST_CHECK(s_ReadFile(cache_path) == cache_data);
+    BOOST_CHECK(s_OpenCached(db0, bam_path, index_path));
+
+    CBamRawDb::SetIndexCacheDir(saved_cache_dir);
+    tmp_dir.Remove(CDir::eRecursive);
+}
@@ -47,6 +47,7 @@
 #include <util/compress/zstd.hpp>
 #include <zstd.h>
 #include <zstd_errors.h>
+#include <zdict.h>
 
 
 BEGIN_NCBI_SCOPE
@@ -343,6 +344,31 @@ bool CZstdCompression::SetDictionary(CCompressionDictionary& dict, ENcbiOwnershi
 }
 
 
+bool CZstdCompression::TrainDictionary(const void*           samples,
+                                       const vector<size_t>& sample_sizes,
+                                       size_t                dict_capacity,
+                                       vector<char>&         dict)
+{
+    dict.clear();
+    if (!samples || sample_sizes.empty() || !dict_capacity) {
+        ERR_COMPRESS(123, "[CZstdCompression::TrainDictionary]  bad argument");
+        return false;
+    }
+    dict.resize(dict_capacity);
+    size_t result = ZDICT_trainFromBuffer(&dict[0], dict_capacity, samples,
+                                          &sample_sizes[0],
+                                          (unsigned)sample_sizes.size());
+    if (ZDICT_isError(result)) {
+        ERR_COMPRESS(123, "[CZstdCompression::TrainDictionary]  " <<
+                          ZDICT_getErrorName(result));
+        dict.clear();
+        return false;
+    }
+    dict.resize(result);
+    return true;
+}
+
+
 string CZstdCompression::FormatErrorMessage(string where, size_t pos) const
 {
     string str = "[" + where + "]  " + GetErrorDescription();
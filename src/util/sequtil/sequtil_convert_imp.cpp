@@ -36,6 +36,7 @@
 
 #include "sequtil_convert_imp.hpp"
 #include "sequtil_shared.hpp"
+#include "sequtil_simd.hpp"
 #include "sequtil_tables.hpp"
 
 #include <stdlib.h>
@@ -246,8 +247,10 @@ SIZE_TYPE CSeqConvert_imp::x_ConvertIupacnaToIupacna
     // given a specific conversion table.
     // the iupacna to iupacna table converts upper and lower case to upper case
     // and U (u) to T
-    return convert_1_to_1(src, pos, length, dst, 
-                          CIupacnaToIupacna::GetTable());
+    static const SSimdByteTable simd(CIupacnaToIupacna::GetTable(),
+                                     kSimdLetterBase);
+    return convert_1_to_1(src, pos, length, dst,
+                          CIupacnaToIupacna::GetTable(), &simd);
 }
 
 
@@ -265,16 +268,24 @@ SIZE_TYPE CSeqConvert_imp::x_ConvertIupacnaTo2na
     // that letter being in one of the 4 possible offsets within the 
     // ncbi2na byte
     const Uint1* table = CIupacnaTo2na::GetTable();
+    static const SSimdByteTable simd(table, kSimdLetterBase, 4);
     
     const char* src_i = src + pos;
-    for ( size_t count = length / 4; count; --count ) {
-        *dst = 
-            table[*src_i * 4          ] | 
-            table[*(src_i + 1) * 4 + 1] |
-            table[*(src_i + 2) * 4 + 2] |
-            table[*(src_i + 3) * 4 + 3];
-        src_i += 4;
-        ++dst;
+    for ( size_t count = length / 4; count; ) {
+        size_t done = simd_convert_4_to_1(src_i, count * 4, dst, simd) / 4;
+        src_i += done * 4;
+        dst += done;
+        count -= done;
+        // a block the kernel could not handle, or the tail
+        for ( size_t n = min(count, kSimdBlock); n; --n, --count ) {
+            *dst = 
+                table[*src_i * 4          ] | 
+                table[*(src_i + 1) * 4 + 1] |
+                table[*(src_i + 2) * 4 + 2] |
+                table[*(src_i + 3) * 4 + 3];
+            src_i += 4;
+            ++dst;
+        }
     }
     
     // Handle overhang
@@ -302,8 +313,10 @@ SIZE_TYPE CSeqConvert_imp::x_ConvertIupacnaTo2naExpand
     // given a specific conversion table.
     // the iupacna to ncbi2na_expand table converts upper and lower case IUPACna
     // into a single ncbi2na_expand byte.
-    return convert_1_to_1(src, pos, length, dst, 
-                          CIupacnaTo2naExpand::GetTable());
+    static const SSimdByteTable simd(CIupacnaTo2naExpand::GetTable(),
+                                     kSimdLetterBase);
+    return convert_1_to_1(src, pos, length, dst,
+                          CIupacnaTo2naExpand::GetTable(), &simd);
 }
 
 
@@ -322,13 +335,20 @@ SIZE_TYPE CSeqConvert_imp::x_ConvertIupacnaTo4na
     // that letter being in one of the 2 possible offsets within the 
     // ncbi4na byte
     const Uint1* table = CIupacnaTo4na::GetTable();
+    static const SSimdByteTable simd(table, kSimdLetterBase, 2);
     
     const char* src_i = src + pos;
     
-    for ( size_t count = length / 2; count; --count ) {
-        *dst = table[*src_i * 2] | table[*(src_i + 1) * 2 + 1];
-        src_i += 2;
-        ++dst;
+    for ( size_t count = length / 2; count; ) {
+        size_t done = simd_convert_2_to_1(src_i, count * 2, dst, simd) / 2;
+        src_i += done * 2;
+        dst += done;
+        count -= done;
+        for ( size_t n = min(count, kSimdBlock); n; --n, --count ) {
+            *dst = table[*src_i * 2] | table[*(src_i + 1) * 2 + 1];
+            src_i += 2;
+            ++dst;
+        }
     }
     
     // handle overhang
@@ -353,8 +373,10 @@ SIZE_TYPE CSeqConvert_imp::x_ConvertIupacnaTo8na
     // given a specific conversion table.
     // the iupacna to ncbi8na table converts upper and lower case IUPACna
     // into a single ncbi8na byte (which is the same as ncbi4na_expand)
-    return convert_1_to_1(src, pos, length, dst, 
-                          CIupacnaTo8na::GetTable());
+    static const SSimdByteTable simd(CIupacnaTo8na::GetTable(),
+                                     kSimdLetterBase);
+    return convert_1_to_1(src, pos, length, dst,
+                          CIupacnaTo8na::GetTable(), &simd);
 }
 
 
@@ -370,7 +392,9 @@ SIZE_TYPE CSeqConvert_imp::x_Convert2naToIupacna
  TSeqPos length,
  char* dst)
 {
-    return convert_1_to_4(src, pos, length, dst, C2naToIupacna::GetTable());
+    static const SSimd2naTable simd(C2naToIupacna::GetTable());
+    return convert_1_to_4(src, pos, length, dst,
+                          C2naToIupacna::GetTable(), &simd);
 }
 
 
@@ -383,7 +407,9 @@ SIZE_TYPE CSeqConvert_imp::x_Convert2naTo2naExpand
  TSeqPos length,
  char* dst)
 {
-    return convert_1_to_4(src, pos, length, dst, C2naTo2naExpand::GetTable());
+    static const SSimd2naTable simd(C2naTo2naExpand::GetTable());
+    return convert_1_to_4(src, pos, length, dst,
+                          C2naTo2naExpand::GetTable(), &simd);
 }
 
 
@@ -527,7 +553,9 @@ SIZE_TYPE CSeqConvert_imp::x_Convert2naTo8na
  TSeqPos length,
  char* dst)
 {
-    return convert_1_to_4(src, pos, length, dst, C2naTo8na::GetTable());
+    static const SSimd2naTable simd(C2naTo8na::GetTable());
+    return convert_1_to_4(src, pos, length, dst,
+                          C2naTo8na::GetTable(), &simd);
 }
 
 
@@ -543,8 +571,10 @@ SIZE_TYPE CSeqConvert_imp::x_Convert2naExpandToIupacna
  TSeqPos length,
  char* dst)
 {
-    return convert_1_to_1(src, pos, length, dst, 
-                          C2naExpandToIupacna::GetTable());
+    static const SSimdByteTable simd(C2naExpandToIupacna::GetTable(),
+                                     kSimdCodeBase);
+    return convert_1_to_1(src, pos, length, dst,
+                          C2naExpandToIupacna::GetTable(), &simd);
 }
 
 
@@ -654,7 +684,10 @@ SIZE_TYPE CSeqConvert_imp::x_Convert4naToIupacna
  TSeqPos length,
  char* dst)
 {
-    return convert_1_to_2(src, pos, length, dst, C4naToIupacna::GetTable());
+    static const SSimdNibbleTable simd(C4naToIupacna::GetTable(),
+                                       SSimdNibbleTable::eExpand);
+    return convert_1_to_2(src, pos, length, dst,
+                          C4naToIupacna::GetTable(), &simd);
 }
 
 // NCBI4na -> NCBI2na
@@ -750,8 +783,10 @@ SIZE_TYPE CSeqConvert_imp::x_Convert4naTo2naExpand
  TSeqPos length,
  char* dst)
 {
-    return convert_1_to_2(src, pos, length, dst, 
-                          C4naTo2naExpand::GetTable());
+    static const SSimdNibbleTable simd(C4naTo2naExpand::GetTable(),
+                                       SSimdNibbleTable::eExpand);
+    return convert_1_to_2(src, pos, length, dst,
+                          C4naTo2naExpand::GetTable(), &simd);
 }
 
 
@@ -764,7 +799,10 @@ SIZE_TYPE CSeqConvert_imp::x_Convert4naTo8na
  TSeqPos length,
  char* dst)
 {
-    return convert_1_to_2(src, pos, length, dst, C4naTo8na::GetTable());
+    static const SSimdNibbleTable simd(C4naTo8na::GetTable(),
+                                       SSimdNibbleTable::eExpand);
+    return convert_1_to_2(src, pos, length, dst,
+                          C4naTo8na::GetTable(), &simd);
 }
 
 
@@ -780,7 +818,10 @@ SIZE_TYPE CSeqConvert_imp::x_Convert8naToIupacna
  TSeqPos length,
  char *dst)
 {
-    return convert_1_to_1(src, pos, length, dst, C8naToIupacna::GetTable());
+    static const SSimdByteTable simd(C8naToIupacna::GetTable(),
+                                     kSimdCodeBase);
+    return convert_1_to_1(src, pos, length, dst,
+                          C8naToIupacna::GetTable(), &simd);
 }
 
 
@@ -794,15 +835,22 @@ SIZE_TYPE CSeqConvert_imp::x_Convert8naTo2na
  char *dst)
 {
     const Uint1* table = C8naTo2na::GetTable();
+    static const SSimdByteTable simd(table, kSimdCodeBase, 4);
     
     const char* iter = src + pos;
     
-    for ( size_t i = length / 4; i; --i, ++dst ) {
-        *dst = table[static_cast<Uint1>(*iter) * 4] |
-            table[static_cast<Uint1>(*(iter + 1)) * 4 + 1] |
-            table[static_cast<Uint1>(*(iter + 2)) * 4 + 2] |
-            table[static_cast<Uint1>(*(iter + 3)) * 4 + 3];
-        iter += 4;
+    for ( size_t count = length / 4; count; ) {
+        size_t done = simd_convert_4_to_1(iter, count * 4, dst, simd) / 4;
+        iter += done * 4;
+        dst += done;
+        count -= done;
+        for ( size_t n = min(count, kSimdBlock); n; --n, --count, ++dst ) {
+            *dst = table[static_cast<Uint1>(*iter) * 4] |
+                table[static_cast<Uint1>(*(iter + 1)) * 4 + 1] |
+                table[static_cast<Uint1>(*(iter + 2)) * 4 + 2] |
+                table[static_cast<Uint1>(*(iter + 3)) * 4 + 3];
+            iter += 4;
+        }
     }
     
     // Handle overhang
@@ -902,7 +950,10 @@ SIZE_TYPE CSeqConvert_imp::x_ConvertIupacaaToStdaa
  TSeqPos length,
  char *dst)
 {
-    return convert_1_to_1(src, pos, length, dst, CIupacaaToStdaa::GetTable());
+    static const SSimdByteTable simd(CIupacaaToStdaa::GetTable(),
+                                     kSimdLetterBase);
+    return convert_1_to_1(src, pos, length, dst,
+                          CIupacaaToStdaa::GetTable(), &simd);
 }
 
 
@@ -917,7 +968,10 @@ SIZE_TYPE CSeqConvert_imp::x_ConvertEaaToIupacaa
  TSeqPos length,
  char *dst)
 {
-    return convert_1_to_1(src, pos, length, dst, CEaaToIupacaa::GetTable());
+    static const SSimdByteTable simd(CEaaToIupacaa::GetTable(),
+                                     kSimdLetterBase);
+    return convert_1_to_1(src, pos, length, dst,
+                          CEaaToIupacaa::GetTable(), &simd);
 }
 
 
@@ -929,7 +983,10 @@ SIZE_TYPE CSeqConvert_imp::x_ConvertEaaToStdaa
  TSeqPos length,
  char *dst)
 {
-    return convert_1_to_1(src, pos, length, dst, CEaaToStdaa::GetTable());
+    static const SSimdByteTable simd(CEaaToStdaa::GetTable(),
+                                     kSimdLetterBase);
+    return convert_1_to_1(src, pos, length, dst,
+                          CEaaToStdaa::GetTable(), &simd);
 }
 
 
@@ -944,7 +1001,10 @@ SIZE_TYPE CSeqConvert_imp::x_ConvertStdaaToIupacaa
  TSeqPos length,
  char *dst)
 {
-    return convert_1_to_1(src, pos, length, dst, CStdaaToIupacaa::GetTable());
+    static const SSimdByteTable simd(CStdaaToIupacaa::GetTable(),
+                                     kSimdCodeBase);
+    return convert_1_to_1(src, pos, length, dst,
+                          CStdaaToIupacaa::GetTable(), &simd);
 }
 
 // NCBIstdaa (NCBI8aa) -> NCBIeaa
@@ -955,7 +1015,10 @@ SIZE_TYPE CSeqConvert_imp::x_ConvertStdaaToEaa
  TSeqPos length,
  char *dst)
 {
-    return convert_1_to_1(src, pos, length, dst, CStdaaToEaa::GetTable());
+    static const SSimdByteTable simd(CStdaaToEaa::GetTable(),
+                                     kSimdCodeBase);
+    return convert_1_to_1(src, pos, length, dst,
+                          CStdaaToEaa::GetTable(), &simd);
 }
 
 
@@ -999,8 +1062,7 @@ SIZE_TYPE CSeqConvert_imp::Subseq
         // iupacna may contain 'U' that needs to be converted to 'T'
         case CSeqUtil::e_Iupacna:
             {{
-                converted = convert_1_to_1(src, pos, length, dst, 
-                    CIupacnaToIupacna::GetTable());
+                converted = x_ConvertIupacnaToIupacna(src, pos, length, dst);
             }}
             break;
             
@@ -1339,28 +1401,20 @@ bool CSeqConvert_imp::x_HasAmbig
 bool CSeqConvert_imp::x_HasAmbigIupacna(const char* src, size_t length)
 {
     const bool *not_ambig = CIupacnaAmbig::GetTable();
+    static const SSimdByteTable simd(not_ambig, kSimdLetterBase);
     
-    const char* end = src + length;
-    
-    const char* iter = src;
-    while ( (iter != end)  &&  (not_ambig[static_cast<Uint1>(*iter)]) ) { 
-          ++iter;
-    }
-
-    return iter != end;
+    return find_first_false(src, length, not_ambig, &simd) != src + length;
 }
 
 
 bool CSeqConvert_imp::x_HasAmbigNcbi4na(const char* src, size_t length)
 {
     const bool* not_ambig = CNcbi4naAmbig::GetTable();
+    static const SSimdNibbleTable simd(not_ambig);
     
     const char* end = src + (length / 2);
     
-    const char* iter = src;
-    while ( (iter != end)  &&  (not_ambig[static_cast<Uint1>(*iter)]) ) {
-          ++iter;
-    }
+    const char* iter = find_first_false(src, length / 2, not_ambig, &simd);
     
     if ( (iter == end)  &&  (length % 2) != 0 ) {
         return not_ambig[static_cast<Uint1>(*iter | 1) & 0xF1];
@@ -1372,15 +1426,9 @@ bool CSeqConvert_imp::x_HasAmbigNcbi4na(const char* src, size_t length)
 bool CSeqConvert_imp::x_HasAmbigNcbi8na(const char* src, size_t length)
 {
     const bool *not_ambig = CNcbi8naAmbig::GetTable();
+    static const SSimdByteTable simd(not_ambig, kSimdCodeBase);
     
-    const char* end = src + length;
-    
-    const char* iter = src;
-    while ( (iter != end)  &&  (not_ambig[static_cast<Uint1>(*iter)]) ) {
-          ++iter;
-    }
-    
-    return iter != end;
+    return find_first_false(src, length, not_ambig, &simd) != src + length;
 }
 
 
@@ -39,11 +39,30 @@
 #include <util/sequtil/sequtil_manip.hpp>
 #include <util/sequtil/sequtil_convert.hpp>
 #include "sequtil_shared.hpp"
+#include "sequtil_simd.hpp"
 #include "sequtil_tables.hpp"
 
 
 BEGIN_NCBI_SCOPE
 
+
+// Vectorized forms of the complement tables
+
+static const SSimdByteTable* s_IupacnaCmpSimd(void)
+{
+    static const SSimdByteTable simd(CIupacnaCmp::GetTable(),
+                                     kSimdLetterBase);
+    return &simd;
+}
+
+
+static const SSimdByteTable* s_8naCmpSimd(void)
+{
+    static const SSimdByteTable simd(C8naCmp::GetTable(), kSimdCodeBase);
+    return &simd;
+}
+
+
 /////////////////////////////////////////////////////////////////////////////
 //
 // Reverse
@@ -341,6 +360,11 @@ static SIZE_TYPE s_Ncbi4naComplement
     switch ( pos % 2 ) {
     case 0:
         {{
+            static const SSimdNibbleTable simd(table,
+                                               SSimdNibbleTable::eTranslate);
+            size_t done = simd_convert_1_to_1(iter, end - iter, dst, simd);
+            iter += done;
+            dst += done;
             for ( ; iter != end; ++iter, ++dst ) {
                 *dst = (char)table[static_cast<Uint1>(*iter)];
             }
@@ -381,7 +405,8 @@ SIZE_TYPE CSeqManip::Complement
 
     switch ( src_coding ) {
     case CSeqUtil::e_Iupacna:
-        return convert_1_to_1(src, pos, length, dst, CIupacnaCmp::GetTable());
+        return convert_1_to_1(src, pos, length, dst, CIupacnaCmp::GetTable(),
+                              s_IupacnaCmpSimd());
 
     case CSeqUtil::e_Ncbi2na:
         return s_Ncbi2naComplement(src, pos, length, dst);
@@ -394,7 +419,8 @@ SIZE_TYPE CSeqManip::Complement
 
     case CSeqUtil::e_Ncbi8na:
     case CSeqUtil::e_Ncbi4na_expand:
-        return convert_1_to_1(src, pos, length, dst, C8naCmp::GetTable());
+        return convert_1_to_1(src, pos, length, dst, C8naCmp::GetTable(),
+                              s_8naCmpSimd());
 
     default:
         break;
@@ -487,6 +513,14 @@ static SIZE_TYPE s_Ncbi2naRevCmp
 
     case 3:
         // aligned operation
+        {{
+            static const SSimdNibbleTable simd(table,
+                                               SSimdNibbleTable::eTranslate);
+            size_t done = simd_copy_1_to_1_reverse(iter, iter - begin,
+                                                   dst, simd);
+            iter -= done;
+            dst += done;
+        }}
         for ( ; iter != begin; ++dst ) {
             *dst = table[static_cast<Uint1>(*--iter)];
         }
@@ -547,6 +581,12 @@ static SIZE_TYPE s_Ncbi4naRevCmp
 
     case 1:
         {{
+            static const SSimdNibbleTable simd(table,
+                                               SSimdNibbleTable::eTranslate);
+            size_t done = simd_copy_1_to_1_reverse(iter, iter - begin,
+                                                   dst, simd);
+            iter -= done;
+            dst += done;
             for ( ; iter != begin; ++dst ) {
                 *dst = table[static_cast<Uint1>(*--iter)];
             }
@@ -574,7 +614,8 @@ SIZE_TYPE CSeqManip::ReverseComplement
     switch ( src_coding ) {
     case CSeqUtil::e_Iupacna:
         return copy_1_to_1_reverse(src, pos, length, dst, 
-                                   CIupacnaCmp::GetTable());
+                                   CIupacnaCmp::GetTable(),
+                                   s_IupacnaCmpSimd());
 
     case CSeqUtil::e_Ncbi2na:
         return s_Ncbi2naRevCmp(src, pos, length, dst);
@@ -588,7 +629,7 @@ SIZE_TYPE CSeqManip::ReverseComplement
     case CSeqUtil::e_Ncbi8na:
     case CSeqUtil::e_Ncbi4na_expand:
         return copy_1_to_1_reverse(src, pos, length, dst, 
-                                   C8naCmp::GetTable());
+                                   C8naCmp::GetTable(), s_8naCmpSimd());
     default:
         break;
     }
@@ -672,7 +713,7 @@ static SIZE_TYPE s_Ncbi2naRevCmp
     char* buf = new char[length];
     CSeqConvert::Convert(src, CSeqUtil::e_Ncbi2na, pos, length, 
         buf, CSeqUtil::e_Ncbi8na);
-    revcmp(buf, pos, length, C8naCmp::GetTable());
+    revcmp(buf, pos, length, C8naCmp::GetTable(), s_8naCmpSimd());
     CSeqConvert::Convert(buf, CSeqUtil::e_Ncbi8na, 0, length, 
         src, CSeqUtil::e_Ncbi2na);
     delete[] buf;
@@ -689,7 +730,7 @@ static SIZE_TYPE s_Ncbi4naRevCmp
     char* buf = new char[length];
     CSeqConvert::Convert(src, CSeqUtil::e_Ncbi4na, pos, length, 
         buf, CSeqUtil::e_Ncbi8na);
-    revcmp(buf, pos, length, C8naCmp::GetTable());
+    revcmp(buf, pos, length, C8naCmp::GetTable(), s_8naCmpSimd());
     CSeqConvert::Convert(buf, CSeqUtil::e_Ncbi8na, 0, length, 
         src, CSeqUtil::e_Ncbi4na);
     delete[] buf;
@@ -708,7 +749,8 @@ SIZE_TYPE CSeqManip::ReverseComplement
 
     switch ( src_coding ) {
     case CSeqUtil::e_Iupacna:
-        return revcmp(src, pos, length, CIupacnaCmp::GetTable());
+        return revcmp(src, pos, length, CIupacnaCmp::GetTable(),
+                      s_IupacnaCmpSimd());
 
     case CSeqUtil::e_Ncbi2na:
         return s_Ncbi2naRevCmp(src, pos, length);
@@ -721,7 +763,8 @@ SIZE_TYPE CSeqManip::ReverseComplement
 
     case CSeqUtil::e_Ncbi8na:
     case CSeqUtil::e_Ncbi4na_expand:
-        return revcmp(src, pos, length, C8naCmp::GetTable());
+        return revcmp(src, pos, length, C8naCmp::GetTable(),
+                      s_8naCmpSimd());
 
     default:
         break;
@@ -33,6 +33,7 @@
 
 #include <util/sequtil/sequtil.hpp>
 #include "sequtil_shared.hpp"
+#include "sequtil_simd.hpp"
 
 
 BEGIN_NCBI_SCOPE
@@ -43,13 +44,24 @@ SIZE_TYPE convert_1_to_1
  TSeqPos pos,
  TSeqPos length,
  char* dst, 
- const Uint1* table)
+ const Uint1* table,
+ const SSimdByteTable* simd)
 {
     const char* iter = src + pos;
     const char* end = src + pos + length;
 
-    for ( ; iter != end; ++iter, ++dst ) {
-        *dst = table[static_cast<Uint1>(*iter)];
+    while ( iter != end ) {
+        if ( simd ) {
+            size_t done = simd_convert_1_to_1(iter, end - iter, dst, *simd);
+            iter += done;
+            dst += done;
+        }
+        // the tail, or a block the kernel could not handle
+        const char* block_end =
+            simd ? iter + min<size_t>(end - iter, kSimdBlock) : end;
+        for ( ; iter != block_end; ++iter, ++dst ) {
+            *dst = table[static_cast<Uint1>(*iter)];
+        }
     }
     
     return length;
@@ -61,7 +73,8 @@ SIZE_TYPE convert_1_to_2
  TSeqPos pos,
  TSeqPos length,
  char* dst,
- const Uint1* table)
+ const Uint1* table,
+ const SSimdNibbleTable* simd)
 {
     size_t size = length;
 
@@ -75,6 +88,13 @@ SIZE_TYPE convert_1_to_2
         --size;
     }
 
+    if ( simd ) {
+        size_t done = simd_convert_1_to_2(iter, size / 2, dst, *simd);
+        iter += done;
+        dst += done * 2;
+        size -= done * 2;
+    }
+
     // NB: we "trick" the compiler so that we copy 2 bytes instead
     // of one with each assignment operation
     Uint2* out_i  = reinterpret_cast<Uint2*>(dst);
@@ -100,7 +120,8 @@ SIZE_TYPE convert_1_to_4
  TSeqPos pos,
  TSeqPos length,
  char* dst, 
- const Uint1* table)
+ const Uint1* table,
+ const SSimd2naTable* simd)
 {
     size_t size = length;
 
@@ -116,6 +137,13 @@ SIZE_TYPE convert_1_to_4
         size -= to - (pos % 4);
     }
 
+    if ( simd ) {
+        size_t done = simd_convert_1_to_4(iter, size / 4, dst, *simd);
+        iter += done;
+        dst += done * 4;
+        size -= done * 4;
+    }
+
     // NB: we "trick" the compiler so that we copy 4 bytes instead
     // of one with each assignment operation
     Uint4* out_i  = reinterpret_cast<Uint4*>(dst);
@@ -143,13 +171,24 @@ SIZE_TYPE copy_1_to_1_reverse
  TSeqPos pos,
  TSeqPos length,
  char* dst, 
- const Uint1* table)
+ const Uint1* table,
+ const SSimdByteTable* simd)
 {
     const char* begin = src + pos;
     const char* iter = src + pos + length;
 
-    for ( ; iter != begin; ++dst ) {
-        *dst = table[static_cast<Uint1>(*--iter)];
+    while ( iter != begin ) {
+        if ( simd ) {
+            size_t done =
+                simd_copy_1_to_1_reverse(iter, iter - begin, dst, *simd);
+            iter -= done;
+            dst += done;
+        }
+        const char* block_begin =
+            simd ? iter - min<size_t>(iter - begin, kSimdBlock) : begin;
+        for ( ; iter != block_begin; ++dst ) {
+            *dst = table[static_cast<Uint1>(*--iter)];
+        }
     }
     
     return length;
@@ -160,16 +199,27 @@ SIZE_TYPE revcmp
 (char* buf, 
  TSeqPos pos,
  TSeqPos length,
- const Uint1* table)
+ const Uint1* table,
+ const SSimdByteTable* simd)
 {
     char* first = buf + pos;
     char* last  = first + length - 1;
     char temp;
 
-    for ( ; first <= last; ++first, --last ) {
-        temp = table[static_cast<Uint1>(*first)];
-        *first = table[static_cast<Uint1>(*last)];
-        *last = temp;
+    while ( first <= last ) {
+        if ( simd ) {
+            size_t done = simd_revcmp(first, last - first + 1, *simd);
+            first += done;
+            last -= done;
+        }
+        // the middle, or a pair of blocks the kernel could not handle
+        char* block_end =
+            simd ? first + min<size_t>(last - first + 1, kSimdBlock) : last + 1;
+        for ( ; first <= last  &&  first < block_end; ++first, --last ) {
+            temp = table[static_cast<Uint1>(*first)];
+            *first = table[static_cast<Uint1>(*last)];
+            *last = temp;
+        }
     }
 
     if ( pos != 0 ) {
@@ -180,6 +230,53 @@ SIZE_TYPE revcmp
 }
 
 
+template <typename TSimdTable>
+static const char* s_FindFirstFalse
+(const char* src,
+ size_t length,
+ const bool* table,
+ const TSimdTable* simd)
+{
+    const char* iter = src;
+    const char* end = src + length;
+
+    while ( iter != end ) {
+        if ( simd ) {
+            iter += simd_scan_1(iter, end - iter, *simd);
+        }
+        const char* block_end =
+            simd ? iter + min<size_t>(end - iter, kSimdBlock) : end;
+        for ( ; iter != block_end; ++iter ) {
+            if ( !table[static_cast<Uint1>(*iter)] ) {
+                return iter;
+            }
+        }
+    }
+
+    return end;
+}
+
+
+const char* find_first_false
+(const char* src,
+ size_t length,
+ const bool* table,
+ const SSimdByteTable* simd)
+{
+    return s_FindFirstFalse(src, length, table, simd);
+}
+
+
+const char* find_first_false
+(const char* src,
+ size_t length,
+ const bool* table,
+ const SSimdNibbleTable* simd)
+{
+    return s_FindFirstFalse(src, length, table, simd);
+}
+
+
 size_t GetBasesPerByte(CSeqUtil::TCoding coding)
 {
     if ( coding == CSeqUtil::e_Ncbi2na ) {
@@ -40,27 +40,47 @@
 BEGIN_NCBI_SCOPE
 
 
+struct SSimdByteTable;
+struct SSimdNibbleTable;
+struct SSimd2naTable;
+
+// The optional 'simd' table (see sequtil_simd.hpp), built from 'table',
+// lets the vectorized kernels do the bulk of the work.
+
 SIZE_TYPE convert_1_to_1(const char* src, 
                          TSeqPos pos, TSeqPos length,
                          char* dst, 
-                         const Uint1* table);
+                         const Uint1* table,
+                         const SSimdByteTable* simd = 0);
 
 SIZE_TYPE convert_1_to_2(const char* src,
                          TSeqPos pos, TSeqPos length,
                          char* dst,
-                         const Uint1* table);
+                         const Uint1* table,
+                         const SSimdNibbleTable* simd = 0);
 
 SIZE_TYPE convert_1_to_4(const char* src, 
                          TSeqPos pos, TSeqPos length,
                          char* dst, 
-                         const Uint1* table);
+                         const Uint1* table,
+                         const SSimd2naTable* simd = 0);
 
 SIZE_TYPE copy_1_to_1_reverse(const char* src,
                               TSeqPos pos, TSeqPos length,
                               char* dst, 
-                              const Uint1* table);
-
-SIZE_TYPE revcmp(char* buf, TSeqPos pos, TSeqPos length, const Uint1* table);
+                              const Uint1* table,
+                              const SSimdByteTable* simd = 0);
+
+SIZE_TYPE revcmp(char* buf, TSeqPos pos, TSeqPos length, const Uint1* table,
+                 const SSimdByteTable* simd = 0);
+
+// Position of the first byte for which 'table' is false, or src + length
+const char* find_first_false(const char* src, size_t length,
+                             const bool* table,
+                             const SSimdByteTable* simd = 0);
+const char* find_first_false(const char* src, size_t length,
+                             const bool* table,
+                             const SSimdNibbleTable* simd);
 
 
 size_t GetBasesPerByte(CSeqUtil::TCoding coding);
@@ -0,0 +1,650 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   Vectorized inner loops of the nucleotide conversions: SSSE3 and AVX2
+ *   on x86 (picked at run time), NEON on 64-bit ARM.
+ */
+#include <ncbi_pch.hpp>
+#include <corelib/ncbistd.hpp>
+#include <corelib/ncbi_system.hpp>
+
+#include <util/sequtil/sequtil.hpp>
+#include "sequtil_simd.hpp"
+
+#include <atomic>
+
+#if defined(__GNUC__)  &&  (defined(__x86_64__)  ||  defined(__i386__))
+#  define NCBI_SEQUTIL_SIMD_X86  1
+#  include <immintrin.h>
+#elif defined(__GNUC__)  &&  defined(__aarch64__)
+#  define NCBI_SEQUTIL_SIMD_NEON  1
+#  include <arm_neon.h>
+#endif
+
+// All primitives are forcibly inlined into the per-instruction-set
+// kernels, so the vector ABI warnings about them do not apply.
+#if defined(__GNUC__)  &&  !defined(__clang__)
+#  pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+
+BEGIN_NCBI_SCOPE
+
+
+/////////////////////////////////////////////////////////////////////////////
+// Tables
+
+SSimdByteTable::SSimdByteTable(const Uint1* table, Uint1 base)
+    : m_Valid(true), m_Base(base)
+{
+    for ( size_t i = 0;  i < 64;  ++i ) {
+        m_Table[i] = table[base + i];
+    }
+}
+
+
+SSimdByteTable::SSimdByteTable(const bool* table, Uint1 base)
+    : m_Valid(true), m_Base(base)
+{
+    for ( size_t i = 0;  i < 64;  ++i ) {
+        m_Table[i] = table[base + i] ? 1 : 0;
+    }
+}
+
+
+SSimdByteTable::SSimdByteTable(const Uint1* table, Uint1 base, size_t columns)
+    : m_Valid(columns == 2  ||  columns == 4), m_Base(base)
+{
+    size_t bits = 8 / columns;
+    for ( size_t i = 0;  i < 64  &&  m_Valid;  ++i ) {
+        const Uint1* row = table + (base + i) * columns;
+        Uint1 code = row[columns - 1];
+        m_Table[i] = code;
+        m_Valid = code < (1 << bits);
+        for ( size_t k = 0;  k < columns  &&  m_Valid;  ++k ) {
+            m_Valid = row[k] == Uint1(code << ((columns - 1 - k) * bits));
+        }
+    }
+}
+
+
+SSimdNibbleTable::SSimdNibbleTable(const Uint1* table, EType type)
+{
+    x_Init(table, type);
+}
+
+
+SSimdNibbleTable::SSimdNibbleTable(const bool* table)
+{
+    Uint1 bytes[256];
+    for ( size_t i = 0;  i < 256;  ++i ) {
+        bytes[i] = table[i] ? 1 : 0;
+    }
+    x_Init(bytes, eTest);
+}
+
+
+void SSimdNibbleTable::x_Init(const Uint1* table, EType type)
+{
+    for ( size_t n = 0;  n < 16;  ++n ) {
+        switch ( type ) {
+        case eExpand:
+            m_Hi[n] = table[(n << 4) * 2];
+            m_Lo[n] = table[n * 2 + 1];
+            break;
+        case eTranslate:
+            m_Hi[n] = table[n << 4];
+            m_Lo[n] = table[n] ^ table[0];
+            break;
+        case eTest:
+            m_Hi[n] = m_Lo[n] = table[n * 0x11];
+            break;
+        }
+    }
+    m_Valid = true;
+    for ( size_t b = 0;  b < 256  &&  m_Valid;  ++b ) {
+        Uint1 hi = m_Hi[b >> 4];
+        Uint1 lo = m_Lo[b & 0xF];
+        switch ( type ) {
+        case eExpand:
+            m_Valid = table[b * 2] == hi  &&  table[b * 2 + 1] == lo;
+            break;
+        case eTranslate:
+            m_Valid = table[b] == (hi ^ lo);
+            break;
+        case eTest:
+            m_Valid = table[b] == (hi  &&  lo ? 1 : 0);
+            break;
+        }
+    }
+}
+
+
+SSimd2naTable::SSimd2naTable(const Uint1* table)
+    : m_Valid(true)
+{
+    memset(m_Table, 0, sizeof(m_Table));
+    for ( size_t k = 0;  k < 4;  ++k ) {
+        for ( size_t code = 0;  code < 4;  ++code ) {
+            m_Table[k][code] = table[(code << (6 - 2 * k)) * 4 + k];
+        }
+    }
+    for ( size_t b = 0;  b < 256  &&  m_Valid;  ++b ) {
+        for ( size_t k = 0;  k < 4  &&  m_Valid;  ++k ) {
+            m_Valid = table[b * 4 + k] == m_Table[k][(b >> (6 - 2 * k)) & 3];
+        }
+    }
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+// Kernels
+
+namespace {
+
+struct SSimdKernels
+{
+    size_t (*convert_1_to_1)(const char*, size_t, char*,
+                             const SSimdByteTable&);
+    size_t (*translate_1_to_1)(const char*, size_t, char*,
+                               const SSimdNibbleTable&);
+    size_t (*copy_reverse)(const char*, size_t, char*,
+                           const SSimdByteTable&);
+    size_t (*translate_reverse)(const char*, size_t, char*,
+                                const SSimdNibbleTable&);
+    size_t (*revcmp)(char*, size_t, const SSimdByteTable&);
+    size_t (*scan_bytes)(const char*, size_t, const SSimdByteTable&);
+    size_t (*scan_nibbles)(const char*, size_t, const SSimdNibbleTable&);
+    size_t (*convert_1_to_2)(const char*, size_t, char*,
+                             const SSimdNibbleTable&);
+    size_t (*convert_1_to_4)(const char*, size_t, char*,
+                             const SSimd2naTable&);
+    size_t (*convert_2_to_1)(const char*, size_t, char*,
+                             const SSimdByteTable&);
+    size_t (*convert_4_to_1)(const char*, size_t, char*,
+                             const SSimdByteTable&);
+};
+
+
+#ifdef NCBI_SEQUTIL_SIMD_X86
+
+#define NCBI_SEQUTIL_SSSE3_INLINE \
+    inline __attribute__((always_inline, target("ssse3")))
+#define NCBI_SEQUTIL_AVX2_INLINE \
+    inline __attribute__((always_inline, target("avx2")))
+
+// Lookup64() uses four 16-byte pshufb tables: adding 0x70 with unsigned
+// saturation keeps the high bit clear exactly for the indices belonging
+// to the current table, and pshufb yields 0 for the others.  Pack2() and
+// Pack4() combine the codes with multiply-adds.
+
+struct SSsse3Ops
+{
+    typedef __m128i TVec;
+    struct TTable64 { TVec m_Part[4]; };
+    enum { kSize = 16 };
+
+    static NCBI_SEQUTIL_SSSE3_INLINE TVec Load(const char* p)
+    { return _mm_loadu_si128(reinterpret_cast<const TVec*>(p)); }
+    static NCBI_SEQUTIL_SSSE3_INLINE void Store(char* p, const TVec& v)
+    { _mm_storeu_si128(reinterpret_cast<TVec*>(p), v); }
+    static NCBI_SEQUTIL_SSSE3_INLINE TVec Splat(Uint1 b)
+    { return _mm_set1_epi8(char(b)); }
+    static NCBI_SEQUTIL_SSSE3_INLINE TVec And(const TVec& a, const TVec& b)
+    { return _mm_and_si128(a, b); }
+    static NCBI_SEQUTIL_SSSE3_INLINE TVec Or(const TVec& a, const TVec& b)
+    { return _mm_or_si128(a, b); }
+    static NCBI_SEQUTIL_SSSE3_INLINE TVec Xor(const TVec& a, const TVec& b)
+    { return _mm_xor_si128(a, b); }
+    static NCBI_SEQUTIL_SSSE3_INLINE TVec Sub(const TVec& a, const TVec& b)
+    { return _mm_sub_epi8(a, b); }
+    template<int N> static NCBI_SEQUTIL_SSSE3_INLINE TVec Shr(const TVec& v)
+    { return And(_mm_srli_epi16(v, N), Splat(Uint1(0xFF >> N))); }
+    static NCBI_SEQUTIL_SSSE3_INLINE TVec HiNibble(const TVec& v)
+    { return Shr<4>(v); }
+    static NCBI_SEQUTIL_SSSE3_INLINE TVec LoNibble(const TVec& v)
+    { return And(v, Splat(0x0F)); }
+    static NCBI_SEQUTIL_SSSE3_INLINE bool AllNonZero(const TVec& v)
+    { return _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128())) == 0; }
+    static NCBI_SEQUTIL_SSSE3_INLINE bool InWindow(const TVec& d)
+    { return _mm_movemask_epi8(_mm_cmpeq_epi8(And(d, Splat(0xC0)),
+                                              _mm_setzero_si128())) == 0xFFFF; }
+    static NCBI_SEQUTIL_SSSE3_INLINE TVec Table16(const Uint1* t)
+    { return _mm_loadu_si128(reinterpret_cast<const TVec*>(t)); }
+    static NCBI_SEQUTIL_SSSE3_INLINE TVec Shuffle16(const TVec& table,
+                                                    const TVec& idx)
+    { return _mm_shuffle_epi8(table, idx); }
+    static NCBI_SEQUTIL_SSSE3_INLINE TTable64 Table64(const Uint1* t)
+    {
+        TTable64 lut;
+        for (int i = 0;  i < 4;  ++i) {
+            lut.m_Part[i] = Table16(t + 16 * i);
+        }
+        return lut;
+    }
+    static NCBI_SEQUTIL_SSSE3_INLINE TVec Lookup64(const TTable64& lut,
+                                                   const TVec& d)
+    {
+        const TVec bias = Splat(0x70);
+        TVec r = Shuffle16(lut.m_Part[0], _mm_adds_epu8(d, bias));
+        for (int i = 1;  i < 4;  ++i) {
+            TVec idx = _mm_adds_epu8(Sub(d, Splat(Uint1(16 * i))), bias);
+            r = Or(r, Shuffle16(lut.m_Part[i], idx));
+        }
+        return r;
+    }
+    static NCBI_SEQUTIL_SSSE3_INLINE TVec Reverse(const TVec& v)
+    {
+        return Shuffle16(v, _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8,
+                                          7, 6, 5, 4, 3, 2, 1, 0));
+    }
+    static NCBI_SEQUTIL_SSSE3_INLINE
+    void Interleave8(const TVec& a, const TVec& b, TVec& lo, TVec& hi)
+    {
+        lo = _mm_unpacklo_epi8(a, b);
+        hi = _mm_unpackhi_epi8(a, b);
+    }
+    static NCBI_SEQUTIL_SSSE3_INLINE
+    void Interleave16(const TVec& a, const TVec& b, TVec& lo, TVec& hi)
+    {
+        lo = _mm_unpacklo_epi16(a, b);
+        hi = _mm_unpackhi_epi16(a, b);
+    }
+    static NCBI_SEQUTIL_SSSE3_INLINE TVec Pack2(const TVec& c0,
+                                                const TVec& c1)
+    {
+        const TVec w = _mm_set1_epi16(0x0110);
+        return _mm_packus_epi16(_mm_maddubs_epi16(c0, w),
+                                _mm_maddubs_epi16(c1, w));
+    }
+    static NCBI_SEQUTIL_SSSE3_INLINE TVec Pack4(const TVec& c0,
+                                                const TVec& c1,
+                                                const TVec& c2,
+                                                const TVec& c3)
+    {
+        const TVec w = _mm_set1_epi32(0x01041040);
+        const TVec one = _mm_set1_epi16(1);
+        TVec m0 = _mm_madd_epi16(_mm_maddubs_epi16(c0, w), one);
+        TVec m1 = _mm_madd_epi16(_mm_maddubs_epi16(c1, w), one);
+        TVec m2 = _mm_madd_epi16(_mm_maddubs_epi16(c2, w), one);
+        TVec m3 = _mm_madd_epi16(_mm_maddubs_epi16(c3, w), one);
+        return _mm_packus_epi16(_mm_packs_epi32(m0, m1),
+                                _mm_packs_epi32(m2, m3));
+    }
+};
+
+
+// The same with AVX2, whose shuffles, unpacks and packs work within
+// 128-bit lanes; the memory order is restored with cross-lane permutes.
+struct SAvx2Ops
+{
+    typedef __m256i TVec;
+    struct TTable64 { TVec m_Part[4]; };
+    enum { kSize = 32 };
+
+    static NCBI_SEQUTIL_AVX2_INLINE TVec Load(const char* p)
+    { return _mm256_loadu_si256(reinterpret_cast<const TVec*>(p)); }
+    static NCBI_SEQUTIL_AVX2_INLINE void Store(char* p, const TVec& v)
+    { _mm256_storeu_si256(reinterpret_cast<TVec*>(p), v); }
+    static NCBI_SEQUTIL_AVX2_INLINE TVec Splat(Uint1 b)
+    { return _mm256_set1_epi8(char(b)); }
+    static NCBI_SEQUTIL_AVX2_INLINE TVec And(const TVec& a, const TVec& b)
+    { return _mm256_and_si256(a, b); }
+    static NCBI_SEQUTIL_AVX2_INLINE TVec Or(const TVec& a, const TVec& b)
+    { return _mm256_or_si256(a, b); }
+    static NCBI_SEQUTIL_AVX2_INLINE TVec Xor(const TVec& a, const TVec& b)
+    { return _mm256_xor_si256(a, b); }
+    static NCBI_SEQUTIL_AVX2_INLINE TVec Sub(const TVec& a, const TVec& b)
+    { return _mm256_sub_epi8(a, b); }
+    template<int N> static NCBI_SEQUTIL_AVX2_INLINE TVec Shr(const TVec& v)
+    { return And(_mm256_srli_epi16(v, N), Splat(Uint1(0xFF >> N))); }
+    static NCBI_SEQUTIL_AVX2_INLINE TVec HiNibble(const TVec& v)
+    { return Shr<4>(v); }
+    static NCBI_SEQUTIL_AVX2_INLINE TVec LoNibble(const TVec& v)
+    { return And(v, Splat(0x0F)); }
+    static NCBI_SEQUTIL_AVX2_INLINE bool AllNonZero(const TVec& v)
+    { return _mm256_movemask_epi8
+            (_mm256_cmpeq_epi8(v, _mm256_setzero_si256())) == 0; }
+    static NCBI_SEQUTIL_AVX2_INLINE bool InWindow(const TVec& d)
+    { return _mm256_testz_si256(d, Splat(0xC0)) != 0; }
+    static NCBI_SEQUTIL_AVX2_INLINE TVec Table16(const Uint1* t)
+    {
+        return _mm256_broadcastsi128_si256
+            (_mm_loadu_si128(reinterpret_cast<const __m128i*>(t)));
+    }
+    static NCBI_SEQUTIL_AVX2_INLINE TVec Shuffle16(const TVec& table,
+                                                   const TVec& idx)
+    { return _mm256_shuffle_epi8(table, idx); }
+    static NCBI_SEQUTIL_AVX2_INLINE TTable64 Table64(const Uint1* t)
+    {
+        TTable64 lut;
+        for (int i = 0;  i < 4;  ++i) {
+            lut.m_Part[i] = Table16(t + 16 * i);
+        }
+        return lut;
+    }
+    static NCBI_SEQUTIL_AVX2_INLINE TVec Lookup64(const TTable64& lut,
+                                                  const TVec& d)
+    {
+        const TVec bias = Splat(0x70);
+        TVec r = Shuffle16(lut.m_Part[0], _mm256_adds_epu8(d, bias));
+        for (int i = 1;  i < 4;  ++i) {
+            TVec idx = _mm256_adds_epu8(Sub(d, Splat(Uint1(16 * i))), bias);
+            r = Or(r, Shuffle16(lut.m_Part[i], idx));
+        }
+        return r;
+    }
+    static NCBI_SEQUTIL_AVX2_INLINE TVec Reverse(const TVec& v)
+    {
+        const TVec rev = _mm256_setr_epi8
+            (15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+             15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+        return _mm256_permute4x64_epi64(Shuffle16(v, rev), 0x4E);
+    }
+    static NCBI_SEQUTIL_AVX2_INLINE
+    void Interleave8(const TVec& a, const TVec& b, TVec& lo, TVec& hi)
+    {
+        TVec l = _mm256_unpacklo_epi8(a, b);
+        TVec h = _mm256_unpackhi_epi8(a, b);
+        lo = _mm256_permute2x128_si256(l, h, 0x20);
+        hi = _mm256_permute2x128_si256(l, h, 0x31);
+    }
+    static NCBI_SEQUTIL_AVX2_INLINE
+    void Interleave16(const TVec& a, const TVec& b, TVec& lo, TVec& hi)
+    {
+        TVec l = _mm256_unpacklo_epi16(a, b);
+        TVec h = _mm256_unpackhi_epi16(a, b);
+        lo = _mm256_permute2x128_si256(l, h, 0x20);
+        hi = _mm256_permute2x128_si256(l, h, 0x31);
+    }
+    static NCBI_SEQUTIL_AVX2_INLINE TVec Pack2(const TVec& c0,
+                                               const TVec& c1)
+    {
+        const TVec w = _mm256_set1_epi16(0x0110);
+        TVec r = _mm256_packus_epi16(_mm256_maddubs_epi16(c0, w),
+                                     _mm256_maddubs_epi16(c1, w));
+        return _mm256_permute4x64_epi64(r, 0xD8);
+    }
+    static NCBI_SEQUTIL_AVX2_INLINE TVec Pack4(const TVec& c0,
+                                               const TVec& c1,
+                                               const TVec& c2,
+                                               const TVec& c3)
+    {
+        const TVec w = _mm256_set1_epi32(0x01041040);
+        const TVec one = _mm256_set1_epi16(1);
+        TVec m0 = _mm256_madd_epi16(_mm256_maddubs_epi16(c0, w), one);
+        TVec m1 = _mm256_madd_epi16(_mm256_maddubs_epi16(c1, w), one);
+        TVec m2 = _mm256_madd_epi16(_mm256_maddubs_epi16(c2, w), one);
+        TVec m3 = _mm256_madd_epi16(_mm256_maddubs_epi16(c3, w), one);
+        TVec r = _mm256_packus_epi16(_mm256_packs_epi32(m0, m1),
+                                     _mm256_packs_epi32(m2, m3));
+        return _mm256_permutevar8x32_epi32
+            (r, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+    }
+};
+
+namespace ssse3 {
+typedef SSsse3Ops SOps;
+#define NCBI_SEQUTIL_SIMD_ENTRY __attribute__((target("ssse3")))
+#include "sequtil_simd_kernels.inc"
+#undef NCBI_SEQUTIL_SIMD_ENTRY
+}
+
+namespace avx2 {
+typedef SAvx2Ops SOps;
+#define NCBI_SEQUTIL_SIMD_ENTRY __attribute__((target("avx2")))
+#include "sequtil_simd_kernels.inc"
+#undef NCBI_SEQUTIL_SIMD_ENTRY
+}
+
+#endif  // NCBI_SEQUTIL_SIMD_X86
+
+
+#ifdef NCBI_SEQUTIL_SIMD_NEON
+
+#define NCBI_SEQUTIL_SIMD_NEON_INLINE  inline __attribute__((always_inline))
+
+struct SNeonOps
+{
+    typedef uint8x16_t   TVec;
+    typedef uint8x16x4_t TTable64;
+    enum { kSize = 16 };
+
+    static NCBI_SEQUTIL_SIMD_NEON_INLINE TVec Load(const char* p)
+    { return vld1q_u8(reinterpret_cast<const uint8_t*>(p)); }
+    static NCBI_SEQUTIL_SIMD_NEON_INLINE void Store(char* p, const TVec& v)
+    { vst1q_u8(reinterpret_cast<uint8_t*>(p), v); }
+    static NCBI_SEQUTIL_SIMD_NEON_INLINE TVec Splat(Uint1 b)
+    { return vdupq_n_u8(b); }
+    static NCBI_SEQUTIL_SIMD_NEON_INLINE TVec And(const TVec& a, const TVec& b)
+    { return vandq_u8(a, b); }
+    static NCBI_SEQUTIL_SIMD_NEON_INLINE TVec Or(const TVec& a, const TVec& b)
+    { return vorrq_u8(a, b); }
+    static NCBI_SEQUTIL_SIMD_NEON_INLINE TVec Xor(const TVec& a, const TVec& b)
+    { return veorq_u8(a, b); }
+    static NCBI_SEQUTIL_SIMD_NEON_INLINE TVec Sub(const TVec& a, const TVec& b)
+    { return vsubq_u8(a, b); }
+    template<int N> static NCBI_SEQUTIL_SIMD_NEON_INLINE TVec Shr(const TVec& v)
+    { return vshrq_n_u8(v, N); }
+    static NCBI_SEQUTIL_SIMD_NEON_INLINE TVec HiNibble(const TVec& v)
+    { return vshrq_n_u8(v, 4); }
+    static NCBI_SEQUTIL_SIMD_NEON_INLINE TVec LoNibble(const TVec& v)
+    { return vandq_u8(v, vdupq_n_u8(0x0F)); }
+    static NCBI_SEQUTIL_SIMD_NEON_INLINE bool AllNonZero(const TVec& v)
+    { return vminvq_u8(v) != 0; }
+    static NCBI_SEQUTIL_SIMD_NEON_INLINE bool InWindow(const TVec& d)
+    { return vmaxvq_u8(d) < 64; }
+    static NCBI_SEQUTIL_SIMD_NEON_INLINE TVec Table16(const Uint1* t)
+    { return vld1q_u8(t); }
+    static NCBI_SEQUTIL_SIMD_NEON_INLINE TVec Shuffle16(const TVec& table,
+                                                        const TVec& idx)
+    { return vqtbl1q_u8(table, idx); }
+    static NCBI_SEQUTIL_SIMD_NEON_INLINE TTable64 Table64(const Uint1* t)
+    {
+        TTable64 lut;
+        lut.val[0] = vld1q_u8(t);
+        lut.val[1] = vld1q_u8(t + 16);
+        lut.val[2] = vld1q_u8(t + 32);
+        lut.val[3] = vld1q_u8(t + 48);
+        return lut;
+    }
+    static NCBI_SEQUTIL_SIMD_NEON_INLINE TVec Lookup64(const TTable64& lut,
+                                                       const TVec& d)
+    { return vqtbl4q_u8(lut, d); }
+    static NCBI_SEQUTIL_SIMD_NEON_INLINE TVec Reverse(const TVec& v)
+    {
+        TVec r = vrev64q_u8(v);
+        return vextq_u8(r, r, 8);
+    }
+    static NCBI_SEQUTIL_SIMD_NEON_INLINE
+    void Interleave8(const TVec& a, const TVec& b, TVec& lo, TVec& hi)
+    {
+        lo = vzip1q_u8(a, b);
+        hi = vzip2q_u8(a, b);
+    }
+    static NCBI_SEQUTIL_SIMD_NEON_INLINE
+    void Interleave16(const TVec& a, const TVec& b, TVec& lo, TVec& hi)
+    {
+        uint16x8_t a16 = vreinterpretq_u16_u8(a);
+        uint16x8_t b16 = vreinterpretq_u16_u8(b);
+        lo = vreinterpretq_u8_u16(vzip1q_u16(a16, b16));
+        hi = vreinterpretq_u8_u16(vzip2q_u16(a16, b16));
+    }
+    static NCBI_SEQUTIL_SIMD_NEON_INLINE TVec Pack2(const TVec& c0,
+                                                    const TVec& c1)
+    {
+        return vorrq_u8(vshlq_n_u8(vuzp1q_u8(c0, c1), 4), vuzp2q_u8(c0, c1));
+    }
+    static NCBI_SEQUTIL_SIMD_NEON_INLINE TVec Pack4(const TVec& c0,
+                                                    const TVec& c1,
+                                                    const TVec& c2,
+                                                    const TVec& c3)
+    {
+        TVec even01 = vuzp1q_u8(c0, c1), odd01 = vuzp2q_u8(c0, c1);
+        TVec even23 = vuzp1q_u8(c2, c3), odd23 = vuzp2q_u8(c2, c3);
+        TVec b0 = vuzp1q_u8(even01, even23), b2 = vuzp2q_u8(even01, even23);
+        TVec b1 = vuzp1q_u8(odd01, odd23),   b3 = vuzp2q_u8(odd01, odd23);
+        return vorrq_u8(vorrq_u8(vshlq_n_u8(b0, 6), vshlq_n_u8(b1, 4)),
+                        vorrq_u8(vshlq_n_u8(b2, 2), b3));
+    }
+};
+
+namespace neon {
+typedef SNeonOps SOps;
+#define NCBI_SEQUTIL_SIMD_ENTRY
+#include "sequtil_simd_kernels.inc"
+#undef NCBI_SEQUTIL_SIMD_ENTRY
+}
+
+#endif  // NCBI_SEQUTIL_SIMD_NEON
+
+
+const SSimdKernels* s_SelectKernels(void)
+{
+#if defined(NCBI_SEQUTIL_SIMD_X86)
+    if ( CCpuFeatures::AVX2() ) {
+        return &avx2::kKernels;
+    }
+    if ( CCpuFeatures::SSSE3() ) {
+        return &ssse3::kKernels;
+    }
+#elif defined(NCBI_SEQUTIL_SIMD_NEON)
+    return &neon::kKernels;
+#endif
+    return 0;
+}
+
+
+std::atomic<bool> s_SimdEnabled(true);
+
+
+inline const SSimdKernels* s_GetKernels(void)
+{
+    static const SSimdKernels* const kernels = s_SelectKernels();
+    return s_SimdEnabled.load(std::memory_order_relaxed) ? kernels : 0;
+}
+
+} // namespace
+
+
+bool CSeqUtil::IsSimdEnabled(void)
+{
+    return s_GetKernels() != 0;
+}
+
+
+void CSeqUtil::SetSimdEnabled(bool enable)
+{
+    s_SimdEnabled.store(enable, std::memory_order_relaxed);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+// Dispatch
+
+#define NCBI_SEQUTIL_SIMD_CALL(kernel, table, ...)                         \
+    const SSimdKernels* kernels = s_GetKernels();                          \
+    return kernels  &&  table.m_Valid ? kernels->kernel(__VA_ARGS__) : 0
+
+
+size_t simd_convert_1_to_1(const char* src, size_t length, char* dst,
+                           const SSimdByteTable& table)
+{
+    NCBI_SEQUTIL_SIMD_CALL(convert_1_to_1, table, src, length, dst, table);
+}
+
+
+size_t simd_convert_1_to_1(const char* src, size_t length, char* dst,
+                           const SSimdNibbleTable& table)
+{
+    NCBI_SEQUTIL_SIMD_CALL(translate_1_to_1, table, src, length, dst, table);
+}
+
+
+size_t simd_copy_1_to_1_reverse(const char* src_end, size_t length, char* dst,
+                                const SSimdByteTable& table)
+{
+    NCBI_SEQUTIL_SIMD_CALL(copy_reverse, table, src_end, length, dst, table);
+}
+
+
+size_t simd_copy_1_to_1_reverse(const char* src_end, size_t length, char* dst,
+                                const SSimdNibbleTable& table)
+{
+    NCBI_SEQUTIL_SIMD_CALL(translate_reverse, table,
+                           src_end, length, dst, table);
+}
+
+
+size_t simd_revcmp(char* first, size_t length, const SSimdByteTable& table)
+{
+    NCBI_SEQUTIL_SIMD_CALL(revcmp, table, first, length, table);
+}
+
+
+size_t simd_scan_1(const char* src, size_t length,
+                   const SSimdByteTable& table)
+{
+    NCBI_SEQUTIL_SIMD_CALL(scan_bytes, table, src, length, table);
+}
+
+
+size_t simd_scan_1(const char* src, size_t length,
+                   const SSimdNibbleTable& table)
+{
+    NCBI_SEQUTIL_SIMD_CALL(scan_nibbles, table, src, length, table);
+}
+
+
+size_t simd_convert_1_to_2(const char* src, size_t length, char* dst,
+                           const SSimdNibbleTable& table)
+{
+    NCBI_SEQUTIL_SIMD_CALL(convert_1_to_2, table, src, length, dst, table);
+}
+
+
+size_t simd_convert_1_to_4(const char* src, size_t length, char* dst,
+                           const SSimd2naTable& table)
+{
+    NCBI_SEQUTIL_SIMD_CALL(convert_1_to_4, table, src, length, dst, table);
+}
+
+
+size_t simd_convert_2_to_1(const char* src, size_t length, char* dst,
+                           const SSimdByteTable& table)
+{
+    NCBI_SEQUTIL_SIMD_CALL(convert_2_to_1, table, src, length, dst, table);
+}
+
+
+size_t simd_convert_4_to_1(const char* src, size_t length, char* dst,
+                           const SSimdByteTable& table)
+{
+    NCBI_SEQUTIL_SIMD_CALL(convert_4_to_1, table, src, length, dst, table);
+}
+
+
+END_NCBI_SCOPE
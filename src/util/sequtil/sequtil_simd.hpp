@@ -0,0 +1,150 @@
+#ifndef UTIL_SEQUTIL___SEQUTIL_SIMD__HPP
+#define UTIL_SEQUTIL___SEQUTIL_SIMD__HPP
+
+/* $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   Vectorized inner loops of the nucleotide conversions.
+ *
+ *   Every kernel handles whole vector blocks only, stops at the first block
+ *   it cannot handle, and returns the number of source bytes it consumed;
+ *   the caller finishes the job with the byte-wise tables.  The shuffle
+ *   tables the kernels use are derived from the byte-wise tables and
+ *   checked against them entry by entry when they are built: a table that
+ *   cannot be expressed that way disables its kernel, so the results never
+ *   differ from the table path.
+ */
+
+#include <corelib/ncbistd.hpp>
+
+
+BEGIN_NCBI_SCOPE
+
+
+// One byte -> one byte lookup, for source bytes in [base, base + 64):
+// 0x40 covers the IUPAC letters, 0x00 the ncbi8na and ncbi2na_expand codes.
+// Blocks holding any other byte are left to the table path.
+struct SSimdByteTable
+{
+    // Plain 256-entry table
+    SSimdByteTable(const Uint1* table, Uint1 base);
+    // 256-entry bool table (ambiguity checks)
+    SSimdByteTable(const bool* table, Uint1 base);
+    // Packing table with 'columns' (2 or 4) entries per source byte, the
+    // code for position k within the packed byte being shifted left by
+    // (columns - 1 - k) * 8 / columns bits
+    SSimdByteTable(const Uint1* table, Uint1 base, size_t columns);
+
+    bool  m_Valid;
+    Uint1 m_Base;
+    Uint1 m_Table[64];
+};
+
+const Uint1 kSimdLetterBase = 0x40;  // IUPAC letters
+const Uint1 kSimdCodeBase   = 0x00;  // binary codes
+
+
+// Byte tables split into independent nibble lookups.
+struct SSimdNibbleTable
+{
+    enum EType {
+        // 1 -> 2 expansion: out[0] = m_Hi[b >> 4], out[1] = m_Lo[b & 0xF]
+        eExpand,
+        // 1 -> 1 translation: out = m_Hi[b >> 4] ^ m_Lo[b & 0xF]
+        eTranslate,
+        // bool table: true iff m_Hi[b >> 4] && m_Lo[b & 0xF]
+        eTest
+    };
+
+    SSimdNibbleTable(const Uint1* table, EType type);
+    SSimdNibbleTable(const bool* table);
+
+    bool  m_Valid;
+    Uint1 m_Hi[16];
+    Uint1 m_Lo[16];
+
+private:
+    void x_Init(const Uint1* table, EType type);
+};
+
+
+// 1 -> 4 expansion of ncbi2na bytes: out[k] = m_Table[k][(b >> (6 - 2k)) & 3]
+struct SSimd2naTable
+{
+    SSimd2naTable(const Uint1* table);
+
+    bool  m_Valid;
+    Uint1 m_Table[4][16];
+};
+
+
+// Source bytes the table path should take over when a kernel stops short
+// (at least one block of the widest kernel).
+const size_t kSimdBlock = 32;
+
+// The simd_* functions do nothing (return 0) unless the CPU supports the
+// kernels and CSeqUtil::SetSimdEnabled() has not switched them off.
+
+// dst[i] = table[src[i]]
+size_t simd_convert_1_to_1(const char* src, size_t length, char* dst,
+                           const SSimdByteTable& table);
+size_t simd_convert_1_to_1(const char* src, size_t length, char* dst,
+                           const SSimdNibbleTable& table);
+
+// dst[i] = table[src[-1 - i]], reading backwards from src_end
+size_t simd_copy_1_to_1_reverse(const char* src_end, size_t length, char* dst,
+                                const SSimdByteTable& table);
+size_t simd_copy_1_to_1_reverse(const char* src_end, size_t length, char* dst,
+                                const SSimdNibbleTable& table);
+
+// In place reverse + translate of [first, first + length), working inwards
+// from both ends; returns the number of bytes done at each end.
+size_t simd_revcmp(char* first, size_t length, const SSimdByteTable& table);
+
+// Number of leading source bytes (in whole blocks) all mapping to true
+size_t simd_scan_1(const char* src, size_t length,
+                   const SSimdByteTable& table);
+size_t simd_scan_1(const char* src, size_t length,
+                   const SSimdNibbleTable& table);
+
+// Unpacking: 'length' source bytes into 2 or 4 bytes each
+size_t simd_convert_1_to_2(const char* src, size_t length, char* dst,
+                           const SSimdNibbleTable& table);
+size_t simd_convert_1_to_4(const char* src, size_t length, char* dst,
+                           const SSimd2naTable& table);
+
+// Packing: 'length' source bytes into length / 2 or length / 4 bytes;
+// 'table' is the packing form of SSimdByteTable.
+size_t simd_convert_2_to_1(const char* src, size_t length, char* dst,
+                           const SSimdByteTable& table);
+size_t simd_convert_4_to_1(const char* src, size_t length, char* dst,
+                           const SSimdByteTable& table);
+
+
+END_NCBI_SCOPE
+
+
+#endif  /* UTIL_SEQUTIL___SEQUTIL_SIMD__HPP */
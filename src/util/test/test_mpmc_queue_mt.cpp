@@ -0,0 +1,260 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   Test CMPMCQueue class in multithreaded environment.
+ *   Threads with even numbers produce, threads with odd numbers consume,
+ *   so the number of threads MUST be even.
+ *
+ */
+
+#include <ncbi_pch.hpp>
+#include <corelib/ncbithr.hpp>
+#include <corelib/ncbitime.hpp>
+#include <corelib/test_mt.hpp>
+#include <util/mpmc_queue.hpp>
+#include <util/random_gen.hpp>
+
+#include <common/test_assert.h>  /* This header must go last */
+
+USING_NCBI_SCOPE;
+
+
+/////////////////////////////////////////////////////////////////////////////
+//  Test application
+
+
+const int kItemsPerProducer = 200000;
+
+typedef CMPMCQueue<int> TQueue;
+
+class CTestMPMCQueueApp : public CThreadedApp
+{
+public:
+    virtual bool Thread_Run(int idx);
+protected:
+    virtual bool TestApp_Init(void);
+    virtual bool TestApp_Exit(void);
+
+private:
+    void RunProducer(int producer);
+    void RunConsumer(void);
+    void TestSingleThread(void);
+
+    static TQueue             sm_Queue;
+    static atomic<Int8>       sm_Popped;
+    static atomic<Int8>       sm_Sum;
+};
+
+
+TQueue       CTestMPMCQueueApp::sm_Queue(64);
+atomic<Int8> CTestMPMCQueueApp::sm_Popped(0);
+atomic<Int8> CTestMPMCQueueApp::sm_Sum(0);
+
+
+/////////////////////////////////////////////////////////////////////////////
+//  IMPLEMENTATION
+
+
+void CTestMPMCQueueApp::RunProducer(int producer)
+{
+    CRandom rnd(producer);
+    vector<int> batch;
+    int i = 0;
+    while (i < kItemsPerProducer) {
+        if (rnd.GetRand(0, 1)) {
+            sm_Queue.Push(producer * kItemsPerProducer + i++);
+        }
+        else {
+            batch.clear();
+            int n = min(int(rnd.GetRand(1, 16)), kItemsPerProducer - i);
+            for (int j = 0;  j < n;  ++j) {
+                batch.push_back(producer * kItemsPerProducer + i++);
+            }
+            size_t pushed = sm_Queue.PushN(batch.begin(), batch.end());
+            assert(pushed == batch.size());
+        }
+    }
+}
+
+
+void CTestMPMCQueueApp::RunConsumer(void)
+{
+    // Elements from the same producer must come in the order they are pushed
+    vector<int> last_seen(s_NumThreads / 2, -1);
+    Int8 total = Int8(kItemsPerProducer) * (s_NumThreads / 2);
+    CTimeSpan timeout(0.01);
+    vector<int> batch;
+    bool use_batch = false;
+
+    while (sm_Popped.load() < total) {
+        batch.clear();
+        if (use_batch) {
+            sm_Queue.PopN(back_inserter(batch), 16, &timeout);
+        }
+        else {
+            try {
+                batch.push_back(sm_Queue.Pop(&timeout));
+            }
+            catch (CSyncQueueException& ex) {
+                assert(ex.GetErrCode() == CSyncQueueException::eEmpty);
+            }
+        }
+        use_batch = !use_batch;
+
+        ITERATE(vector<int>, it, batch) {
+            int producer = *it / kItemsPerProducer;
+            assert(producer < int(last_seen.size()));
+            assert(*it > last_seen[producer]);
+            last_seen[producer] = *it;
+            sm_Sum += *it;
+        }
+        sm_Popped += batch.size();
+    }
+}
+
+
+void CTestMPMCQueueApp::TestSingleThread(void)
+{
+    TQueue q(5);
+    assert(q.GetMaxSize() == 8);
+    assert(q.IsEmpty());
+
+    for (int i = 0;  i < 8;  ++i) {
+        assert(q.TryPush(i));
+    }
+    assert(q.IsFull());
+    assert( !q.TryPush(8) );
+
+    CTimeSpan timeout(0.05);
+    try {
+        q.Push(8, &timeout);
+        assert(false);
+    } catch (CSyncQueueException& ex) {
+        assert(ex.GetErrCode() == CSyncQueueException::eNoRoom);
+    }
+
+    int elem = -1;
+    assert(q.TryPop(elem)  &&  elem == 0);
+    assert(q.Pop() == 1);
+
+    // Only 2 of 3 fit
+    int more[] = { 8, 9, 10 };
+    assert(q.PushN(more, more + 3, &timeout) == 2);
+
+    vector<int> out;
+    assert(q.PopN(back_inserter(out), 100) == 8);
+    for (int i = 0;  i < 8;  ++i) {
+        assert(out[i] == i + 2);
+    }
+    assert(q.IsEmpty());
+    assert( !q.TryPop(elem) );
+    assert(q.PopN(back_inserter(out), 100, &timeout) == 0);
+    try {
+        q.Pop(&timeout);
+        assert(false);
+    } catch (CSyncQueueException& ex) {
+        assert(ex.GetErrCode() == CSyncQueueException::eEmpty);
+    }
+
+    // Elements left in the queue must be destroyed with it
+    CMPMCQueue<string> sq(4);
+    sq.Push(string(100, 'a'));
+    sq.Push(string(100, 'b'));
+    assert(sq.Pop() == string(100, 'a'));
+
+    // PushN() copies, unless given move iterators
+    vector<string> strs(3, string(100, 'c'));
+    assert(sq.PushN(strs.begin(), strs.begin() + 1) == 1);
+    assert(strs[0] == string(100, 'c'));
+    CMPMCQueue< unique_ptr<int> > pq(4);
+    vector< unique_ptr<int> > ptrs;
+    ptrs.emplace_back(new int(1));
+    ptrs.emplace_back(new int(2));
+    assert(pq.PushN(make_move_iterator(ptrs.begin()),
+                    make_move_iterator(ptrs.end())) == 2);
+    assert( !ptrs[0]  &&  !ptrs[1] );
+    assert(*pq.Pop() == 1  &&  *pq.Pop() == 2);
+}
+
+
+bool CTestMPMCQueueApp::Thread_Run(int idx)
+{
+    if (idx % 2 == 0) {
+        RunProducer(idx / 2);
+    }
+    else {
+        RunConsumer();
+    }
+    return true;
+}
+
+
+bool CTestMPMCQueueApp::TestApp_Init(void)
+{
+    NcbiCout
+        << NcbiEndl
+        << "Testing lock-free queue with "
+        << NStr::IntToString(s_NumThreads)
+        << " threads"
+        << NcbiEndl;
+    if ( s_NumThreads%2 != 0 ) {
+#ifdef NCBI_THREADS
+        throw runtime_error("The number of threads MUST be even");
+#else
+        ++s_NumThreads;
+#endif
+    }
+
+    TestSingleThread();
+    return true;
+}
+
+
+bool CTestMPMCQueueApp::TestApp_Exit(void)
+{
+    Int8 n_producers = s_NumThreads / 2;
+    Int8 total = kItemsPerProducer * n_producers;
+    assert(sm_Popped.load() == total);
+    // Sum of 0 .. total-1
+    assert(sm_Sum.load() == total * (total - 1) / 2);
+    assert(sm_Queue.IsEmpty());
+
+    NcbiCout
+        << "Test completed"
+        << NcbiEndl;
+    return true;
+}
+
+
+
+/////////////////////////////////////////////////////////////////////////////
+//  MAIN
+
+int main(int argc, const char* argv[])
+{
+    // Execute main application function
+    return CTestMPMCQueueApp().AppMain(argc, argv);
+}
@@ -0,0 +1,275 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   Micro-benchmark of CMPMCQueue against CSyncQueue: several producer
+ *   threads push integers, several consumer threads pop them.
+ *
+ */
+
+#include <ncbi_pch.hpp>
+#include <corelib/ncbiapp.hpp>
+#include <corelib/ncbiargs.hpp>
+#include <corelib/ncbithr.hpp>
+#include <corelib/ncbitime.hpp>
+#include <util/sync_queue.hpp>
+#include <util/mpmc_queue.hpp>
+
+#include <common/test_assert.h>  /* This header must go last */
+
+USING_NCBI_SCOPE;
+
+
+/// Value telling a consumer to stop
+const int kStop = -1;
+
+
+/// Adaptor giving the same interface to both queues
+template <class TQueue>
+struct SQueueOps
+{
+    static void Push(TQueue& q, const int* values, size_t n)
+    {
+        for (size_t i = 0;  i < n;  ++i) {
+            q.Push(values[i]);
+        }
+    }
+    static size_t Pop(TQueue& q, int* values, size_t /* max_n */)
+    {
+        values[0] = q.Pop();
+        return 1;
+    }
+};
+
+template <>
+struct SQueueOps< CMPMCQueue<int> >
+{
+    typedef CMPMCQueue<int> TQueue;
+    static void Push(TQueue& q, const int* values, size_t n)
+    {
+        if (n == 1) {
+            q.Push(values[0]);
+        }
+        else {
+            q.PushN(values, values + n);
+        }
+    }
+    static size_t Pop(TQueue& q, int* values, size_t max_n)
+    {
+        if (max_n == 1) {
+            values[0] = q.Pop();
+            return 1;
+        }
+        return q.PopN(values, max_n);
+    }
+};
+
+
+template <class TQueue>
+class CProducerThread : public CThread
+{
+public:
+    CProducerThread(TQueue& q, int items, size_t batch)
+        : m_Queue(q), m_Items(items), m_Batch(batch)
+    {}
+protected:
+    virtual void* Main(void)
+    {
+        vector<int> values(m_Batch);
+        for (int i = 0;  i < m_Items;  ) {
+            size_t n = 0;
+            for ( ;  n < m_Batch  &&  i < m_Items;  ++n, ++i) {
+                values[n] = i;
+            }
+            SQueueOps<TQueue>::Push(m_Queue, values.data(), n);
+        }
+        return NULL;
+    }
+private:
+    TQueue& m_Queue;
+    int     m_Items;
+    size_t  m_Batch;
+};
+
+
+template <class TQueue>
+class CConsumerThread : public CThread
+{
+public:
+    CConsumerThread(TQueue& q, size_t batch)
+        : m_Queue(q), m_Batch(batch), m_Sum(0)
+    {}
+    Int8 GetSum(void) const { return m_Sum; }
+protected:
+    virtual void* Main(void)
+    {
+        vector<int> values(m_Batch);
+        for (;;) {
+            size_t n = SQueueOps<TQueue>::Pop(m_Queue, values.data(), m_Batch);
+            for (size_t i = 0;  i < n;  ++i) {
+                if (values[i] == kStop) {
+                    // Other consumers' stop values could come in the same
+                    // batch, give them back
+                    for (size_t j = i + 1;  j < n;  ++j) {
+                        _ASSERT(values[j] == kStop);
+                        SQueueOps<TQueue>::Push(m_Queue, &values[j], 1);
+                    }
+                    return NULL;
+                }
+                m_Sum += values[i];
+            }
+        }
+    }
+private:
+    TQueue& m_Queue;
+    size_t  m_Batch;
+    Int8    m_Sum;
+};
+
+
+/////////////////////////////////////////////////////////////////////////////
+//  Test application
+
+class CTestApp : public CNcbiApplication
+{
+public:
+    virtual void Init(void);
+    virtual int  Run(void);
+
+private:
+    template <class TQueue>
+    double x_Run(TQueue& q, size_t batch);
+
+    int m_Producers;
+    int m_Consumers;
+    int m_Items;
+};
+
+
+void CTestApp::Init(void)
+{
+    unique_ptr<CArgDescriptions> arg_desc(new CArgDescriptions);
+    arg_desc->SetUsageContext(GetArguments().GetProgramBasename(),
+                              "CMPMCQueue vs CSyncQueue benchmark");
+    arg_desc->AddDefaultKey("producers", "N", "Number of producer threads",
+                            CArgDescriptions::eInteger, "4");
+    arg_desc->AddDefaultKey("consumers", "N", "Number of consumer threads",
+                            CArgDescriptions::eInteger, "4");
+    arg_desc->AddDefaultKey("items", "N", "Number of items per producer",
+                            CArgDescriptions::eInteger, "1000000");
+    arg_desc->AddDefaultKey("capacity", "N", "Capacity of the queues",
+                            CArgDescriptions::eInteger, "1024");
+    arg_desc->AddDefaultKey("batch", "N",
+                            "Batch size for PushN()/PopN() of CMPMCQueue",
+                            CArgDescriptions::eInteger, "32");
+    SetupArgDescriptions(arg_desc.release());
+}
+
+
+template <class TQueue>
+double CTestApp::x_Run(TQueue& q, size_t batch)
+{
+    typedef CProducerThread<TQueue> TProducer;
+    typedef CConsumerThread<TQueue> TConsumer;
+
+    CStopWatch sw(CStopWatch::eStart);
+
+    vector< CRef<TProducer> > producers;
+    vector< CRef<TConsumer> > consumers;
+    for (int i = 0;  i < m_Consumers;  ++i) {
+        consumers.push_back(Ref(new TConsumer(q, batch)));
+        consumers.back()->Run();
+    }
+    for (int i = 0;  i < m_Producers;  ++i) {
+        producers.push_back(Ref(new TProducer(q, m_Items, batch)));
+        producers.back()->Run();
+    }
+    NON_CONST_ITERATE(typename vector< CRef<TProducer> >, it, producers) {
+        (*it)->Join();
+    }
+    for (int i = 0;  i < m_Consumers;  ++i) {
+        SQueueOps<TQueue>::Push(q, &kStop, 1);
+    }
+    Int8 sum = 0;
+    NON_CONST_ITERATE(typename vector< CRef<TConsumer> >, it, consumers) {
+        (*it)->Join();
+        sum += (*it)->GetSum();
+    }
+
+    double elapsed = sw.Elapsed();
+    Int8 expected = Int8(m_Items) * (m_Items - 1) / 2 * m_Producers;
+    if (sum != expected) {
+        NCBI_THROW(CException, eUnknown,
+                   "Checksum mismatch: " + NStr::Int8ToString(sum) +
+                   " instead of " + NStr::Int8ToString(expected));
+    }
+    return elapsed;
+}
+
+
+int CTestApp::Run(void)
+{
+    const CArgs& args = GetArgs();
+    m_Producers = args["producers"].AsInteger();
+    m_Consumers = args["consumers"].AsInteger();
+    m_Items     = args["items"].AsInteger();
+    size_t capacity = args["capacity"].AsInteger();
+    size_t batch    = args["batch"].AsInteger();
+
+    double total = double(m_Items) * m_Producers;
+    NcbiCout << m_Producers << " producers, " << m_Consumers
+             << " consumers, " << m_Items << " items per producer, capacity "
+             << capacity << NcbiEndl;
+
+    {{
+        CSyncQueue<int> q(capacity);
+        double t = x_Run(q, 1);
+        NcbiCout << "CSyncQueue Push/Pop:   " << t << " s, "
+                 << total / t / 1e6 << " Mops/s" << NcbiEndl;
+    }}
+    {{
+        CMPMCQueue<int> q(capacity);
+        double t = x_Run(q, 1);
+        NcbiCout << "CMPMCQueue Push/Pop:   " << t << " s, "
+                 << total / t / 1e6 << " Mops/s" << NcbiEndl;
+    }}
+    if (batch > 1) {
+        CMPMCQueue<int> q(capacity);
+        double t = x_Run(q, batch);
+        NcbiCout << "CMPMCQueue PushN/PopN: " << t << " s, "
+                 << total / t / 1e6 << " Mops/s (batch " << batch << ")"
+                 << NcbiEndl;
+    }
+    return 0;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+//  MAIN
+
+int main(int argc, const char* argv[])
+{
+    return CTestApp().AppMain(argc, argv);
+}
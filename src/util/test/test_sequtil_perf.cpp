@@ -0,0 +1,324 @@
+/*  $Id$
+ * ===========================================================================
+ *
+ *                            PUBLIC DOMAIN NOTICE
+ *               National Center for Biotechnology Information
+ *
+ *  This software/database is a "United States Government Work" under the
+ *  terms of the United States Copyright Act.  It was written as part of
+ *  the author's official duties as a United States Government employee and
+ *  thus cannot be copyrighted.  This software/database is freely available
+ *  to the public for use. The National Library of Medicine and the U.S.
+ *  Government have not placed any restriction on its use or reproduction.
+ *
+ *  Although all reasonable efforts have been taken to ensure the accuracy
+ *  and reliability of the software and data, the NLM and the U.S.
+ *  Government do not and cannot warrant the performance or results that
+ *  may be obtained by using this software or data. The NLM and the U.S.
+ *  Government disclaim all warranties, express or implied, including
+ *  warranties of performance, merchantability or fitness for any particular
+ *  purpose.
+ *
+ *  Please cite the author in any work or product based on this material.
+ *
+ * ===========================================================================
+ *
+ * File Description:
+ *   Throughput of the CSeqConvert/CSeqManip nucleotide conversions with and
+ *   without the vectorized kernels, checking that both give the same
+ *   results (on random ranges of sequences with ambiguities, lower case
+ *   letters and gaps as well).
+ *
+ */
+
+#include <ncbi_pch.hpp>
+#include <corelib/ncbiapp.hpp>
+#include <corelib/ncbiargs.hpp>
+#include <corelib/ncbitime.hpp>
+#include <util/random_gen.hpp>
+#include <util/sequtil/sequtil.hpp>
+#include <util/sequtil/sequtil_convert.hpp>
+#include <util/sequtil/sequtil_manip.hpp>
+
+#include <common/test_assert.h>  /* This header must go last */
+
+USING_NCBI_SCOPE;
+
+
+typedef CSeqUtil::TCoding TCoding;
+
+enum EOpType {
+    eConvert,
+    eComplement,
+    eRevComp,
+    eRevCompInPlace,
+    ePack,
+    eHasAmbig
+};
+
+struct SOp
+{
+    const char* m_Name;
+    EOpType     m_Type;
+    TCoding     m_SrcCoding;
+    TCoding     m_DstCoding;
+};
+
+// Short names for the table below
+const TCoding e_Iupacna = CSeqUtil::e_Iupacna;
+const TCoding e_Ncbi2na = CSeqUtil::e_Ncbi2na;
+const TCoding e_Ncbi4na = CSeqUtil::e_Ncbi4na;
+const TCoding e_Ncbi8na = CSeqUtil::e_Ncbi8na;
+const TCoding e_not_set = CSeqUtil::e_not_set;
+
+static const SOp kOps[] = {
+    { "iupacna -> ncbi2na",          eConvert,        e_Iupacna, e_Ncbi2na },
+    { "iupacna -> ncbi4na",          eConvert,        e_Iupacna, e_Ncbi4na },
+    { "iupacna -> ncbi8na",          eConvert,        e_Iupacna, e_Ncbi8na },
+    { "iupacna -> iupacna",          eConvert,        e_Iupacna, e_Iupacna },
+    { "ncbi8na -> ncbi2na",          eConvert,        e_Ncbi8na, e_Ncbi2na },
+    { "ncbi8na -> iupacna",          eConvert,        e_Ncbi8na, e_Iupacna },
+    { "ncbi2na -> iupacna",          eConvert,        e_Ncbi2na, e_Iupacna },
+    { "ncbi2na -> ncbi8na",          eConvert,        e_Ncbi2na, e_Ncbi8na },
+    { "ncbi4na -> iupacna",          eConvert,        e_Ncbi4na, e_Iupacna },
+    { "ncbi4na -> ncbi8na",          eConvert,        e_Ncbi4na, e_Ncbi8na },
+    { "complement iupacna",          eComplement,     e_Iupacna, e_not_set },
+    { "complement ncbi4na",          eComplement,     e_Ncbi4na, e_not_set },
+    { "revcomp iupacna",             eRevComp,        e_Iupacna, e_not_set },
+    { "revcomp ncbi8na",             eRevComp,        e_Ncbi8na, e_not_set },
+    { "revcomp ncbi2na",             eRevComp,        e_Ncbi2na, e_not_set },
+    { "revcomp ncbi4na",             eRevComp,        e_Ncbi4na, e_not_set },
+    { "revcomp iupacna (in place)",  eRevCompInPlace, e_Iupacna, e_not_set },
+    { "pack iupacna",                ePack,           e_Iupacna, e_not_set },
+    { "pack ncbi4na",                ePack,           e_Ncbi4na, e_not_set },
+    { "pack ncbi8na",                ePack,           e_Ncbi8na, e_not_set },
+    { "has ambig iupacna",           eHasAmbig,       e_Iupacna, e_not_set },
+    { "has ambig ncbi4na",           eHasAmbig,       e_Ncbi4na, e_not_set },
+    { "has ambig ncbi8na",           eHasAmbig,       e_Ncbi8na, e_not_set }
+};
+
+
+static size_t s_Bytes(TCoding coding, size_t length)
+{
+    switch ( coding ) {
+    case CSeqUtil::e_Ncbi2na:  return (length + 3) / 4;
+    case CSeqUtil::e_Ncbi4na:  return (length + 1) / 2;
+    default:                   return length;
+    }
+}
+
+
+// Run the operation; 'dst' must be a copy of 'src' for in place ones
+static void s_Run(const SOp& op, const char* src, TSeqPos pos, TSeqPos length,
+                  char* dst)
+{
+    switch ( op.m_Type ) {
+    case eConvert:
+        CSeqConvert::Convert(src, op.m_SrcCoding, pos, length,
+                             dst, op.m_DstCoding);
+        break;
+    case eComplement:
+        CSeqManip::Complement(src, op.m_SrcCoding, pos, length, dst);
+        break;
+    case eRevComp:
+        CSeqManip::ReverseComplement(src, op.m_SrcCoding, pos, length, dst);
+        break;
+    case eRevCompInPlace:
+        CSeqManip::ReverseComplement(dst, op.m_SrcCoding, pos, length);
+        break;
+    case ePack:
+        {{
+            TCoding coding;
+            CSeqConvert::Pack(src + s_Bytes(op.m_SrcCoding, pos), length,
+                              op.m_SrcCoding, dst, coding);
+        }}
+        break;
+    case eHasAmbig:
+        {{
+            // Pack() picks ncbi4na only for ranges with ambiguities;
+            // the chosen coding goes first, then the packed data
+            TCoding coding;
+            CSeqConvert::Pack(src + s_Bytes(op.m_SrcCoding, pos), length,
+                              op.m_SrcCoding, dst + 1, coding);
+            dst[0] = char(coding);
+        }}
+        break;
+    }
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+//  Test application
+
+class CTestApp : public CNcbiApplication
+{
+public:
+    virtual void Init(void);
+    virtual int  Run(void);
+
+private:
+    typedef map<TCoding, string> TData;
+
+    void x_MakeData(TSeqPos length, double ambig, bool messy, TData& data);
+    bool x_Check(const SOp& op, const string& src, TSeqPos pos,
+                 TSeqPos length);
+
+    CRandom m_Random;
+};
+
+
+void CTestApp::Init(void)
+{
+    unique_ptr<CArgDescriptions> arg_desc(new CArgDescriptions);
+    arg_desc->SetUsageContext(GetArguments().GetProgramBasename(),
+                              "Vectorized vs table-driven sequtil conversions");
+    arg_desc->AddDefaultKey("length", "N", "Sequence length, bases",
+                            CArgDescriptions::eInteger, "16000000");
+    arg_desc->AddDefaultKey("iterations", "N", "Timed runs per conversion",
+                            CArgDescriptions::eInteger, "10");
+    arg_desc->AddDefaultKey("ambig", "F",
+                            "Fraction of ambiguous bases in timed data",
+                            CArgDescriptions::eDouble, "0.0");
+    arg_desc->AddDefaultKey("checks", "N",
+                            "Random ranges to check per conversion",
+                            CArgDescriptions::eInteger, "2000");
+    SetupArgDescriptions(arg_desc.release());
+}
+
+
+// Random iupacna, converted to the other codings with the tables.
+// 'messy' adds lower case letters, U and gaps to the IUPAC text.
+void CTestApp::x_MakeData(TSeqPos length, double ambig, bool messy,
+                          TData& data)
+{
+    static const char kBases[] = "ACGT";
+    static const char kAmbig[] = "MRSVWYHKDBN";
+    static const char kMessy[] = "acgtnU-*";
+    string& iupac = data[CSeqUtil::e_Iupacna];
+    iupac.resize(length);
+    for (TSeqPos i = 0;  i < length;  ++i) {
+        if (messy  &&  m_Random.GetRand(0, 99) == 0) {
+            iupac[i] = kMessy[m_Random.GetRand(0, sizeof(kMessy) - 2)];
+        }
+        else if (m_Random.GetRand(0, 999999) < ambig * 1000000) {
+            iupac[i] = kAmbig[m_Random.GetRand(0, sizeof(kAmbig) - 2)];
+        }
+        else {
+            iupac[i] = kBases[m_Random.GetRand(0, 3)];
+        }
+    }
+    CSeqUtil::SetSimdEnabled(false);
+    CSeqConvert::Convert(iupac, CSeqUtil::e_Iupacna, 0, length,
+                         data[CSeqUtil::e_Ncbi4na], CSeqUtil::e_Ncbi4na);
+    CSeqConvert::Convert(iupac, CSeqUtil::e_Iupacna, 0, length,
+                         data[CSeqUtil::e_Ncbi8na], CSeqUtil::e_Ncbi8na);
+    // ncbi2na from random bytes: every byte value is valid
+    string& na2 = data[CSeqUtil::e_Ncbi2na];
+    na2.resize(s_Bytes(CSeqUtil::e_Ncbi2na, length));
+    for (size_t i = 0;  i < na2.size();  ++i) {
+        na2[i] = char(m_Random.GetRand(0, 255));
+    }
+    CSeqUtil::SetSimdEnabled(true);
+}
+
+
+bool CTestApp::x_Check(const SOp& op, const string& src, TSeqPos pos,
+                       TSeqPos length)
+{
+    // Guard bytes past the output catch overruns as well
+    size_t size = max(src.size(), size_t(length)) + 64;
+    vector<char> expected(size, '\x5A'), actual(size, '\x5A');
+    if (op.m_Type == eRevCompInPlace) {
+        copy(src.begin(), src.end(), expected.begin());
+        copy(src.begin(), src.end(), actual.begin());
+    }
+    CSeqUtil::SetSimdEnabled(false);
+    s_Run(op, src.data(), pos, length, expected.data());
+    CSeqUtil::SetSimdEnabled(true);
+    s_Run(op, src.data(), pos, length, actual.data());
+    if (expected != actual) {
+        ERR_POST(op.m_Name << ": results differ for pos " << pos
+                 << ", length " << length);
+        return false;
+    }
+    return true;
+}
+
+
+int CTestApp::Run(void)
+{
+    const CArgs& args = GetArgs();
+    TSeqPos length  = args["length"].AsInteger();
+    int iterations  = args["iterations"].AsInteger();
+    double ambig    = args["ambig"].AsDouble();
+    int checks      = args["checks"].AsInteger();
+
+    if ( !CSeqUtil::IsSimdEnabled() ) {
+        NcbiCout << "Vectorized kernels are not available on this CPU"
+                 << NcbiEndl;
+    }
+
+    // Correctness: random ranges of messy sequences, including short and
+    // unaligned ones
+    TData messy;
+    x_MakeData(10000, 0.05, true, messy);
+    bool ok = true;
+    for (const SOp& op : kOps) {
+        const string& src = messy[op.m_SrcCoding];
+        TSeqPos total = 10000;
+        ok &= x_Check(op, src, 0, total);
+        for (int i = 0;  i < checks;  ++i) {
+            TSeqPos pos = m_Random.GetRand(0, total - 1);
+            TSeqPos max_len = total - pos;
+            TSeqPos len = i % 2 ? m_Random.GetRand(0, min(max_len, 300u))
+                : m_Random.GetRand(0, max_len);
+            if (op.m_Type == ePack  ||  op.m_Type == eHasAmbig) {
+                // Pack works on whole bytes
+                pos -= pos % 4;
+                len = min(len, total - pos);
+            }
+            ok &= x_Check(op, src, pos, len);
+        }
+    }
+    NcbiCout << (ok ? "Results match the table-driven code"
+                 : "MISMATCHES FOUND") << NcbiEndl;
+
+    // Throughput
+    TData data;
+    x_MakeData(length, ambig, false, data);
+    vector<char> dst(length + 65);
+    NcbiCout << length << " bases, " << iterations << " iterations; "
+             << "GB/s of input:" << NcbiEndl;
+    for (const SOp& op : kOps) {
+        const string& src = data[op.m_SrcCoding];
+        if (op.m_Type == eRevCompInPlace) {
+            copy(src.begin(), src.end(), dst.begin());
+        }
+        double rate[2];
+        for (int simd = 0;  simd < 2;  ++simd) {
+            CSeqUtil::SetSimdEnabled(simd != 0);
+            CStopWatch sw(CStopWatch::eStart);
+            for (int i = 0;  i < iterations;  ++i) {
+                s_Run(op, src.data(), 0, length, dst.data());
+            }
+            rate[simd] = double(src.size()) * iterations / sw.Elapsed() / 1e9;
+        }
+        NcbiCout << setw(28) << left << op.m_Name << right << fixed
+                 << setprecision(2)
+                 << " table " << setw(6) << rate[0]
+                 << "  simd " << setw(6) << rate[1]
+                 << "  x" << rate[1] / rate[0] << NcbiEndl;
+    }
+    CSeqUtil::SetSimdEnabled(true);
+
+    return ok ? 0 : 1;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+//  MAIN
+
+int main(int argc, const char* argv[])
+{
+    return CTestApp().AppMain(argc, argv);
+}
@@ -94,10 +94,13 @@ static CRef<CThreadPool_Task> s_GetTask(size_t index)
 }
 
 static bool                              s_ZeroSleep = false;
+static CThreadPool::EScheduling          s_Scheduling
+                                             = CThreadPool::eSharedQueue;
 
 class CThreadPoolTester : public CThreadedApp
 {
 protected:
+    virtual bool TestApp_Args(CArgDescriptions& args);
     virtual bool TestApp_Init(void);
     virtual bool TestApp_Exit(void);
     virtual bool Thread_Run(int idx);
@@ -165,6 +168,27 @@ private:
     unsigned m_SleepTime;
 };
 
+// For the one-off test for tasks adding more tasks to the same pool
+// (fork-join style, goes through threads' deques with work stealing)
+class CSpawningThreadPool_Task : public CThreadPool_Task
+{
+public:
+    CSpawningThreadPool_Task(unsigned depth)
+        : m_Depth(depth)
+    {s_TaskCounter.Add(1);}
+    virtual EStatus Execute()
+    {
+        if (m_Depth > 0) {
+            GetPool()->AddTask(new CSpawningThreadPool_Task(m_Depth - 1));
+            GetPool()->AddTask(new CSpawningThreadPool_Task(m_Depth - 1));
+        }
+        s_TaskCounter.Add(-1);
+        return eCompleted;
+    }
+private:
+    unsigned m_Depth;
+};
+
 inline
 void CThreadPoolTester::GetMinMaxThreads
 (unsigned* min_threads, unsigned* max_threads)
@@ -179,6 +203,17 @@ void CThreadPoolTester::GetMinMaxThreads
 }
 
 
+bool CThreadPoolTester::TestApp_Args(CArgDescriptions& args)
+{
+    args.AddDefaultKey("scheduling", "Scheduling",
+        "How the pool distributes tasks among threads",
+        CArgDescriptions::eString, "shared");
+    args.SetConstraint("scheduling",
+        &(*new CArgAllow_Strings, "shared", "stealing"));
+    return true;
+}
+
+
 bool CThreadPoolTester::TestApp_Init(void)
 {
     s_Timer.Start();
@@ -189,6 +224,11 @@ bool CThreadPoolTester::TestApp_Init(void)
             MSG_POST("Randomization seed value: " << pid);
     }}
 
+    if (GetArgs()["scheduling"].AsString() == "stealing") {
+        s_Scheduling = CThreadPool::eWorkStealing;
+    }
+    MSG_POST("Scheduling: " << GetArgs()["scheduling"].AsString());
+
     // One-off test for using exclusive task to wait for termination of
     // previously run regular tasks
 
@@ -197,7 +237,8 @@ bool CThreadPoolTester::TestApp_Init(void)
         GetMinMaxThreads(&min_threads, &max_threads);
         MSG_POST("Terminator task test. Round: " << j <<
                  ", min/max threads: " << min_threads << "/" << max_threads);
-        CThreadPool tp(100, max_threads, min_threads);
+        CThreadPool tp(100, max_threads, min_threads,
+                       CThread::fRunDefault, s_Scheduling);
         _ASSERT(s_TaskCounter.Get() == 0);
         for (unsigned i = 0;  i < 98;  i++) {
             tp.AddTask(new CSentinelThreadPool_Task(i));
@@ -215,7 +256,8 @@ bool CThreadPoolTester::TestApp_Init(void)
     MSG_POST("One-off exclusive task test, with min/max threads: "
              << min_threads << "/" << max_threads);
 
-    CThreadPool tp(100, max_threads, min_threads);
+    CThreadPool tp(100, max_threads, min_threads,
+                   CThread::fRunDefault, s_Scheduling);
 
     _ASSERT(s_TaskCounter.Get() == 0);
     for (unsigned i = 0;  i < 50;  i++) {
@@ -241,9 +283,46 @@ bool CThreadPoolTester::TestApp_Init(void)
     _ASSERT(!tp.GetExecutingTasksCount());
     MSG_POST("(2) Finished");
 
+    // One-off test for tasks adding more tasks to the pool
+    for (unsigned j = 0; j < 20; j++) {
+        unsigned min_threads, max_threads;
+        GetMinMaxThreads(&min_threads, &max_threads);
+        MSG_POST("Spawning task test. Round: " << j <<
+                 ", min/max threads: " << min_threads << "/" << max_threads);
+        // With the shared queue the tasks adding more tasks would block
+        // if the queue could get full
+        CThreadPool tp(10000, max_threads, min_threads,
+                       CThread::fRunDefault, s_Scheduling);
+        _ASSERT(s_TaskCounter.Get() == 0);
+        for (unsigned i = 0;  i < 4;  i++) {
+            tp.AddTask(new CSpawningThreadPool_Task(10));
+        }
+        // Every task is counted before its parent finishes, so the counter
+        // drops to 0 only when the whole tree is done
+        while (s_TaskCounter.Get() != 0) {
+            SleepMilliSec(1);
+        }
+        _ASSERT(!tp.GetQueuedTasksCount());
+
+        CThreadPool::SSchedulerStats stats = tp.GetSchedulerStats();
+        MSG_POST("Scheduler stats: local " << stats.local_tasks
+                 << ", shared " << stats.shared_tasks
+                 << ", stolen " << stats.stolen_tasks
+                 << ", steal attempts " << stats.steal_attempts
+                 << ", failed steals " << stats.failed_steals
+                 << ", idle waits " << stats.idle_waits
+                 << ", max deque depth " << stats.max_local_depth);
+        _ASSERT(stats.queued_local == 0  &&  stats.queued_shared == 0);
+        if (s_Scheduling == CThreadPool::eWorkStealing) {
+            _ASSERT(stats.local_tasks + stats.shared_tasks
+                    + stats.stolen_tasks == 4 * ((1 << 11) - 1));
+        }
+    }
+
 
     //
-    s_Pool = new CThreadPool(kQueueSize, kMaxThreads);
+    s_Pool = new CThreadPool(kQueueSize, kMaxThreads, 2,
+                             CThread::fRunDefault, s_Scheduling);
 
     if (s_NumThreads > kQueueSize) {
         s_NumThreads = kQueueSize;
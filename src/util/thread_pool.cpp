@@ -42,6 +42,7 @@ BEGIN_NCBI_SCOPE
 
 class CThreadPool_Guard;
 class CThreadPool_ServiceThread;
+class CThreadPool_Impl;
 
 
 /// Functor to compare tasks by priority
@@ -54,6 +55,68 @@ struct SThreadPool_TaskCompare {
 };
 
 
+/// Deque of tasks belonging to one thread of the pool with work-stealing
+/// scheduling. The owning thread pushes and pops tasks at the back of the
+/// deque, other threads steal them from the front.
+/// Deques are never destroyed before the pool itself: when the thread stops
+/// its deque (together with the tasks left there) is passed to the next
+/// started thread.
+struct SThreadPool_LocalQueue
+{
+    typedef deque< CRef<CThreadPool_Task> >  TTasks;
+
+    SThreadPool_LocalQueue(CThreadPool_Impl* pool, unsigned int index)
+        : m_Pool(pool), m_Index(index), m_Owned(false), m_Size(0),
+          m_LocalTasks(0), m_SharedTasks(0), m_StolenTasks(0),
+          m_StealAttempts(0), m_FailedSteals(0), m_IdleWaits(0),
+          m_MaxDepth(0)
+    {}
+
+    /// Add to the counter of statistics. Can be called only by the thread
+    /// owning the deque.
+    static void Count(atomic<Uint8>& counter, Uint8 value = 1)
+    {
+        counter.store(counter.load(memory_order_relaxed) + value,
+                      memory_order_relaxed);
+    }
+
+    /// Update the maximum depth of the deque after adding of tasks.
+    /// Can be called only by the thread owning the deque.
+    void UpdateMaxDepth(size_t depth)
+    {
+        if (depth > m_MaxDepth.load(memory_order_relaxed)) {
+            m_MaxDepth.store(depth, memory_order_relaxed);
+        }
+    }
+
+    /// Pool this deque belongs to
+    CThreadPool_Impl*  m_Pool;
+    /// Index of the deque in the pool
+    unsigned int       m_Index;
+    /// If some thread owns the deque now. Guarded by the main pool mutex.
+    bool               m_Owned;
+    /// Mutex guarding m_Tasks
+    CFastMutex         m_Mutex;
+    /// Tasks waiting for execution
+    TTasks             m_Tasks;
+    /// Size of m_Tasks for checking it without taking the mutex
+    atomic<size_t>     m_Size;
+
+    /// Statistics, see CThreadPool::SSchedulerStats
+    atomic<Uint8>      m_LocalTasks;
+    atomic<Uint8>      m_SharedTasks;
+    atomic<Uint8>      m_StolenTasks;
+    atomic<Uint8>      m_StealAttempts;
+    atomic<Uint8>      m_FailedSteals;
+    atomic<Uint8>      m_IdleWaits;
+    atomic<Uint8>      m_MaxDepth;
+};
+
+
+/// Deque of the pool thread running in the current thread (if any)
+static thread_local SThreadPool_LocalQueue* s_CurrentLocalQueue = NULL;
+
+
 /// Real implementation of all ThreadPool functions
 class CThreadPool_Impl : public CObject
 {
@@ -90,7 +153,9 @@ public:
                      unsigned int      queue_size,
                      unsigned int      max_threads,
                      unsigned int      min_threads,
-                     CThread::TRunMode threads_mode = CThread::fRunDefault);
+                     CThread::TRunMode threads_mode = CThread::fRunDefault,
+                     CThreadPool::EScheduling scheduling
+                                                 = CThreadPool::eSharedQueue);
 
     /// Constructor with explicitly given controller
     /// @param pool_intf
@@ -100,7 +165,9 @@ public:
     CThreadPool_Impl(CThreadPool*        pool_intf,
                      unsigned int        queue_size,
                      CThreadPool_Controller* controller,
-                     CThread::TRunMode   threads_mode = CThread::fRunDefault);
+                     CThread::TRunMode   threads_mode = CThread::fRunDefault,
+                     CThreadPool::EScheduling scheduling
+                                                 = CThreadPool::eSharedQueue);
 
     /// Get pointer to ThreadPool interface object
     CThreadPool* GetPoolInterface(void) const;
@@ -178,7 +245,23 @@ public:
 
     /// Get next task from queue if there is one
     /// If the queue is empty then return NULL.
-    CRef<CThreadPool_Task> TryGetNextTask(void);
+    /// @param local_queue
+    ///   Deque of the calling thread (NULL if the thread has none). With
+    ///   work-stealing scheduling tasks are looked for first in this deque,
+    ///   then in the shared queue and then in deques of other threads.
+    CRef<CThreadPool_Task> TryGetNextTask(SThreadPool_LocalQueue* local_queue);
+
+    /// Give the deque of tasks to the starting thread.
+    /// Return NULL if the pool doesn't use work-stealing scheduling.
+    SThreadPool_LocalQueue* AcquireLocalQueue(void);
+
+    /// Get the scheduling the pool was created with
+    CThreadPool::EScheduling GetScheduling(void) const;
+
+    /// Get the scheduler statistics
+    ///
+    /// @sa CThreadPool::GetSchedulerStats()
+    CThreadPool::SSchedulerStats GetSchedulerStats(void) const;
 
     /// Callback from thread when it is starting to execute task
     void TaskStarting(void);
@@ -259,6 +342,12 @@ private:
     /// Type of list of all poolled threads
     typedef set<CThreadPool_ThreadImpl*> TThreadsList;
 
+    /// Maximum number of threads' deques in the pool. Threads started above
+    /// this number work with the shared queue only (and steal tasks).
+    static const unsigned int kMaxLocalQueues = 256;
+    /// Maximum number of tasks taken from the shared queue at once
+    static const size_t kMaxSharedBatch = 32;
+
 
     /// Prohibit copying and assigning
     CThreadPool_Impl(const CThreadPool_Impl&);
@@ -276,9 +365,10 @@ private:
     ///   ThreadPool interface object attached to this implementation
     /// @param controller
     ///   Controller for the pool
-    void x_Init(CThreadPool*            pool_intf,
-                CThreadPool_Controller* controller,
-                CThread::TRunMode       threads_mode);
+    void x_Init(CThreadPool*             pool_intf,
+                CThreadPool_Controller*  controller,
+                CThread::TRunMode        threads_mode,
+                CThreadPool::EScheduling scheduling);
 
     /// Destructor. Will be called from CRef
     ~CThreadPool_Impl(void);
@@ -290,6 +380,28 @@ private:
     /// Cancel all tasks waiting in the queue
     void x_CancelQueuedTasks(void);
 
+    /// Check if there are tasks waiting in the shared queue or in deques
+    /// of threads
+    bool x_HasQueuedTasks(void) const;
+
+    /// Add task to the deque of the current thread of the pool
+    void x_AddLocalTask(CThreadPool_Task* task,
+                        SThreadPool_LocalQueue* local_queue);
+
+    /// Take tasks from the shared queue: return the first one and put
+    /// some more into the deque of the thread
+    CRef<CThreadPool_Task> x_TakeSharedTasks(SThreadPool_LocalQueue* local_queue);
+
+    /// Steal tasks from the deques of other threads: return the first one
+    /// and put the rest into the deque of the thread
+    CRef<CThreadPool_Task> x_StealTasks(SThreadPool_LocalQueue* local_queue);
+
+    /// Wake up one idle thread if there are any
+    void x_WakeUpIdleThread(void);
+
+    /// Get the deque with the given index
+    SThreadPool_LocalQueue* x_GetLocalQueue(unsigned int index) const;
+
     /// Cancel all currently executing tasks
     void x_CancelExecutingTasks(void);
 
@@ -390,6 +502,19 @@ private:
     CRef<CThreadPool_ServiceThread>  m_ServiceThread;
     /// Queue for information about exclusive tasks
     TExclusiveQueue                  m_ExclusiveQueue;
+    /// How tasks are distributed among threads
+    CThreadPool::EScheduling         m_Scheduling;
+    /// Number of threads in m_IdleThreads. Changed under the main pool
+    /// mutex but read without it in x_AddLocalTask().
+    atomic<unsigned int>             m_IdleCount;
+    /// Number of tasks waiting in deques of threads
+    atomic<int>                      m_LocalTasksCount;
+    /// Deques of threads for work-stealing scheduling. Only first
+    /// m_LocalQueuesCount elements are used. New deques are added under the
+    /// main pool mutex, they are never deleted before the pool.
+    atomic<SThreadPool_LocalQueue*>  m_LocalQueues[kMaxLocalQueues];
+    /// Number of deques created
+    atomic<unsigned int>             m_LocalQueuesCount;
 };
 
 
@@ -462,6 +587,9 @@ public:
     /// @sa CThreadPool_Thread::OnExit()
     void OnExit(void);
 
+    /// Get deque of tasks of the thread (NULL if there is none)
+    SThreadPool_LocalQueue* GetLocalQueue(void) const;
+
 private:
     /// Prohibit copying and assigning
     CThreadPool_ThreadImpl(const CThreadPool_ThreadImpl&);
@@ -497,6 +625,8 @@ private:
     CSemaphore                   m_IdleTrigger;
     /// General-use mutex for very (very!) trivial ops
     mutable CFastMutex           m_FastMutex;
+    /// Deque of tasks for work-stealing scheduling
+    SThreadPool_LocalQueue*      m_LocalQueue;
 };
 
 
@@ -731,7 +861,27 @@ CThreadPool_Impl::GetThreadsCount(void) const
 inline unsigned int
 CThreadPool_Impl::GetQueuedTasksCount(void) const
 {
-    return (unsigned int)m_Queue.GetSize();
+    int local_tasks = m_LocalTasksCount.load(memory_order_relaxed);
+    return (unsigned int)m_Queue.GetSize()
+           + (local_tasks > 0 ? (unsigned int)local_tasks : 0);
+}
+
+inline CThreadPool::EScheduling
+CThreadPool_Impl::GetScheduling(void) const
+{
+    return m_Scheduling;
+}
+
+inline SThreadPool_LocalQueue*
+CThreadPool_Impl::x_GetLocalQueue(unsigned int index) const
+{
+    return m_LocalQueues[index].load(memory_order_acquire);
+}
+
+inline bool
+CThreadPool_Impl::x_HasQueuedTasks(void) const
+{
+    return m_Queue.GetSize() != 0  ||  m_LocalTasksCount.load() > 0;
 }
 
 inline unsigned int
@@ -830,26 +980,229 @@ CThreadPool_Impl::ThreadStopped(CThreadPool_ThreadImpl* thread)
 
     m_ThreadsCount.Add(-1);
 
-    m_IdleThreads.erase(thread);
+    if (m_IdleThreads.erase(thread) != 0) {
+        m_IdleCount.fetch_sub(1);
+    }
     m_WorkingThreads.erase(thread);
 
+    SThreadPool_LocalQueue* local_queue = thread->GetLocalQueue();
+    if (local_queue) {
+        // Tasks left in the deque can be stolen, make sure someone will
+        local_queue->m_Owned = false;
+        if (local_queue->m_Size.load() != 0  &&  !IsSuspended()) {
+            x_WakeUpIdleThread();
+        }
+    }
+
     CallControllerOther();
 
     ThreadStateChanged();
 }
 
 inline CRef<CThreadPool_Task>
-CThreadPool_Impl::TryGetNextTask(void)
+CThreadPool_Impl::TryGetNextTask(SThreadPool_LocalQueue* local_queue)
 {
-    if ( !IsSuspended() ) {
+    if (IsSuspended()) {
+        return CRef<CThreadPool_Task>();
+    }
+
+    if (m_Scheduling == CThreadPool::eSharedQueue) {
         TQueue::TAccessGuard guard(m_Queue);
 
         if (m_Queue.GetSize() != 0) {
             return m_Queue.Pop();
         }
+        return CRef<CThreadPool_Task>();
+    }
+
+    CRef<CThreadPool_Task> task;
+    if (local_queue  &&  local_queue->m_Size.load(memory_order_relaxed)) {
+        CFastMutexGuard guard(local_queue->m_Mutex);
+
+        if ( !local_queue->m_Tasks.empty() ) {
+            task.Swap(local_queue->m_Tasks.back());
+            local_queue->m_Tasks.pop_back();
+            local_queue->m_Size.store(local_queue->m_Tasks.size(),
+                                      memory_order_relaxed);
+        }
+    }
+    if (task.NotNull()) {
+        m_LocalTasksCount.fetch_sub(1);
+        SThreadPool_LocalQueue::Count(local_queue->m_LocalTasks);
+        return task;
+    }
+
+    task = x_TakeSharedTasks(local_queue);
+    if (task.IsNull()) {
+        task = x_StealTasks(local_queue);
+    }
+    return task;
+}
+
+CRef<CThreadPool_Task>
+CThreadPool_Impl::x_TakeSharedTasks(SThreadPool_LocalQueue* local_queue)
+{
+    CRef<CThreadPool_Task> task;
+    vector< CRef<CThreadPool_Task> > batch;
+
+    {{
+        TQueue::TAccessGuard guard(m_Queue);
+
+        size_t size = m_Queue.GetSize();
+        if (size == 0) {
+            return task;
+        }
+        task = m_Queue.Pop();
+
+        // Take the fair share of the remaining tasks so that other threads
+        // don't have to come to the shared queue for them. When queuing
+        // is disabled every task must be started by a thread immediately.
+        if (local_queue  &&  m_IsQueueAllowed) {
+            size_t n_threads = max(GetThreadsCount(), 1u);
+            size_t n_batch = min((size - 1) / n_threads, kMaxSharedBatch - 1);
+            if (n_batch != 0) {
+                // Count the tasks before they disappear from the shared
+                // queue, see SetThreadIdle()
+                m_LocalTasksCount.fetch_add(int(n_batch));
+                batch.reserve(n_batch);
+                for (size_t i = 0;  i < n_batch;  ++i) {
+                    batch.push_back(m_Queue.Pop());
+                }
+            }
+        }
+    }}
+
+    // The batch is counted in m_LocalTasks when its tasks are taken from
+    // the deque
+    if (local_queue) {
+        SThreadPool_LocalQueue::Count(local_queue->m_SharedTasks);
+    }
+    if ( !batch.empty() ) {
+        // The owner pops from the back, so the most important task goes last
+        CFastMutexGuard guard(local_queue->m_Mutex);
+        local_queue->m_Tasks.insert(local_queue->m_Tasks.end(),
+                                    batch.rbegin(), batch.rend());
+        local_queue->m_Size.store(local_queue->m_Tasks.size(),
+                                  memory_order_relaxed);
+        local_queue->UpdateMaxDepth(local_queue->m_Tasks.size());
+    }
+    return task;
+}
+
+CRef<CThreadPool_Task>
+CThreadPool_Impl::x_StealTasks(SThreadPool_LocalQueue* local_queue)
+{
+    CRef<CThreadPool_Task> task;
+    unsigned int n_queues = m_LocalQueuesCount.load(memory_order_acquire);
+    if (n_queues == 0  ||  m_LocalTasksCount.load() <= 0) {
+        return task;
+    }
+    if (local_queue) {
+        SThreadPool_LocalQueue::Count(local_queue->m_StealAttempts);
+    }
+
+    // Start with the neighbour to spread thieves among victims. Only one
+    // deque is locked at any time.
+    unsigned int start = local_queue ? local_queue->m_Index + 1 : 0;
+    vector< CRef<CThreadPool_Task> > stolen;
+    for (unsigned int i = 0;  i < n_queues  &&  stolen.empty();  ++i) {
+        SThreadPool_LocalQueue* victim = x_GetLocalQueue((start + i) % n_queues);
+        if (victim == local_queue
+            ||  victim->m_Size.load(memory_order_relaxed) == 0)
+        {
+            continue;
+        }
+
+        CFastMutexGuard guard(victim->m_Mutex);
+        size_t size = victim->m_Tasks.size();
+        if (size == 0) {
+            continue;
+        }
+        // Take the older half of the tasks, or just one if there is no
+        // place to keep the rest
+        size_t n_steal = local_queue ? (size + 1) / 2 : 1;
+        SThreadPool_LocalQueue::TTasks::iterator first
+                                                = victim->m_Tasks.begin();
+        stolen.assign(first, first + n_steal);
+        victim->m_Tasks.erase(first, first + n_steal);
+        victim->m_Size.store(victim->m_Tasks.size(), memory_order_relaxed);
+    }
+
+    if (stolen.empty()) {
+        if (local_queue) {
+            SThreadPool_LocalQueue::Count(local_queue->m_FailedSteals);
+        }
+        return task;
+    }
+
+    m_LocalTasksCount.fetch_sub(1);
+    task = stolen.front();
+    if (local_queue) {
+        SThreadPool_LocalQueue::Count(local_queue->m_StolenTasks);
+    }
+    if (stolen.size() > 1) {
+        // The oldest of the stolen tasks is executed first
+        CFastMutexGuard guard(local_queue->m_Mutex);
+        local_queue->m_Tasks.insert(local_queue->m_Tasks.end(),
+                                    stolen.rbegin(), stolen.rend() - 1);
+        local_queue->m_Size.store(local_queue->m_Tasks.size(),
+                                  memory_order_relaxed);
+        local_queue->UpdateMaxDepth(local_queue->m_Tasks.size());
+    }
+    return task;
+}
+
+SThreadPool_LocalQueue*
+CThreadPool_Impl::AcquireLocalQueue(void)
+{
+    if (m_Scheduling != CThreadPool::eWorkStealing) {
+        return NULL;
+    }
+
+    CThreadPool_Guard guard(this);
+
+    unsigned int n_queues = m_LocalQueuesCount.load(memory_order_relaxed);
+    for (unsigned int i = 0;  i < n_queues;  ++i) {
+        SThreadPool_LocalQueue* local_queue = x_GetLocalQueue(i);
+        if ( !local_queue->m_Owned ) {
+            local_queue->m_Owned = true;
+            return local_queue;
+        }
+    }
+    if (n_queues == kMaxLocalQueues) {
+        return NULL;
+    }
+
+    SThreadPool_LocalQueue* local_queue
+                            = new SThreadPool_LocalQueue(this, n_queues);
+    local_queue->m_Owned = true;
+    m_LocalQueues[n_queues].store(local_queue, memory_order_release);
+    m_LocalQueuesCount.store(n_queues + 1, memory_order_release);
+    return local_queue;
+}
+
+CThreadPool::SSchedulerStats
+CThreadPool_Impl::GetSchedulerStats(void) const
+{
+    CThreadPool::SSchedulerStats stats;
+
+    unsigned int n_queues = m_LocalQueuesCount.load(memory_order_acquire);
+    for (unsigned int i = 0;  i < n_queues;  ++i) {
+        const SThreadPool_LocalQueue* q = x_GetLocalQueue(i);
+        stats.local_tasks    += q->m_LocalTasks.load(memory_order_relaxed);
+        stats.shared_tasks   += q->m_SharedTasks.load(memory_order_relaxed);
+        stats.stolen_tasks   += q->m_StolenTasks.load(memory_order_relaxed);
+        stats.steal_attempts += q->m_StealAttempts.load(memory_order_relaxed);
+        stats.failed_steals  += q->m_FailedSteals.load(memory_order_relaxed);
+        stats.idle_waits     += q->m_IdleWaits.load(memory_order_relaxed);
+        stats.max_local_depth = max(stats.max_local_depth,
+                                  q->m_MaxDepth.load(memory_order_relaxed));
     }
 
-    return CRef<CThreadPool_Task>();
+    int local_tasks = m_LocalTasksCount.load(memory_order_relaxed);
+    stats.queued_local  = local_tasks > 0 ? local_tasks : 0;
+    stats.queued_shared = m_Queue.GetSize();
+    return stats;
 }
 
 
@@ -1221,7 +1574,8 @@ CThreadPool_ThreadImpl::CThreadPool_ThreadImpl
     m_Finishing(false),
     m_CancelRequested(false),
     m_IsIdle(true),
-    m_IdleTrigger(0, kMax_Int)
+    m_IdleTrigger(0, kMax_Int),
+    m_LocalQueue(NULL)
 {}
 
 inline
@@ -1240,6 +1594,12 @@ CThreadPool_ThreadImpl::IsFinishing(void) const
     return m_Finishing;
 }
 
+inline SThreadPool_LocalQueue*
+CThreadPool_ThreadImpl::GetLocalQueue(void) const
+{
+    return m_LocalQueue;
+}
+
 inline CRef<CThreadPool_Task>
 CThreadPool_ThreadImpl::GetCurrentTask(void) const
 {
@@ -1277,8 +1637,12 @@ CThreadPool_ThreadImpl::x_TaskFinished(CThreadPool_Task::EStatus status)
 inline void
 CThreadPool_ThreadImpl::x_Idle(void)
 {
-    if ( x_SetIdleState(true) )
+    if ( x_SetIdleState(true) ) {
+        if (m_LocalQueue) {
+            SThreadPool_LocalQueue::Count(m_LocalQueue->m_IdleWaits);
+        }
         m_IdleTrigger.Wait();
+    }
 }
 
 inline void
@@ -1311,6 +1675,9 @@ CThreadPool_ThreadImpl::Main(void)
 {
     m_Interface->Initialize();
 
+    m_LocalQueue = m_Pool->AcquireLocalQueue();
+    s_CurrentLocalQueue = m_LocalQueue;
+
     while (!m_Finishing) {
         // We have to heed call to CancelCurrentTask() only after this point.
         // So we reset value of m_CancelRequested here without any mutexes.
@@ -1321,7 +1688,7 @@ CThreadPool_ThreadImpl::Main(void)
         m_CancelRequested = false;
 
         {{
-            CRef<CThreadPool_Task> task = m_Pool->TryGetNextTask();
+            CRef<CThreadPool_Task> task = m_Pool->TryGetNextTask(m_LocalQueue);
             CFastMutexGuard fast_guard(m_FastMutex);
             m_CurrentTask = task;
         }}
@@ -1384,6 +1751,8 @@ CThreadPool_ThreadImpl::Main(void)
 inline void
 CThreadPool_ThreadImpl::OnExit(void)
 {
+    s_CurrentLocalQueue = NULL;
+
     try {
         m_Interface->Finalize();
     } STD_CATCH_ALL_X(8, "Finalize")
@@ -1420,32 +1789,35 @@ CThreadPool_Impl::CThreadPool_Impl(CThreadPool*      pool_intf,
                                    unsigned int      queue_size,
                                    unsigned int      max_threads,
                                    unsigned int      min_threads,
-                                   CThread::TRunMode threads_mode)
+                                   CThread::TRunMode threads_mode,
+                                   CThreadPool::EScheduling scheduling)
     : m_Queue(x_GetQueueSize(queue_size)),
       m_RoomWait(0, kMax_Int),
       m_AbortWait(0, kMax_Int)
 {
     x_Init(pool_intf,
            new CThreadPool_Controller_PID(max_threads, min_threads),
-           threads_mode);
+           threads_mode, scheduling);
 }
 
 inline
 CThreadPool_Impl::CThreadPool_Impl(CThreadPool*            pool_intf,
                                    unsigned int            queue_size,
                                    CThreadPool_Controller* controller,
-                                   CThread::TRunMode       threads_mode)
+                                   CThread::TRunMode       threads_mode,
+                                   CThreadPool::EScheduling scheduling)
     : m_Queue(x_GetQueueSize(queue_size)),
       m_RoomWait(0, kMax_Int),
       m_AbortWait(0, kMax_Int)
 {
-    x_Init(pool_intf, controller, threads_mode);
+    x_Init(pool_intf, controller, threads_mode, scheduling);
 }
 
 void
 CThreadPool_Impl::x_Init(CThreadPool*             pool_intf,
                          CThreadPool_Controller*  controller,
-                         CThread::TRunMode        threads_mode)
+                         CThread::TRunMode        threads_mode,
+                         CThreadPool::EScheduling scheduling)
 {
     m_Interface = pool_intf;
     m_SelfRef = this;
@@ -1458,6 +1830,13 @@ CThreadPool_Impl::x_Init(CThreadPool*             pool_intf,
     m_FlushRequested = false;
     m_ThreadsMode = (threads_mode | CThread::fRunDetached)
                      & ~CThread::fRunAllowST;
+    m_Scheduling = scheduling;
+    m_IdleCount.store(0);
+    m_LocalTasksCount.store(0);
+    m_LocalQueuesCount.store(0);
+    for (unsigned int i = 0;  i < kMaxLocalQueues;  ++i) {
+        m_LocalQueues[i].store(NULL, memory_order_relaxed);
+    }
 
     controller->x_AttachToPool(this);
     m_Controller = controller;
@@ -1466,7 +1845,12 @@ CThreadPool_Impl::x_Init(CThreadPool*             pool_intf,
 }
 
 CThreadPool_Impl::~CThreadPool_Impl(void)
-{}
+{
+    unsigned int n_queues = m_LocalQueuesCount.load();
+    for (unsigned int i = 0;  i < n_queues;  ++i) {
+        delete x_GetLocalQueue(i);
+    }
+}
 
 inline void
 CThreadPool_Impl::DestroyReference(void)
@@ -1511,6 +1895,7 @@ CThreadPool_Impl::LaunchThreads(unsigned int count)
     }
 
     m_ThreadsCount.Add(count);
+    m_IdleCount.fetch_add(count);
     CallControllerOther();
 }
 
@@ -1556,7 +1941,14 @@ CThreadPool_Impl::SetThreadIdle(CThreadPool_ThreadImpl* thread, bool is_idle)
 {
     CThreadPool_Guard guard(this);
 
-    if (is_idle  &&  !IsSuspended()  &&  m_Queue.GetSize() != 0) {
+    // Threads adding tasks to their deques don't take the mutex, they only
+    // check m_IdleCount after counting the new task. So it must be changed
+    // before checking for tasks here.
+    if (is_idle) {
+        m_IdleCount.fetch_add(1);
+    }
+    if (is_idle  &&  !IsSuspended()  &&  x_HasQueuedTasks()) {
+        m_IdleCount.fetch_sub(1);
         thread->WakeUp();
         return false;
     }
@@ -1575,6 +1967,9 @@ CThreadPool_Impl::SetThreadIdle(CThreadPool_ThreadImpl* thread, bool is_idle)
     TThreadsList::iterator it = to_del->find(thread);
     if (it != to_del->end()) {
         to_del->erase(it);
+        if ( !is_idle ) {
+            m_IdleCount.fetch_sub(1);
+        }
     }
     to_ins->insert(thread);
 
@@ -1678,6 +2073,13 @@ CThreadPool_Impl::AddTask(CThreadPool_Task* task, const CTimeSpan* timeout)
         ThrowAddProhibited();
     }
 
+    // Tasks spawned by tasks of this very pool go to the thread's own deque
+    SThreadPool_LocalQueue* local_queue = s_CurrentLocalQueue;
+    if (local_queue  &&  local_queue->m_Pool == this  &&  m_IsQueueAllowed) {
+        x_AddLocalTask(task, local_queue);
+        return;
+    }
+
     CThreadPool_Guard guard(this, false);
     unique_ptr<CTimeSpan> adjusted_timeout;
 
@@ -1755,18 +2157,113 @@ CThreadPool_Impl::AddTask(CThreadPool_Task* task, const CTimeSpan* timeout)
     CallControllerOther();
 }
 
+void
+CThreadPool_Impl::x_AddLocalTask(CThreadPool_Task*       task,
+                                 SThreadPool_LocalQueue* local_queue)
+{
+    task->x_SetOwner(this);
+    task->x_SetStatus(CThreadPool_Task::eQueued);
+    // The task can be stolen and finished right after it is pushed, so
+    // count it in advance
+    m_TotalTasks.Add(1);
+
+    {{
+        CFastMutexGuard guard(local_queue->m_Mutex);
+        local_queue->m_Tasks.push_back(Ref(task));
+        local_queue->m_Size.store(local_queue->m_Tasks.size(),
+                                  memory_order_relaxed);
+        local_queue->UpdateMaxDepth(local_queue->m_Tasks.size());
+    }}
+    m_LocalTasksCount.fetch_add(1);
+
+    // Same check as in AddTask() but without the mutex - any race here is
+    // a matter of timing only.
+    CThreadPool::TExclusiveFlags check_flags
+        = CThreadPool::fDoNotAllowNewTasks | CThreadPool::fCancelQueuedTasks;
+    if (m_Aborted  ||  (IsSuspended()
+                        &&  (m_SuspendFlags & check_flags)  == check_flags))
+    {
+        CThreadPool_Guard guard(this);
+
+        // The task is uncounted only if it is still queued; once taken by
+        // a thread it is counted off by TaskFinished() or left as any
+        // canceled task.
+        bool dequeued = false;
+        {{
+            CFastMutexGuard q_guard(local_queue->m_Mutex);
+            SThreadPool_LocalQueue::TTasks& tasks = local_queue->m_Tasks;
+            for (SThreadPool_LocalQueue::TTasks::iterator it = tasks.end();
+                 it != tasks.begin(); )
+            {
+                if ((--it)->GetPointer() == task) {
+                    tasks.erase(it);
+                    dequeued = true;
+                    break;
+                }
+            }
+            local_queue->m_Size.store(tasks.size(), memory_order_relaxed);
+        }}
+        if (dequeued) {
+            m_LocalTasksCount.fetch_sub(1);
+            m_TotalTasks.Add(-1);
+            sx_RequestToCancel(task);
+        }
+        x_CancelQueuedTasks();
+        return;
+    }
+
+    // Pairs with SetThreadIdle(): either the thread going idle sees the new
+    // task or we see the thread.
+    if (m_IdleCount.load() != 0  &&  !IsSuspended()) {
+        CThreadPool_Guard guard(this);
+        x_WakeUpIdleThread();
+    }
+
+    CallControllerOther();
+}
+
+void
+CThreadPool_Impl::x_WakeUpIdleThread(void)
+{
+    ITERATE(TThreadsList, it, m_IdleThreads) {
+        if (! (*it)->IsFinishing()) {
+            (*it)->WakeUp();
+            break;
+        }
+    }
+}
+
 inline void
 CThreadPool_Impl::x_RemoveTaskFromQueue(const CThreadPool_Task* task)
 {
-    TQueue::TAccessGuard q_guard(m_Queue);
+    {{
+        TQueue::TAccessGuard q_guard(m_Queue);
 
-    TQueue::TAccessGuard::TIterator it = q_guard.Begin();
-    while (it != q_guard.End()  &&  *it != task) {
-        ++it;
-    }
+        TQueue::TAccessGuard::TIterator it = q_guard.Begin();
+        while (it != q_guard.End()  &&  *it != task) {
+            ++it;
+        }
 
-    if (it != q_guard.End()) {
-        q_guard.Erase(it);
+        if (it != q_guard.End()) {
+            q_guard.Erase(it);
+            return;
+        }
+    }}
+
+    unsigned int n_queues = m_LocalQueuesCount.load(memory_order_acquire);
+    for (unsigned int i = 0;  i < n_queues;  ++i) {
+        SThreadPool_LocalQueue* local_queue = x_GetLocalQueue(i);
+        CFastMutexGuard guard(local_queue->m_Mutex);
+
+        SThreadPool_LocalQueue::TTasks& tasks = local_queue->m_Tasks;
+        SThreadPool_LocalQueue::TTasks::iterator it
+                                    = find(tasks.begin(), tasks.end(), task);
+        if (it != tasks.end()) {
+            tasks.erase(it);
+            local_queue->m_Size.store(tasks.size(), memory_order_relaxed);
+            m_LocalTasksCount.fetch_sub(1);
+            return;
+        }
     }
 }
 
@@ -1874,6 +2371,21 @@ CThreadPool_Impl::x_CancelQueuedTasks(void)
     }
 
     m_Queue.Clear();
+
+    unsigned int n_queues = m_LocalQueuesCount.load(memory_order_acquire);
+    for (unsigned int i = 0;  i < n_queues;  ++i) {
+        SThreadPool_LocalQueue* local_queue = x_GetLocalQueue(i);
+        CFastMutexGuard guard(local_queue->m_Mutex);
+
+        NON_CONST_ITERATE(SThreadPool_LocalQueue::TTasks, it,
+                          local_queue->m_Tasks)
+        {
+            it->GetNCPointer()->x_RequestToCancel();
+        }
+        m_LocalTasksCount.fetch_sub(int(local_queue->m_Tasks.size()));
+        local_queue->m_Tasks.clear();
+        local_queue->m_Size.store(0, memory_order_relaxed);
+    }
 }
 
 inline void
@@ -2177,18 +2689,21 @@ CThreadPool_Thread::OnExit(void)
 CThreadPool::CThreadPool(unsigned int      queue_size,
                          unsigned int      max_threads,
                          unsigned int      min_threads,
-                         CThread::TRunMode threads_mode)
+                         CThread::TRunMode threads_mode,
+                         EScheduling       scheduling)
 {
     m_Impl = new CThreadPool_Impl(this, queue_size, max_threads, min_threads,
-                                  threads_mode);
+                                  threads_mode, scheduling);
     m_Impl->SetInterfaceStarted();
 }
 
 CThreadPool::CThreadPool(unsigned int            queue_size,
                          CThreadPool_Controller* controller,
-                         CThread::TRunMode       threads_mode)
+                         CThread::TRunMode       threads_mode,
+                         EScheduling             scheduling)
 {
-    m_Impl = new CThreadPool_Impl(this, queue_size, controller, threads_mode);
+    m_Impl = new CThreadPool_Impl(this, queue_size, controller, threads_mode,
+                                  scheduling);
     m_Impl->SetInterfaceStarted();
 }
 
@@ -2282,6 +2797,18 @@ CThreadPool::GetExecutingTasksCount(void) const
     return m_Impl->GetExecutingTasksCount();
 }
 
+CThreadPool::SSchedulerStats
+CThreadPool::GetSchedulerStats(void) const
+{
+    return m_Impl->GetSchedulerStats();
+}
+
+CThreadPool::EScheduling
+CThreadPool::GetScheduling(void) const
+{
+    return m_Impl->GetScheduling();
+}
+
 
 
 END_NCBI_SCOPE